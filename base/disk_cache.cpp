@@ -0,0 +1,525 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/disk_cache.h"
+
+#include "base/debug.h"
+#include "base/file_content.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/thread_pool.h"
+#include "base/time.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace base {
+
+namespace {
+
+constexpr char kIndexMagic[8] = { 'L', 'A', 'F', 'C', 'A', 'C', 'H', 'E' };
+constexpr uint32_t kIndexVersion = 1;
+constexpr const char* kIndexName = "index";
+constexpr const char* kTempExtension = ".tmp";
+
+// Number of changes (new entries, accesses, etc.) before saving the
+// index again
+constexpr int kChangesToCompact = 64;
+
+constexpr uint64_t kPrime1 = 0x9e3779b185ebca87ull;
+constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4full;
+constexpr uint64_t kPrime3 = 0x165667b19e3779f9ull;
+constexpr uint64_t kPrime4 = 0x85ebca77c2b2ae63ull;
+constexpr uint64_t kPrime5 = 0x27d4eb2f165667c5ull;
+
+inline uint64_t rotl(const uint64_t x, const int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t* p)
+{
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint32_t read32(const uint8_t* p)
+{
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+inline uint64_t hash_round(uint64_t acc, const uint64_t input)
+{
+  acc += input * kPrime2;
+  acc = rotl(acc, 31);
+  return acc * kPrime1;
+}
+
+inline uint64_t hash_merge(uint64_t acc, const uint64_t value)
+{
+  acc ^= hash_round(0, value);
+  return acc * kPrime1 + kPrime4;
+}
+
+void put_u32(buffer& buf, const uint32_t v)
+{
+  const uint8_t* p = (const uint8_t*)&v;
+  buf.insert(buf.end(), p, p + 4);
+}
+
+void put_u64(buffer& buf, const uint64_t v)
+{
+  const uint8_t* p = (const uint8_t*)&v;
+  buf.insert(buf.end(), p, p + 8);
+}
+
+// Returns a unique name for a temporary file (entries can be written
+// from several threads or processes at the same time).
+std::string temp_filename(const std::string& filename)
+{
+  static std::mutex mutex;
+  static std::mt19937_64 rng(std::random_device{}());
+  uint64_t id;
+  {
+    const std::lock_guard lock(mutex);
+    id = rng();
+  }
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), ".%016llx", (unsigned long long)id);
+  return filename + buf + kTempExtension;
+}
+
+// Deletes a file without throwing exceptions (e.g. files that are
+// mapped in memory cannot be deleted on Windows).
+bool remove_file(const std::string& filename)
+{
+  try {
+    if (is_file(filename)) {
+      delete_file(filename);
+      return true;
+    }
+  }
+  catch (const std::exception&) {
+    // Ignore
+  }
+  return false;
+}
+
+bool write_file(const std::string& filename, const void* data, const size_t size)
+{
+  bool ok;
+  {
+    FileHandle f = open_file(filename, "wb");
+    if (!f)
+      return false;
+    ok = (std::fwrite(data, 1, size, f.get()) == size && std::fflush(f.get()) == 0);
+  }
+  if (!ok)
+    remove_file(filename);
+  return ok;
+}
+
+// Parses the key of an entry filename (16 hex digits)
+bool parse_key(const std::string& name, uint64_t& key)
+{
+  if (name.size() != 16)
+    return false;
+  key = 0;
+  for (const char c : name) {
+    int v;
+    if (c >= '0' && c <= '9')
+      v = c - '0';
+    else if (c >= 'a' && c <= 'f')
+      v = c - 'a' + 10;
+    else
+      return false;
+    key = (key << 4) | v;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+uint64_t content_hash(const void* data, const size_t size, const uint64_t seed)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  const uint8_t* const end = p + size;
+  uint64_t h;
+
+  if (size >= 32) {
+    uint64_t v1 = seed + kPrime1 + kPrime2;
+    uint64_t v2 = seed + kPrime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - kPrime1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = hash_round(v1, read64(p));
+      v2 = hash_round(v2, read64(p + 8));
+      v3 = hash_round(v3, read64(p + 16));
+      v4 = hash_round(v4, read64(p + 24));
+    }
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = hash_merge(h, v1);
+    h = hash_merge(h, v2);
+    h = hash_merge(h, v3);
+    h = hash_merge(h, v4);
+  }
+  else {
+    h = seed + kPrime5;
+  }
+
+  h += size;
+  for (; p + 8 <= end; p += 8) {
+    h ^= hash_round(0, read64(p));
+    h = rotl(h, 27) * kPrime1 + kPrime4;
+  }
+  if (p + 4 <= end) {
+    h ^= read32(p) * kPrime1;
+    h = rotl(h, 23) * kPrime2 + kPrime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    h ^= (*p) * kPrime5;
+    h = rotl(h, 11) * kPrime1;
+  }
+
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
+}
+
+disk_cache::disk_cache(const std::string& dir, const uint64_t max_size)
+  : m_dir(dir)
+  , m_max_size(max_size)
+  , m_worker(std::make_unique<thread_pool>(1))
+{
+  try {
+    if (!is_directory(m_dir))
+      make_all_directories(m_dir);
+  }
+  catch (const std::exception&) {
+    // Entries cannot be written (put() will fail)
+  }
+
+  const std::lock_guard lock(m_mutex);
+  load_index();
+  evict();
+  m_worker->execute([this] { adopt_files(); });
+}
+
+disk_cache::~disk_cache()
+{
+  flush();
+}
+
+uint64_t disk_cache::max_size() const
+{
+  const std::lock_guard lock(m_mutex);
+  return m_max_size;
+}
+
+void disk_cache::set_max_size(const uint64_t max_size)
+{
+  const std::lock_guard lock(m_mutex);
+  m_max_size = max_size;
+  evict();
+}
+
+MappedFile disk_cache::get(const uint64_t key)
+{
+  {
+    const std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+      ++m_stats.misses;
+      return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    schedule_compaction();
+  }
+
+  MappedFile file = map_file(entry_filename(key));
+
+  const std::lock_guard lock(m_mutex);
+  if (!file) {
+    // The file was deleted/evicted
+    if (m_entries.find(key) != m_entries.end()) {
+      remove_entry(key);
+      schedule_compaction();
+    }
+    ++m_stats.misses;
+    return nullptr;
+  }
+  ++m_stats.hits;
+  return file;
+}
+
+bool disk_cache::put(const uint64_t key, const void* data, const size_t size)
+{
+  {
+    const std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+      m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+      schedule_compaction();
+      return true;
+    }
+    // Empty files cannot be mapped
+    if (size == 0 || size > m_max_size)
+      return false;
+  }
+
+  // Write the entry in a temporary file (without locking the mutex)
+  const std::string filename = entry_filename(key);
+  const std::string tmp = temp_filename(filename);
+  const bool written = write_file(tmp, data, size);
+
+  const std::lock_guard lock(m_mutex);
+  if (!written) {
+    ++m_stats.write_errors;
+    return false;
+  }
+  // Added from other thread
+  if (m_entries.find(key) != m_entries.end()) {
+    remove_file(tmp);
+    return true;
+  }
+  if (!replace_file(tmp, filename)) {
+    remove_file(tmp);
+    ++m_stats.write_errors;
+    return false;
+  }
+
+  add_entry(key, size, true);
+  ++m_stats.writes;
+  m_stats.bytes_written += size;
+  evict();
+  schedule_compaction();
+  return true;
+}
+
+bool disk_cache::contains(const uint64_t key) const
+{
+  const std::lock_guard lock(m_mutex);
+  return (m_entries.find(key) != m_entries.end());
+}
+
+void disk_cache::remove(const uint64_t key)
+{
+  const std::lock_guard lock(m_mutex);
+  if (m_entries.find(key) == m_entries.end())
+    return;
+
+  remove_entry(key);
+  if (m_deleted.empty())
+    m_worker->execute([this] { delete_files(); });
+  m_deleted.push_back(key);
+  schedule_compaction();
+}
+
+void disk_cache::clear()
+{
+  const std::lock_guard lock(m_mutex);
+  if (m_entries.empty())
+    return;
+
+  if (m_deleted.empty())
+    m_worker->execute([this] { delete_files(); });
+  for (const uint64_t key : m_lru)
+    m_deleted.push_back(key);
+  m_entries.clear();
+  m_lru.clear();
+  m_stats.size = 0;
+  m_stats.entries = 0;
+
+  m_changes = kChangesToCompact;
+  schedule_compaction();
+}
+
+void disk_cache::flush()
+{
+  m_worker->wait_all();
+  compact();
+  m_worker->wait_all();
+}
+
+disk_cache::stats disk_cache::get_stats() const
+{
+  const std::lock_guard lock(m_mutex);
+  return m_stats;
+}
+
+std::string disk_cache::entry_filename(const uint64_t key) const
+{
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)key);
+  return join_path(m_dir, buf);
+}
+
+std::string disk_cache::index_filename() const
+{
+  return join_path(m_dir, kIndexName);
+}
+
+// Index format: magic, version, number of entries, entries (key and
+// size) from the least to the most recently used, and the
+// content_hash() of all the previous data.
+bool disk_cache::load_index()
+{
+  const buffer buf = read_file_content(index_filename());
+  const size_t header = sizeof(kIndexMagic) + 8;
+  if (buf.size() < header + 8 || std::memcmp(buf.data(), kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+      read32(&buf[8]) != kIndexVersion) {
+    return false;
+  }
+
+  const uint32_t count = read32(&buf[12]);
+  if ((buf.size() - header - 8) / 16 != count || (buf.size() - header - 8) % 16 != 0 ||
+      read64(&buf[buf.size() - 8]) != content_hash(buf.data(), buf.size() - 8)) {
+    return false;
+  }
+
+  const uint8_t* p = &buf[header];
+  for (uint32_t i = 0; i < count; ++i, p += 16) {
+    const uint64_t key = read64(p);
+    if (m_entries.find(key) == m_entries.end())
+      add_entry(key, read64(p + 8), true);
+  }
+  return true;
+}
+
+void disk_cache::add_entry(const uint64_t key, const uint64_t size, const bool most_recent)
+{
+  auto lru = m_lru.insert(most_recent ? m_lru.begin() : m_lru.end(), key);
+  m_entries[key] = entry{ size, lru };
+  m_stats.size += size;
+  m_stats.entries = m_entries.size();
+}
+
+void disk_cache::remove_entry(const uint64_t key)
+{
+  auto it = m_entries.find(key);
+  ASSERT(it != m_entries.end());
+  m_stats.size -= it->second.size;
+  m_lru.erase(it->second.lru);
+  m_entries.erase(it);
+  m_stats.entries = m_entries.size();
+}
+
+void disk_cache::evict()
+{
+  bool evicted = false;
+  while (m_stats.size > m_max_size && !m_lru.empty()) {
+    const uint64_t key = m_lru.back();
+    remove_entry(key);
+    if (m_deleted.empty())
+      m_worker->execute([this] { delete_files(); });
+    m_deleted.push_back(key);
+    ++m_stats.evictions;
+    evicted = true;
+  }
+  if (evicted)
+    schedule_compaction();
+}
+
+void disk_cache::schedule_compaction()
+{
+  if (++m_changes >= kChangesToCompact && !m_compaction_scheduled) {
+    m_compaction_scheduled = true;
+    m_worker->execute([this] { compact(); });
+  }
+}
+
+void disk_cache::compact()
+{
+  buffer buf;
+  {
+    const std::lock_guard lock(m_mutex);
+    m_compaction_scheduled = false;
+    if (m_changes == 0)
+      return;
+    m_changes = 0;
+
+    buf.reserve(sizeof(kIndexMagic) + 16 * (m_entries.size() + 1));
+    buf.insert(buf.end(), std::begin(kIndexMagic), std::end(kIndexMagic));
+    put_u32(buf, kIndexVersion);
+    put_u32(buf, uint32_t(m_entries.size()));
+    for (auto it = m_lru.rbegin(); it != m_lru.rend(); ++it) {
+      put_u64(buf, *it);
+      put_u64(buf, m_entries[*it].size);
+    }
+  }
+  put_u64(buf, content_hash(buf.data(), buf.size()));
+
+  // Index files are written from this thread only, but the cache
+  // directory can be shared with other processes
+  const std::string filename = index_filename();
+  const std::string tmp = temp_filename(filename);
+  if (write_file(tmp, buf.data(), buf.size())) {
+    if (!replace_file(tmp, filename))
+      remove_file(tmp);
+  }
+
+  const std::lock_guard lock(m_mutex);
+  ++m_stats.compactions;
+}
+
+void disk_cache::delete_files()
+{
+  std::vector<uint64_t> keys;
+  {
+    const std::lock_guard lock(m_mutex);
+    keys.swap(m_deleted);
+  }
+  for (const uint64_t key : keys) {
+    // The mutex is locked to avoid deleting an entry that was added
+    // again in put()
+    const std::lock_guard lock(m_mutex);
+    if (m_entries.find(key) == m_entries.end())
+      remove_file(entry_filename(key));
+  }
+}
+
+// Adds files that are not in the index (e.g. entries written before
+// a crash, or by other processes) as the least recently used
+// entries, and deletes old temporary files.
+void disk_cache::adopt_files()
+{
+  Time old = current_time();
+  old.addDays(-1);
+
+  for (const std::string& name : list_files(m_dir, ItemType::Files)) {
+    const std::string path = join_path(m_dir, name);
+    uint64_t key;
+    if (parse_key(name, key)) {
+      const size_t size = file_size(path);
+      const std::lock_guard lock(m_mutex);
+      if (size > 0 && m_entries.find(key) == m_entries.end()) {
+        add_entry(key, size, false);
+        schedule_compaction();
+      }
+    }
+    else if (get_file_extension(name) == kTempExtension + 1 &&
+             get_modification_time(path) < old) {
+      remove_file(path);
+    }
+  }
+
+  const std::lock_guard lock(m_mutex);
+  evict();
+}
+
+} // namespace base
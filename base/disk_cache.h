@@ -0,0 +1,126 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_DISK_CACHE_H_INCLUDED
+#define BASE_DISK_CACHE_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/ints.h"
+#include "base/mapped_file.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace base {
+
+class thread_pool;
+
+// Fast non-cryptographic 64-bit hash (based on xxHash64) to create
+// keys from the content used to generate an artifact. Hashes are
+// not portable between machines with different byte order.
+uint64_t content_hash(const void* data, size_t size, uint64_t seed = 0);
+
+// Persistent cache of artifacts (rasterized glyphs, font indexes,
+// thumbnails, etc.) in a directory, reusable between runs. Each
+// entry is a file identified by a 64-bit key (e.g. the
+// content_hash() of the input data), and the total size is limited
+// removing the least recently used entries.
+//
+// * Entries are written to a temporary file and renamed, so a crash
+//   never leaves a partial entry.
+// * Entries are read mapping the file in memory.
+// * The index (keys in LRU order) is kept in memory and saved from
+//   time to time in a background thread, which also deletes evicted
+//   files and adopts entries that are not in the index (e.g. after
+//   a crash).
+//
+// All member functions are thread-safe.
+class disk_cache {
+public:
+  struct stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t writes = 0;
+    uint64_t write_errors = 0;
+    uint64_t evictions = 0;
+    uint64_t compactions = 0;
+    uint64_t bytes_written = 0;
+    uint64_t size = 0; // Total size of entries in bytes
+    size_t entries = 0;
+  };
+
+  // Opens (or creates) the cache in the given directory.
+  disk_cache(const std::string& dir, uint64_t max_size);
+
+  // Saves the index and waits the background tasks.
+  ~disk_cache();
+
+  const std::string& dir() const { return m_dir; }
+  uint64_t max_size() const;
+  void set_max_size(uint64_t max_size);
+
+  // Returns the mapped content of the entry, or nullptr if it's not
+  // in the cache. The mapped file is valid even if the entry is
+  // evicted.
+  MappedFile get(uint64_t key);
+
+  // Adds an entry. Entries are immutable: if the key is already in
+  // the cache, its content is not replaced. Returns false if the
+  // entry cannot be written or if it's bigger than max_size().
+  bool put(uint64_t key, const void* data, size_t size);
+
+  bool contains(uint64_t key) const;
+  void remove(uint64_t key);
+  void clear();
+
+  // Saves the index and waits until all background tasks are done
+  // (deleted files, etc.).
+  void flush();
+
+  stats get_stats() const;
+
+private:
+  struct entry {
+    uint64_t size;
+    std::list<uint64_t>::iterator lru; // Position in m_lru
+  };
+
+  std::string entry_filename(uint64_t key) const;
+  std::string index_filename() const;
+  bool load_index();
+  void add_entry(uint64_t key, uint64_t size, bool most_recent);
+  void remove_entry(uint64_t key);
+  void evict();
+  void schedule_compaction();
+
+  // Tasks of the background thread
+  void compact();
+  void delete_files();
+  void adopt_files();
+
+  const std::string m_dir;
+  mutable std::mutex m_mutex;
+  uint64_t m_max_size;
+  std::unordered_map<uint64_t, entry> m_entries;
+  std::list<uint64_t> m_lru; // Most recently used first
+  std::vector<uint64_t> m_deleted;
+  int m_changes = 0;
+  bool m_compaction_scheduled = false;
+  stats m_stats;
+  std::unique_ptr<thread_pool> m_worker;
+
+  DISABLE_COPYING(disk_cache);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,247 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/disk_cache.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+static const char* kDir = "_test_disk_cache_";
+
+class DiskCache : public ::testing::Test {
+protected:
+  void SetUp() override { remove_dir(); }
+  void TearDown() override { remove_dir(); }
+
+  static void remove_dir()
+  {
+    if (!is_directory(kDir))
+      return;
+    for (const std::string& fn : list_files(kDir))
+      delete_file(join_path(kDir, fn));
+    remove_directory(kDir);
+  }
+
+  static buffer make_data(const size_t size, const int seed)
+  {
+    buffer buf(size);
+    for (size_t i = 0; i < size; ++i)
+      buf[i] = uint8_t(i * 7 + seed);
+    return buf;
+  }
+
+  static bool has_content(const MappedFile& file, const buffer& buf)
+  {
+    return (file && file->size() == buf.size() &&
+            std::memcmp(file->data(), buf.data(), buf.size()) == 0);
+  }
+};
+
+TEST(ContentHash, Values)
+{
+  const char* abc = "abc";
+  EXPECT_EQ(0xef46db3751d8e999ull, content_hash("", 0));
+  EXPECT_EQ(0x44bc2cf5ad770999ull, content_hash(abc, 3));
+  EXPECT_EQ(0xbea9ca8199328908ull, content_hash(abc, 3, 1));
+
+  uint8_t data[100];
+  for (int i = 0; i < 100; ++i)
+    data[i] = i;
+  EXPECT_EQ(0x6ac1e58032166597ull, content_hash(data, 100));
+}
+
+TEST_F(DiskCache, PutGet)
+{
+  const buffer a = make_data(100, 1);
+  const buffer b = make_data(70000, 2);
+  const uint64_t ka = content_hash(a.data(), a.size());
+  const uint64_t kb = content_hash(b.data(), b.size());
+  {
+    disk_cache cache(kDir, 1024 * 1024);
+    EXPECT_EQ(nullptr, cache.get(ka));
+    EXPECT_FALSE(cache.contains(ka));
+    EXPECT_TRUE(cache.put(ka, a.data(), a.size()));
+    EXPECT_TRUE(cache.put(kb, b.data(), b.size()));
+    EXPECT_TRUE(cache.contains(ka));
+    EXPECT_TRUE(has_content(cache.get(ka), a));
+    EXPECT_TRUE(has_content(cache.get(kb), b));
+
+    // Entries are immutable
+    EXPECT_TRUE(cache.put(ka, b.data(), b.size()));
+    EXPECT_TRUE(has_content(cache.get(ka), a));
+
+    // Empty or too big entries
+    EXPECT_FALSE(cache.put(1, a.data(), 0));
+    const buffer big = make_data(1024 * 1024 + 1, 3);
+    EXPECT_FALSE(cache.put(2, big.data(), big.size()));
+
+    const disk_cache::stats stats = cache.get_stats();
+    EXPECT_EQ(3, stats.hits);
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(2, stats.writes);
+    EXPECT_EQ(0, stats.write_errors);
+    EXPECT_EQ(a.size() + b.size(), stats.bytes_written);
+    EXPECT_EQ(a.size() + b.size(), stats.size);
+    EXPECT_EQ(2, stats.entries);
+  }
+
+  // Persistent entries
+  disk_cache cache(kDir, 1024 * 1024);
+  EXPECT_EQ(2, cache.get_stats().entries);
+  EXPECT_TRUE(has_content(cache.get(ka), a));
+  EXPECT_TRUE(has_content(cache.get(kb), b));
+}
+
+TEST_F(DiskCache, EvictLeastRecentlyUsed)
+{
+  std::vector<buffer> data;
+  for (int i = 0; i < 5; ++i)
+    data.push_back(make_data(1000, i));
+  {
+    disk_cache cache(kDir, 3500);
+    for (int i = 0; i < 3; ++i)
+      EXPECT_TRUE(cache.put(i, data[i].data(), 1000));
+
+    // Entry 0 is used, so 1 is the least recently used
+    EXPECT_NE(nullptr, cache.get(0));
+    EXPECT_TRUE(cache.put(3, data[3].data(), 1000));
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_EQ(1, cache.get_stats().evictions);
+    EXPECT_EQ(3000, cache.get_stats().size);
+
+    // Mapped entries are valid even if they are evicted
+    MappedFile file = cache.get(2);
+    EXPECT_NE(nullptr, cache.get(0));
+    cache.set_max_size(1000);
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(has_content(file, data[2]));
+    EXPECT_EQ(1, cache.get_stats().entries);
+    EXPECT_TRUE(cache.contains(0));
+  }
+
+  // The LRU order is persistent
+  disk_cache cache(kDir, 2000);
+  EXPECT_TRUE(cache.contains(0));
+  EXPECT_TRUE(cache.put(4, data[4].data(), 1000));
+  EXPECT_TRUE(cache.put(1, data[1].data(), 1000));
+  EXPECT_FALSE(cache.contains(0));
+  EXPECT_TRUE(has_content(cache.get(4), data[4]));
+  EXPECT_TRUE(has_content(cache.get(1), data[1]));
+  cache.flush();
+
+  // Only the files of the entries are kept (plus the index)
+  EXPECT_EQ(3, list_files(kDir, ItemType::Files).size());
+}
+
+TEST_F(DiskCache, RemoveAndClear)
+{
+  const buffer a = make_data(10, 0);
+  disk_cache cache(kDir, 1000);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(cache.put(i, a.data(), a.size()));
+
+  cache.remove(3);
+  cache.remove(3);
+  EXPECT_FALSE(cache.contains(3));
+  EXPECT_EQ(nullptr, cache.get(3));
+  EXPECT_EQ(9, cache.get_stats().entries);
+
+  // Removed entries can be added again
+  EXPECT_TRUE(cache.put(3, a.data(), a.size()));
+  cache.flush();
+  EXPECT_TRUE(has_content(cache.get(3), a));
+
+  cache.clear();
+  EXPECT_EQ(0, cache.get_stats().entries);
+  EXPECT_EQ(0, cache.get_stats().size);
+  cache.flush();
+  EXPECT_EQ(1, list_files(kDir, ItemType::Files).size());
+}
+
+TEST_F(DiskCache, AdoptFiles)
+{
+  const buffer a = make_data(50, 0);
+  {
+    disk_cache cache(kDir, 1000);
+    EXPECT_TRUE(cache.put(1, a.data(), a.size()));
+  }
+
+  // Entry and temporary files that are not in the index
+  write_file_content(join_path(kDir, "00000000000000ff"), a);
+  write_file_content(join_path(kDir, "not-an-entry"), a);
+  delete_file(join_path(kDir, "index"));
+
+  disk_cache cache(kDir, 1000);
+  cache.flush();
+  EXPECT_EQ(2, cache.get_stats().entries);
+  EXPECT_TRUE(has_content(cache.get(1), a));
+  EXPECT_TRUE(has_content(cache.get(0xff), a));
+}
+
+TEST_F(DiskCache, CorruptedIndex)
+{
+  const buffer a = make_data(50, 0);
+  {
+    disk_cache cache(kDir, 1000);
+    EXPECT_TRUE(cache.put(1, a.data(), a.size()));
+  }
+
+  buffer index = read_file_content(join_path(kDir, "index"));
+  ASSERT_FALSE(index.empty());
+  index[index.size() / 2] ^= 1;
+  write_file_content(join_path(kDir, "index"), index);
+
+  // The entry is recovered from the directory
+  disk_cache cache(kDir, 1000);
+  cache.flush();
+  EXPECT_TRUE(has_content(cache.get(1), a));
+}
+
+TEST_F(DiskCache, Threads)
+{
+  disk_cache cache(kDir, 40 * 1000);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t] {
+      for (int i = 0; i < 100; ++i) {
+        const int key = (i * 7 + t) % 60;
+        const buffer data = make_data(1000, key);
+        MappedFile file = cache.get(key);
+        if (file) {
+          EXPECT_TRUE(has_content(file, data));
+        }
+        else {
+          EXPECT_TRUE(cache.put(key, data.data(), data.size()));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  cache.flush();
+
+  const disk_cache::stats stats = cache.get_stats();
+  EXPECT_LE(stats.size, 40 * 1000);
+  EXPECT_EQ(400, stats.hits + stats.misses);
+  EXPECT_EQ(0, stats.write_errors);
+  EXPECT_EQ(stats.entries + 1, list_files(kDir, ItemType::Files).size());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -33,6 +33,13 @@ bool is_absolute_path(const std::string& path);
 size_t file_size(const std::string& path);
 
 void move_file(const std::string& src, const std::string& dst);
+
+// Renames "src" to "dst" replacing "dst" atomically if it exists
+// (readers of the old "dst" file, e.g. a mapped file, keep seeing
+// the old content on POSIX systems). Returns false if it fails
+// instead of throwing an exception.
+bool replace_file(const std::string& src, const std::string& dst);
+
 void copy_file(const std::string& src, const std::string& dst, bool overwrite);
 void delete_file(const std::string& path);
 
@@ -460,6 +460,25 @@ TEST(FS, CopyFiles)
   EXPECT_EQ(data, read_file_content(dst));
 }
 
+TEST(FS, ReplaceFile)
+{
+  const std::vector<uint8_t> a = { 'a' };
+  const std::vector<uint8_t> b = { 'b', 'c' };
+  const std::string src = "_test_replace_src_.tmp";
+  const std::string dst = "_test_replace_dst_.tmp";
+
+  write_file_content(dst, a.data(), a.size());
+  write_file_content(src, b.data(), b.size());
+  EXPECT_TRUE(replace_file(src, dst));
+  EXPECT_FALSE(is_file(src));
+  EXPECT_EQ(b, read_file_content(dst));
+
+  // The source doesn't exist anymore
+  EXPECT_FALSE(replace_file(src, dst));
+  EXPECT_EQ(b, read_file_content(dst));
+  delete_file(dst);
+}
+
 TEST(FS, ListFiles)
 {
   // Prepare files
@@ -70,6 +70,11 @@ void move_file(const std::string& src, const std::string& dst)
     throw std::runtime_error("Error moving file: " + std::string(std::strerror(errno)));
 }
 
+bool replace_file(const std::string& src, const std::string& dst)
+{
+  return (std::rename(src.c_str(), dst.c_str()) == 0);
+}
+
 void copy_file(const std::string& src_fn, const std::string& dst_fn, const bool overwrite)
 {
   // First copy the file content
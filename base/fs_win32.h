@@ -49,6 +49,12 @@ void move_file(const std::string& src, const std::string& dst)
     throw Win32Exception("Error moving file");
 }
 
+bool replace_file(const std::string& src, const std::string& dst)
+{
+  return (::MoveFileEx(from_utf8(src).c_str(), from_utf8(dst).c_str(), MOVEFILE_REPLACE_EXISTING) !=
+          0);
+}
+
 void copy_file(const std::string& src, const std::string& dst, bool overwrite)
 {
   BOOL result = ::CopyFile(from_utf8(src).c_str(), from_utf8(dst).c_str(), !overwrite);
@@ -0,0 +1,326 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/line_break.h"
+
+#include "base/utf8_decode.h"
+
+#include <initializer_list>
+
+namespace base {
+
+namespace {
+
+// Line break classes (a subset of UAX #14 classes)
+enum class LB {
+  AL, // Alphabetic (and everything else)
+  BA, // Break after
+  B2, // Break opportunity before and after
+  BK, // Mandatory break
+  CL, // Close punctuation
+  CM, // Combining mark
+  CP, // Close parenthesis
+  CR, // Carriage return
+  EX, // Exclamation/interrogation
+  GL, // Non-breaking (glue)
+  HY, // Hyphen
+  ID, // Ideographic
+  IS, // Infix numeric separator
+  LF, // Line feed
+  NL, // Next line
+  NS, // Non-starter
+  NU, // Numeric
+  OP, // Open punctuation
+  PO, // Postfix numeric
+  PR, // Prefix numeric
+  QU, // Quotation
+  SP, // Space
+  SY, // Symbols allowing break after
+  WJ, // Word joiner
+  ZW, // Zero width space
+};
+
+LB line_break_class(const int c)
+{
+  if (c < 0x80) {
+    if (c >= '0' && c <= '9')
+      return LB::NU;
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+      return LB::AL;
+    switch (c) {
+      case '\t': return LB::BA;
+      case '\n': return LB::LF;
+      case '\r': return LB::CR;
+      case 0x0B:
+      case 0x0C: return LB::BK;
+      case ' ':  return LB::SP;
+      case '!':
+      case '?':  return LB::EX;
+      case '"':
+      case '\'': return LB::QU;
+      case '$':
+      case '+':
+      case '\\': return LB::PR;
+      case '%':  return LB::PO;
+      case '(':
+      case '[':
+      case '{':  return LB::OP;
+      case ')':
+      case ']':  return LB::CP;
+      case '}':  return LB::CL;
+      case ',':
+      case '.':
+      case ':':
+      case ';':  return LB::IS;
+      case '-':  return LB::HY;
+      case '/':  return LB::SY;
+      case '|':  return LB::BA;
+    }
+    return (c < 0x20 || c == 0x7F ? LB::CM : LB::AL);
+  }
+
+  switch (c) {
+    case 0x0085: return LB::NL;
+    case 0x00A0:
+    case 0x202F:
+    case 0x2007:
+    case 0x034F: return LB::GL;
+    case 0x00A1:
+    case 0x00BF: return LB::OP;
+    case 0x00A2:
+    case 0x00B0:
+    case 0x2030:
+    case 0x2031:
+    case 0x2032:
+    case 0x2033: return LB::PO;
+    case 0x00A3:
+    case 0x00A5:
+    case 0x00B1:
+    case 0x20AC: return LB::PR;
+    case 0x00AB:
+    case 0x00BB:
+    case 0x2018:
+    case 0x2019:
+    case 0x201C:
+    case 0x201D: return LB::QU;
+    case 0x00AD:
+    case 0x1680:
+    case 0x2010:
+    case 0x2012:
+    case 0x2013: return LB::BA;
+    case 0x200B: return LB::ZW;
+    case 0x200D: return LB::CM;
+    case 0x2014: return LB::B2;
+    case 0x2028:
+    case 0x2029: return LB::BK;
+    case 0x2060:
+    case 0xFEFF: return LB::WJ;
+    case 0x3001:
+    case 0x3002:
+    case 0xFF0C:
+    case 0xFF0E:
+    case 0x300D:
+    case 0x300F:
+    case 0x3011: return LB::CL;
+    case 0x300C:
+    case 0x300E:
+    case 0x3010: return LB::OP;
+    case 0xFF08: return LB::OP;
+    case 0xFF09: return LB::CP;
+    case 0xFF01:
+    case 0xFF1F: return LB::EX;
+    case 0x3005:
+    case 0x303B:
+    case 0x309D:
+    case 0x309E:
+    case 0x30FC:
+    case 0x30FD:
+    case 0x30FE: return LB::NS;
+  }
+
+  // Combining marks
+  if ((c >= 0x0300 && c <= 0x036F) || (c >= 0x0483 && c <= 0x0489) ||
+      (c >= 0x0591 && c <= 0x05BD) || (c >= 0x064B && c <= 0x065F) ||
+      (c >= 0x1AB0 && c <= 0x1AFF) || (c >= 0x1DC0 && c <= 0x1DFF) ||
+      (c >= 0x20D0 && c <= 0x20FF) || (c >= 0xFE00 && c <= 0xFE0F) ||
+      (c >= 0xFE20 && c <= 0xFE2F) || (c >= 0xE0100 && c <= 0xE01EF)) {
+    return LB::CM;
+  }
+
+  // Small kana are non-starters
+  if ((c >= 0x3041 && c <= 0x3049 && (c & 1)) || (c >= 0x30A1 && c <= 0x30A9 && (c & 1)) ||
+      c == 0x3063 || c == 0x30C3 || (c >= 0x31F0 && c <= 0x31FF)) {
+    return LB::NS;
+  }
+
+  // Ideographs, kana, Hangul syllables, and emoji
+  if ((c >= 0x2E80 && c <= 0x2FFF) || (c >= 0x3040 && c <= 0x30FF) ||
+      (c >= 0x3130 && c <= 0x318F) || (c >= 0x3400 && c <= 0x4DBF) ||
+      (c >= 0x4E00 && c <= 0x9FFF) || (c >= 0xAC00 && c <= 0xD7AF) ||
+      (c >= 0xF900 && c <= 0xFAFF) || (c >= 0xFF10 && c <= 0xFF19) ||
+      (c >= 0xFF21 && c <= 0xFF5A) || (c >= 0x1F000 && c <= 0x1FAFF) ||
+      (c >= 0x20000 && c <= 0x3FFFD)) {
+    return LB::ID;
+  }
+
+  // Other digits
+  if ((c >= 0x0660 && c <= 0x0669) || (c >= 0x06F0 && c <= 0x06F9) ||
+      (c >= 0x0966 && c <= 0x096F)) {
+    return LB::NU;
+  }
+
+  return LB::AL;
+}
+
+bool is_one_of(const LB c, std::initializer_list<LB> list)
+{
+  for (LB i : list)
+    if (c == i)
+      return true;
+  return false;
+}
+
+// Returns true if there is a break opportunity between "a" and "b"
+// (rules LB12a to LB31). "beforeSpaces" is the class before the
+// spaces that precede "b" (or "a" if "a" is not a space).
+bool can_break(const LB a, const LB b, const LB beforeSpaces)
+{
+  // LB12a
+  if (b == LB::GL && !is_one_of(a, { LB::SP, LB::BA, LB::HY }))
+    return false;
+  // LB13
+  if (is_one_of(b, { LB::CL, LB::CP, LB::EX, LB::IS, LB::SY }))
+    return false;
+  // LB14
+  if (beforeSpaces == LB::OP)
+    return false;
+  // LB15
+  if (beforeSpaces == LB::QU && b == LB::OP)
+    return false;
+  // LB16
+  if (is_one_of(beforeSpaces, { LB::CL, LB::CP }) && b == LB::NS)
+    return false;
+  // LB17
+  if (beforeSpaces == LB::B2 && b == LB::B2)
+    return false;
+  // LB18
+  if (a == LB::SP)
+    return true;
+  // LB19
+  if (a == LB::QU || b == LB::QU)
+    return false;
+  // LB21
+  if (is_one_of(b, { LB::BA, LB::HY, LB::NS }))
+    return false;
+  // LB23
+  if ((a == LB::AL && b == LB::NU) || (a == LB::NU && b == LB::AL))
+    return false;
+  // LB23a
+  if ((a == LB::PR && b == LB::ID) || (a == LB::ID && b == LB::PO))
+    return false;
+  // LB24
+  if ((is_one_of(a, { LB::PR, LB::PO }) && b == LB::AL) ||
+      (a == LB::AL && is_one_of(b, { LB::PR, LB::PO })))
+    return false;
+  // LB25 (simplified, without looking back the whole number)
+  if ((is_one_of(a, { LB::CL, LB::CP, LB::NU }) && is_one_of(b, { LB::PO, LB::PR })) ||
+      (is_one_of(a, { LB::PO, LB::PR }) && is_one_of(b, { LB::OP, LB::NU })) ||
+      (is_one_of(a, { LB::HY, LB::IS, LB::NU, LB::SY }) && b == LB::NU))
+    return false;
+  // LB28
+  if (a == LB::AL && b == LB::AL)
+    return false;
+  // LB29
+  if (a == LB::IS && b == LB::AL)
+    return false;
+  // LB30
+  if ((is_one_of(a, { LB::AL, LB::NU }) && b == LB::OP) ||
+      (a == LB::CP && is_one_of(b, { LB::AL, LB::NU })))
+    return false;
+  // LB31
+  return true;
+}
+
+} // anonymous namespace
+
+std::vector<line_break> find_line_breaks(const std::string& utf8)
+{
+  std::vector<line_break> breaks;
+  utf8_decode decode(utf8);
+
+  // Class of the previous char (after applying LB9/LB10), and the
+  // class before the last sequence of spaces.
+  LB prev = LB::AL;
+  LB beforeSpaces = LB::AL;
+  bool first = true;
+  bool afterZW = false; // LB8: ZW SP* ÷
+
+  while (true) {
+    const int pos = decode.pos() - utf8.begin();
+    const int chr = decode.next();
+    if (!chr)
+      break;
+
+    LB cls = line_break_class(chr);
+
+    // LB2: Never break at the start of text
+    if (first) {
+      // LB10: Treat a CM at the beginning as AL
+      if (cls == LB::CM)
+        cls = LB::AL;
+      first = false;
+      prev = beforeSpaces = cls;
+      afterZW = (cls == LB::ZW);
+      continue;
+    }
+
+    int result; // 0 = no break, 1 = break, 2 = mandatory break
+
+    // LB4, LB5
+    if (prev == LB::BK || prev == LB::LF || prev == LB::NL)
+      result = 2;
+    else if (prev == LB::CR)
+      result = (cls == LB::LF ? 0 : 2);
+    // LB6, LB7
+    else if (is_one_of(cls, { LB::BK, LB::CR, LB::LF, LB::NL, LB::SP, LB::ZW }))
+      result = 0;
+    // LB8
+    else if (afterZW)
+      result = 1;
+    // LB9: X CM* -> X (CM after spaces/breaks is treated as AL, LB10)
+    else if (cls == LB::CM) {
+      if (prev != LB::SP)
+        continue;
+      cls = LB::AL;
+      result = 1;
+    }
+    // LB11, LB12
+    else if (prev == LB::WJ || cls == LB::WJ || prev == LB::GL)
+      result = 0;
+    else
+      result = (can_break(prev, cls, beforeSpaces) ? 1 : 0);
+
+    if (result)
+      breaks.push_back(line_break{ pos, result == 2 });
+
+    if (cls == LB::ZW)
+      afterZW = true;
+    else if (cls != LB::SP)
+      afterZW = false;
+
+    if (cls != LB::SP)
+      beforeSpaces = cls;
+    prev = cls;
+  }
+
+  return breaks;
+}
+
+} // namespace base
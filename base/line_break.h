@@ -0,0 +1,33 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_LINE_BREAK_H_INCLUDED
+#define BASE_LINE_BREAK_H_INCLUDED
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace base {
+
+// Position in a UTF-8 string where a line can be broken (the line
+// break goes before the byte at "pos").
+struct line_break {
+  int pos;
+  bool mandatory; // True after a new line char
+};
+
+// Finds the line break opportunities of the given UTF-8 string using
+// the rules of the Unicode Line Breaking Algorithm (UAX #14). The
+// line break classes of code points are approximated with the most
+// common ranges (Latin, punctuation, CJK, Hangul, emoji), and rules
+// for East Asian Width/regional indicators are not implemented. The
+// end of the string is not included.
+std::vector<line_break> find_line_breaks(const std::string& utf8);
+
+} // namespace base
+
+#endif
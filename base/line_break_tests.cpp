@@ -0,0 +1,104 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/line_break.h"
+
+#include <string>
+#include <vector>
+
+using namespace base;
+
+namespace {
+
+// Returns the positions of the line breaks (mandatory breaks are
+// negative).
+std::vector<int> breaks(const std::string& text)
+{
+  std::vector<int> result;
+  for (const line_break& b : find_line_breaks(text))
+    result.push_back(b.mandatory ? -b.pos : b.pos);
+  return result;
+}
+
+} // anonymous namespace
+
+using V = std::vector<int>;
+
+TEST(LineBreak, Empty)
+{
+  EXPECT_EQ(V(), breaks(""));
+  EXPECT_EQ(V(), breaks("a"));
+  EXPECT_EQ(V(), breaks("word"));
+}
+
+TEST(LineBreak, Spaces)
+{
+  EXPECT_EQ(V({ 6 }), breaks("Hello World"));
+  EXPECT_EQ(V({ 6, 10 }), breaks("one   two three"));
+  EXPECT_EQ(V({ 2 }), breaks("  leading"));
+  EXPECT_EQ(V(), breaks("trailing   "));
+}
+
+TEST(LineBreak, NewLines)
+{
+  EXPECT_EQ(V({ -2, -4 }), breaks("a\nb\nc"));
+  EXPECT_EQ(V({ -3 }), breaks("a\r\nb"));
+  EXPECT_EQ(V({ -2, -3 }), breaks("a\n\nb"));
+  // The end of text is not included
+  EXPECT_EQ(V(), breaks("a\n"));
+}
+
+TEST(LineBreak, Punctuation)
+{
+  EXPECT_EQ(V({ 7 }), breaks("Hello, world!"));
+  EXPECT_EQ(V({ 5 }), breaks("well-known"));
+  EXPECT_EQ(V({ 5 }), breaks("(ok) go"));
+  EXPECT_EQ(V({ 5 }), breaks("test (a)"));
+  EXPECT_EQ(V({ 4 }), breaks("and/or"));
+  EXPECT_EQ(V(), breaks("\"quoted\""));
+}
+
+TEST(LineBreak, Numbers)
+{
+  EXPECT_EQ(V(), breaks("3.14"));
+  EXPECT_EQ(V(), breaks("$100"));
+  EXPECT_EQ(V(), breaks("50%"));
+  EXPECT_EQ(V(), breaks("-10"));
+  EXPECT_EQ(V(), breaks("1,000,000"));
+}
+
+TEST(LineBreak, NoBreakSpace)
+{
+  // U+00A0 No-Break Space
+  EXPECT_EQ(V(), breaks("10\xC2\xA0kg"));
+  // U+2060 Word Joiner
+  EXPECT_EQ(V(), breaks("a\xE2\x81\xA0(b)"));
+  // U+200B Zero Width Space
+  EXPECT_EQ(V({ 4 }), breaks("a\xE2\x80\x8B" "b"));
+}
+
+TEST(LineBreak, Ideographs)
+{
+  // Each CJK ideograph (3 bytes in UTF-8) is a break opportunity
+  EXPECT_EQ(V({ 3, 6 }), breaks("\xE6\xBC\xA2\xE5\xAD\x97\xE3\x81\x82"));
+  // Except before closing punctuation (U+3002 Ideographic Full Stop)
+  EXPECT_EQ(V({ 3 }), breaks("\xE6\xBC\xA2\xE5\xAD\x97\xE3\x80\x82"));
+}
+
+TEST(LineBreak, CombiningMarks)
+{
+  // U+0301 Combining Acute Accent after "e" doesn't break the word
+  EXPECT_EQ(V({ 4 }), breaks("e\xCC\x81 x"));
+  EXPECT_EQ(V(), breaks("ae\xCC\x81z"));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
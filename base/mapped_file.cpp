@@ -0,0 +1,137 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/mapped_file.h"
+
+#include "base/string.h"
+
+#if LAF_WINDOWS
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace base {
+
+mapped_file::mapped_file()
+  : m_data(nullptr)
+  , m_size(0)
+#if LAF_WINDOWS
+  , m_mapping(nullptr)
+#endif
+{
+}
+
+mapped_file::~mapped_file()
+{
+  close();
+}
+
+#if LAF_WINDOWS
+
+bool mapped_file::open(const std::string& filename)
+{
+  close();
+
+  HANDLE file = CreateFileW(from_utf8(filename).c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  // The mapping keeps a reference to the file, so we can close it
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping)
+    return false;
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!data) {
+    CloseHandle(mapping);
+    return false;
+  }
+
+  m_data = (const uint8_t*)data;
+  m_size = size_t(size.QuadPart);
+  m_mapping = mapping;
+  return true;
+}
+
+void mapped_file::close()
+{
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping);
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+  }
+}
+
+#else
+
+bool mapped_file::open(const std::string& filename)
+{
+  close();
+
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat sts;
+  if (fstat(fd, &sts) != 0 || sts.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // The mapping is still valid after closing the file descriptor
+  void* data = mmap(nullptr, size_t(sts.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  m_data = (const uint8_t*)data;
+  m_size = size_t(sts.st_size);
+  return true;
+}
+
+void mapped_file::close()
+{
+  if (m_data) {
+    munmap((void*)m_data, m_size);
+    m_data = nullptr;
+    m_size = 0;
+  }
+}
+
+#endif
+
+MappedFile map_file(const std::string& filename)
+{
+  auto file = std::make_shared<mapped_file>();
+  if (!file->open(filename))
+    file.reset();
+  return file;
+}
+
+} // namespace base
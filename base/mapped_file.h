@@ -0,0 +1,54 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_MAPPED_FILE_H_INCLUDED
+#define BASE_MAPPED_FILE_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/ints.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace base {
+
+// Read-only view of a whole file mapped in memory. Pages are loaded
+// by the OS on demand, so accessing a small part of a big file
+// doesn't read the whole file.
+class mapped_file {
+public:
+  mapped_file();
+  ~mapped_file();
+
+  // Returns false if the file cannot be opened/mapped (or if it's
+  // empty).
+  bool open(const std::string& filename);
+  void close();
+
+  bool is_open() const { return m_data != nullptr; }
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+#if LAF_WINDOWS
+  void* m_mapping;
+#endif
+
+  DISABLE_COPYING(mapped_file);
+};
+
+using MappedFile = std::shared_ptr<mapped_file>;
+
+// Maps the given file, returns nullptr if it cannot be mapped.
+MappedFile map_file(const std::string& filename);
+
+} // namespace base
+
+#endif
@@ -0,0 +1,57 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/mapped_file.h"
+
+using namespace base;
+
+TEST(MappedFile, MapContent)
+{
+  const char* fn = "_test_mapped_file_.tmp";
+
+  for (size_t s : { 1, 30, 4096, 1024 * 64 * 3 + 4 }) {
+    buffer buf(s);
+    for (size_t i = 0; i < buf.size(); ++i)
+      buf[i] = i * 7;
+    write_file_content(fn, buf);
+
+    MappedFile file = map_file(fn);
+    ASSERT_TRUE(file != nullptr);
+    ASSERT_EQ(s, file->size());
+    EXPECT_EQ(0, memcmp(buf.data(), file->data(), s));
+
+    file->close();
+    EXPECT_FALSE(file->is_open());
+    EXPECT_EQ(0, file->size());
+  }
+
+  delete_file(fn);
+}
+
+TEST(MappedFile, Errors)
+{
+  const char* fn = "_test_mapped_file_empty_.tmp";
+  open_file(fn, "wb"); // Create an empty file
+
+  mapped_file file;
+  EXPECT_FALSE(file.open(fn));
+  EXPECT_FALSE(file.is_open());
+  EXPECT_FALSE(file.open("_this_file_does_not_exist_.tmp"));
+  EXPECT_EQ(nullptr, map_file("_this_file_does_not_exist_.tmp"));
+
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,21 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_SIMD_H_INCLUDED
+#define BASE_SIMD_H_INCLUDED
+#pragma once
+
+// LAF_SSE2 is defined when the compiler targets a CPU with SSE2
+// instructions enabled by default (always true on x86-64). Code
+// using this macro must provide a scalar fallback for other
+// platforms.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define LAF_SSE2 1
+  #include <emmintrin.h>
+#endif
+
+#endif
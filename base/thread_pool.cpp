@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -12,8 +12,18 @@
 #include "base/log.h"
 #include "base/thread_pool.h"
 
+#include <algorithm>
+#include <exception>
+
 namespace base {
 
+namespace {
+
+// Pool of the current worker thread
+thread_local const thread_pool* t_pool = nullptr;
+
+} // anonymous namespace
+
 thread_pool::thread_pool(const size_t n) : m_running(true), m_threads(n), m_doingWork(0)
 {
   const std::unique_lock lock(m_mutex);
@@ -41,6 +51,11 @@ void thread_pool::wait_all()
                 [this]() -> bool { return !m_running || (m_work.empty() && m_doingWork == 0); });
 }
 
+bool thread_pool::is_worker_thread() const
+{
+  return (t_pool == this);
+}
+
 void thread_pool::join_all()
 {
   {
@@ -67,6 +82,8 @@ void thread_pool::join_all()
 
 void thread_pool::worker()
 {
+  t_pool = this;
+
   bool running;
   {
     const std::unique_lock lock(m_mutex);
@@ -107,4 +124,48 @@ void thread_pool::worker()
   }
 }
 
+void for_each_task(thread_pool* pool,
+                   const int count,
+                   const int perTask,
+                   const std::function<void(int, int)>& func)
+{
+  ASSERT(perTask > 0);
+  if (count <= 0)
+    return;
+  if (!pool || count <= perTask || pool->is_worker_thread()) {
+    func(0, count);
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int pendingTasks = (count + perTask - 1) / perTask;
+  std::exception_ptr error;
+
+  for (int i = 0; i < count; i += perTask) {
+    const int j = std::min(i + perTask, count);
+    pool->execute([&, i, j] {
+      // The task must be counted as finished even if func() throws
+      std::exception_ptr taskError;
+      try {
+        func(i, j);
+      }
+      catch (...) {
+        taskError = std::current_exception();
+      }
+
+      const std::lock_guard lock(mutex);
+      if (taskError && !error)
+        error = taskError;
+      if (--pendingTasks == 0)
+        cv.notify_one();
+    });
+  }
+
+  std::unique_lock lock(mutex);
+  cv.wait(lock, [&pendingTasks] { return pendingTasks == 0; });
+  if (error)
+    std::rethrow_exception(error);
+}
+
 } // namespace base
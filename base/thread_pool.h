@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -27,6 +27,9 @@ public:
   // Waits until the queue is empty.
   void wait_all();
 
+  // Returns true if it's called from one of the threads of this pool.
+  bool is_worker_thread() const;
+
 private:
   // Joins all threads without waiting the queue to be processed.
   void join_all();
@@ -43,6 +46,17 @@ private:
   int m_doingWork;
 };
 
+// Calls func(i, j) for each range [i, j) of "perTask" consecutive
+// items of [0, count) in the threads of "pool", and waits all of
+// them. If "pool" is nullptr, there is only one range, or this is
+// called from a thread of "pool" (which couldn't wait its own
+// tasks), func(0, count) is called in this thread. The first
+// exception thrown by func() is rethrown when all tasks finish.
+void for_each_task(thread_pool* pool,
+                   int count,
+                   int perTask,
+                   const std::function<void(int, int)>& func);
+
 } // namespace base
 
 #endif
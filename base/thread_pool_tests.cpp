@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -9,6 +9,8 @@
 #include "base/thread_pool.h"
 
 #include <atomic>
+#include <stdexcept>
+#include <vector>
 
 using namespace base;
 
@@ -23,6 +25,58 @@ TEST(ThreadPool, Basic)
   EXPECT_EQ(10000, c);
 }
 
+TEST(ThreadPool, ForEachTask)
+{
+  thread_pool p(3);
+  for (thread_pool* pool : { (thread_pool*)nullptr, &p }) {
+    for (const int count : { 0, 1, 7, 64, 1001 }) {
+      std::vector<int> visited(count, 0);
+      std::atomic<int> tasks(0);
+      for_each_task(pool, count, 16, [&](const int i, const int j) {
+        EXPECT_LT(i, j);
+        if (pool) {
+          EXPECT_LE(j - i, 16);
+        }
+        for (int k = i; k < j; ++k)
+          ++visited[k];
+        ++tasks;
+      });
+      EXPECT_EQ(std::vector<int>(count, 1), visited);
+      EXPECT_EQ(pool && count > 16 ? (count + 15) / 16 : (count > 0 ? 1 : 0), tasks);
+    }
+  }
+}
+
+TEST(ThreadPool, ForEachTaskException)
+{
+  thread_pool p(3);
+  std::atomic<int> tasks(0);
+  EXPECT_THROW(for_each_task(&p,
+                             100,
+                             10,
+                             [&](const int i, int) {
+                               ++tasks;
+                               if (i == 50)
+                                 throw std::runtime_error("error");
+                             }),
+               std::runtime_error);
+  // All tasks have finished before the exception is rethrown
+  EXPECT_EQ(10, tasks);
+}
+
+TEST(ThreadPool, ForEachTaskFromWorker)
+{
+  thread_pool p(1);
+  std::atomic<int> items(0);
+  for_each_task(&p, 4, 1, [&](int, int) {
+    EXPECT_TRUE(p.is_worker_thread());
+    // Nested calls run in the worker thread
+    for_each_task(&p, 10, 1, [&](const int i, const int j) { items += j - i; });
+  });
+  EXPECT_FALSE(p.is_worker_thread());
+  EXPECT_EQ(40, items);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
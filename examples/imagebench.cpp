@@ -0,0 +1,101 @@
+// LAF Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Loads image files one by one, in parallel with os::load_surfaces(),
+// and only their central area (ROI decoding), then saves them as PNG
+// files (with one thread and with a thread pool), and prints the
+// time spent in each case. Usage: imagebench files...
+
+#include "base/chrono.h"
+#include "base/fs.h"
+#include "base/thread_pool.h"
+#include "os/os.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void print_result(const char* name,
+                         const std::vector<os::SurfaceRef>& surfaces,
+                         const double seconds)
+{
+  int loaded = 0;
+  double pixels = 0.0;
+  for (const os::SurfaceRef& surface : surfaces) {
+    if (surface) {
+      ++loaded;
+      pixels += double(surface->width()) * surface->height();
+    }
+  }
+  std::printf("%-10s %3d files %9.3f ms %9.2f Mpixels/s\n",
+              name,
+              loaded,
+              seconds * 1000.0,
+              (seconds > 0.0 ? pixels / seconds / 1000000.0 : 0.0));
+}
+
+int app_main(int argc, char* argv[])
+{
+  os::SystemRef system = os::make_system();
+  system->setAppMode(os::AppMode::CLI);
+
+  if (argc < 2) {
+    std::printf("Usage: %s files...\n", argv[0]);
+    return 1;
+  }
+
+  const std::vector<std::string> filenames(argv + 1, argv + argc);
+  base::Chrono chrono;
+
+  // One by one in this thread
+  std::vector<os::SurfaceRef> surfaces;
+  for (const std::string& fn : filenames)
+    surfaces.push_back(os::load_surface(fn.c_str()));
+  print_result("serial", surfaces, chrono.elapsed());
+
+  // Decode files in parallel
+  {
+    base::thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    chrono.reset();
+    const std::vector<os::SurfaceRef> result = os::load_surfaces(filenames, &pool);
+    print_result("parallel", result, chrono.elapsed());
+  }
+
+  // Only the central 256x256 area of each image
+  {
+    std::vector<os::SurfaceRef> result;
+    chrono.reset();
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+      if (!surfaces[i])
+        continue;
+      const gfx::Rect bounds = surfaces[i]->bounds();
+      gfx::Rect roi(0, 0, std::min(256, bounds.w), std::min(256, bounds.h));
+      roi.offset((bounds.w - roi.w) / 2, (bounds.h - roi.h) / 2);
+      result.push_back(os::load_surface(filenames[i].c_str(), roi));
+    }
+    print_result("roi", result, chrono.elapsed());
+  }
+
+  // Save all images as PNG, compressing each one with one thread and
+  // then with the thread pool
+  {
+    const char* tmpFilename = "_imagebench_.tmp.png";
+    base::thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    for (base::thread_pool* p : { (base::thread_pool*)nullptr, &pool }) {
+      chrono.reset();
+      for (const os::SurfaceRef& surface : surfaces) {
+        if (surface)
+          os::save_surface(surface.get(), tmpFilename, p);
+      }
+      print_result(p ? "png-pool" : "png", surfaces, chrono.elapsed());
+    }
+    if (base::is_file(tmpFilename))
+      base::delete_file(tmpFilename);
+  }
+  return 0;
+}
@@ -1,9 +1,11 @@
 // LAF Library
-// Copyright (C) 2020-2022  Igara Studio S.A.
+// Copyright (C) 2020-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
 
+#include "base/chrono.h"
+#include "base/thread_pool.h"
 #include "gfx/hsv.h"
 #include "gfx/rgb.h"
 #include "os/os.h"
@@ -11,17 +13,27 @@
 #include <algorithm>
 #include <cstdarg>
 #include <cstdlib>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+// Size of the image that we pan/zoom
+constexpr int kImageSize = 4096;
+
 class PanWindow {
 public:
   PanWindow(os::System* system)
     : m_window(system->makeWindow(800, 600))
     , m_scroll(0.0, 0.0)
     , m_zoom(1.0)
+    , m_pool(std::max(1u, std::thread::hardware_concurrency()))
+    , m_image(makeImage())
+    , m_usePyramid(true)
     , m_hasCapture(false)
+    , m_painting(false)
   {
+    makePyramid(os::SurfacePyramid::Filter::Box);
     m_window->setCursor(os::NativeCursor::Arrow);
     m_window->setTitle("Pan Viewport");
     repaint();
@@ -38,14 +50,26 @@ public:
       case os::Event::MouseEnter:   break;
       case os::Event::MouseLeave:   break;
       case os::Event::MouseMove:
-        if (m_hasCapture) {
+        if (m_painting) {
+          paintAt(ev.position());
+          repaint();
+        }
+        else if (m_hasCapture) {
           m_scroll = m_captureScroll + gfx::PointF(ev.position() - m_capturePos);
           repaint();
         }
         break;
 
       case os::Event::MouseDown:
-        if (!m_hasCapture) {
+        // Paint in the image with the right button, only the modified
+        // area of the pyramid levels is calculated again
+        if (ev.button() == os::Event::RightButton) {
+          m_window->captureMouse();
+          m_painting = true;
+          paintAt(ev.position());
+          repaint();
+        }
+        else if (!m_hasCapture) {
           m_window->setCursor(os::NativeCursor::Move);
           m_window->captureMouse();
           m_hasCapture = true;
@@ -55,7 +79,11 @@ public:
         break;
 
       case os::Event::MouseUp:
-        if (m_hasCapture) {
+        if (m_painting) {
+          m_window->releaseMouse();
+          m_painting = false;
+        }
+        else if (m_hasCapture) {
           m_window->setCursor(os::NativeCursor::Arrow);
           m_window->releaseMouse();
           m_hasCapture = false;
@@ -92,6 +120,19 @@ public:
       case os::Event::KeyDown:
         if (ev.scancode() == os::kKeyEsc)
           return false;
+        // Toggle the use of the image pyramid (to compare it with
+        // drawSurface() using the full-size image)
+        else if (ev.scancode() == os::kKeyP) {
+          m_usePyramid = !m_usePyramid;
+          repaint();
+        }
+        // Change the filter used to create the pyramid levels
+        else if (ev.scancode() == os::kKeyF && ev.modifiers() == os::kKeyNoneModifier) {
+          makePyramid(m_pyramid->filter() == os::SurfacePyramid::Filter::Box ?
+                        os::SurfacePyramid::Filter::Lanczos :
+                        os::SurfacePyramid::Filter::Box);
+          repaint();
+        }
         // Toggle full-screen
         else if ( // F11 for Windows/Linux
           (ev.scancode() == os::kKeyF11) ||
@@ -120,6 +161,19 @@ public:
     p.color(gfx::rgba(32, 32, 32, 255));
     surface->drawRect(rc, p);
 
+    base::Chrono chrono;
+    {
+      const gfx::Rect dstRect(imageBounds());
+      if (m_usePyramid)
+        m_pyramid->drawTo(surface, m_image->bounds(), dstRect);
+      else
+        surface->drawSurface(m_image.get(),
+                             m_image->bounds(),
+                             dstRect,
+                             os::Sampling(os::Sampling::Filter::Linear));
+    }
+    const double drawTime = chrono.elapsed();
+
     p.style(os::Paint::Stroke);
     p.color(gfx::rgba(255, 255, 200, 255));
     {
@@ -143,10 +197,14 @@ public:
       std::vector<char> buf(256);
       std::snprintf(buf.data(),
                     buf.size(),
-                    "Scroll=%.2f %.2f  Zoom=%.2f",
+                    "Scroll=%.2f %.2f  Zoom=%.2f  %s Level=%d  Draw=%.2f ms  "
+                    "(P=toggle pyramid, F=filter, Right button=paint)",
                     m_scroll.x,
                     m_scroll.y,
-                    m_zoom);
+                    m_zoom,
+                    (m_pyramid->filter() == os::SurfacePyramid::Filter::Box ? "Box" : "Lanczos"),
+                    (m_usePyramid ? m_pyramid->levelForScale(m_zoom) : 0),
+                    drawTime * 1000.0);
       p.style(os::Paint::Fill);
       os::draw_text(surface, nullptr, &buf[0], gfx::Point(12, 12), &p);
     }
@@ -156,6 +214,63 @@ public:
   }
 
 private:
+  static os::SurfaceRef makeImage()
+  {
+    os::SurfaceRef image = os::instance()->makeRgbaSurface(kImageSize, kImageSize);
+    os::SurfaceLock lock(image.get());
+    os::Paint p;
+    p.style(os::Paint::Fill);
+
+    // Colored tiles with thin lines, the lines create aliasing
+    // artifacts when the image is zoomed out without mipmaps
+    constexpr int kTileSize = 256;
+    for (int y = 0; y < kImageSize; y += kTileSize) {
+      for (int x = 0; x < kImageSize; x += kTileSize) {
+        gfx::Rgb rgb(gfx::Hsv(360.0 * (x + y) / (2 * kImageSize), 0.6, 0.4 + 0.6 * y / kImageSize));
+        p.color(gfx::rgba(rgb.red(), rgb.green(), rgb.blue()));
+        image->drawRect(gfx::Rect(x, y, kTileSize, kTileSize), p);
+      }
+    }
+    p.color(gfx::rgba(255, 255, 255, 160));
+    for (int i = 0; i < kImageSize; i += 4) {
+      image->drawRect(gfx::Rect(i, 0, 1, kImageSize), p);
+      image->drawRect(gfx::Rect(0, i, kImageSize, 1), p);
+    }
+    return image;
+  }
+
+  void makePyramid(const os::SurfacePyramid::Filter filter)
+  {
+    m_pyramid = std::make_unique<os::SurfacePyramid>(m_image, filter, &m_pool);
+  }
+
+  // Bounds of the image in the window
+  gfx::RectF imageBounds() const
+  {
+    gfx::RectF rc(-kImageSize / 2.0, -kImageSize / 2.0, kImageSize, kImageSize);
+    rc *= m_zoom;
+    rc.offset(center());
+    rc.offset(m_scroll);
+    return rc;
+  }
+
+  void paintAt(const gfx::Point& mousePos)
+  {
+    const gfx::RectF bounds = imageBounds();
+    const gfx::PointF pos((mousePos.x - bounds.x) / m_zoom, (mousePos.y - bounds.y) / m_zoom);
+    const int r = int(8 / m_zoom) + 1;
+
+    {
+      os::SurfaceLock lock(m_image.get());
+      os::Paint p;
+      p.style(os::Paint::Fill);
+      p.color(gfx::rgba(255, 64, 32));
+      p.antialias(true);
+      m_image->drawCircle(pos.x, pos.y, r, p);
+    }
+    m_pyramid->invalidate(gfx::Rect(int(pos.x) - r - 1, int(pos.y) - r - 1, 2 * r + 3, 2 * r + 3));
+  }
+
   void setZoom(const gfx::PointF& mousePos, double newZoom)
   {
     double oldZoom = m_zoom;
@@ -183,10 +298,17 @@ private:
   gfx::PointF m_scroll;
   double m_zoom;
 
+  // Image and its pyramid to draw it zoomed out
+  base::thread_pool m_pool;
+  os::SurfaceRef m_image;
+  std::unique_ptr<os::SurfacePyramid> m_pyramid;
+  bool m_usePyramid;
+
   // To pan the viewport with drag & drop
   bool m_hasCapture;
   gfx::Point m_capturePos;
   gfx::PointF m_captureScroll;
+  bool m_painting;
 };
 
 int app_main(int argc, char* argv[])
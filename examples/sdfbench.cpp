@@ -0,0 +1,105 @@
+// LAF Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Compares rasterizing glyphs with FreeType at each size vs rendering
+// them from signed distance fields (ft::SdfGlyphCache) generated at a
+// reference size. Prints the time per glyph and the mean error of the
+// SDF coverage. Usage: sdfbench font.ttf [referenceSize]
+
+#include "base/chrono.h"
+#include "ft/face.h"
+#include "ft/lib.h"
+#include "ft/sdf.h"
+#include "gfx/point.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Face = ft::FaceFT<ft::NoCache>;
+
+int app_main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::printf("Usage: %s font.ttf [referenceSize]\n", argv[0]);
+    return 1;
+  }
+
+  const int refSize = (argc > 2 ? std::atoi(argv[2]) : 64);
+
+  ft::Lib lib;
+  Face face(lib.openShared(argv[1]));
+  Face sdfFace(lib.openShared(argv[1]));
+  if (!face.isValid()) {
+    std::printf("Font %s not found\n", argv[1]);
+    return 1;
+  }
+  face.setAntialias(true);
+
+  std::vector<FT_UInt> glyphs;
+  for (int chr = '!'; chr <= '~'; ++chr)
+    glyphs.push_back(FT_Get_Char_Index(face, chr));
+
+  base::Chrono chrono;
+  ft::SdfGlyphCache<Face> sdfCache(sdfFace, refSize);
+  for (FT_UInt glyph : glyphs)
+    sdfCache.glyph(glyph);
+  std::printf("SDF generation at %dpx: %.3f ms/glyph\n\n",
+              refSize,
+              chrono.elapsed() * 1000.0 / glyphs.size());
+
+  std::printf("size  raster ms/glyph  sdf ms/glyph  mean error (0-255)\n");
+
+  std::vector<uint8_t> mask;
+  for (int size : { 8, 12, 16, 24, 32, 48, 64, 96, 128 }) {
+    face.setSize(size);
+    const double scale = double(size) / refSize;
+
+    chrono.reset();
+    for (FT_UInt glyph : glyphs)
+      face.cache().doneGlyph(face.cache().loadGlyph(face, glyph, true));
+    const double rasterTime = chrono.elapsed();
+
+    chrono.reset();
+    gfx::Rect bounds;
+    for (FT_UInt glyph : glyphs)
+      ft::render_sdf(*sdfCache.glyph(glyph), scale, mask, bounds);
+    const double sdfTime = chrono.elapsed();
+
+    // Compare both coverage masks in the union of their bounds
+    double error = 0.0;
+    int pixels = 0;
+    for (FT_UInt glyph : glyphs) {
+      auto* g = face.cache().loadGlyph(face, glyph, true);
+      if (!g)
+        continue;
+      const FT_BitmapGlyph bg = FT_BitmapGlyph(g->ft_glyph);
+      const gfx::Rect rasterBounds(bg->left, -bg->top, bg->bitmap.width, bg->bitmap.rows);
+      ft::render_sdf(*sdfCache.glyph(glyph), scale, mask, bounds);
+
+      const gfx::Rect all = rasterBounds.createUnion(bounds);
+      for (int y = all.y; y < all.y2(); ++y) {
+        for (int x = all.x; x < all.x2(); ++x) {
+          int a = 0, b = 0;
+          if (rasterBounds.contains(gfx::Point(x, y)))
+            a = bg->bitmap.buffer[(y - rasterBounds.y) * bg->bitmap.pitch + x - rasterBounds.x];
+          if (bounds.contains(gfx::Point(x, y)))
+            b = mask[(y - bounds.y) * bounds.w + x - bounds.x];
+          error += std::abs(a - b);
+          ++pixels;
+        }
+      }
+      face.cache().doneGlyph(g);
+    }
+
+    std::printf("%4d  %15.4f  %12.4f  %18.2f\n",
+                size,
+                rasterTime * 1000.0 / glyphs.size(),
+                sdfTime * 1000.0 / glyphs.size(),
+                error / pixels);
+  }
+  return 0;
+}
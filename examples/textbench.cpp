@@ -0,0 +1,165 @@
+// LAF Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Draws thousands of short labels (like a big list/table in a UI)
+// with os::draw_text() into an offscreen surface and prints the
+// time spent. Usage: textbench font.ttf [labels] [height]
+
+#include "base/chrono.h"
+#include "base/string.h"
+#include "base/thread_pool.h"
+#include "os/os.h"
+#include "os/text_layout.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+int app_main(int argc, char* argv[])
+{
+  os::SystemRef system = os::make_system();
+  system->setAppMode(os::AppMode::CLI);
+
+  if (argc < 2) {
+    std::printf("Usage: %s font.ttf [labels] [height]\n", argv[0]);
+    return 1;
+  }
+
+  const int nlabels = (argc > 2 ? std::atoi(argv[2]) : 10000);
+  const int height = (argc > 3 ? std::atoi(argv[3]) : 12);
+
+  os::FontRef font = system->loadTrueTypeFont(argv[1], height);
+  if (!font) {
+    std::printf("Font %s not found\n", argv[1]);
+    return 1;
+  }
+
+  // Create the same font with different sizes (they share the
+  // FT_Face, see ft::Lib::openShared())
+  {
+    std::vector<os::FontRef> fonts;
+    base::Chrono chrono;
+    for (int i = 6; i < 36; ++i)
+      fonts.push_back(system->loadTrueTypeFont(argv[1], i));
+    std::printf("%-16s %d sizes in %.3f ms\n",
+                "load font",
+                int(fonts.size()),
+                chrono.elapsed() * 1000.0);
+  }
+
+  const gfx::Size size(1024, 768);
+  os::SurfaceRef surface = system->makeRgbaSurface(size.w, size.h);
+  os::SurfaceLock lock(surface.get());
+
+  const char* labels[] = { "File",      "Edit",    "Select", "View",     "Image",
+                           "Layer",     "Frame",   "Sprite", "Tag",      "Help",
+                           "Cel #1",    "Opacity", "Normal", "Untitled", "Palette",
+                           "RGB Color", "Size",    "100%",   "Preview",  "Background" };
+  const int nstrings = sizeof(labels) / sizeof(labels[0]);
+
+  // Warm up the glyph cache so we measure only the rasterization of
+  // coverage masks into the surface.
+  for (int i = 0; i < nstrings; ++i)
+    os::draw_text(surface.get(), font.get(), labels[i], gfx::rgba(0, 0, 0), 0, 0, 0, nullptr);
+
+  const struct {
+    const char* name;
+    gfx::Color fg, bg;
+  } modes[] = {
+    { "opaque fg",      gfx::rgba(255, 255, 255),      gfx::ColorNone        },
+    { "translucent fg", gfx::rgba(255, 255, 255, 128), gfx::ColorNone        },
+    { "opaque fg + bg", gfx::rgba(255, 255, 255),      gfx::rgba(32, 32, 32) },
+  };
+
+  for (const auto& mode : modes) {
+    surface->clear();
+
+    base::Chrono chrono;
+    int x = 0, y = 0;
+    for (int i = 0; i < nlabels; ++i) {
+      const gfx::Rect bounds = os::draw_text(surface.get(),
+                                             font.get(),
+                                             labels[i % nstrings],
+                                             mode.fg,
+                                             mode.bg,
+                                             x,
+                                             y,
+                                             nullptr);
+      x += bounds.w + 8;
+      if (x > size.w) {
+        x = 0;
+        y += font->height();
+        if (y > size.h)
+          y = 0;
+      }
+    }
+    const double t = chrono.elapsed();
+    std::printf("%-16s %d labels in %.3f ms (%.1f labels/ms)\n",
+                mode.name,
+                nlabels,
+                t * 1000.0,
+                nlabels / (t * 1000.0));
+  }
+
+  // Shape all labels at once (sequentially and with a thread pool),
+  // then draw the cached layouts.
+  std::vector<std::string> strings(nlabels);
+  for (int i = 0; i < nlabels; ++i)
+    strings[i] = std::string(labels[i % nstrings]) + " " + std::to_string(i);
+
+  base::Chrono chrono;
+  std::vector<os::TextLayout> layouts = os::layout_texts(font.get(), strings);
+  std::printf("%-16s %d labels in %.3f ms\n", "layout", nlabels, chrono.elapsed() * 1000.0);
+
+  const int nthreads = std::max(1u, std::thread::hardware_concurrency());
+  base::thread_pool pool(nthreads);
+  chrono.reset();
+  layouts = os::layout_texts(font.get(), strings, &pool);
+  std::printf("%-16s %d labels in %.3f ms (%d threads)\n",
+              "layout parallel",
+              nlabels,
+              chrono.elapsed() * 1000.0,
+              nthreads);
+
+  // Warm the glyph cache of new font sizes drawing all Latin-1 chars
+  // vs rasterizing the glyphs in parallel first
+  std::wstring wchars;
+  for (int chr = 0x21; chr <= 0xff; ++chr) {
+    if (chr < 0x7f || chr > 0xa0)
+      wchars.push_back(wchar_t(chr));
+  }
+  const std::string chars = base::to_utf8(wchars);
+  for (int parallel = 0; parallel < 2; ++parallel) {
+    os::FontRef newFont = system->loadTrueTypeFont(argv[1], height * 3 + parallel);
+    chrono.reset();
+    if (parallel)
+      os::prerasterize_glyphs(newFont.get(), chars, pool);
+    os::draw_text(surface.get(), newFont.get(), chars, gfx::rgba(0, 0, 0), 0, 0, 0, nullptr);
+    std::printf("%-16s %d chars in %.3f ms\n",
+                (parallel ? "warm parallel" : "warm cache"),
+                int(chars.size()),
+                chrono.elapsed() * 1000.0);
+  }
+
+  surface->clear();
+  chrono.reset();
+  int y = 0;
+  for (const auto& layout : layouts) {
+    os::draw_text_layout(surface.get(),
+                         font.get(),
+                         layout,
+                         gfx::rgba(255, 255, 255),
+                         gfx::ColorNone,
+                         0,
+                         y);
+    y = (y + font->height()) % size.h;
+  }
+  std::printf("%-16s %d labels in %.3f ms\n", "draw layouts", nlabels, chrono.elapsed() * 1000.0);
+  return 0;
+}
@@ -0,0 +1,387 @@
+// LAF Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Text rendering benchmark/regression suite. Measures draw_text(),
+// Font::textLength() (calc_text_bounds()), shaping (layout_texts(),
+// i.e. HBShaper) and draw_text_layout() with a corpus of short
+// labels, long paragraphs, mixed scripts, symbols/emoji, and strings
+// that need the fallback font. Each operation is measured with a
+// cold glyph cache (a new font instance) and a warm one, printing
+// glyphs/sec, allocations per call, and the glyph cache hit rate.
+//
+// By default it uses the fonts of examples/data, so the results are
+// reproducible offline. The results can be saved and compared with
+// a previous run to find regressions (the exit code is 1 if there is
+// a regression).
+//
+// Usage: textcorpus [--font font.ttf] [--fallback font.ttf]
+//                   [--size height] [--save file] [--compare file]
+//                   [--tolerance percent]
+
+#include "base/chrono.h"
+#include "base/file_handle.h"
+#include "base/ints.h"
+#include "os/os.h"
+#include "os/text_layout.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+// Number of C++ allocations (FreeType and HarfBuzz allocate memory
+// with malloc(), those allocations are not counted).
+static std::atomic<uint64_t> g_allocs(0);
+
+void* operator new(std::size_t size)
+{
+  ++g_allocs;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace {
+
+struct Corpus {
+  const char* name;
+  std::vector<std::string> strings;
+};
+
+std::vector<Corpus> make_corpus()
+{
+  std::vector<Corpus> corpus;
+
+  corpus.push_back({ "labels",
+                     { "File",      "Edit",    "Select", "View",     "Image",
+                       "Layer",     "Frame",   "Sprite", "Tag",      "Help",
+                       "Cel #1",    "Opacity", "Normal", "Untitled", "Palette",
+                       "RGB Color", "Size",    "100%",   "Preview",  "Background" } });
+
+  corpus.push_back(
+    { "paragraphs",
+      { "Text rendering looks simple from the outside: take a string, find the glyph of "
+        "each character, and copy its pixels to the screen. In practice each step hides "
+        "a lot of work, the string must be split in runs of the same script and font, "
+        "each run is shaped to get the glyphs and their positions, and each glyph is "
+        "rasterized at the exact size (and subpixel position) before it's blended with "
+        "the background. Caches make the second time much faster than the first one.",
+        "A paragraph of a few hundred characters is a good way to measure the throughput "
+        "of the whole pipeline, because the fixed cost of each call (finding the font, "
+        "creating buffers, locking the surface) is amortized between many glyphs. Short "
+        "labels show the opposite case, where the fixed cost is the most important part "
+        "of the time spent, and where allocations per call matter the most.",
+        "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor "
+        "jugs. How vexingly quick daft zebras jump! Sphinx of black quartz, judge my vow. "
+        "The five boxing wizards jump quickly. Jackdaws love my big sphinx of quartz." } });
+
+  corpus.push_back({ "mixed scripts",
+                     { "English and Ελληνικά: Καλημέρα κόσμε",
+                       "Русский: Съешь же ещё этих мягких французских булок",
+                       "Hebrew עברית: שלום עולם",
+                       "Arabic العربية: مرحبا بالعالم",
+                       "Latin, Ελληνικά, Кириллица, עברית, العربية" } });
+
+  corpus.push_back({ "emoji",
+                     { "Sunny ☀ today ☺",
+                       "Rating ★★★★☆",
+                       "♥ Favorites",
+                       "✔ Done ✘ Failed",
+                       "☎ Call ✉ Mail ✈ Travel",
+                       "Weather: ☀ ☁ ☂ ☃" } });
+
+  corpus.push_back({ "fallback",
+                     { "a→b→c→d→e→f",
+                       "☐ one ☑ two ☒ three",
+                       "←↑→↓ ←↑→↓ ←↑→↓",
+                       "✓✗✓✗ ♠♣♥♦ ♪♫",
+                       "x☀y☁z☂w☃v★u☆" } });
+
+  return corpus;
+}
+
+struct Result {
+  double glyphsPerSec = 0.0;
+  double allocsPerCall = 0.0;
+  double hitRate = -1.0; // -1 if the glyph cache is not used
+};
+
+using Results = std::map<std::string, Result>;
+
+std::string result_key(const char* corpus, const char* op, const bool warm)
+{
+  std::string key = std::string(corpus) + "/" + op + "/" + (warm ? "warm" : "cold");
+  for (char& chr : key) {
+    if (chr == ' ')
+      chr = '_';
+  }
+  return key;
+}
+
+bool save_results(const char* filename, const Results& results)
+{
+  base::FileHandle f(base::open_file(filename, "wb"));
+  if (!f)
+    return false;
+  for (const auto& it : results) {
+    std::fprintf(f.get(),
+                 "%s %.1f %.2f %.4f\n",
+                 it.first.c_str(),
+                 it.second.glyphsPerSec,
+                 it.second.allocsPerCall,
+                 it.second.hitRate);
+  }
+  return true;
+}
+
+bool load_results(const char* filename, Results& results)
+{
+  base::FileHandle f(base::open_file(filename, "rb"));
+  if (!f)
+    return false;
+  char key[256];
+  Result r;
+  while (std::fscanf(f.get(),
+                     "%255s %lf %lf %lf",
+                     key,
+                     &r.glyphsPerSec,
+                     &r.allocsPerCall,
+                     &r.hitRate) == 4) {
+    results[key] = r;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int app_main(int argc, char* argv[])
+{
+  os::SystemRef system = os::make_system();
+  system->setAppMode(os::AppMode::CLI);
+
+  std::string fontFile, fallbackFile;
+#ifdef LAF_EXAMPLES_DATA_DIR
+  fontFile = LAF_EXAMPLES_DATA_DIR "/DejaVuSans-Text.ttf";
+  fallbackFile = LAF_EXAMPLES_DATA_DIR "/DejaVuSans-Symbols.ttf";
+#endif
+  int height = 14;
+  const char* saveFile = nullptr;
+  const char* compareFile = nullptr;
+  double tolerance = 15.0;
+
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = (i + 1 < argc);
+    if (std::strcmp(argv[i], "--font") == 0 && hasValue)
+      fontFile = argv[++i];
+    else if (std::strcmp(argv[i], "--fallback") == 0 && hasValue)
+      fallbackFile = argv[++i];
+    else if (std::strcmp(argv[i], "--size") == 0 && hasValue)
+      height = std::atoi(argv[++i]);
+    else if (std::strcmp(argv[i], "--save") == 0 && hasValue)
+      saveFile = argv[++i];
+    else if (std::strcmp(argv[i], "--compare") == 0 && hasValue)
+      compareFile = argv[++i];
+    else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue)
+      tolerance = std::atof(argv[++i]);
+    else {
+      std::printf("Usage: %s [--font font.ttf] [--fallback font.ttf] [--size height]\n"
+                  "          [--save file] [--compare file] [--tolerance percent]\n",
+                  argv[0]);
+      return 1;
+    }
+  }
+
+  // Loads a new instance of the font (with an empty glyph cache)
+  auto loadFonts = [&](os::FontRef& font, os::FontRef& fallback) {
+    font = system->loadTrueTypeFont(fontFile.c_str(), height);
+    fallback = (fallbackFile.empty() ? nullptr :
+                                       system->loadTrueTypeFont(fallbackFile.c_str(), height));
+    if (font && fallback)
+      font->setFallback(fallback.get());
+    return (font != nullptr);
+  };
+
+  os::FontRef font, fallback;
+  if (!loadFonts(font, fallback)) {
+    std::printf("Font %s not found\n", fontFile.c_str());
+    return 1;
+  }
+
+  const gfx::Size size(1024, 768);
+  os::SurfaceRef surface = system->makeRgbaSurface(size.w, size.h);
+  os::SurfaceLock lock(surface.get());
+
+  const std::vector<Corpus> corpus = make_corpus();
+  Results results;
+
+  std::printf("%-14s %-17s %-5s %12s %12s %9s\n",
+              "corpus",
+              "operation",
+              "cache",
+              "glyphs/sec",
+              "allocs/call",
+              "hit rate");
+
+  for (const Corpus& c : corpus) {
+    // Number of glyphs of the whole corpus (shaped with the main font)
+    int glyphsPerPass = 0;
+    for (const os::TextLayout& layout : os::layout_texts(font.get(), c.strings))
+      glyphsPerPass += int(layout.glyphs.size());
+
+    std::vector<os::TextLayout> layouts;
+
+    const struct {
+      const char* name;
+      bool usesCache;
+      std::function<void(os::Font*, const std::string&, int)> run;
+    } ops[] = {
+      { "draw_text",
+        true, [&](os::Font* f, const std::string& str, int i) {
+          os::draw_text(surface.get(),
+                        f,
+                        str,
+                        gfx::rgba(255, 255, 255),
+                        gfx::ColorNone,
+                        0,
+                        (i * 16) % size.h,
+                        nullptr);
+        } },
+      { "textLength",
+        true, [&](os::Font* f, const std::string& str, int) { f->textLength(str); } },
+      { "layout_texts",
+        false, [&](os::Font* f, const std::string& str, int i) {
+          layouts[i] = std::move(os::layout_texts(f, { str })[0]);
+        } },
+      { "draw_text_layout",
+        true, [&](os::Font* f, const std::string&, int i) {
+          os::draw_text_layout(surface.get(),
+                               f,
+                               layouts[i],
+                               gfx::rgba(255, 255, 255),
+                               gfx::ColorNone,
+                               0,
+                               (i * 16) % size.h);
+        } },
+    };
+
+    for (const auto& op : ops) {
+      // Cold: new font instances (first pass), warm: the same fonts
+      // (several passes).
+      for (int warm = 0; warm < 2; ++warm) {
+        os::FontRef opFont = font, opFallback = fallback;
+        if (!warm)
+          loadFonts(opFont, opFallback);
+
+        // Layouts drawn by draw_text_layout() are created with the
+        // same font instance
+        layouts = os::layout_texts(opFont.get(), c.strings);
+
+        os::reset_glyph_cache_stats(opFont.get());
+        if (opFallback)
+          os::reset_glyph_cache_stats(opFallback.get());
+
+        const int passes = (warm ? 50 : 1);
+        const uint64_t allocs0 = g_allocs;
+        base::Chrono chrono;
+        for (int pass = 0; pass < passes; ++pass) {
+          for (int i = 0; i < int(c.strings.size()); ++i)
+            op.run(opFont.get(), c.strings[i], i);
+        }
+        const double t = chrono.elapsed();
+        const int calls = passes * int(c.strings.size());
+
+        Result r;
+        r.glyphsPerSec = (t > 0.0 ? passes * glyphsPerPass / t : 0.0);
+        r.allocsPerCall = double(g_allocs - allocs0) / calls;
+        if (op.usesCache) {
+          os::GlyphCacheStats stats = os::glyph_cache_stats(opFont.get());
+          if (opFallback) {
+            const os::GlyphCacheStats fb = os::glyph_cache_stats(opFallback.get());
+            stats.hits += fb.hits;
+            stats.misses += fb.misses;
+          }
+          const uint64_t total = stats.hits + stats.misses;
+          r.hitRate = (total ? double(stats.hits) / total : 0.0);
+        }
+        results[result_key(c.name, op.name, warm)] = r;
+
+        char hitRate[32] = "-";
+        if (r.hitRate >= 0.0)
+          std::snprintf(hitRate, sizeof(hitRate), "%.1f%%", r.hitRate * 100.0);
+        std::printf("%-14s %-17s %-5s %12.0f %12.2f %9s\n",
+                    c.name,
+                    op.name,
+                    (warm ? "warm" : "cold"),
+                    r.glyphsPerSec,
+                    r.allocsPerCall,
+                    hitRate);
+      }
+    }
+  }
+
+  if (saveFile && !save_results(saveFile, results)) {
+    std::printf("Cannot save %s\n", saveFile);
+    return 1;
+  }
+
+  int regressions = 0;
+  if (compareFile) {
+    Results baseline;
+    if (!load_results(compareFile, baseline)) {
+      std::printf("Cannot load %s\n", compareFile);
+      return 1;
+    }
+
+    std::printf("\nComparing with %s (tolerance %.1f%%)\n", compareFile, tolerance);
+    for (const auto& it : baseline) {
+      auto cur = results.find(it.first);
+      if (cur == results.end())
+        continue;
+
+      const Result& a = it.second;
+      const Result& b = cur->second;
+      if (b.glyphsPerSec < a.glyphsPerSec * (1.0 - tolerance / 100.0)) {
+        std::printf("  %-40s %.0f -> %.0f glyphs/sec\n",
+                    it.first.c_str(),
+                    a.glyphsPerSec,
+                    b.glyphsPerSec);
+        ++regressions;
+      }
+      if (b.allocsPerCall > a.allocsPerCall + 0.5) {
+        std::printf("  %-40s %.2f -> %.2f allocs/call\n",
+                    it.first.c_str(),
+                    a.allocsPerCall,
+                    b.allocsPerCall);
+        ++regressions;
+      }
+      if (a.hitRate >= 0.0 && b.hitRate < a.hitRate - 0.01) {
+        std::printf("  %-40s %.1f%% -> %.1f%% cache hits\n",
+                    it.first.c_str(),
+                    a.hitRate * 100.0,
+                    b.hitRate * 100.0);
+        ++regressions;
+      }
+    }
+    std::printf("%d regression(s)\n", regressions);
+  }
+
+  return (regressions > 0 ? 1 : 0);
+}
@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2025 Igara Studio S.A.
 // Copyright (c) 2016-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -109,11 +109,17 @@ private:
 
     unloadGlyph();
 
-    // Load new glyph
-    m_glyph = m_face.cache().loadGlyph(m_face, glyphIndex, m_face.antialias());
+    // Load new glyph (with subpixel positioning the glyph is
+    // rasterized with the fractional part of the pen position)
+    double pixelX = m_x;
+    int subpixel = 0;
+    if (m_face.subpixelPositioning())
+      subpixel = subpixel_step(m_x, pixelX);
+
+    m_glyph = m_face.cache().loadGlyph(m_face, glyphIndex, m_face.antialias(), subpixel);
     if (m_glyph) {
       m_glyph->bitmap = &FT_BitmapGlyph(m_glyph->ft_glyph)->bitmap;
-      m_glyph->x = m_x + m_glyph->bearingX;
+      m_glyph->x = pixelX + m_glyph->bearingX;
       m_glyph->y = m_y + m_face.height() + m_face.descender() // descender is negative
                    - m_glyph->bearingY;
 
@@ -142,6 +148,59 @@ private:
   double m_x, m_y;
 };
 
+// A glyph positioned by shape_text(). It doesn't need the glyph
+// bitmap, so the position doesn't include the glyph bearing.
+struct ShapedGlyph {
+  FT_UInt glyph_index;
+  int char_index; // Byte index of the cluster in the UTF-8 string
+  double x;       // Pen position + glyph offset
+  double y;
+  double startX; // Pen position before/after the glyph (same as
+  double endX;   // Glyph::startX/endX)
+};
+
+// Shapes the given string calling f(const ShapedGlyph&) for each
+// glyph, using the same positions as ForEachGlyph<HBFace> but without
+// loading/rasterizing glyphs. Returns the total advance. The HarfBuzz
+// buffers can be given to reuse them between calls (see HBShaper).
+template<typename HBFace, typename Callback>
+double shape_text(HBFace& face,
+                  const std::string& str,
+                  Callback&& f,
+                  hb_buffer_t* buf = nullptr,
+                  hb_buffer_t* chrBuf = nullptr)
+{
+  HBShaper<HBFace> shaper(face, str, buf, chrBuf);
+  const bool useKerning = (FT_HAS_KERNING(((FT_Face)face)) ? true : false);
+  FT_UInt prevGlyph = 0;
+  double x = 0.0;
+  double y = 0.0;
+
+  while (shaper.next()) {
+    ShapedGlyph glyph;
+    glyph.glyph_index = shaper.glyphIndex();
+    glyph.char_index = shaper.charIndex();
+    glyph.startX = x;
+
+    if (useKerning && prevGlyph && glyph.glyph_index) {
+      FT_Vector kerning;
+      FT_Get_Kerning(face, prevGlyph, glyph.glyph_index, FT_KERNING_DEFAULT, &kerning);
+      x += kerning.x / 64.0;
+    }
+
+    const hb_glyph_position_t& pos = shaper.glyphPosition();
+    glyph.x = x + pos.x_offset / 64.0;
+    glyph.y = y + pos.y_offset / 64.0;
+    x += pos.x_advance / 64.0;
+    y += pos.y_advance / 64.0;
+    glyph.endX = x;
+
+    f(glyph);
+    prevGlyph = glyph.glyph_index;
+  }
+  return x;
+}
+
 template<typename FaceFT>
 gfx::Rect calc_text_bounds(FaceFT& face, const std::string& str)
 {
@@ -0,0 +1,157 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "ft/color_glyph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace ft {
+
+namespace {
+
+// Source pixels (and their weights) that are averaged to get one
+// destination pixel.
+struct AreaWeights {
+  int first = 0;
+  std::vector<float> weights;
+};
+
+std::vector<AreaWeights> calc_area_weights(const int srcSize, const int dstSize)
+{
+  const double scale = double(dstSize) / srcSize;
+  std::vector<AreaWeights> result(dstSize);
+
+  for (int i = 0; i < dstSize; ++i) {
+    // Source interval covered by the destination pixel "i"
+    const double a = i / scale;
+    const double b = std::min((i + 1) / scale, double(srcSize));
+    AreaWeights& w = result[i];
+    w.first = std::min(int(a), srcSize - 1);
+
+    double total = 0.0;
+    for (int j = w.first; j < b; ++j) {
+      const double area = std::min(b, j + 1.0) - std::max(a, double(j));
+      w.weights.push_back(float(area));
+      total += area;
+    }
+    if (total > 0.0) {
+      for (float& v : w.weights)
+        v = float(v / total);
+    }
+    else {
+      w.weights.assign(1, 1.0f);
+    }
+  }
+  return result;
+}
+
+} // anonymous namespace
+
+double select_bitmap_strike(FT_Face face, const int size)
+{
+  if (face->num_fixed_sizes <= 0)
+    return 1.0;
+
+  int best = -1;
+  int biggest = 0;
+  for (int i = 0; i < face->num_fixed_sizes; ++i) {
+    const FT_Pos ppem = face->available_sizes[i].y_ppem;
+    if (ppem > face->available_sizes[biggest].y_ppem)
+      biggest = i;
+    if (ppem >= size * 64 && (best < 0 || ppem < face->available_sizes[best].y_ppem))
+      best = i;
+  }
+  if (best < 0)
+    best = biggest;
+
+  if (FT_Select_Size(face, best) != 0)
+    return 1.0;
+
+  const FT_Pos ppem = face->available_sizes[best].y_ppem;
+  return (ppem > 0 ? size * 64.0 / ppem : 1.0);
+}
+
+bool scale_color_bitmap(FT_Library library, FT_Bitmap* bitmap, const double scale)
+{
+  if (bitmap->pixel_mode != FT_PIXEL_MODE_BGRA || scale <= 0.0)
+    return false;
+
+  const int srcW = int(bitmap->width);
+  const int srcH = int(bitmap->rows);
+  if (srcW == 0 || srcH == 0)
+    return true;
+
+  const int dstW = std::max(1, int(std::lround(srcW * scale)));
+  const int dstH = std::max(1, int(std::lround(srcH * scale)));
+  const std::vector<AreaWeights> wx = calc_area_weights(srcW, dstW);
+  const std::vector<AreaWeights> wy = calc_area_weights(srcH, dstH);
+
+  // Horizontal pass (4 float channels per pixel)
+  const int srcPitch = std::abs(bitmap->pitch);
+  std::vector<float> tmp(std::size_t(dstW) * srcH * 4);
+  for (int y = 0; y < srcH; ++y) {
+    const uint8_t* src = (bitmap->pitch >= 0 ? bitmap->buffer + y * srcPitch :
+                                               bitmap->buffer + (srcH - 1 - y) * srcPitch);
+    float* dst = &tmp[std::size_t(y) * dstW * 4];
+    for (int x = 0; x < dstW; ++x, dst += 4) {
+      const AreaWeights& w = wx[x];
+      const uint8_t* s = src + w.first * 4;
+      dst[0] = dst[1] = dst[2] = dst[3] = 0.0f;
+      for (const float v : w.weights) {
+        for (int c = 0; c < 4; ++c)
+          dst[c] += s[c] * v;
+        s += 4;
+      }
+    }
+  }
+
+  // Vertical pass, as the values are premultiplied each color
+  // channel is still <= alpha after averaging them.
+  const int dstPitch = dstW * 4;
+  std::vector<uint8_t> pixels(std::size_t(dstPitch) * dstH);
+  for (int y = 0; y < dstH; ++y) {
+    const AreaWeights& w = wy[y];
+    uint8_t* dst = &pixels[std::size_t(y) * dstPitch];
+    for (int x = 0; x < dstW; ++x, dst += 4) {
+      float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      const float* s = &tmp[(std::size_t(w.first) * dstW + x) * 4];
+      for (const float v : w.weights) {
+        for (int c = 0; c < 4; ++c)
+          acc[c] += s[c] * v;
+        s += std::size_t(dstW) * 4;
+      }
+      const int alpha = std::clamp(int(acc[3] + 0.5f), 0, 255);
+      for (int c = 0; c < 3; ++c)
+        dst[c] = uint8_t(std::clamp(int(acc[c] + 0.5f), 0, alpha));
+      dst[3] = uint8_t(alpha);
+    }
+  }
+
+  FT_Bitmap scaled;
+  FT_Bitmap_Init(&scaled);
+  scaled.width = dstW;
+  scaled.rows = dstH;
+  scaled.pitch = dstPitch;
+  scaled.buffer = pixels.data();
+  scaled.pixel_mode = FT_PIXEL_MODE_BGRA;
+  scaled.num_grays = 256;
+
+  // Copy the pixels to a buffer allocated by the FreeType library
+  FT_Bitmap result;
+  FT_Bitmap_Init(&result);
+  if (FT_Bitmap_Copy(library, &scaled, &result) != 0)
+    return false;
+
+  FT_Bitmap_Done(library, bitmap);
+  *bitmap = result;
+  return true;
+}
+
+} // namespace ft
@@ -0,0 +1,30 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef FT_COLOR_GLYPH_H_INCLUDED
+#define FT_COLOR_GLYPH_H_INCLUDED
+#pragma once
+
+#include "ft/freetype_headers.h"
+
+namespace ft {
+
+// Selects the bitmap strike of a face without outlines (e.g. CBDT or
+// sbix emoji fonts) that is better to draw glyphs of "size" pixels:
+// the smallest strike bigger than "size" (so bitmaps are downscaled),
+// or the biggest one. Returns the scale that must be applied to the
+// strike bitmaps/metrics to get "size" pixels.
+double select_bitmap_strike(FT_Face face, int size);
+
+// Scales a color bitmap (FT_PIXEL_MODE_BGRA with premultiplied
+// alpha) averaging the area of source pixels that each destination
+// pixel covers. The bitmap buffer is replaced with a new one
+// allocated by the given library.
+bool scale_color_bitmap(FT_Library library, FT_Bitmap* bitmap, double scale);
+
+} // namespace ft
+
+#endif
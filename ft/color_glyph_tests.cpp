@@ -0,0 +1,103 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "ft/color_glyph.h"
+#include "ft/lib.h"
+
+#include <vector>
+
+using namespace ft;
+
+// Creates a BGRA bitmap allocated by the library
+static void make_bitmap(Lib& lib,
+                        const int w,
+                        const int h,
+                        std::vector<uint8_t> pixels,
+                        FT_Bitmap* bitmap)
+{
+  FT_Bitmap src;
+  FT_Bitmap_Init(&src);
+  src.width = w;
+  src.rows = h;
+  src.pitch = w * 4;
+  src.buffer = pixels.data();
+  src.pixel_mode = FT_PIXEL_MODE_BGRA;
+  src.num_grays = 256;
+
+  FT_Bitmap_Init(bitmap);
+  ASSERT_EQ(0, FT_Bitmap_Copy(lib, &src, bitmap));
+}
+
+TEST(ColorGlyph, Downscale)
+{
+  Lib lib;
+  FT_Bitmap bitmap;
+  // 4x2 pixels: opaque white, transparent, two halves of red/blue
+  make_bitmap(lib,
+              4,
+              2,
+              { 255, 255, 255, 255, 0, 0, 0, 0, 0, 0, 255, 255, 255, 0, 0, 255,
+                255, 255, 255, 255, 0, 0, 0, 0, 0, 0, 255, 255, 255, 0, 0, 255 },
+              &bitmap);
+
+  EXPECT_TRUE(scale_color_bitmap(lib, &bitmap, 0.5));
+  ASSERT_EQ(2, bitmap.width);
+  ASSERT_EQ(1, bitmap.rows);
+  ASSERT_EQ(8, bitmap.pitch);
+  EXPECT_EQ(FT_PIXEL_MODE_BGRA, bitmap.pixel_mode);
+
+  // Premultiplied average
+  const uint8_t expected[8] = { 128, 128, 128, 128, 128, 0, 128, 255 };
+  for (int i = 0; i < 8; ++i)
+    EXPECT_EQ(expected[i], bitmap.buffer[i]) << "byte " << i;
+
+  FT_Bitmap_Done(lib, &bitmap);
+}
+
+TEST(ColorGlyph, DownscaleByNonIntegerFactor)
+{
+  Lib lib;
+  FT_Bitmap bitmap;
+  std::vector<uint8_t> pixels(136 * 128 * 4);
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    pixels[i + 0] = 10;
+    pixels[i + 1] = 20;
+    pixels[i + 2] = 30;
+    pixels[i + 3] = 40;
+  }
+  make_bitmap(lib, 136, 128, pixels, &bitmap);
+
+  EXPECT_TRUE(scale_color_bitmap(lib, &bitmap, 13.0 / 109.0));
+  EXPECT_EQ(16, bitmap.width);
+  EXPECT_EQ(15, bitmap.rows);
+
+  // A solid color is the same color after averaging
+  for (unsigned int i = 0; i < bitmap.rows * bitmap.pitch; i += 4) {
+    ASSERT_EQ(10, bitmap.buffer[i + 0]);
+    ASSERT_EQ(20, bitmap.buffer[i + 1]);
+    ASSERT_EQ(30, bitmap.buffer[i + 2]);
+    ASSERT_EQ(40, bitmap.buffer[i + 3]);
+  }
+
+  FT_Bitmap_Done(lib, &bitmap);
+}
+
+TEST(ColorGlyph, OnlyColorBitmaps)
+{
+  Lib lib;
+  FT_Bitmap bitmap;
+  FT_Bitmap_Init(&bitmap);
+  bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+  EXPECT_FALSE(scale_color_bitmap(lib, &bitmap, 0.5));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef FT_CONCURRENT_GLYPH_CACHE_H_INCLUDED
+#define FT_CONCURRENT_GLYPH_CACHE_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/ints.h"
+#include "ft/freetype_headers.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ft {
+
+// A glyph bitmap that doesn't depend on a FT_Library (it owns its
+// pixels), so it can be rasterized in one thread and used in another.
+struct RasterGlyph {
+  FT_UInt glyphIndex = 0;
+  int subpixel = 0;
+  uint32_t generation = 0; // ConcurrentGlyphCache::generation() of the glyph
+  FT_Bitmap bitmap = {}; // bitmap.buffer points to "buffer"
+  std::vector<uint8_t> buffer;
+  int left = 0; // Same as FT_BitmapGlyph left/top
+  int top = 0;
+  double bearingX = 0.0; // Same as ft::Glyph bearingX/Y
+  double bearingY = 0.0;
+  FT_Vector advance = {}; // Same as FT_Glyph advance (16.16)
+};
+
+// Fixed-size hash table of glyphs (keyed by glyph index + subpixel
+// step) where several threads can insert and find glyphs without
+// locks. Glyphs cannot be removed/replaced once they are inserted
+// (only with clear(), when no other thread is using the cache), but
+// invalidate() can be used at any time to discard all glyphs
+// rasterized with old settings (e.g. other font size).
+class ConcurrentGlyphCache {
+public:
+  // "capacity" is rounded up to a power of two.
+  explicit ConcurrentGlyphCache(size_t capacity = 4096)
+  {
+    m_capacity = 1;
+    while (m_capacity < capacity)
+      m_capacity <<= 1;
+    m_slots.reset(new Slot[m_capacity]);
+  }
+
+  ~ConcurrentGlyphCache() { clear(); }
+
+  size_t capacity() const { return m_capacity; }
+
+  // Glyphs are found only if they were inserted with the current
+  // generation. A rasterizer must use the generation from before it
+  // starts rasterizing, so glyphs rasterized with old settings are
+  // never found.
+  uint32_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+  // Thread-safe: glyphs of previous generations are not found
+  // anymore (their slots are kept until clear()).
+  void invalidate() { m_generation.fetch_add(1, std::memory_order_acq_rel); }
+
+  // Returns nullptr if the glyph is not in the cache yet.
+  const RasterGlyph* find(const FT_UInt glyphIndex, const int subpixel) const
+  {
+    const uint64_t key = makeKey(glyphIndex, subpixel, generation());
+    for (size_t i = 0, j = hash(key); i < m_capacity; ++i, j = (j + 1) & (m_capacity - 1)) {
+      const uint64_t slotKey = m_slots[j].key.load(std::memory_order_acquire);
+      if (slotKey == key)
+        // Can be nullptr if the glyph is being inserted right now
+        return m_slots[j].glyph.load(std::memory_order_acquire);
+      if (slotKey == kEmpty)
+        break;
+    }
+    return nullptr;
+  }
+
+  // Inserts the glyph and takes its ownership. Returns false (and
+  // deletes the glyph) if the glyph was already in the cache or the
+  // cache is full.
+  bool insert(std::unique_ptr<RasterGlyph>&& glyph)
+  {
+    const uint64_t key = makeKey(glyph->glyphIndex, glyph->subpixel, glyph->generation);
+    for (size_t i = 0, j = hash(key); i < m_capacity; ++i, j = (j + 1) & (m_capacity - 1)) {
+      uint64_t slotKey = kEmpty;
+      if (m_slots[j].key.compare_exchange_strong(slotKey, key, std::memory_order_acq_rel)) {
+        m_slots[j].glyph.store(glyph.release(), std::memory_order_release);
+        return true;
+      }
+      if (slotKey == key)
+        return false;
+    }
+    return false;
+  }
+
+  // Not thread-safe, no other thread can use the cache in the
+  // meantime.
+  void clear()
+  {
+    for (size_t i = 0; i < m_capacity; ++i) {
+      delete m_slots[i].glyph.exchange(nullptr);
+      m_slots[i].key = kEmpty;
+    }
+  }
+
+private:
+  static constexpr uint64_t kEmpty = 0;
+
+  struct Slot {
+    std::atomic<uint64_t> key = kEmpty;
+    std::atomic<RasterGlyph*> glyph = nullptr;
+  };
+
+  static uint64_t makeKey(const FT_UInt glyphIndex, const int subpixel, const uint32_t generation)
+  {
+    // 24 bits of generation, 32 bits of glyph index, and 8 bits of
+    // subpixel step
+    const uint64_t key = (uint64_t(generation & 0xffffff) << 40) | (uint64_t(glyphIndex) << 8) |
+                         uint64_t(subpixel & 0xff);
+    return key + 1; // +1 because 0 is kEmpty
+  }
+
+  size_t hash(uint64_t key) const
+  {
+    key *= 0x9E3779B97F4A7C15ull;
+    return size_t(key >> 32) & (m_capacity - 1);
+  }
+
+  size_t m_capacity;
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint32_t> m_generation = 0;
+
+  DISABLE_COPYING(ConcurrentGlyphCache);
+};
+
+} // namespace ft
+
+#endif
@@ -0,0 +1,118 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "ft/concurrent_glyph_cache.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ft;
+
+static std::unique_ptr<RasterGlyph> make_glyph(FT_UInt glyphIndex, int subpixel = 0)
+{
+  auto glyph = std::make_unique<RasterGlyph>();
+  glyph->glyphIndex = glyphIndex;
+  glyph->subpixel = subpixel;
+  glyph->left = int(glyphIndex);
+  return glyph;
+}
+
+TEST(ConcurrentGlyphCache, InsertFind)
+{
+  ConcurrentGlyphCache cache(100);
+  EXPECT_EQ(128, cache.capacity());
+  EXPECT_EQ(nullptr, cache.find(1, 0));
+
+  EXPECT_TRUE(cache.insert(make_glyph(1)));
+  EXPECT_TRUE(cache.insert(make_glyph(1, 2)));
+  EXPECT_FALSE(cache.insert(make_glyph(1)));
+
+  ASSERT_NE(nullptr, cache.find(1, 0));
+  EXPECT_EQ(0, cache.find(1, 0)->subpixel);
+  ASSERT_NE(nullptr, cache.find(1, 2));
+  EXPECT_EQ(2, cache.find(1, 2)->subpixel);
+  EXPECT_EQ(nullptr, cache.find(1, 1));
+  EXPECT_EQ(nullptr, cache.find(2, 0));
+
+  cache.clear();
+  EXPECT_EQ(nullptr, cache.find(1, 0));
+  EXPECT_TRUE(cache.insert(make_glyph(1)));
+}
+
+TEST(ConcurrentGlyphCache, Invalidate)
+{
+  ConcurrentGlyphCache cache(100);
+  EXPECT_TRUE(cache.insert(make_glyph(1)));
+  const uint32_t oldGeneration = cache.generation();
+
+  cache.invalidate();
+  EXPECT_NE(oldGeneration, cache.generation());
+  EXPECT_EQ(nullptr, cache.find(1, 0));
+
+  // A glyph rasterized before the invalidation is not found
+  auto oldGlyph = make_glyph(2);
+  oldGlyph->generation = oldGeneration;
+  EXPECT_TRUE(cache.insert(std::move(oldGlyph)));
+  EXPECT_EQ(nullptr, cache.find(2, 0));
+
+  auto glyph = make_glyph(1);
+  glyph->generation = cache.generation();
+  EXPECT_TRUE(cache.insert(std::move(glyph)));
+  ASSERT_NE(nullptr, cache.find(1, 0));
+  EXPECT_EQ(cache.generation(), cache.find(1, 0)->generation);
+}
+
+TEST(ConcurrentGlyphCache, Full)
+{
+  ConcurrentGlyphCache cache(4);
+  for (FT_UInt i = 0; i < 4; ++i)
+    EXPECT_TRUE(cache.insert(make_glyph(i)));
+  EXPECT_FALSE(cache.insert(make_glyph(4)));
+  for (FT_UInt i = 0; i < 4; ++i)
+    EXPECT_NE(nullptr, cache.find(i, 0));
+  EXPECT_EQ(nullptr, cache.find(4, 0));
+}
+
+TEST(ConcurrentGlyphCache, ParallelInsert)
+{
+  constexpr int kGlyphs = 2000;
+  constexpr int kThreads = 8;
+  ConcurrentGlyphCache cache(kGlyphs * 2);
+  std::atomic<int> inserted(0);
+
+  // All threads try to insert the same glyphs
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&cache, &inserted, t] {
+      for (int i = 0; i < kGlyphs; ++i) {
+        const FT_UInt glyph = FT_UInt((i + t * 97) % kGlyphs);
+        if (cache.insert(make_glyph(glyph)))
+          ++inserted;
+        const RasterGlyph* found = cache.find(glyph, 0);
+        if (found) {
+          EXPECT_EQ(int(glyph), found->left);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(kGlyphs, inserted);
+  for (int i = 0; i < kGlyphs; ++i) {
+    ASSERT_NE(nullptr, cache.find(i, 0));
+    EXPECT_EQ(i, cache.find(i, 0)->left);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
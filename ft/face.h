@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2016-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,12 +11,34 @@
 
 #include "base/debug.h"
 #include "base/disable_copying.h"
+#include "base/ints.h"
+#include "ft/color_glyph.h"
+#include "ft/concurrent_glyph_cache.h"
 #include "ft/freetype_headers.h"
 
+#include <cmath>
 #include <map>
+#include <utility>
 
 namespace ft {
 
+// Number of horizontal subpixel positions in which glyphs are
+// rasterized when subpixel positioning is enabled.
+constexpr int kSubpixelSteps = 4;
+
+// Splits the "x" pen position in an integer part ("pixelX") and the
+// nearest subpixel step (from 0 to kSubpixelSteps-1).
+inline int subpixel_step(const double x, double& pixelX)
+{
+  pixelX = std::floor(x);
+  int step = int(std::round((x - pixelX) * kSubpixelSteps));
+  if (step == kSubpixelSteps) {
+    step = 0;
+    pixelX += 1.0;
+  }
+  return step;
+}
+
 struct Glyph {
   FT_UInt glyph_index;
   FT_Glyph ft_glyph;
@@ -34,16 +56,48 @@ class FaceFT {
 public:
   typedef ft::Glyph Glyph;
 
-  FaceFT(FT_Face face) : m_face(face) {}
+  // Each FaceFT uses its own FT_Size, so one FT_Face can be shared
+  // by several FaceFT with different sizes (see Lib::openShared()).
+  FaceFT(FT_Face face)
+    : m_face(face)
+    , m_size(nullptr)
+    , m_antialias(true)
+    , m_subpixelPositioning(false)
+  {
+    if (m_face && FT_New_Size(m_face, &m_size) == 0)
+      FT_Activate_Size(m_size);
+    else
+      m_size = nullptr;
+  }
 
   ~FaceFT()
   {
-    if (m_face)
+    if (m_face) {
+      if (m_size)
+        FT_Done_Size(m_size);
       FT_Done_Face(m_face);
+    }
   }
 
-  operator FT_Face() { return m_face; }
-  FT_Face operator->() { return m_face; }
+  operator FT_Face()
+  {
+    activateSize();
+    return m_face;
+  }
+
+  FT_Face operator->()
+  {
+    activateSize();
+    return m_face;
+  }
+
+  // Makes the FT_Size of this FaceFT the active one of the FT_Face,
+  // it must be called before loading glyphs if the face is shared.
+  void activateSize() const
+  {
+    if (m_size && m_face->size != m_size)
+      FT_Activate_Size(m_size);
+  }
 
   bool isValid() const { return (m_face != nullptr); }
 
@@ -55,36 +109,45 @@ public:
     m_cache.invalidate();
   }
 
-  void setSize(int size)
+  // Subpixel positioning is used only for antialiased glyphs (glyph
+  // variants are cached for each subpixel step, see subpixel_step()).
+  // Color glyphs are bitmaps/layers that cannot be translated, so
+  // they are always drawn in integer positions.
+  bool subpixelPositioning() const
   {
-    FT_Set_Pixel_Sizes(m_face, size, size);
-    m_cache.invalidate();
+    return m_subpixelPositioning && m_antialias && !hasColorGlyphs();
   }
+  void setSubpixelPositioning(bool state) { m_subpixelPositioning = state; }
 
-  double height() const
-  {
-    FT_Size_Metrics* metrics = &m_face->size->metrics;
-    double em_size = 1.0 * m_face->units_per_EM;
-    double y_scale = metrics->y_ppem / em_size;
-    return int(m_face->height * y_scale) - 1;
-  }
+  // True if the face has color glyphs (CBDT/sbix bitmaps or COLR
+  // layers), which are loaded as FT_PIXEL_MODE_BGRA bitmaps.
+  bool hasColorGlyphs() const { return (m_face && FT_HAS_COLOR(m_face)); }
 
-  double ascender() const
-  {
-    FT_Size_Metrics* metrics = &m_face->size->metrics;
-    double em_size = 1.0 * m_face->units_per_EM;
-    double y_scale = metrics->y_ppem / em_size;
-    return int(m_face->ascender * y_scale);
-  }
+  // Scale applied to the glyphs of the selected bitmap strike (1.0
+  // for scalable fonts).
+  double bitmapScale() const { return m_bitmapScale; }
 
-  double descender() const
+  void setSize(int size)
   {
-    FT_Size_Metrics* metrics = &m_face->size->metrics;
-    double em_size = 1.0 * m_face->units_per_EM;
-    double y_scale = metrics->y_ppem / em_size;
-    return int(m_face->descender * y_scale);
+    activateSize();
+    // Fonts with bitmap strikes only (e.g. emoji fonts) cannot be
+    // rasterized in any size, so we use the closest strike and its
+    // bitmaps are scaled (once, when they are cached).
+    if (!FT_IS_SCALABLE(m_face) && FT_HAS_FIXED_SIZES(m_face)) {
+      m_bitmapScale = select_bitmap_strike(m_face, size);
+    }
+    else {
+      FT_Set_Pixel_Sizes(m_face, size, size);
+      m_bitmapScale = 1.0;
+    }
+    m_cache.setBitmapScale(m_bitmapScale);
+    m_cache.invalidate();
   }
 
+  double height() const { return int(m_face->height * yScale()) - 1; }
+  double ascender() const { return int(m_face->ascender * yScale()); }
+  double descender() const { return int(m_face->descender * yScale()); }
+
   bool hasCodePoint(int codepoint) const
   {
     if (m_face) {
@@ -94,17 +157,55 @@ public:
     return false;
   }
 
+  // Calls f(codepoint) for each code point in the current charmap.
+  template<typename Callback>
+  void forEachCodePoint(Callback&& f) const
+  {
+    if (!m_face)
+      return;
+
+    FT_UInt glyphIndex;
+    FT_ULong codepoint = FT_Get_First_Char(m_face, &glyphIndex);
+    while (glyphIndex != 0) {
+      f(int(codepoint));
+      codepoint = FT_Get_Next_Char(m_face, codepoint, &glyphIndex);
+    }
+  }
+
   Cache& cache() { return m_cache; }
 
 protected:
+  const FT_Size_Metrics* sizeMetrics() const
+  {
+    return (m_size ? &m_size->metrics : &m_face->size->metrics);
+  }
+
+  // Pixels per font unit
+  double yScale() const
+  {
+    const FT_Size_Metrics* metrics = sizeMetrics();
+    double em_size = 1.0 * m_face->units_per_EM;
+    return metrics->y_ppem * m_bitmapScale / em_size;
+  }
+
   FT_Face m_face;
+  FT_Size m_size;
   bool m_antialias;
+  bool m_subpixelPositioning;
+  double m_bitmapScale = 1.0;
   Cache m_cache;
 
 private:
   DISABLE_COPYING(FaceFT);
 };
 
+// Number of glyphs found in a glyph cache (hits) or loaded/rasterized
+// (misses), e.g. to measure how warm the cache is in benchmarks.
+struct GlyphCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
 class NoCache {
 public:
   void invalidate()
@@ -112,21 +213,42 @@ public:
     // Do nothing
   }
 
+  // Scale of color bitmaps (see FaceFT::bitmapScale()).
+  void setBitmapScale(double scale) { m_bitmapScale = scale; }
+
   FT_UInt getGlyphIndex(FT_Face face, int charCode) { return FT_Get_Char_Index(face, charCode); }
 
-  Glyph* loadGlyph(FT_Face face, FT_UInt glyphIndex, bool antialias)
+  // Loads the glyph translated "subpixel" steps to the right (to
+  // draw it later in a fractional x position).
+  Glyph* loadGlyph(FT_Face face, FT_UInt glyphIndex, bool antialias, int subpixel = 0)
   {
-    FT_Error err = FT_Load_Glyph(
-      face,
-      glyphIndex,
-      FT_LOAD_RENDER |
-        // TODO Check if we can render correctly th embedded bitmaps
-        //      in the future removing FT_LOAD_NO_BITMAP for fonts
-        //      like Calibri, Cambria, Monaco, etc.
-        (antialias ? FT_LOAD_TARGET_NORMAL | FT_LOAD_NO_BITMAP : FT_LOAD_TARGET_MONO));
+    FT_Int32 flags = (subpixel ? FT_LOAD_DEFAULT : FT_LOAD_RENDER);
+    // Color glyphs (emoji) are loaded as BGRA bitmaps, from the
+    // embedded bitmaps (CBDT/sbix) or rendering the COLR layers.
+    if (antialias && FT_HAS_COLOR(face))
+      flags |= FT_LOAD_TARGET_NORMAL | FT_LOAD_COLOR;
+    // TODO Check if we can render correctly th embedded bitmaps
+    //      in the future removing FT_LOAD_NO_BITMAP for fonts
+    //      like Calibri, Cambria, Monaco, etc.
+    else if (antialias)
+      flags |= FT_LOAD_TARGET_NORMAL | FT_LOAD_NO_BITMAP;
+    else
+      flags |= FT_LOAD_TARGET_MONO;
+
+    FT_Error err = FT_Load_Glyph(face, glyphIndex, flags);
     if (err)
       return nullptr;
 
+    if (subpixel) {
+      if (face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        FT_Outline_Translate(&face->glyph->outline, subpixel * 64 / kSubpixelSteps, 0);
+
+      err = FT_Render_Glyph(face->glyph,
+                            (antialias ? FT_RENDER_MODE_NORMAL : FT_RENDER_MODE_MONO));
+      if (err)
+        return nullptr;
+    }
+
     FT_Glyph ft_glyph;
     err = FT_Get_Glyph(face->glyph, &ft_glyph);
     if (err)
@@ -134,16 +256,35 @@ public:
 
     if (ft_glyph->format != FT_GLYPH_FORMAT_BITMAP) {
       err = FT_Glyph_To_Bitmap(&ft_glyph, FT_RENDER_MODE_NORMAL, 0, 1);
-      if (!err) {
+      if (err) {
         FT_Done_Glyph(ft_glyph);
         return nullptr;
       }
     }
 
     m_glyph.ft_glyph = ft_glyph;
-    m_glyph.bearingX = face->glyph->metrics.horiBearingX / 64.0;
+    // The left side of the rendered bitmap is used in all subpixel
+    // steps (the bitmap of a translated glyph can start in the next
+    // pixel), as horiBearingX is rounded in a different way and the
+    // glyph would jump when the step changes.
+    m_glyph.bearingX = face->glyph->bitmap_left;
     m_glyph.bearingY = face->glyph->metrics.horiBearingY / 64.0;
 
+    // Bitmaps of a strike are scaled to the requested size
+    FT_BitmapGlyph bitmapGlyph = FT_BitmapGlyph(ft_glyph);
+    if (m_bitmapScale != 1.0 && bitmapGlyph->bitmap.pixel_mode == FT_PIXEL_MODE_BGRA) {
+      if (!scale_color_bitmap(face->glyph->library, &bitmapGlyph->bitmap, m_bitmapScale)) {
+        FT_Done_Glyph(ft_glyph);
+        return nullptr;
+      }
+      bitmapGlyph->left = int(std::lround(bitmapGlyph->left * m_bitmapScale));
+      bitmapGlyph->top = int(std::lround(bitmapGlyph->top * m_bitmapScale));
+      ft_glyph->advance.x = FT_Pos(ft_glyph->advance.x * m_bitmapScale);
+      ft_glyph->advance.y = FT_Pos(ft_glyph->advance.y * m_bitmapScale);
+      m_glyph.bearingX *= m_bitmapScale;
+      m_glyph.bearingY *= m_bitmapScale;
+    }
+
     return &m_glyph;
   }
 
@@ -155,6 +296,7 @@ public:
 
 private:
   Glyph m_glyph;
+  double m_bitmapScale = 1.0;
 };
 
 class SimpleCache : public NoCache {
@@ -169,15 +311,39 @@ public:
     }
 
     m_glyphMap.clear();
+
+    // Other threads can be using the shared cache, so it cannot be
+    // cleared
+    if (m_sharedCache)
+      m_sharedCache->invalidate();
   }
 
-  Glyph* loadGlyph(FT_Face face, FT_UInt glyphIndex, bool antialias)
+  // Glyphs rasterized by other threads (e.g. with GlyphRasterizer)
+  // are searched in this cache before loading them. The shared cache
+  // is invalidated when this cache is invalidated.
+  void setSharedCache(ConcurrentGlyphCache* sharedCache) { m_sharedCache = sharedCache; }
+
+  Glyph* loadGlyph(FT_Face face, FT_UInt glyphIndex, bool antialias, int subpixel = 0)
   {
-    auto it = m_glyphMap.find(glyphIndex);
-    if (it != m_glyphMap.end())
+    const GlyphKey key(glyphIndex, subpixel);
+    auto it = m_glyphMap.find(key);
+    if (it != m_glyphMap.end()) {
+      ++m_stats.hits;
       return it->second;
+    }
+
+    if (m_sharedCache) {
+      if (const RasterGlyph* raster = m_sharedCache->find(glyphIndex, subpixel)) {
+        if (Glyph* newGlyph = copyRasterGlyph(face, raster)) {
+          m_glyphMap[key] = newGlyph;
+          ++m_stats.hits;
+          return newGlyph;
+        }
+      }
+    }
 
-    Glyph* glyph = NoCache::loadGlyph(face, glyphIndex, antialias);
+    ++m_stats.misses;
+    Glyph* glyph = NoCache::loadGlyph(face, glyphIndex, antialias, subpixel);
     if (!glyph)
       return nullptr;
 
@@ -189,7 +355,7 @@ public:
     Glyph* newGlyph = new Glyph(*glyph);
     newGlyph->ft_glyph = new_ft_glyph;
 
-    m_glyphMap[glyphIndex] = newGlyph;
+    m_glyphMap[key] = newGlyph;
     FT_Done_Glyph(glyph->ft_glyph);
 
     return newGlyph;
@@ -200,8 +366,44 @@ public:
     // Do nothing
   }
 
+  // Glyphs rasterized by other threads (shared cache) count as hits.
+  // The stats are not reset when the cache is invalidated.
+  const GlyphCacheStats& stats() const { return m_stats; }
+  void resetStats() { m_stats = GlyphCacheStats(); }
+
 private:
-  std::map<FT_UInt, Glyph*> m_glyphMap;
+  // Creates a FT_Glyph in the library of this face with a copy of
+  // the bitmap rasterized by other thread.
+  Glyph* copyRasterGlyph(FT_Face face, const RasterGlyph* raster)
+  {
+    FT_Library library = face->glyph->library;
+    FT_Glyph ft_glyph = nullptr;
+    if (FT_New_Glyph(library, FT_GLYPH_FORMAT_BITMAP, &ft_glyph) != 0)
+      return nullptr;
+
+    FT_BitmapGlyph bitmapGlyph = FT_BitmapGlyph(ft_glyph);
+    if (FT_Bitmap_Copy(library, &raster->bitmap, &bitmapGlyph->bitmap) != 0) {
+      FT_Done_Glyph(ft_glyph);
+      return nullptr;
+    }
+    bitmapGlyph->left = raster->left;
+    bitmapGlyph->top = raster->top;
+    ft_glyph->advance = raster->advance;
+
+    Glyph* newGlyph = new Glyph();
+    newGlyph->glyph_index = raster->glyphIndex;
+    newGlyph->ft_glyph = ft_glyph;
+    newGlyph->bearingX = raster->bearingX;
+    newGlyph->bearingY = raster->bearingY;
+    return newGlyph;
+  }
+
+  // Glyph index + subpixel step
+  using GlyphKey = std::pair<FT_UInt, int>;
+
+  std::map<GlyphKey, Glyph*> m_glyphMap;
+  ConcurrentGlyphCache* m_sharedCache = nullptr;
+  GlyphCacheStats m_stats;
 };
 
 } // namespace ft
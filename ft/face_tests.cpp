@@ -0,0 +1,54 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/fs.h"
+#include "ft/face.h"
+#include "ft/lib.h"
+
+using namespace ft;
+
+static const char* kFontFile = LAF_EXAMPLES_DATA_DIR "/DejaVuSans-Text.ttf";
+
+TEST(Face, SubpixelOrigin)
+{
+  if (!base::is_file(kFontFile))
+    GTEST_SKIP() << "Font not found: " << kFontFile;
+
+  Lib lib;
+  FaceFT<NoCache> face(lib.open(kFontFile));
+  ASSERT_TRUE(face.isValid());
+
+  for (const int size : { 9, 12, 16, 23 }) {
+    face.setSize(size);
+    for (const int chr : { 'A', 'a', 'W', 'g', 'i', 'j', '1', '/' }) {
+      const FT_UInt glyphIndex = face.cache().getGlyphIndex(face, chr);
+      ASSERT_NE(0, glyphIndex);
+
+      // The left side of the glyph moves to the right (at most one
+      // pixel) when the subpixel step increases
+      double bearingX[kSubpixelSteps];
+      for (int step = 0; step < kSubpixelSteps; ++step) {
+        Glyph* glyph = face.cache().loadGlyph(face, glyphIndex, true, step);
+        ASSERT_NE(nullptr, glyph);
+        bearingX[step] = glyph->bearingX;
+        // Same as the bitmap position in all steps
+        EXPECT_EQ(FT_BitmapGlyph(glyph->ft_glyph)->left, bearingX[step]);
+        face.cache().doneGlyph(glyph);
+      }
+      for (int step = 1; step < kSubpixelSteps; ++step)
+        EXPECT_LE(bearingX[step - 1], bearingX[step]) << "size=" << size << " chr=" << chr;
+      EXPECT_LE(bearingX[kSubpixelSteps - 1] - bearingX[0], 1.0);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
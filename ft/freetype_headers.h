@@ -1,4 +1,5 @@
 // LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,7 +10,11 @@
 #pragma once
 
 #include <ft2build.h>
+#include FT_BITMAP_H
 #include FT_GLYPH_H
 #include FT_FREETYPE_H
+#include FT_OUTLINE_H
+#include FT_SIZES_H
+#include FT_TRUETYPE_TABLES_H
 
 #endif
@@ -0,0 +1,103 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "ft/glyph_rasterizer.h"
+
+#include "base/thread_pool.h"
+#include "ft/face.h"
+#include "ft/thread_face.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace ft {
+
+namespace {
+
+// Number of glyphs rasterized by each task sent to the thread pool.
+constexpr int kGlyphsPerTask = 32;
+
+// Copies the glyph loaded with NoCache::loadGlyph() so it can be used
+// after the FT_Library of this thread is destroyed.
+std::unique_ptr<RasterGlyph> make_raster_glyph(const Glyph* glyph,
+                                               const FT_UInt glyphIndex,
+                                               const int subpixel,
+                                               const uint32_t generation)
+{
+  const FT_BitmapGlyph bitmapGlyph = FT_BitmapGlyph(glyph->ft_glyph);
+  const FT_Bitmap& src = bitmapGlyph->bitmap;
+  const int pitch = std::abs(src.pitch);
+
+  auto raster = std::make_unique<RasterGlyph>();
+  raster->glyphIndex = glyphIndex;
+  raster->subpixel = subpixel;
+  raster->generation = generation;
+  raster->left = bitmapGlyph->left;
+  raster->top = bitmapGlyph->top;
+  raster->bearingX = glyph->bearingX;
+  raster->bearingY = glyph->bearingY;
+  raster->advance = glyph->ft_glyph->advance;
+
+  raster->bitmap = src;
+  raster->bitmap.pitch = pitch;
+  raster->buffer.resize(pitch * src.rows);
+  if (!raster->buffer.empty()) {
+    for (unsigned int y = 0; y < src.rows; ++y) {
+      const uint8_t* srcRow = (src.pitch >= 0 ? src.buffer + y * pitch :
+                                                src.buffer + (src.rows - 1 - y) * pitch);
+      std::memcpy(&raster->buffer[y * pitch], srcRow, pitch);
+    }
+  }
+  raster->bitmap.buffer = raster->buffer.data();
+  return raster;
+}
+
+} // anonymous namespace
+
+GlyphRasterizer::GlyphRasterizer(base::thread_pool& pool) : m_pool(pool)
+{
+}
+
+int GlyphRasterizer::rasterize(const std::string& filename,
+                               const int faceIndex,
+                               const int size,
+                               const bool antialias,
+                               const std::vector<FT_UInt>& glyphs,
+                               ConcurrentGlyphCache& cache)
+{
+  using Face = FaceFT<NoCache>;
+  std::atomic<int> inserted(0);
+
+  // Glyphs are rasterized with the current settings of the font
+  const uint32_t generation = cache.generation();
+
+  const int n = int(glyphs.size());
+  base::for_each_task(&m_pool, n, kGlyphsPerTask, [&](const int begin, const int end) {
+    Face& face = get_thread_face<Face>(filename, faceIndex, size, antialias, false);
+    if (!face.isValid())
+      return;
+
+    for (int i = begin; i < end; ++i) {
+      if (cache.find(glyphs[i], 0))
+        continue;
+
+      Glyph* glyph = face.cache().loadGlyph(face, glyphs[i], antialias);
+      if (!glyph)
+        continue;
+
+      auto raster = make_raster_glyph(glyph, glyphs[i], 0, generation);
+      face.cache().doneGlyph(glyph);
+
+      if (cache.insert(std::move(raster)))
+        ++inserted;
+    }
+  });
+  return inserted;
+}
+
+} // namespace ft
@@ -0,0 +1,48 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef FT_GLYPH_RASTERIZER_H_INCLUDED
+#define FT_GLYPH_RASTERIZER_H_INCLUDED
+#pragma once
+
+#include "ft/concurrent_glyph_cache.h"
+
+#include <string>
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace ft {
+
+// Rasterizes glyphs in parallel using the threads of a pool. A
+// FT_Face cannot be used from two threads at the same time, so each
+// thread opens its own FT_Library/face for each font file/size (see
+// get_thread_face()). A few glyphs are rasterized in the calling
+// thread.
+class GlyphRasterizer {
+public:
+  explicit GlyphRasterizer(base::thread_pool& pool);
+
+  // Rasterizes the given glyphs of the face "faceIndex" of the font
+  // file with the given size and inserts them in the cache (glyphs already in the cache are
+  // skipped). Waits until all glyphs are rasterized. Returns the
+  // number of inserted glyphs.
+  int rasterize(const std::string& filename,
+                int faceIndex,
+                int size,
+                bool antialias,
+                const std::vector<FT_UInt>& glyphs,
+                ConcurrentGlyphCache& cache);
+
+private:
+  base::thread_pool& m_pool;
+};
+
+} // namespace ft
+
+#endif
@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (c) 2020 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -31,7 +31,12 @@ public:
       hb_font_destroy(m_font);
   }
 
-  hb_font_t* font() const { return m_font; }
+  hb_font_t* font() const
+  {
+    // HarfBuzz uses the active size of the FT_Face
+    this->activateSize();
+    return m_font;
+  }
 
 private:
   hb_font_t* m_font;
@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (c) 2020-2022 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,7 @@
 #include "base/utf8_decode.h"
 #include "ft/hb_face.h"
 
+#include <cmath>
 #include <vector>
 
 namespace ft {
@@ -19,14 +20,28 @@ namespace ft {
 template<typename HBFace>
 class HBShaper {
 public:
-  HBShaper(HBFace& face, const std::string& str) : m_face(face)
+  // The "buf" and "chrBuf" buffers can be given to re-use them
+  // between several strings (e.g. one pair of buffers per thread),
+  // in other case they are created/destroyed for this string only.
+  HBShaper(HBFace& face,
+           const std::string& str,
+           hb_buffer_t* buf = nullptr,
+           hb_buffer_t* chrBuf = nullptr)
+    : m_face(face)
   {
     base::utf8_decode decode(str);
     if (decode.is_end())
       return;
 
-    hb_buffer_t* buf = hb_buffer_create();
-    hb_buffer_t* chrBuf = hb_buffer_create();
+    const bool ownBuffers = (!buf || !chrBuf);
+    if (ownBuffers) {
+      buf = hb_buffer_create();
+      chrBuf = hb_buffer_create();
+    }
+    else {
+      hb_buffer_reset(buf);
+      hb_buffer_reset(chrBuf);
+    }
     hb_script_t script = HB_SCRIPT_UNKNOWN;
 
     const auto begin = str.begin();
@@ -53,8 +68,10 @@ public:
     }
     addBuffer(buf, script);
 
-    hb_buffer_destroy(buf);
-    hb_buffer_destroy(chrBuf);
+    if (ownBuffers) {
+      hb_buffer_destroy(buf);
+      hb_buffer_destroy(chrBuf);
+    }
   }
 
   int next()
@@ -70,6 +87,8 @@ public:
 
   unsigned int glyphIndex() const { return m_glyphInfo[m_index].codepoint; }
 
+  const hb_glyph_position_t& glyphPosition() const { return m_glyphPos[m_index]; }
+
   void glyphOffsetXY(Glyph* glyph)
   {
     glyph->x += m_glyphPos[m_index].x_offset / 64.0;
@@ -110,6 +129,19 @@ private:
       m_glyphInfo[start + i] = info[i];
       m_glyphPos[start + i] = pos[i];
     }
+
+    // HarfBuzz positions glyphs using the size of the bitmap strike,
+    // so we scale them in the same way as the glyph bitmaps.
+    const double scale = m_face.bitmapScale();
+    if (scale != 1.0) {
+      for (unsigned int i = 0; i < count; ++i) {
+        hb_glyph_position_t& p = m_glyphPos[start + i];
+        p.x_advance = hb_position_t(std::lround(p.x_advance * scale));
+        p.y_advance = hb_position_t(std::lround(p.y_advance * scale));
+        p.x_offset = hb_position_t(std::lround(p.x_offset * scale));
+        p.y_offset = hb_position_t(std::lround(p.y_offset * scale));
+      }
+    }
   }
 
   HBFace& m_face;
@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (c) 2020  Igara Studio S.A.
+// Copyright (c) 2020-2025  Igara Studio S.A.
 // Copyright (c) 2016-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -25,7 +25,32 @@ Lib::~Lib()
     FT_Done_FreeType(m_ft);
 }
 
-FT_Face Lib::open(const std::string& filename)
+FT_Face Lib::open(const std::string& filename, const int faceIndex)
+{
+  return openFace(filename, faceIndex);
+}
+
+FT_Face Lib::openShared(const std::string& filename, const int faceIndex)
+{
+  const FaceKey key(filename, faceIndex);
+  auto it = m_sharedFaces.find(key);
+  if (it != m_sharedFaces.end()) {
+    FT_Reference_Face(it->second);
+    return it->second;
+  }
+
+  FT_Face face = openFace(filename, faceIndex);
+  if (face) {
+    // Removes the face from m_sharedFaces when its last reference is
+    // released with FT_Done_Face()
+    face->generic.data = this;
+    face->generic.finalizer = &Lib::onSharedFaceDestroyed;
+    m_sharedFaces[key] = face;
+  }
+  return face;
+}
+
+FT_Face Lib::openFace(const std::string& filename, const int faceIndex)
 {
   FT_Stream stream = ft::open_stream(filename);
   FT_Open_Args args;
@@ -36,10 +61,23 @@ FT_Face Lib::open(const std::string& filename)
   LOG(VERBOSE, "FT: Loading font '%s'\n", filename.c_str());
 
   FT_Face face = nullptr;
-  const FT_Error err = FT_Open_Face(m_ft, &args, 0, &face);
+  const FT_Error err = FT_Open_Face(m_ft, &args, faceIndex, &face);
   if (!err)
     FT_Select_Charmap(face, FT_ENCODING_UNICODE);
   return face;
 }
 
+// static
+void Lib::onSharedFaceDestroyed(void* object)
+{
+  FT_Face face = (FT_Face)object;
+  Lib* lib = (Lib*)face->generic.data;
+  for (auto it = lib->m_sharedFaces.begin(); it != lib->m_sharedFaces.end(); ++it) {
+    if (it->second == face) {
+      lib->m_sharedFaces.erase(it);
+      break;
+    }
+  }
+}
+
 } // namespace ft
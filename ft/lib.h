@@ -1,4 +1,5 @@
 // LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2016-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,7 +12,9 @@
 #include "base/disable_copying.h"
 #include "ft/freetype_headers.h"
 
+#include <map>
 #include <string>
+#include <utility>
 
 namespace ft {
 
@@ -22,10 +25,23 @@ public:
 
   operator FT_Library() { return m_ft; }
 
-  FT_Face open(const std::string& filename);
+  FT_Face open(const std::string& filename, int faceIndex = 0);
+
+  // Returns the face already opened with openShared() for the same
+  // file and face index (increasing its reference count with
+  // FT_Reference_Face), or opens a new one. The caller must release
+  // the face with FT_Done_Face() as usual. Users of the same face
+  // must use their own FT_Size (FaceFT does this).
+  FT_Face openShared(const std::string& filename, int faceIndex = 0);
 
 private:
+  FT_Face openFace(const std::string& filename, int faceIndex);
+  static void onSharedFaceDestroyed(void* face);
+
+  using FaceKey = std::pair<std::string, int>;
+
   FT_Library m_ft;
+  std::map<FaceKey, FT_Face> m_sharedFaces;
 
   DISABLE_COPYING(Lib);
 };
@@ -0,0 +1,188 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include "ft/sdf.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ft {
+
+namespace {
+
+// Value used for pixels that are not features in distance transforms
+// (a big value instead of infinity simplifies the calculations).
+constexpr double kFar = 1e20;
+
+// 1D squared Euclidean distance transform of "f" (Felzenszwalb &
+// Huttenlocher, "Distance Transforms of Sampled Functions"). "d",
+// "v", and "z" are temporary buffers of n, n, and n+1 elements.
+void edt_1d(double* f, const int n, const int stride, double* d, int* v, double* z)
+{
+  int k = 0;
+  v[0] = 0;
+  z[0] = -kFar;
+  z[1] = kFar;
+
+  for (int q = 1; q < n; ++q) {
+    double s;
+    while (true) {
+      const int p = v[k];
+      s = ((f[q * stride] + q * q) - (f[p * stride] + p * p)) / (2.0 * (q - p));
+      if (s <= z[k] && k > 0)
+        --k;
+      else
+        break;
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = kFar;
+  }
+
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < q)
+      ++k;
+    const int p = v[k];
+    d[q] = double(q - p) * (q - p) + f[p * stride];
+  }
+
+  for (int q = 0; q < n; ++q)
+    f[q * stride] = d[q];
+}
+
+// 2D squared Euclidean distance transform (in place), pixels with 0
+// are the features and pixels with kFar the background.
+void edt_2d(std::vector<double>& grid, const int w, const int h)
+{
+  const int n = std::max(w, h);
+  std::vector<double> d(n);
+  std::vector<int> v(n);
+  std::vector<double> z(n + 1);
+
+  for (int x = 0; x < w; ++x)
+    edt_1d(&grid[x], h, w, d.data(), v.data(), z.data());
+  for (int y = 0; y < h; ++y)
+    edt_1d(&grid[y * w], w, 1, d.data(), v.data(), z.data());
+}
+
+} // anonymous namespace
+
+void make_sdf(const uint8_t* coverage,
+              const int width,
+              const int height,
+              const int pitch,
+              int spread,
+              SdfGlyph& glyph)
+{
+  // At least one pixel of padding (distances are divided by "spread")
+  spread = std::max(spread, 1);
+
+  const int w = width + 2 * spread;
+  const int h = height + 2 * spread;
+
+  glyph.width = w;
+  glyph.height = h;
+  glyph.spread = spread;
+  glyph.field.resize(w * h);
+
+  auto coverageAt = [=](int x, int y) -> int {
+    x -= spread;
+    y -= spread;
+    if (x < 0 || y < 0 || x >= width || y >= height)
+      return 0;
+    return coverage[y * pitch + x];
+  };
+
+  // Distances to the nearest inside pixel (for outside pixels) and to
+  // the nearest outside pixel (for inside pixels).
+  std::vector<double> toInside(w * h);
+  std::vector<double> toOutside(w * h);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      const bool inside = (coverageAt(x, y) >= 128);
+      toInside[y * w + x] = (inside ? 0.0 : kFar);
+      toOutside[y * w + x] = (inside ? kFar : 0.0);
+    }
+  }
+  edt_2d(toInside, w, h);
+  edt_2d(toOutside, w, h);
+
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      const int i = y * w + x;
+      const int c = coverageAt(x, y);
+      float dist;
+
+      // The edge crosses antialiased pixels, so their coverage is a
+      // better estimation of the distance to the edge.
+      if (c > 0 && c < 255)
+        dist = c / 255.0f - 0.5f;
+      else if (c >= 128)
+        dist = float(std::sqrt(toOutside[i])) - 0.5f;
+      else
+        dist = 0.5f - float(std::sqrt(toInside[i]));
+
+      const float v = 128.0f + dist * 127.0f / spread;
+      glyph.field[i] = uint8_t(std::clamp(v + 0.5f, 0.0f, 255.0f));
+    }
+  }
+}
+
+void render_sdf(const SdfGlyph& glyph,
+                const double scale,
+                std::vector<uint8_t>& mask,
+                gfx::Rect& bounds)
+{
+  if (glyph.field.empty() || scale <= 0.0) {
+    mask.clear();
+    bounds = gfx::Rect();
+    return;
+  }
+
+  const int x0 = int(std::floor(glyph.left * scale));
+  const int y0 = int(std::floor(-glyph.top * scale));
+  const int x1 = int(std::ceil((glyph.left + glyph.width) * scale));
+  const int y1 = int(std::ceil((-glyph.top + glyph.height) * scale));
+  bounds = gfx::Rect(x0, y0, x1 - x0, y1 - y0);
+  mask.resize(bounds.w * bounds.h);
+
+  const int w = glyph.width;
+  const int h = glyph.height;
+  const uint8_t* field = glyph.field.data();
+
+  // Converts field values to coverage in the destination scale
+  const float k = float(glyph.spread * scale / 127.0);
+  const float invScale = float(1.0 / scale);
+
+  for (int y = 0; y < bounds.h; ++y) {
+    // Position in the field (pixel centers)
+    const float fy = (y0 + y + 0.5f) * invScale + float(glyph.top) - 0.5f;
+    const int iy = int(std::floor(fy));
+    const float ty = fy - iy;
+    const int ya = std::clamp(iy, 0, h - 1);
+    const int yb = std::clamp(iy + 1, 0, h - 1);
+    uint8_t* dst = &mask[y * bounds.w];
+
+    for (int x = 0; x < bounds.w; ++x) {
+      const float fx = (x0 + x + 0.5f) * invScale - float(glyph.left) - 0.5f;
+      const int ix = int(std::floor(fx));
+      const float tx = fx - ix;
+      const int xa = std::clamp(ix, 0, w - 1);
+      const int xb = std::clamp(ix + 1, 0, w - 1);
+
+      const float a = field[ya * w + xa] + (field[ya * w + xb] - field[ya * w + xa]) * tx;
+      const float b = field[yb * w + xa] + (field[yb * w + xb] - field[yb * w + xa]) * tx;
+      const float v = a + (b - a) * ty;
+
+      const float cov = std::clamp((v - 128.0f) * k + 0.5f, 0.0f, 1.0f);
+      dst[x] = uint8_t(cov * 255.0f + 0.5f);
+    }
+  }
+}
+
+} // namespace ft
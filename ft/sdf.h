@@ -0,0 +1,106 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef FT_SDF_H_INCLUDED
+#define FT_SDF_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "ft/freetype_headers.h"
+#include "gfx/rect.h"
+
+#include <map>
+#include <vector>
+
+namespace ft {
+
+// Signed distance field of a glyph rasterized at a reference size.
+// It can be rendered at any scale with render_sdf() without
+// rasterizing the glyph again.
+struct SdfGlyph {
+  int width = 0; // Size of the distance field
+  int height = 0;
+  int spread = 0; // Max distance (in reference pixels) stored in the field
+  double left = 0.0; // Position of the field top-left corner relative to
+  double top = 0.0;  // the pen position (like FT_BitmapGlyph left/top)
+  double advance = 0.0;
+
+  // Distances to the glyph edge, 128 is the edge, values > 128 are
+  // inside the glyph, and 127 units are equal to "spread" pixels.
+  std::vector<uint8_t> field;
+};
+
+// Creates the distance field of a 8-bit coverage mask
+// (FT_PIXEL_MODE_GRAY) with "spread" pixels of padding on each side
+// ("spread" values less than 1 are used as 1).
+void make_sdf(const uint8_t* coverage,
+              int width,
+              int height,
+              int pitch,
+              int spread,
+              SdfGlyph& glyph);
+
+// Renders the glyph scaled by "scale" (destination pixels per
+// reference pixel) into an 8-bit coverage mask of bounds.w * bounds.h
+// bytes. "bounds" is relative to the pen position (y-axis pointing
+// down, like draw_text() positions).
+void render_sdf(const SdfGlyph& glyph,
+                double scale,
+                std::vector<uint8_t>& mask,
+                gfx::Rect& bounds);
+
+// Creates distance fields of glyphs on demand. The given face is
+// used only by this cache (its size is changed to the reference
+// size), e.g. a face opened with Lib::openShared().
+template<typename FaceFT>
+class SdfGlyphCache {
+public:
+  SdfGlyphCache(FaceFT& face, const int referenceSize = 64, const int spread = 8)
+    : m_face(face)
+    , m_referenceSize(referenceSize)
+    , m_spread(spread)
+  {
+    m_face.setAntialias(true);
+    m_face.setSize(referenceSize);
+  }
+
+  int referenceSize() const { return m_referenceSize; }
+
+  // Returns nullptr if the glyph cannot be loaded.
+  const SdfGlyph* glyph(const FT_UInt glyphIndex)
+  {
+    auto it = m_glyphs.find(glyphIndex);
+    if (it != m_glyphs.end())
+      return &it->second;
+
+    auto* glyph = m_face.cache().loadGlyph(m_face, glyphIndex, true);
+    if (!glyph)
+      return nullptr;
+
+    const FT_BitmapGlyph bitmapGlyph = FT_BitmapGlyph(glyph->ft_glyph);
+    const FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+
+    SdfGlyph& sdf = m_glyphs[glyphIndex];
+    if (bitmap.pixel_mode == FT_PIXEL_MODE_GRAY)
+      make_sdf(bitmap.buffer, int(bitmap.width), int(bitmap.rows), bitmap.pitch, m_spread, sdf);
+    sdf.left = bitmapGlyph->left - sdf.spread;
+    sdf.top = bitmapGlyph->top + sdf.spread;
+    sdf.advance = glyph->ft_glyph->advance.x / double(1 << 16);
+
+    m_face.cache().doneGlyph(glyph);
+    return &sdf;
+  }
+
+private:
+  FaceFT& m_face;
+  int m_referenceSize;
+  int m_spread;
+  std::map<FT_UInt, SdfGlyph> m_glyphs;
+};
+
+} // namespace ft
+
+#endif
@@ -0,0 +1,129 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "ft/sdf.h"
+
+#include <cstdlib>
+
+using namespace ft;
+
+// A square of 16x16 pixels with antialiased edges at half coverage
+static std::vector<uint8_t> make_square(int& w, int& h)
+{
+  w = h = 18;
+  std::vector<uint8_t> cov(w * h, 0);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      const bool edgeX = (x == 0 || x == w - 1);
+      const bool edgeY = (y == 0 || y == h - 1);
+      cov[y * w + x] = (edgeX && edgeY ? 64 : (edgeX || edgeY ? 128 : 255));
+    }
+  }
+  return cov;
+}
+
+TEST(Sdf, MakeSdf)
+{
+  int w, h;
+  std::vector<uint8_t> cov = make_square(w, h);
+
+  SdfGlyph glyph;
+  make_sdf(cov.data(), w, h, w, 4, glyph);
+  EXPECT_EQ(w + 8, glyph.width);
+  EXPECT_EQ(h + 8, glyph.height);
+  EXPECT_EQ(4, glyph.spread);
+
+  auto at = [&glyph](int x, int y) { return glyph.field[y * glyph.width + x]; };
+  EXPECT_EQ(0, at(0, 0));                                // Far outside
+  EXPECT_EQ(255, at(glyph.width / 2, glyph.height / 2)); // Far inside
+  EXPECT_NEAR(128, at(4, glyph.height / 2), 1);          // Edge
+
+  // Distance decreases from the center to the border
+  for (int x = 1; x <= glyph.width / 2; ++x)
+    EXPECT_GE(at(x, glyph.height / 2), at(x - 1, glyph.height / 2));
+}
+
+TEST(Sdf, ZeroSpread)
+{
+  int w, h;
+  std::vector<uint8_t> cov = make_square(w, h);
+
+  // A spread of 0 is used as 1
+  SdfGlyph glyph;
+  make_sdf(cov.data(), w, h, w, 0, glyph);
+  EXPECT_EQ(1, glyph.spread);
+  EXPECT_EQ(w + 2, glyph.width);
+  EXPECT_EQ(h + 2, glyph.height);
+  EXPECT_EQ(0, glyph.field[0]);
+  EXPECT_EQ(255, glyph.field[(glyph.height / 2) * glyph.width + glyph.width / 2]);
+}
+
+TEST(Sdf, RenderAtReferenceScale)
+{
+  int w, h;
+  std::vector<uint8_t> cov = make_square(w, h);
+
+  SdfGlyph glyph;
+  make_sdf(cov.data(), w, h, w, 4, glyph);
+  glyph.left = -4;
+  glyph.top = h + 4;
+
+  std::vector<uint8_t> mask;
+  gfx::Rect bounds;
+  render_sdf(glyph, 1.0, mask, bounds);
+  EXPECT_EQ(gfx::Rect(-4, -h - 4, w + 8, h + 8), bounds);
+
+  // The rendered mask is similar to the original coverage
+  for (int y = 0; y < bounds.h; ++y) {
+    for (int x = 0; x < bounds.w; ++x) {
+      const int cx = x - 4;
+      const int cy = y - 4;
+      const int expected = (cx >= 0 && cy >= 0 && cx < w && cy < h ? cov[cy * w + cx] : 0);
+      EXPECT_NEAR(expected, mask[y * bounds.w + x], 8) << "x=" << x << " y=" << y;
+    }
+  }
+}
+
+TEST(Sdf, RenderScaled)
+{
+  int w, h;
+  std::vector<uint8_t> cov = make_square(w, h);
+
+  SdfGlyph glyph;
+  make_sdf(cov.data(), w, h, w, 4, glyph);
+
+  for (double scale : { 0.5, 2.0, 3.5 }) {
+    std::vector<uint8_t> mask;
+    gfx::Rect bounds;
+    render_sdf(glyph, scale, mask, bounds);
+    ASSERT_EQ(bounds.w * bounds.h, int(mask.size()));
+
+    // The covered area grows with the square of the scale
+    double area = 0.0;
+    for (uint8_t v : mask)
+      area += v / 255.0;
+    const double expected = 17.0 * 17.0 * scale * scale;
+    EXPECT_NEAR(expected, area, expected * 0.1) << "scale=" << scale;
+  }
+}
+
+TEST(Sdf, EmptyGlyph)
+{
+  SdfGlyph glyph;
+  std::vector<uint8_t> mask(10);
+  gfx::Rect bounds(1, 2, 3, 4);
+  render_sdf(glyph, 2.0, mask, bounds);
+  EXPECT_TRUE(mask.empty());
+  EXPECT_TRUE(bounds.isEmpty());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
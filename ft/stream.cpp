@@ -1,5 +1,5 @@
 // LAF FreeType Wrapper
-// Copyright (c) 2020 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2016-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,13 +9,55 @@
 
 #include "base/debug.h"
 #include "base/file_handle.h"
+#include "base/mapped_file.h"
 
 #include <ft2build.h>
 
-#define STREAM_FILE(stream) ((FILE*)(stream)->descriptor.pointer)
+#include <map>
+#include <memory>
+#include <mutex>
+
+#define STREAM_FILE(stream)        ((FILE*)(stream)->descriptor.pointer)
+#define STREAM_MAPPED_FILE(stream) ((base::MappedFile*)(stream)->descriptor.pointer)
 
 namespace ft {
 
+// Files mapped in memory by open_stream(), so all faces opened on
+// the same file (even from different FT_Library instances/threads)
+// share the same mapping.
+static std::mutex g_mappedFilesMutex;
+static std::map<std::string, std::weak_ptr<base::mapped_file>> g_mappedFiles;
+
+static base::MappedFile get_mapped_file(const std::string& utf8Filename)
+{
+  const std::lock_guard lock(g_mappedFilesMutex);
+
+  base::MappedFile file = g_mappedFiles[utf8Filename].lock();
+  if (!file) {
+    file = base::map_file(utf8Filename);
+    if (file)
+      g_mappedFiles[utf8Filename] = file;
+    else
+      g_mappedFiles.erase(utf8Filename);
+  }
+  return file;
+}
+
+static void ft_mapped_stream_close(FT_Stream stream)
+{
+  // Unmaps the file if this was the last stream using it
+  delete STREAM_MAPPED_FILE(stream);
+  free(stream);
+
+  const std::lock_guard lock(g_mappedFilesMutex);
+  for (auto it = g_mappedFiles.begin(); it != g_mappedFiles.end();) {
+    if (it->second.expired())
+      it = g_mappedFiles.erase(it);
+    else
+      ++it;
+  }
+}
+
 static void ft_stream_close(FT_Stream stream)
 {
   fclose(STREAM_FILE(stream));
@@ -47,6 +89,20 @@ FT_Stream open_stream(const std::string& utf8Filename)
 
   TRACE("FT: Loading font %s... ", utf8Filename.c_str());
 
+  // A memory-based stream (read == nullptr) lets FreeType access the
+  // font data directly without seek/read calls
+  if (base::MappedFile mappedFile = get_mapped_file(utf8Filename)) {
+    stream->descriptor.pointer = new base::MappedFile(mappedFile);
+    stream->base = (unsigned char*)mappedFile->data();
+    stream->size = (unsigned long)mappedFile->size();
+    stream->pos = 0;
+    stream->read = nullptr;
+    stream->close = ft_mapped_stream_close;
+
+    TRACE("OK (mapped)\n");
+    return stream;
+  }
+
   FILE* file = base::open_file_raw(utf8Filename, "rb");
   if (!file) {
     free(stream);
@@ -1,4 +1,5 @@
 // LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -14,6 +15,9 @@
 
 namespace ft {
 
+// Opens a stream to read the given font file. The file is mapped in
+// memory and the mapping is shared by all the streams opened on the
+// same file. If the file cannot be mapped, it's read with fread().
 FT_Stream open_stream(const std::string& utf8Filename);
 
 } // namespace ft
@@ -0,0 +1,81 @@
+// LAF FreeType Wrapper
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef FT_THREAD_FACE_H_INCLUDED
+#define FT_THREAD_FACE_H_INCLUDED
+#pragma once
+
+#include "ft/lib.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace ft {
+
+// Copy of a font face to be used from one specific thread. A FT_Face
+// cannot be used from two threads at the same time, and creating
+// faces on the same FT_Library needs a lock, so each thread uses its
+// own FT_Library too.
+template<typename FaceType>
+class ThreadFace {
+public:
+  ThreadFace(const std::string& filename, const int faceIndex, const int size)
+    : m_face(m_lib.open(filename, faceIndex))
+  {
+    if (m_face.isValid())
+      m_face.setSize(size);
+  }
+
+  FaceType& face() { return m_face; }
+
+private:
+  Lib m_lib; // Must be destroyed after m_face
+  FaceType m_face;
+};
+
+// Returns the face of the current thread for the given font file,
+// face index (e.g. of a .ttc collection), and size, with the
+// antialias and subpixel positioning settings of the original face.
+// Faces are kept for future calls (up to 8 faces per thread) and
+// destroyed when the thread finishes. The returned face can be
+// invalid if the file cannot be opened again.
+template<typename FaceType>
+FaceType& get_thread_face(const std::string& filename,
+                          const int faceIndex,
+                          const int size,
+                          const bool antialias,
+                          const bool subpixelPositioning)
+{
+  constexpr size_t kMaxFacesPerThread = 8;
+  using Key = std::tuple<std::string, int, int>;
+  thread_local std::map<Key, std::unique_ptr<ThreadFace<FaceType>>> faces;
+
+  const Key key(filename, faceIndex, size);
+  auto it = faces.find(key);
+  if (it == faces.end()) {
+    if (faces.size() >= kMaxFacesPerThread)
+      faces.clear();
+
+    auto threadFace = std::make_unique<ThreadFace<FaceType>>(filename, faceIndex, size);
+    it = faces.emplace(key, std::move(threadFace)).first;
+    FaceType& face = it->second->face();
+    face.setAntialias(antialias);
+    face.setSubpixelPositioning(subpixelPositioning);
+    return face;
+  }
+
+  FaceType& face = it->second->face();
+  if (face.antialias() != antialias)
+    face.setAntialias(antialias);
+  face.setSubpixelPositioning(subpixelPositioning);
+  return face;
+}
+
+} // namespace ft
+
+#endif
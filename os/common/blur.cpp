@@ -0,0 +1,467 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/blur.h"
+
+#include "base/thread_pool.h"
+#include "os/common/surface_utils.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Rows blurred in each task of the horizontal pass
+constexpr int kRowsPerTask = 64;
+
+// Columns blurred together in the vertical pass (a strip of
+// h*kStripWidth pixels is copied to a temporary buffer)
+constexpr int kStripWidth = 32;
+constexpr int kStripsPerTask = 2;
+
+// With bigger radius the fixed point box averages could overflow
+constexpr int kMaxRadius = 16383;
+
+// Box averages are calculated as (sum * inv) >> 24
+inline uint32_t box_inv(const int r)
+{
+  const uint32_t w = 2 * r + 1;
+  return ((1u << 24) + w / 2) / w;
+}
+
+// Parameters of the blur in one axis
+struct Blur {
+  BlurKernel kernel;
+  BlurEdges edges;
+  int boxRadii[3] = { 0, 0, 0 };
+  int radius = 0;                // Total radius
+  std::vector<uint32_t> weights; // Gaussian weights (sum = 1<<16)
+
+  Blur(const float sigma, const BlurKernel kernel, const BlurEdges edges)
+    : kernel(kernel)
+    , edges(edges)
+  {
+    if (!(sigma > 0.0f))
+      return;
+
+    const double s2 = double(sigma) * sigma;
+    if (kernel == BlurKernel::Box) {
+      // Widths of three boxes to approximate the Gaussian variance,
+      // from "Fast Almost-Gaussian Filtering" (Kovesi, 2010)
+      const int n = 3;
+      int wl = int(std::floor(std::sqrt(12.0 * s2 / n + 1.0)));
+      if (wl % 2 == 0)
+        --wl;
+      const int m = int(std::round((12.0 * s2 - n * wl * wl - 4.0 * n * wl - 3.0 * n) /
+                                   (-4.0 * wl - 4.0)));
+      for (int i = 0; i < n; ++i) {
+        const int w = (i < m ? wl : wl + 2);
+        boxRadii[i] = std::min((w - 1) / 2, kMaxRadius);
+        radius += boxRadii[i];
+      }
+    }
+    else {
+      radius = std::min(int(std::ceil(3.0 * sigma)), kMaxRadius);
+      std::vector<double> w(2 * radius + 1);
+      double sum = 0.0;
+      for (int i = -radius; i <= radius; ++i)
+        sum += (w[i + radius] = std::exp(-i * i / (2.0 * s2)));
+
+      // Integer weights, the rounding error goes to the center
+      weights.resize(w.size());
+      int64_t total = 0;
+      for (std::size_t i = 0; i < w.size(); ++i)
+        total += (weights[i] = uint32_t(std::round(65536.0 * w[i] / sum)));
+      weights[radius] += int(65536 - total);
+    }
+  }
+
+  bool isIdentity() const { return radius == 0; }
+};
+
+// Copies "n" pixels of N channels from "src" to "pad" adding "r"
+// pixels on each side.
+template<int N>
+void pad_line(const uint8_t* src, const int n, const int r, const BlurEdges edges, uint8_t* pad)
+{
+  std::memcpy(pad + r * N, src, std::size_t(n) * N);
+  if (edges == BlurEdges::Clamp) {
+    for (int i = 0; i < r; ++i) {
+      std::memcpy(pad + i * N, src, N);
+      std::memcpy(pad + (r + n + i) * N, src + (n - 1) * N, N);
+    }
+  }
+  else {
+    std::memset(pad, 0, std::size_t(r) * N);
+    std::memset(pad + std::size_t(r + n) * N, 0, std::size_t(r) * N);
+  }
+}
+
+// Box blur of a line of "n" pixels with a sliding window sum.
+template<int N>
+void box_line(const uint8_t* src,
+              uint8_t* dst,
+              const int n,
+              const int r,
+              const BlurEdges edges,
+              std::vector<uint8_t>& pad)
+{
+  if (r == 0) {
+    std::memcpy(dst, src, std::size_t(n) * N);
+    return;
+  }
+  pad.resize(std::size_t(n + 2 * r) * N);
+  pad_line<N>(src, n, r, edges, pad.data());
+
+  const uint8_t* p = pad.data();
+  const uint32_t inv = box_inv(r);
+  uint32_t sum[N] = {};
+  for (int k = 0; k < 2 * r + 1; ++k)
+    for (int c = 0; c < N; ++c)
+      sum[c] += p[k * N + c];
+
+  for (int x = 0;; ++x, dst += N, p += N) {
+    for (int c = 0; c < N; ++c)
+      dst[c] = uint8_t((sum[c] * inv + (1u << 23)) >> 24);
+    if (x + 1 == n)
+      break;
+    for (int c = 0; c < N; ++c)
+      sum[c] += p[(2 * r + 1) * N + c] - p[c];
+  }
+}
+
+template<int N>
+void gaussian_line(const uint8_t* src,
+                   uint8_t* dst,
+                   const int n,
+                   const std::vector<uint32_t>& weights,
+                   const BlurEdges edges,
+                   std::vector<uint8_t>& pad)
+{
+  const int r = int(weights.size()) / 2;
+  pad.resize(std::size_t(n + 2 * r) * N);
+  pad_line<N>(src, n, r, edges, pad.data());
+
+  const uint8_t* p = pad.data();
+  for (int x = 0; x < n; ++x, dst += N, p += N) {
+    uint32_t acc[N];
+    for (int c = 0; c < N; ++c)
+      acc[c] = (1u << 15);
+    for (int k = 0; k < 2 * r + 1; ++k)
+      for (int c = 0; c < N; ++c)
+        acc[c] += weights[k] * p[k * N + c];
+    for (int c = 0; c < N; ++c)
+      dst[c] = uint8_t(acc[c] >> 16);
+  }
+}
+
+// Blurs a row in place
+template<int N>
+void blur_row(uint8_t* row,
+              const int n,
+              const Blur& blur,
+              std::vector<uint8_t>& tmp1,
+              std::vector<uint8_t>& tmp2,
+              std::vector<uint8_t>& pad)
+{
+  tmp1.resize(std::size_t(n) * N);
+  if (blur.kernel == BlurKernel::Box) {
+    tmp2.resize(tmp1.size());
+    box_line<N>(row, tmp1.data(), n, blur.boxRadii[0], blur.edges, pad);
+    box_line<N>(tmp1.data(), tmp2.data(), n, blur.boxRadii[1], blur.edges, pad);
+    box_line<N>(tmp2.data(), row, n, blur.boxRadii[2], blur.edges, pad);
+  }
+  else {
+    std::memcpy(tmp1.data(), row, tmp1.size());
+    gaussian_line<N>(tmp1.data(), row, n, blur.weights, blur.edges, pad);
+  }
+}
+
+// Vertical passes over a strip of "h" rows of "rowBytes" bytes
+// (all channels of all pixels of a row are blurred at the same time).
+class VerticalPass {
+public:
+  VerticalPass(const uint8_t* src, const int h, const int rowBytes, const BlurEdges edges)
+    : m_src(src)
+    , m_h(h)
+    , m_rowBytes(rowBytes)
+    , m_clamp(edges == BlurEdges::Clamp)
+  {
+  }
+
+  // Returns the row "y" or nullptr if it's outside and transparent
+  const uint8_t* row(int y) const
+  {
+    if (y < 0 || y >= m_h) {
+      if (!m_clamp)
+        return nullptr;
+      y = std::clamp(y, 0, m_h - 1);
+    }
+    return m_src + std::size_t(y) * m_rowBytes;
+  }
+
+  void box(uint8_t* dst, const int r, std::vector<uint32_t>& sums) const
+  {
+    if (r == 0) {
+      std::memcpy(dst, m_src, std::size_t(m_h) * m_rowBytes);
+      return;
+    }
+    sums.assign(m_rowBytes, 0);
+    uint32_t* s = sums.data();
+    for (int k = -r; k <= r; ++k) {
+      if (const uint8_t* p = row(k)) {
+        for (int c = 0; c < m_rowBytes; ++c)
+          s[c] += p[c];
+      }
+    }
+
+    const uint32_t inv = box_inv(r);
+    for (int y = 0; y < m_h; ++y, dst += m_rowBytes) {
+      for (int c = 0; c < m_rowBytes; ++c)
+        dst[c] = uint8_t((s[c] * inv + (1u << 23)) >> 24);
+
+      if (const uint8_t* add = row(y + r + 1)) {
+        for (int c = 0; c < m_rowBytes; ++c)
+          s[c] += add[c];
+      }
+      if (const uint8_t* sub = row(y - r)) {
+        for (int c = 0; c < m_rowBytes; ++c)
+          s[c] -= sub[c];
+      }
+    }
+  }
+
+  void gaussian(uint8_t* dst,
+                const std::vector<uint32_t>& weights,
+                std::vector<uint32_t>& acc) const
+  {
+    const int r = int(weights.size()) / 2;
+    for (int y = 0; y < m_h; ++y, dst += m_rowBytes) {
+      acc.assign(m_rowBytes, 1u << 15);
+      uint32_t* a = acc.data();
+      for (int k = 0; k < 2 * r + 1; ++k) {
+        if (const uint8_t* p = row(y + k - r)) {
+          const uint32_t w = weights[k];
+          for (int c = 0; c < m_rowBytes; ++c)
+            a[c] += w * p[c];
+        }
+      }
+      for (int c = 0; c < m_rowBytes; ++c)
+        dst[c] = uint8_t(a[c] >> 16);
+    }
+  }
+
+private:
+  const uint8_t* m_src;
+  int m_h;
+  int m_rowBytes;
+  bool m_clamp;
+};
+
+// Blurs the columns [x, x+w) of the image
+template<int N>
+void blur_strip(uint8_t* pixels,
+                const int stride,
+                const int h,
+                const int x,
+                const int w,
+                const Blur& blur,
+                std::vector<uint8_t>& strip1,
+                std::vector<uint8_t>& strip2,
+                std::vector<uint32_t>& sums)
+{
+  const int rowBytes = w * N;
+  strip1.resize(std::size_t(h) * rowBytes);
+  strip2.resize(strip1.size());
+  for (int y = 0; y < h; ++y)
+    std::memcpy(&strip1[std::size_t(y) * rowBytes],
+                pixels + std::size_t(y) * stride + x * N,
+                rowBytes);
+
+  if (blur.kernel == BlurKernel::Box) {
+    for (const int r : blur.boxRadii) {
+      VerticalPass(strip1.data(), h, rowBytes, blur.edges).box(strip2.data(), r, sums);
+      strip1.swap(strip2);
+    }
+  }
+  else {
+    VerticalPass(strip1.data(), h, rowBytes, blur.edges)
+      .gaussian(strip2.data(), blur.weights, sums);
+    strip1.swap(strip2);
+  }
+
+  for (int y = 0; y < h; ++y)
+    std::memcpy(pixels + std::size_t(y) * stride + x * N,
+                &strip1[std::size_t(y) * rowBytes],
+                rowBytes);
+}
+
+// "stride" is in bytes
+template<int N>
+void blur_image(uint8_t* pixels,
+                const int stride,
+                const gfx::Size& size,
+                const float sigma,
+                const BlurKernel kernel,
+                const BlurEdges edges,
+                base::thread_pool* pool)
+{
+  if (!pixels || size.w <= 0 || size.h <= 0)
+    return;
+
+  const Blur blur(sigma, kernel, edges);
+  if (blur.isIdentity())
+    return;
+
+  base::for_each_task(pool, size.h, kRowsPerTask, [&](const int y1, const int y2) {
+    std::vector<uint8_t> tmp1, tmp2, pad;
+    for (int y = y1; y < y2; ++y)
+      blur_row<N>(pixels + std::size_t(y) * stride, size.w, blur, tmp1, tmp2, pad);
+  });
+
+  const int nstrips = (size.w + kStripWidth - 1) / kStripWidth;
+  base::for_each_task(pool, nstrips, kStripsPerTask, [&](const int i1, const int i2) {
+    std::vector<uint8_t> strip1, strip2;
+    std::vector<uint32_t> sums;
+    for (int i = i1; i < i2; ++i) {
+      const int x = i * kStripWidth;
+      blur_strip<N>(pixels,
+                    stride,
+                    size.h,
+                    x,
+                    std::min(kStripWidth, size.w - x),
+                    blur,
+                    strip1,
+                    strip2,
+                    sums);
+    }
+  });
+}
+
+} // anonymous namespace
+
+int blur_radius(const float sigma, const BlurKernel kernel)
+{
+  return Blur(sigma, kernel, BlurEdges::Transparent).radius;
+}
+
+void blur_rgba(uint32_t* pixels,
+               const int stride,
+               const gfx::Size& size,
+               const float sigma,
+               const BlurKernel kernel,
+               const BlurEdges edges,
+               base::thread_pool* pool)
+{
+  blur_image<4>((uint8_t*)pixels, 4 * stride, size, sigma, kernel, edges, pool);
+}
+
+void blur_alpha(uint8_t* pixels,
+                const int stride,
+                const gfx::Size& size,
+                const float sigma,
+                const BlurKernel kernel,
+                const BlurEdges edges,
+                base::thread_pool* pool)
+{
+  blur_image<1>(pixels, stride, size, sigma, kernel, edges, pool);
+}
+
+void blur_surface(Surface* surface,
+                  const gfx::Rect& area,
+                  const float sigma,
+                  const BlurKernel kernel,
+                  const BlurEdges edges,
+                  base::thread_pool* pool)
+{
+  const gfx::Rect rc = area & surface->bounds();
+  if (rc.isEmpty())
+    return;
+
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return;
+
+  SurfaceLock lock(surface);
+  uint32_t* pixels = (uint32_t*)surface->getData(rc.x, rc.y);
+  if (!pixels)
+    return;
+
+  blur_rgba(pixels,
+            row_stride(surface),
+            rc.size(),
+            sigma,
+            kernel,
+            edges,
+            pool);
+}
+
+void make_shadow(const Surface* src,
+                 Surface* dst,
+                 const gfx::Point& offset,
+                 const gfx::Color color,
+                 const float sigma,
+                 const BlurKernel kernel,
+                 base::thread_pool* pool)
+{
+  SurfaceFormatData sfd, dfd;
+  src->getFormat(&sfd);
+  dst->getFormat(&dfd);
+  if (sfd.bitsPerPixel != 32 || dfd.bitsPerPixel != 32)
+    return;
+
+  SurfaceLock lockSrc(src);
+  SurfaceLock lockDst(dst);
+  if (!src->getData(0, 0) || !dst->getData(0, 0))
+    return;
+
+  // Alpha mask of the source surface in its position in "dst"
+  const int w = dst->width();
+  const int h = dst->height();
+  std::vector<uint8_t> mask(std::size_t(w) * h, 0);
+  const gfx::Rect area = gfx::Rect(offset, gfx::Size(src->width(), src->height())) &
+                         dst->bounds();
+  for (int y = area.y; y < area.y2(); ++y) {
+    const uint32_t* s = (const uint32_t*)src->getData(area.x - offset.x, y - offset.y);
+    uint8_t* m = &mask[std::size_t(y) * w + area.x];
+    for (int x = 0; x < area.w; ++x)
+      m[x] = (sfd.alphaMask ? uint8_t((s[x] & sfd.alphaMask) >> sfd.alphaShift) : 255);
+  }
+
+  blur_alpha(mask.data(), w, gfx::Size(w, h), sigma, kernel, BlurEdges::Transparent, pool);
+
+  const bool premultiplied = (dfd.pixelAlpha == PixelAlpha::kPremultiplied);
+  const uint32_t ca = gfx::geta(color);
+  for (int y = 0; y < h; ++y) {
+    const uint8_t* m = &mask[std::size_t(y) * w];
+    uint32_t* d = (uint32_t*)dst->getData(0, y);
+    for (int x = 0; x < w; ++x) {
+      const uint32_t a = (m[x] * ca + 127) / 255;
+      uint32_t r = gfx::getr(color);
+      uint32_t g = gfx::getg(color);
+      uint32_t b = gfx::getb(color);
+      if (premultiplied) {
+        r = (r * a + 127) / 255;
+        g = (g * a + 127) / 255;
+        b = (b * a + 127) / 255;
+      }
+      d[x] = (r << dfd.redShift) | (g << dfd.greenShift) | (b << dfd.blueShift) |
+             ((a << dfd.alphaShift) & dfd.alphaMask);
+    }
+  }
+}
+
+} // namespace os
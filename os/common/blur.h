@@ -0,0 +1,95 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_BLUR_H_INCLUDED
+#define OS_COMMON_BLUR_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/color.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+enum class BlurKernel {
+  // Three box blurs (a Gaussian approximation) calculated with
+  // sliding window sums, so the time per pixel is constant for any
+  // sigma.
+  Box,
+  // Exact Gaussian weights (up to 3*sigma pixels), slower for big
+  // sigmas.
+  Gaussian,
+};
+
+enum class BlurEdges {
+  Transparent, // Pixels outside the image are zero (e.g. shadows)
+  Clamp,       // The edge pixels are repeated (e.g. backdrops)
+};
+
+// Returns the number of pixels that the blur spreads in each
+// direction (e.g. the padding needed around a shadow).
+int blur_radius(float sigma, BlurKernel kernel);
+
+// Blurs the 32bpp image "pixels" in place with a Gaussian of the
+// given "sigma" (in pixels). The 4 channels are blurred
+// independently, so premultiplied images stay premultiplied.
+//
+// The kernel is separable: rows are blurred in a horizontal pass,
+// and columns in strips of a few pixels (copied to a temporary
+// buffer to stay in the cache) in a vertical pass. The inner loops
+// work over contiguous channels of several pixels so the compiler
+// can vectorize them. If "pool" is not nullptr, bands of rows and
+// strips of columns are blurred in parallel.
+void blur_rgba(uint32_t* pixels,
+               int stride,
+               const gfx::Size& size,
+               float sigma,
+               BlurKernel kernel = BlurKernel::Box,
+               BlurEdges edges = BlurEdges::Transparent,
+               base::thread_pool* pool = nullptr);
+
+// Same as blur_rgba() for 8-bit masks (the stride is in bytes).
+void blur_alpha(uint8_t* pixels,
+                int stride,
+                const gfx::Size& size,
+                float sigma,
+                BlurKernel kernel = BlurKernel::Box,
+                BlurEdges edges = BlurEdges::Transparent,
+                base::thread_pool* pool = nullptr);
+
+// Blurs the given area of a 32bpp surface (pixels outside the area
+// are not used).
+void blur_surface(Surface* surface,
+                  const gfx::Rect& area,
+                  float sigma,
+                  BlurKernel kernel = BlurKernel::Box,
+                  BlurEdges edges = BlurEdges::Transparent,
+                  base::thread_pool* pool = nullptr);
+
+// Replaces the pixels of "dst" with a drop shadow of "src": the
+// alpha channel of "src" (placed at "offset" in "dst") blurred and
+// filled with "color". To get the whole shadow, "dst" should be
+// bigger than "src" by blur_radius() pixels on each side. Both
+// surfaces must be 32bpp.
+void make_shadow(const Surface* src,
+                 Surface* dst,
+                 const gfx::Point& offset,
+                 gfx::Color color,
+                 float sigma,
+                 BlurKernel kernel = BlurKernel::Box,
+                 base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
@@ -0,0 +1,254 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "os/common/blur.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace os;
+
+// Random premultiplied RGBA image
+static std::vector<uint32_t> make_image(const int w, const int h, const int seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<uint32_t> pixels(std::size_t(w) * h);
+  for (uint32_t& c : pixels) {
+    const uint32_t a = rng() % 256;
+    c = (rng() % (a + 1)) | ((rng() % (a + 1)) << 8) | ((rng() % (a + 1)) << 16) | (a << 24);
+  }
+  return pixels;
+}
+
+// Reference 1D convolution of one channel with transparent edges
+static std::vector<double> convolve(const std::vector<double>& src,
+                                    const int n,
+                                    const int count,
+                                    const int step,
+                                    const std::vector<double>& kernel)
+{
+  const int r = int(kernel.size()) / 2;
+  std::vector<double> dst(src.size(), 0.0);
+  for (int line = 0; line < count; ++line) {
+    // Lines are rows (step=1) or columns (step=width)
+    const int first = (step == 1 ? line * n : line);
+    const int inc = (step == 1 ? 1 : step);
+    for (int i = 0; i < n; ++i) {
+      double v = 0.0;
+      for (int k = -r; k <= r; ++k) {
+        if (i + k >= 0 && i + k < n)
+          v += kernel[k + r] * src[first + (i + k) * inc];
+      }
+      dst[first + i * inc] = v;
+    }
+  }
+  return dst;
+}
+
+static std::vector<double> blur_reference(const std::vector<double>& src,
+                                          const int w,
+                                          const int h,
+                                          const std::vector<std::vector<double>>& kernels)
+{
+  std::vector<double> v = src;
+  for (const auto& k : kernels)
+    v = convolve(v, w, h, 1, k);
+  for (const auto& k : kernels)
+    v = convolve(v, h, w, w, k);
+  return v;
+}
+
+static std::vector<double> box_kernel(const int r)
+{
+  return std::vector<double>(2 * r + 1, 1.0 / (2 * r + 1));
+}
+
+static std::vector<double> gaussian_kernel(const float sigma)
+{
+  const int r = int(std::ceil(3.0 * sigma));
+  std::vector<double> k(2 * r + 1);
+  double sum = 0.0;
+  for (int i = -r; i <= r; ++i)
+    sum += (k[i + r] = std::exp(-i * i / (2.0 * sigma * sigma)));
+  for (double& v : k)
+    v /= sum;
+  return k;
+}
+
+static void expect_near_reference(const std::vector<uint32_t>& src,
+                                  const std::vector<uint32_t>& result,
+                                  const int w,
+                                  const int h,
+                                  const std::vector<std::vector<double>>& kernels,
+                                  const int tolerance)
+{
+  for (int shift = 0; shift < 32; shift += 8) {
+    std::vector<double> channel(src.size());
+    for (std::size_t i = 0; i < src.size(); ++i)
+      channel[i] = (src[i] >> shift) & 0xff;
+    const std::vector<double> expected = blur_reference(channel, w, h, kernels);
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      ASSERT_NEAR(expected[i], double((result[i] >> shift) & 0xff), tolerance)
+        << "pixel " << i << " shift " << shift;
+    }
+  }
+}
+
+TEST(Blur, Identity)
+{
+  const std::vector<uint32_t> src = make_image(20, 10, 1);
+  std::vector<uint32_t> dst = src;
+  blur_rgba(dst.data(), 20, gfx::Size(20, 10), 0.0f);
+  EXPECT_EQ(src, dst);
+  EXPECT_EQ(0, blur_radius(0.0f, BlurKernel::Box));
+  EXPECT_EQ(0, blur_radius(0.0f, BlurKernel::Gaussian));
+  EXPECT_EQ(30, blur_radius(10.0f, BlurKernel::Gaussian));
+  EXPECT_NEAR(30, blur_radius(10.0f, BlurKernel::Box), 3);
+}
+
+TEST(Blur, ConstantImageWithClampedEdges)
+{
+  for (const BlurKernel kernel : { BlurKernel::Box, BlurKernel::Gaussian }) {
+    std::vector<uint32_t> pixels(50 * 40, 0xff804020);
+    blur_rgba(pixels.data(), 50, gfx::Size(50, 40), 6.0f, kernel, BlurEdges::Clamp);
+    for (const uint32_t c : pixels)
+      ASSERT_EQ(0xff804020, c);
+  }
+}
+
+TEST(Blur, BoxReference)
+{
+  const int w = 70, h = 45;
+  const std::vector<uint32_t> src = make_image(w, h, 2);
+  for (const float sigma : { 1.0f, 2.5f, 8.0f }) {
+    std::vector<uint32_t> dst = src;
+    blur_rgba(dst.data(), w, gfx::Size(w, h), sigma, BlurKernel::Box);
+
+    // Same box widths used by the implementation
+    const double s2 = double(sigma) * sigma;
+    int wl = int(std::floor(std::sqrt(12.0 * s2 / 3 + 1.0)));
+    if (wl % 2 == 0)
+      --wl;
+    const int m = int(std::round((12.0 * s2 - 3 * wl * wl - 12.0 * wl - 9.0) / (-4.0 * wl - 4.0)));
+    std::vector<std::vector<double>> kernels;
+    for (int i = 0; i < 3; ++i)
+      kernels.push_back(box_kernel(((i < m ? wl : wl + 2) - 1) / 2));
+
+    // Each of the 6 passes can round by 0.5
+    expect_near_reference(src, dst, w, h, kernels, 3);
+  }
+}
+
+TEST(Blur, GaussianReference)
+{
+  const int w = 60, h = 50;
+  const std::vector<uint32_t> src = make_image(w, h, 3);
+  for (const float sigma : { 0.8f, 3.0f }) {
+    std::vector<uint32_t> dst = src;
+    blur_rgba(dst.data(), w, gfx::Size(w, h), sigma, BlurKernel::Gaussian);
+    expect_near_reference(src, dst, w, h, { gaussian_kernel(sigma) }, 1);
+  }
+}
+
+TEST(Blur, SpreadsAlpha)
+{
+  // One opaque pixel in the center keeps (almost) the same total
+  // alpha, spread symmetrically
+  const int w = 61, h = 61;
+  for (const BlurKernel kernel : { BlurKernel::Box, BlurKernel::Gaussian }) {
+    std::vector<uint8_t> mask(w * h, 0);
+    for (int y = 28; y < 33; ++y)
+      for (int x = 28; x < 33; ++x)
+        mask[y * w + x] = 255;
+    blur_alpha(mask.data(), w, gfx::Size(w, h), 4.0f, kernel);
+
+    int total = 0;
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        total += mask[y * w + x];
+        ASSERT_EQ(mask[y * w + x], mask[(h - 1 - y) * w + (w - 1 - x)]);
+        // Rows and columns are rounded in a different order
+        ASSERT_NEAR(mask[y * w + x], mask[x * w + y], 1);
+      }
+    }
+    EXPECT_NEAR(25 * 255, total, 25 * 255 / 20);
+    EXPECT_LT(mask[30 * w + 30], 255);
+    EXPECT_GT(mask[30 * w + 30], mask[30 * w + 36]);
+  }
+}
+
+TEST(Blur, PremultipliedAndAlphaMasks)
+{
+  const int w = 90, h = 33;
+  const std::vector<uint32_t> src = make_image(w, h, 4);
+  for (const BlurKernel kernel : { BlurKernel::Box, BlurKernel::Gaussian }) {
+    for (const BlurEdges edges : { BlurEdges::Transparent, BlurEdges::Clamp }) {
+      std::vector<uint32_t> dst = src;
+      blur_rgba(dst.data(), w, gfx::Size(w, h), 5.0f, kernel, edges);
+
+      std::vector<uint8_t> mask(src.size());
+      for (std::size_t i = 0; i < src.size(); ++i)
+        mask[i] = src[i] >> 24;
+      blur_alpha(mask.data(), w, gfx::Size(w, h), 5.0f, kernel, edges);
+
+      for (std::size_t i = 0; i < dst.size(); ++i) {
+        const uint32_t c = dst[i];
+        const uint32_t a = (c >> 24);
+        ASSERT_LE(c & 0xff, a);
+        ASSERT_LE((c >> 8) & 0xff, a);
+        ASSERT_LE((c >> 16) & 0xff, a);
+        ASSERT_EQ(mask[i], a);
+      }
+    }
+  }
+}
+
+TEST(Blur, SubImageAndThreads)
+{
+  // Blur a 150x130 area of a bigger image (the rest is untouched)
+  const int w = 200, h = 150;
+  const std::vector<uint32_t> src = make_image(w, h, 5);
+  base::thread_pool pool(3);
+  for (const BlurKernel kernel : { BlurKernel::Box, BlurKernel::Gaussian }) {
+    std::vector<uint32_t> a = src, b = src;
+    blur_rgba(&a[10 * w + 20], w, gfx::Size(150, 130), 3.0f, kernel, BlurEdges::Clamp);
+    blur_rgba(&b[10 * w + 20], w, gfx::Size(150, 130), 3.0f, kernel, BlurEdges::Clamp, &pool);
+    EXPECT_EQ(a, b);
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        if (!gfx::Rect(20, 10, 150, 130).contains(gfx::Point(x, y))) {
+          ASSERT_EQ(src[y * w + x], a[y * w + x]);
+        }
+      }
+    }
+  }
+}
+
+TEST(Blur, BigRadius)
+{
+  // Radius bigger than the image
+  std::vector<uint32_t> pixels(7 * 5, 0);
+  pixels[17] = 0xffffffff;
+  blur_rgba(pixels.data(), 7, gfx::Size(7, 5), 50.0f, BlurKernel::Box, BlurEdges::Clamp);
+  for (const uint32_t c : pixels)
+    EXPECT_LE(c, 0x02020202u);
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
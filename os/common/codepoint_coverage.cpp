@@ -0,0 +1,80 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/codepoint_coverage.h"
+
+#include <algorithm>
+
+namespace os {
+
+CodePointCoverage::CodePointCoverage()
+{
+}
+
+CodePointCoverage::~CodePointCoverage()
+{
+}
+
+void CodePointCoverage::add(const int codepoint)
+{
+  if (codepoint < 0 || codepoint > kMaxCodePoint)
+    return;
+
+  std::unique_ptr<Plane>& plane = m_planes[codepoint >> 16];
+  if (!plane)
+    plane = std::make_unique<Plane>();
+
+  uint16_t& page = plane->pages[(codepoint >> 8) & 0xff];
+  if (page == kFullPage)
+    return;
+  if (page == kEmptyPage) {
+    plane->bits.push_back(Bits{});
+    page = uint16_t(kFirstPage + plane->bits.size() - 1);
+  }
+
+  uint32_t& word = plane->bits[page - kFirstPage][(codepoint >> 5) & 7];
+  const uint32_t bit = (1u << (codepoint & 31));
+  if ((word & bit) == 0) {
+    word |= bit;
+    ++m_size;
+  }
+}
+
+void CodePointCoverage::clear()
+{
+  for (auto& plane : m_planes)
+    plane.reset();
+  m_size = 0;
+}
+
+void CodePointCoverage::shrink()
+{
+  for (auto& plane : m_planes) {
+    if (!plane)
+      continue;
+
+    std::vector<Bits> bits;
+    for (uint16_t& page : plane->pages) {
+      if (page < kFirstPage)
+        continue;
+
+      const Bits& pageBits = plane->bits[page - kFirstPage];
+      if (std::all_of(pageBits.begin(), pageBits.end(), [](uint32_t w) { return w == 0xffffffff; }))
+        page = kFullPage;
+      else {
+        bits.push_back(pageBits);
+        page = uint16_t(kFirstPage + bits.size() - 1);
+      }
+    }
+    plane->bits = std::move(bits);
+  }
+}
+
+} // namespace os
@@ -0,0 +1,79 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_CODEPOINT_COVERAGE_H_INCLUDED
+#define OS_COMMON_CODEPOINT_COVERAGE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace os {
+
+// Set of Unicode code points supported by a font. Code points are
+// grouped in pages of 256 bits, and pages in planes (0x10000 code
+// points). Empty planes/pages don't use memory, and full pages are
+// shared, so a typical font uses only a few KB.
+class CodePointCoverage {
+public:
+  static constexpr int kMaxCodePoint = 0x10FFFF;
+
+  CodePointCoverage();
+  ~CodePointCoverage();
+
+  bool empty() const { return m_size == 0; }
+  int size() const { return m_size; }
+
+  bool contains(int codepoint) const
+  {
+    if (codepoint < 0 || codepoint > kMaxCodePoint)
+      return false;
+
+    const Plane* plane = m_planes[codepoint >> 16].get();
+    if (!plane)
+      return false;
+
+    const uint16_t page = plane->pages[(codepoint >> 8) & 0xff];
+    if (page == kEmptyPage)
+      return false;
+    if (page == kFullPage)
+      return true;
+
+    const Bits& bits = plane->bits[page - kFirstPage];
+    return (bits[(codepoint >> 5) & 7] >> (codepoint & 31)) & 1;
+  }
+
+  void add(int codepoint);
+  void clear();
+
+  // Replaces full pages with a reference to the shared full page.
+  // Call it after adding all the code points.
+  void shrink();
+
+private:
+  using Bits = std::array<uint32_t, 8>;
+
+  static constexpr uint16_t kEmptyPage = 0;
+  static constexpr uint16_t kFullPage = 1;
+  static constexpr uint16_t kFirstPage = 2;
+
+  struct Plane {
+    // Index of each page (kEmptyPage, kFullPage, or kFirstPage+i to
+    // use bits[i]).
+    std::array<uint16_t, 256> pages = {};
+    std::vector<Bits> bits;
+  };
+
+  std::array<std::unique_ptr<Plane>, 17> m_planes;
+  int m_size = 0;
+};
+
+} // namespace os
+
+#endif
@@ -0,0 +1,80 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "os/common/codepoint_coverage.h"
+
+using namespace os;
+
+TEST(CodePointCoverage, Empty)
+{
+  CodePointCoverage cov;
+  EXPECT_TRUE(cov.empty());
+  EXPECT_FALSE(cov.contains(0));
+  EXPECT_FALSE(cov.contains('A'));
+  EXPECT_FALSE(cov.contains(-1));
+  EXPECT_FALSE(cov.contains(0x110000));
+}
+
+TEST(CodePointCoverage, AddAndContains)
+{
+  CodePointCoverage cov;
+  cov.add('A');
+  cov.add('A');
+  cov.add(0x65E5);  // CJK
+  cov.add(0x1F600); // Emoji (plane 1)
+  cov.add(CodePointCoverage::kMaxCodePoint);
+  cov.add(0x110000); // Ignored
+
+  EXPECT_EQ(4, cov.size());
+  EXPECT_TRUE(cov.contains('A'));
+  EXPECT_FALSE(cov.contains('B'));
+  EXPECT_TRUE(cov.contains(0x65E5));
+  EXPECT_FALSE(cov.contains(0x65E6));
+  EXPECT_TRUE(cov.contains(0x1F600));
+  EXPECT_FALSE(cov.contains(0xF600));
+  EXPECT_TRUE(cov.contains(CodePointCoverage::kMaxCodePoint));
+
+  cov.clear();
+  EXPECT_TRUE(cov.empty());
+  EXPECT_FALSE(cov.contains('A'));
+}
+
+TEST(CodePointCoverage, Shrink)
+{
+  CodePointCoverage cov;
+  for (int i = 0; i < 256; ++i)
+    cov.add(0x4E00 + i);
+  cov.add(0x20);
+  cov.add(0x7E);
+  cov.shrink();
+
+  EXPECT_EQ(258, cov.size());
+  for (int i = 0; i < 256; ++i)
+    EXPECT_TRUE(cov.contains(0x4E00 + i));
+  EXPECT_FALSE(cov.contains(0x4DFF));
+  EXPECT_FALSE(cov.contains(0x4F00));
+  EXPECT_TRUE(cov.contains(0x20));
+  EXPECT_TRUE(cov.contains(0x7E));
+  EXPECT_FALSE(cov.contains(0x7F));
+
+  // Adding to a shared full page does nothing
+  cov.add(0x4E10);
+  EXPECT_EQ(258, cov.size());
+  cov.add(0x7F);
+  EXPECT_TRUE(cov.contains(0x7F));
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,557 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/deflate.h"
+
+#include "os/common/deflate_tables.h"
+
+#include <algorithm>
+#include <iterator>
+#include <queue>
+
+namespace os {
+
+namespace {
+
+constexpr int kWindowSize = 32768;
+constexpr int kMinMatch = 3;
+constexpr int kMaxMatch = 258;
+constexpr int kHashBits = 15;
+
+// Number of candidates checked to find a match, and length of a
+// match that is good enough to skip the lazy evaluation
+constexpr int kMaxChain = 64;
+constexpr int kLazyLimit = 32;
+
+// Matches of 3 bytes that are too far cost more than 3 literals
+constexpr int kTooFar = 4096;
+
+// Tokens of each compressed block
+constexpr std::size_t kTokensPerBlock = 16384;
+
+// A literal (dist == 0) or a match
+struct Token {
+  uint16_t value; // Literal byte or match length
+  uint16_t dist;
+};
+
+int length_code(const int length)
+{
+  return int(std::upper_bound(std::begin(kLengthBase), std::end(kLengthBase), length) -
+             std::begin(kLengthBase)) -
+         1;
+}
+
+int dist_code(const int dist)
+{
+  return int(std::upper_bound(std::begin(kDistBase), std::end(kDistBase), dist) -
+             std::begin(kDistBase)) -
+         1;
+}
+
+// Calculates the lengths of a Huffman code for the given symbol
+// frequencies limited to "maxBits". When the tree is too deep,
+// frequencies are halved until it fits.
+void build_lengths(const uint32_t* freq, const int n, const int maxBits, uint8_t* lengths)
+{
+  std::vector<uint32_t> f(freq, freq + n);
+  std::fill(lengths, lengths + n, 0);
+
+  while (true) {
+    std::vector<int> symbols;
+    for (int i = 0; i < n; ++i) {
+      if (f[i])
+        symbols.push_back(i);
+    }
+    if (symbols.empty())
+      return;
+    if (symbols.size() == 1) {
+      lengths[symbols[0]] = 1;
+      return;
+    }
+
+    // Nodes [0, leaves) are the symbols, then the internal nodes
+    const int leaves = int(symbols.size());
+    std::vector<int> parent(2 * leaves - 1, -1);
+    using Item = std::pair<uint64_t, int>; // Frequency and node
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (int i = 0; i < leaves; ++i)
+      queue.push(Item(f[symbols[i]], i));
+    for (int node = leaves; queue.size() > 1; ++node) {
+      const Item a = queue.top();
+      queue.pop();
+      const Item b = queue.top();
+      queue.pop();
+      parent[a.second] = parent[b.second] = node;
+      queue.push(Item(a.first + b.first, node));
+    }
+
+    // Parents are created after their children, so depths can be
+    // calculated from the root
+    std::vector<int> depth(parent.size(), 0);
+    int maxDepth = 0;
+    for (int node = int(parent.size()) - 2; node >= 0; --node) {
+      depth[node] = depth[parent[node]] + 1;
+      maxDepth = std::max(maxDepth, depth[node]);
+    }
+    if (maxDepth <= maxBits) {
+      for (int i = 0; i < leaves; ++i)
+        lengths[symbols[i]] = uint8_t(depth[i]);
+      return;
+    }
+    for (uint32_t& v : f) {
+      if (v)
+        v = std::max(1u, v / 2);
+    }
+  }
+}
+
+// Canonical Huffman codes (with reversed bits as they are written
+// starting from the least significant bit)
+void build_codes(const uint8_t* lengths, const int n, uint16_t* codes)
+{
+  int count[16] = {};
+  for (int i = 0; i < n; ++i)
+    ++count[lengths[i]];
+  count[0] = 0;
+
+  int next[16];
+  int code = 0;
+  for (int len = 1; len < 16; ++len) {
+    code = (code + count[len - 1]) << 1;
+    next[len] = code;
+  }
+  for (int i = 0; i < n; ++i) {
+    const int len = lengths[i];
+    if (len == 0) {
+      codes[i] = 0;
+      continue;
+    }
+    int c = next[len]++;
+    int reversed = 0;
+    for (int j = 0; j < len; ++j, c >>= 1)
+      reversed = (reversed << 1) | (c & 1);
+    codes[i] = uint16_t(reversed);
+  }
+}
+
+class BitWriter {
+public:
+  BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+  void put(const uint32_t value, const int n)
+  {
+    m_bits |= uint64_t(value) << m_n;
+    m_n += n;
+    while (m_n >= 8) {
+      m_out.push_back(uint8_t(m_bits));
+      m_bits >>= 8;
+      m_n -= 8;
+    }
+  }
+
+  void align()
+  {
+    if (m_n > 0)
+      put(0, 8 - m_n);
+  }
+
+  void bytes(const uint8_t* data, const std::size_t n)
+  {
+    align();
+    m_out.insert(m_out.end(), data, data + n);
+  }
+
+private:
+  std::vector<uint8_t>& m_out;
+  uint64_t m_bits = 0;
+  int m_n = 0;
+};
+
+class Deflater {
+public:
+  Deflater(const uint8_t* data, const std::size_t size, std::vector<uint8_t>& out)
+    : m_data(data)
+    , m_size(size)
+    , m_writer(out)
+    , m_head(1 << kHashBits, -1)
+    , m_prev(kWindowSize, -1)
+  {
+    m_tokens.reserve(kTokensPerBlock);
+  }
+
+  void compress(const bool final)
+  {
+    int pos = 0;
+    const int size = int(m_size);
+    int nextLen = 0, nextDist = 0;
+    bool hasNext = false;
+
+    while (pos < size) {
+      int len = 0, dist = 0;
+      if (hasNext) {
+        len = nextLen;
+        dist = nextDist;
+        hasNext = false;
+      }
+      else {
+        len = findMatch(pos, dist);
+      }
+      insert(pos);
+
+      // Lazy evaluation: a literal is better if the next position
+      // has a longer match
+      if (len >= kMinMatch && len < kLazyLimit && pos + 1 < size) {
+        nextLen = findMatch(pos + 1, nextDist);
+        if (nextLen > len) {
+          hasNext = true;
+          addToken(Token{ m_data[pos], 0 }, pos);
+          ++pos;
+          continue;
+        }
+      }
+
+      if (len >= kMinMatch) {
+        addToken(Token{ uint16_t(len), uint16_t(dist) }, pos);
+        for (int i = 1; i < len; ++i)
+          insert(pos + i);
+        pos += len;
+      }
+      else {
+        addToken(Token{ m_data[pos], 0 }, pos);
+        ++pos;
+      }
+    }
+
+    writeBlock(final);
+    if (!final) {
+      // Empty stored block (sync flush)
+      m_writer.put(0, 3);
+      m_writer.align();
+      const uint8_t empty[4] = { 0, 0, 0xff, 0xff };
+      m_writer.bytes(empty, 4);
+    }
+    m_writer.align();
+  }
+
+private:
+  uint32_t hash(const int pos) const
+  {
+    if (pos + kMinMatch > int(m_size))
+      return 0;
+    const uint32_t v = m_data[pos] | (m_data[pos + 1] << 8) | (m_data[pos + 2] << 16);
+    return (v * 2654435761u) >> (32 - kHashBits);
+  }
+
+  void insert(const int pos)
+  {
+    if (pos + kMinMatch > int(m_size))
+      return;
+    const uint32_t h = hash(pos);
+    m_prev[pos & (kWindowSize - 1)] = m_head[h];
+    m_head[h] = pos;
+  }
+
+  int findMatch(const int pos, int& dist) const
+  {
+    if (pos + kMinMatch > int(m_size))
+      return 0;
+
+    const int maxLen = std::min(kMaxMatch, int(m_size) - pos);
+    const uint8_t* p = m_data + pos;
+    int best = 0;
+    int candidate = m_head[hash(pos)];
+    for (int chain = kMaxChain; candidate >= 0 && chain > 0; --chain) {
+      if (pos - candidate > kWindowSize)
+        break;
+
+      const uint8_t* q = m_data + candidate;
+      if (q[best] == p[best] && q[0] == p[0]) {
+        int len = 0;
+        while (len < maxLen && q[len] == p[len])
+          ++len;
+        if (len > best && (len > kMinMatch || pos - candidate <= kTooFar)) {
+          best = len;
+          dist = pos - candidate;
+          if (len == maxLen)
+            break;
+        }
+      }
+
+      // Old entries of the window can be overwritten by newer
+      // positions
+      const int next = m_prev[candidate & (kWindowSize - 1)];
+      if (next >= candidate)
+        break;
+      candidate = next;
+    }
+    return (best >= kMinMatch ? best : 0);
+  }
+
+  void addToken(const Token token, const int pos)
+  {
+    if (m_tokens.empty())
+      m_blockStart = pos;
+    m_tokens.push_back(token);
+    m_blockEnd = pos + (token.dist ? token.value : 1);
+    if (m_tokens.size() == kTokensPerBlock)
+      writeBlock(false);
+  }
+
+  void writeBlock(const bool final)
+  {
+    if (m_tokens.empty()) {
+      if (final) {
+        // Fixed Huffman block with the end-of-block code only
+        m_writer.put(1, 1);
+        m_writer.put(1, 2);
+        m_writer.put(0, 7);
+      }
+      return;
+    }
+
+    uint32_t litFreq[286] = {};
+    uint32_t distFreq[30] = {};
+    for (const Token& t : m_tokens) {
+      if (t.dist) {
+        ++litFreq[257 + length_code(t.value)];
+        ++distFreq[dist_code(t.dist)];
+      }
+      else
+        ++litFreq[t.value];
+    }
+    litFreq[256] = 1;
+
+    uint8_t lengths[286 + 30];
+    uint8_t* litLen = lengths;
+    uint8_t* distLen = lengths + 286;
+    build_lengths(litFreq, 286, 15, litLen);
+    build_lengths(distFreq, 30, 15, distLen);
+    if (std::all_of(distLen, distLen + 30, [](const uint8_t v) { return v == 0; }))
+      distLen[0] = 1;
+
+    int hlit = 286;
+    while (hlit > 257 && litLen[hlit - 1] == 0)
+      --hlit;
+    int hdist = 30;
+    while (hdist > 1 && distLen[hdist - 1] == 0)
+      --hdist;
+
+    // Run-length encoding of the code lengths
+    std::vector<uint8_t> all(litLen, litLen + hlit);
+    all.insert(all.end(), distLen, distLen + hdist);
+    std::vector<std::pair<uint8_t, uint8_t>> clSymbols; // Symbol and extra bits value
+    uint32_t clFreq[19] = {};
+    for (std::size_t i = 0; i < all.size();) {
+      const uint8_t v = all[i];
+      std::size_t run = 1;
+      while (i + run < all.size() && all[i + run] == v)
+        ++run;
+      std::size_t left = run;
+      if (v == 0) {
+        while (left >= 11) {
+          const std::size_t n = std::min<std::size_t>(left, 138);
+          clSymbols.push_back({ 18, uint8_t(n - 11) });
+          left -= n;
+        }
+        if (left >= 3) {
+          clSymbols.push_back({ 17, uint8_t(left - 3) });
+          left = 0;
+        }
+      }
+      else {
+        clSymbols.push_back({ v, 0 });
+        --left;
+        while (left >= 3) {
+          const std::size_t n = std::min<std::size_t>(left, 6);
+          clSymbols.push_back({ 16, uint8_t(n - 3) });
+          left -= n;
+        }
+      }
+      for (; left > 0; --left)
+        clSymbols.push_back({ v, 0 });
+      i += run;
+    }
+    for (const auto& s : clSymbols)
+      ++clFreq[s.first];
+
+    uint8_t clLen[19];
+    build_lengths(clFreq, 19, 7, clLen);
+    int hclen = 19;
+    while (hclen > 4 && clLen[kCodeLengthOrder[hclen - 1]] == 0)
+      --hclen;
+
+    // Size of the block with each kind of encoding
+    uint8_t fixedLengths[288 + 30];
+    std::fill(fixedLengths, fixedLengths + 144, 8);
+    std::fill(fixedLengths + 144, fixedLengths + 256, 9);
+    std::fill(fixedLengths + 256, fixedLengths + 280, 7);
+    std::fill(fixedLengths + 280, fixedLengths + 288, 8);
+    std::fill(fixedLengths + 288, fixedLengths + 318, 5);
+
+    uint64_t dynamicBits = 3 + 5 + 5 + 4 + 3 * hclen;
+    for (const auto& s : clSymbols) {
+      static constexpr int kRepeatBits[3] = { 2, 3, 7 }; // Extra bits of 16, 17, 18
+      dynamicBits += clLen[s.first] + (s.first >= 16 ? kRepeatBits[s.first - 16] : 0);
+    }
+    uint64_t fixedBits = 3;
+    for (int i = 0; i < 286; ++i) {
+      dynamicBits += uint64_t(litFreq[i]) * litLen[i];
+      fixedBits += uint64_t(litFreq[i]) * fixedLengths[i];
+    }
+    for (int i = 0; i < 30; ++i) {
+      dynamicBits += uint64_t(distFreq[i]) * distLen[i];
+      fixedBits += uint64_t(distFreq[i]) * 5;
+    }
+    for (int i = 0; i < 29; ++i) {
+      dynamicBits += uint64_t(litFreq[257 + i]) * kLengthExtra[i];
+      fixedBits += uint64_t(litFreq[257 + i]) * kLengthExtra[i];
+    }
+    for (int i = 0; i < 30; ++i) {
+      dynamicBits += uint64_t(distFreq[i]) * kDistExtra[i];
+      fixedBits += uint64_t(distFreq[i]) * kDistExtra[i];
+    }
+    const std::size_t blockBytes = m_blockEnd - m_blockStart;
+    const uint64_t storedBits = 8 * (blockBytes + 5 * (blockBytes / 65535 + 1)) + 7;
+
+    if (storedBits <= std::min(dynamicBits, fixedBits)) {
+      writeStored(m_data + m_blockStart, blockBytes, final);
+    }
+    else if (fixedBits <= dynamicBits) {
+      m_writer.put(final ? 1 : 0, 1);
+      m_writer.put(1, 2);
+      writeTokens(fixedLengths, fixedLengths + 288, 288);
+    }
+    else {
+      m_writer.put(final ? 1 : 0, 1);
+      m_writer.put(2, 2);
+      m_writer.put(hlit - 257, 5);
+      m_writer.put(hdist - 1, 5);
+      m_writer.put(hclen - 4, 4);
+      for (int i = 0; i < hclen; ++i)
+        m_writer.put(clLen[kCodeLengthOrder[i]], 3);
+
+      uint16_t clCodes[19];
+      build_codes(clLen, 19, clCodes);
+      for (const auto& s : clSymbols) {
+        m_writer.put(clCodes[s.first], clLen[s.first]);
+        switch (s.first) {
+          case 16: m_writer.put(s.second, 2); break;
+          case 17: m_writer.put(s.second, 3); break;
+          case 18: m_writer.put(s.second, 7); break;
+        }
+      }
+      writeTokens(litLen, distLen, 286);
+    }
+    m_tokens.clear();
+  }
+
+  void writeTokens(const uint8_t* litLen, const uint8_t* distLen, const int nlit)
+  {
+    uint16_t litCodes[288];
+    uint16_t distCodes[30];
+    build_codes(litLen, nlit, litCodes);
+    build_codes(distLen, 30, distCodes);
+
+    for (const Token& t : m_tokens) {
+      if (t.dist) {
+        const int lc = length_code(t.value);
+        m_writer.put(litCodes[257 + lc], litLen[257 + lc]);
+        m_writer.put(t.value - kLengthBase[lc], kLengthExtra[lc]);
+        const int dc = dist_code(t.dist);
+        m_writer.put(distCodes[dc], distLen[dc]);
+        m_writer.put(t.dist - kDistBase[dc], kDistExtra[dc]);
+      }
+      else {
+        m_writer.put(litCodes[t.value], litLen[t.value]);
+      }
+    }
+    m_writer.put(litCodes[256], litLen[256]);
+  }
+
+  void writeStored(const uint8_t* data, std::size_t n, const bool final)
+  {
+    do {
+      const std::size_t len = std::min<std::size_t>(n, 65535);
+      n -= len;
+      m_writer.put(final && n == 0 ? 1 : 0, 1);
+      m_writer.put(0, 2);
+      m_writer.align();
+      const uint8_t header[4] = {
+        uint8_t(len), uint8_t(len >> 8), uint8_t(~len), uint8_t(~len >> 8)
+      };
+      m_writer.bytes(header, 4);
+      m_writer.bytes(data, len);
+      data += len;
+    } while (n > 0);
+  }
+
+  const uint8_t* m_data;
+  std::size_t m_size;
+  BitWriter m_writer;
+  std::vector<int> m_head;
+  std::vector<int> m_prev;
+  std::vector<Token> m_tokens;
+  int m_blockStart = 0;
+  int m_blockEnd = 0;
+};
+
+} // anonymous namespace
+
+void deflate_piece(const uint8_t* data,
+                   const std::size_t size,
+                   const bool final,
+                   std::vector<uint8_t>& out)
+{
+  Deflater(data, size, out).compress(final);
+}
+
+uint32_t adler32(const uint32_t adler, const uint8_t* data, std::size_t size)
+{
+  constexpr uint32_t kBase = 65521;
+  // Max number of bytes before the sums can overflow
+  constexpr std::size_t kMaxBytes = 5552;
+
+  uint32_t a = adler & 0xffff;
+  uint32_t b = adler >> 16;
+  while (size > 0) {
+    const std::size_t n = std::min(size, kMaxBytes);
+    for (std::size_t i = 0; i < n; ++i) {
+      a += data[i];
+      b += a;
+    }
+    a %= kBase;
+    b %= kBase;
+    data += n;
+    size -= n;
+  }
+  return (b << 16) | a;
+}
+
+uint32_t adler32_combine(const uint32_t adler1, const uint32_t adler2, const std::size_t size2)
+{
+  constexpr uint32_t kBase = 65521;
+  const uint32_t rem = uint32_t(size2 % kBase);
+  uint32_t a = adler1 & 0xffff;
+  uint32_t b = uint32_t((uint64_t(rem) * a) % kBase);
+  a += (adler2 & 0xffff) + kBase - 1;
+  b += (adler1 >> 16) + (adler2 >> 16) + kBase - rem;
+  if (a >= kBase)
+    a -= kBase;
+  if (a >= kBase)
+    a -= kBase;
+  if (b >= (kBase << 1))
+    b -= (kBase << 1);
+  if (b >= kBase)
+    b -= kBase;
+  return (b << 16) | a;
+}
+
+} // namespace os
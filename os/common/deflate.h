@@ -0,0 +1,36 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_DEFLATE_H_INCLUDED
+#define OS_COMMON_DEFLATE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace os {
+
+// Compresses "data" as a piece of a raw deflate stream (RFC 1951)
+// and appends it to "out". The piece doesn't reference data of
+// previous pieces, so different pieces can be compressed in
+// parallel and concatenated (like pigz does). If "final" is false,
+// the piece ends with an empty stored block (a sync flush) so the
+// next piece starts in a byte boundary. The last piece of the stream
+// must be "final".
+void deflate_piece(const uint8_t* data, std::size_t size, bool final, std::vector<uint8_t>& out);
+
+// Adler-32 checksum used in zlib streams (start with adler=1).
+uint32_t adler32(uint32_t adler, const uint8_t* data, std::size_t size);
+
+// Returns the Adler-32 of two concatenated pieces of data, where
+// "size2" is the size of the second piece.
+uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, std::size_t size2);
+
+} // namespace os
+
+#endif
@@ -0,0 +1,143 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "os/common/deflate.h"
+#include "os/common/inflate.h"
+
+#include <random>
+#include <vector>
+
+using namespace os;
+
+// Compresses "data" in pieces of "pieceSize" bytes as a zlib stream
+static std::vector<uint8_t> compress(const std::vector<uint8_t>& data, const std::size_t pieceSize)
+{
+  std::vector<uint8_t> out = { 0x78, 0x9c };
+  uint32_t adler = 1;
+  std::size_t pos = 0;
+  do {
+    const std::size_t n = std::min(pieceSize, data.size() - pos);
+    deflate_piece(data.data() + pos, n, pos + n == data.size(), out);
+    adler = adler32_combine(adler, adler32(1, data.data() + pos, n), n);
+    pos += n;
+  } while (pos < data.size());
+
+  for (int i = 24; i >= 0; i -= 8)
+    out.push_back(uint8_t(adler >> i));
+  return out;
+}
+
+static std::vector<uint8_t> decompress(const std::vector<uint8_t>& compressed,
+                                       const std::size_t size)
+{
+  bool done = false;
+  Inflater inflater([&](const uint8_t*& data, std::size_t& n) {
+    if (done)
+      return false;
+    data = compressed.data();
+    n = compressed.size();
+    done = true;
+    return true;
+  });
+  std::vector<uint8_t> out(size);
+  if (size > 0 && !inflater.read(out.data(), size))
+    return {};
+  // The stream must end here
+  uint8_t extra;
+  if (inflater.read(&extra, 1))
+    return {};
+  return out;
+}
+
+static std::vector<std::vector<uint8_t>> test_data()
+{
+  std::mt19937 rng(1);
+  std::vector<std::vector<uint8_t>> result;
+  result.push_back({});
+  result.push_back({ 42 });
+  result.push_back(std::vector<uint8_t>(100000, 7));
+
+  // Random bytes (incompressible)
+  std::vector<uint8_t> random(70000);
+  for (uint8_t& v : random)
+    v = uint8_t(rng());
+  result.push_back(random);
+
+  // Repeated patterns with some noise (like image rows)
+  std::vector<uint8_t> rows;
+  for (int y = 0; y < 300; ++y) {
+    for (int x = 0; x < 1000; ++x)
+      rows.push_back(uint8_t((x * 3 + y / 10) ^ (rng() % 16 == 0 ? rng() : 0)));
+  }
+  result.push_back(rows);
+
+  // Text
+  std::string text;
+  for (int i = 0; i < 2000; ++i)
+    text += "The quick brown fox " + std::to_string(i * 37 % 101) + " jumps over the lazy dog\n";
+  result.push_back(std::vector<uint8_t>(text.begin(), text.end()));
+  return result;
+}
+
+TEST(Deflate, RoundTrip)
+{
+  for (const std::vector<uint8_t>& data : test_data()) {
+    const std::vector<uint8_t> compressed = compress(data, data.size() + 1);
+    EXPECT_EQ(data, decompress(compressed, data.size())) << data.size();
+  }
+}
+
+TEST(Deflate, Pieces)
+{
+  for (const std::vector<uint8_t>& data : test_data()) {
+    for (const std::size_t pieceSize : { 1000, 32768, 65536 }) {
+      const std::vector<uint8_t> compressed = compress(data, pieceSize);
+      EXPECT_EQ(data, decompress(compressed, data.size())) << data.size() << " " << pieceSize;
+    }
+  }
+}
+
+TEST(Deflate, CompressionRatio)
+{
+  const std::vector<uint8_t> data(100000, 7);
+  EXPECT_LT(compress(data, data.size()).size(), 1000);
+
+  // Incompressible data uses stored blocks
+  std::mt19937 rng(2);
+  std::vector<uint8_t> random(100000);
+  for (uint8_t& v : random)
+    v = uint8_t(rng());
+  EXPECT_LT(compress(random, random.size()).size(), random.size() + 100);
+}
+
+TEST(Deflate, Adler32)
+{
+  const std::string s = "Wikipedia";
+  EXPECT_EQ(0x11e60398, adler32(1, (const uint8_t*)s.data(), s.size()));
+
+  std::mt19937 rng(3);
+  std::vector<uint8_t> data(20000);
+  for (uint8_t& v : data)
+    v = uint8_t(rng());
+  const uint32_t whole = adler32(1, data.data(), data.size());
+  for (const std::size_t split : { 0, 1, 5552, 10000, 20000 }) {
+    const uint32_t a = adler32(1, data.data(), split);
+    const uint32_t b = adler32(1, data.data() + split, data.size() - split);
+    EXPECT_EQ(whole, adler32_combine(a, b, data.size() - split)) << split;
+  }
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
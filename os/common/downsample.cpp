@@ -0,0 +1,224 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/downsample.h"
+
+#include "base/simd.h"
+#include "gfx/point.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Number of taps (source pixels in each axis) of the Lanczos filter
+// used to calculate one pixel of the half-size image.
+constexpr int kLanczosTaps = 8;
+
+// Lanczos-2 kernel
+double lanczos2(const double x)
+{
+  constexpr double kPi = 3.14159265358979323846;
+  if (x == 0.0)
+    return 1.0;
+  if (x <= -2.0 || x >= 2.0)
+    return 0.0;
+  const double px = kPi * x;
+  return 2.0 * std::sin(px) * std::sin(px / 2.0) / (px * px);
+}
+
+// Weights of the source pixels 2x-3...2x+4 for the destination pixel
+// x (its center is between the source pixels 2x and 2x+1).
+struct LanczosWeights {
+  float w[kLanczosTaps];
+
+  LanczosWeights()
+  {
+    double total = 0.0;
+    for (int t = 0; t < kLanczosTaps; ++t) {
+      // Distance in destination pixels
+      w[t] = float(lanczos2((t - 3.5) / 2.0));
+      total += w[t];
+    }
+    for (float& v : w)
+      v = float(v / total);
+  }
+};
+
+inline uint32_t channel(const uint32_t p, const int c)
+{
+  return (p >> (c * 8)) & 0xff;
+}
+
+inline uint32_t box_pixel(const uint32_t a, const uint32_t b, const uint32_t c, const uint32_t d)
+{
+  uint32_t result = 0;
+  for (int i = 0; i < 4; ++i) {
+    const uint32_t sum = channel(a, i) + channel(b, i) + channel(c, i) + channel(d, i);
+    result |= ((sum + 2) >> 2) << (i * 8);
+  }
+  return result;
+}
+
+void downsample_box(const uint32_t* src,
+                    const int srcWidth,
+                    const int srcHeight,
+                    const int srcStride,
+                    uint32_t* dst,
+                    const int dstStride,
+                    const gfx::Rect& dstArea)
+{
+  for (int y = dstArea.y; y < dstArea.y2(); ++y) {
+    const uint32_t* row0 = src + 2 * y * srcStride;
+    const uint32_t* row1 = (2 * y + 1 < srcHeight ? row0 + srcStride : row0);
+    uint32_t* dstRow = dst + y * dstStride;
+
+    int x = dstArea.x;
+#if LAF_SSE2
+    // Two destination pixels (4x2 source pixels) in each iteration
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    for (; x + 2 <= dstArea.x2() && 2 * x + 4 <= srcWidth; x += 2) {
+      const __m128i a = _mm_loadu_si128((const __m128i*)(row0 + 2 * x));
+      const __m128i b = _mm_loadu_si128((const __m128i*)(row1 + 2 * x));
+      // Vertical sums of the 4 columns as 16-bit channels
+      const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+      const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+      // Horizontal sums of each pair of columns
+      const __m128i sumLo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+      const __m128i sumHi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+      __m128i sum = _mm_unpacklo_epi64(sumLo, sumHi);
+      sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+      _mm_storel_epi64((__m128i*)(dstRow + x), _mm_packus_epi16(sum, zero));
+    }
+#endif
+
+    for (; x < dstArea.x2(); ++x) {
+      const int x0 = 2 * x;
+      const int x1 = std::min(x0 + 1, srcWidth - 1);
+      dstRow[x] = box_pixel(row0[x0], row0[x1], row1[x0], row1[x1]);
+    }
+  }
+}
+
+void downsample_lanczos(const uint32_t* src,
+                        const int srcWidth,
+                        const int srcHeight,
+                        const int srcStride,
+                        uint32_t* dst,
+                        const int dstStride,
+                        const gfx::Rect& dstArea,
+                        const SurfaceFormatData& fd)
+{
+  static const LanczosWeights weights;
+  const float* w = weights.w;
+
+  // Horizontal pass: source rows 2*y-3...2*y+4 of all destination
+  // rows, only the destination columns of the area.
+  const int firstRow = 2 * dstArea.y - 3;
+  const int nrows = 2 * dstArea.h + kLanczosTaps - 2;
+  const int ncols = dstArea.w;
+  std::vector<float> tmp(std::size_t(nrows) * ncols * 4);
+
+  for (int r = 0; r < nrows; ++r) {
+    const int sy = std::clamp(firstRow + r, 0, srcHeight - 1);
+    const uint32_t* srcRow = src + sy * srcStride;
+    float* out = &tmp[std::size_t(r) * ncols * 4];
+
+    for (int x = dstArea.x; x < dstArea.x2(); ++x, out += 4) {
+      float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      for (int t = 0; t < kLanczosTaps; ++t) {
+        const uint32_t p = srcRow[std::clamp(2 * x - 3 + t, 0, srcWidth - 1)];
+        for (int c = 0; c < 4; ++c)
+          acc[c] += channel(p, c) * w[t];
+      }
+      for (int c = 0; c < 4; ++c)
+        out[c] = acc[c];
+    }
+  }
+
+  // Vertical pass
+  const bool premultiplied = (fd.pixelAlpha == PixelAlpha::kPremultiplied);
+  const int alphaChannel = int(fd.alphaShift / 8);
+
+  for (int y = 0; y < dstArea.h; ++y) {
+    uint32_t* dstRow = dst + (dstArea.y + y) * dstStride + dstArea.x;
+    for (int x = 0; x < ncols; ++x) {
+      float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      const float* in = &tmp[(std::size_t(2 * y) * ncols + x) * 4];
+      for (int t = 0; t < kLanczosTaps; ++t, in += std::size_t(ncols) * 4) {
+        for (int c = 0; c < 4; ++c)
+          acc[c] += in[c] * w[t];
+      }
+
+      int v[4];
+      for (int c = 0; c < 4; ++c)
+        v[c] = std::clamp(int(std::lround(acc[c])), 0, 255);
+
+      // The negative lobes of the filter can create colors that are
+      // not valid premultiplied values
+      if (premultiplied) {
+        for (int c = 0; c < 4; ++c) {
+          if (c != alphaChannel)
+            v[c] = std::min(v[c], v[alphaChannel]);
+        }
+      }
+
+      dstRow[x] = uint32_t(v[0]) | (uint32_t(v[1]) << 8) | (uint32_t(v[2]) << 16) |
+                  (uint32_t(v[3]) << 24);
+    }
+  }
+}
+
+} // anonymous namespace
+
+gfx::Rect downsample_area(const gfx::Rect& area, const DownsampleFilter filter)
+{
+  if (area.isEmpty())
+    return gfx::Rect();
+
+  // Each destination pixel reads 2 (box) or 8 (Lanczos) source pixels
+  const int border = (filter == DownsampleFilter::Lanczos ? 2 : 0);
+  const int x1 = area.x / 2 - border;
+  const int y1 = area.y / 2 - border;
+  const int x2 = (area.x2() + 1) / 2 + border;
+  const int y2 = (area.y2() + 1) / 2 + border;
+  return gfx::Rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+void downsample_half(const uint32_t* src,
+                     const int srcWidth,
+                     const int srcHeight,
+                     const int srcStride,
+                     uint32_t* dst,
+                     const int dstStride,
+                     const gfx::Rect& dstArea,
+                     const SurfaceFormatData& fd,
+                     const DownsampleFilter filter)
+{
+  const gfx::Rect area =
+    dstArea & gfx::Rect(0, 0, downsample_size(srcWidth), downsample_size(srcHeight));
+  if (area.isEmpty())
+    return;
+
+  switch (filter) {
+    case DownsampleFilter::Box:
+      downsample_box(src, srcWidth, srcHeight, srcStride, dst, dstStride, area);
+      break;
+    case DownsampleFilter::Lanczos:
+      downsample_lanczos(src, srcWidth, srcHeight, srcStride, dst, dstStride, area, fd);
+      break;
+  }
+}
+
+} // namespace os
@@ -0,0 +1,52 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_DOWNSAMPLE_H_INCLUDED
+#define OS_COMMON_DOWNSAMPLE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/rect.h"
+#include "os/surface_format.h"
+
+namespace os {
+
+enum class DownsampleFilter {
+  Box,     // Average of 2x2 pixels
+  Lanczos, // Lanczos-2 windowed sinc (8x8 pixels), sharper
+};
+
+// Returns the size of the next level of an image pyramid (half size
+// rounded up).
+inline int downsample_size(const int size)
+{
+  return (size + 1) / 2;
+}
+
+// Returns the area of the half-size image affected by the given area
+// of the full-size image (e.g. to update the next pyramid level when
+// the image is modified).
+gfx::Rect downsample_area(const gfx::Rect& area, DownsampleFilter filter);
+
+// Calculates the pixels inside "dstArea" of the half-size image
+// "dst" from the 32bpp image "src" (strides are in pixels). Both
+// images use the "fd" format, the color channels are filtered
+// independently (so premultiplied values stay premultiplied).
+// Different areas can be calculated from different threads at the
+// same time.
+void downsample_half(const uint32_t* src,
+                     int srcWidth,
+                     int srcHeight,
+                     int srcStride,
+                     uint32_t* dst,
+                     int dstStride,
+                     const gfx::Rect& dstArea,
+                     const SurfaceFormatData& fd,
+                     DownsampleFilter filter);
+
+} // namespace os
+
+#endif
@@ -0,0 +1,162 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/point.h"
+#include "os/common/downsample.h"
+#include "os/common/test_support.h"
+
+#include <random>
+#include <vector>
+
+using namespace os;
+
+static std::vector<uint32_t> downsample(const std::vector<uint32_t>& src,
+                                        const int w,
+                                        const int h,
+                                        const DownsampleFilter filter)
+{
+  const int dw = downsample_size(w);
+  const int dh = downsample_size(h);
+  std::vector<uint32_t> dst(dw * dh, 0);
+  downsample_half(src.data(),
+                  w,
+                  h,
+                  w,
+                  dst.data(),
+                  dw,
+                  gfx::Rect(0, 0, dw, dh),
+                  rgba_format(PixelAlpha::kPremultiplied),
+                  filter);
+  return dst;
+}
+
+TEST(Downsample, Size)
+{
+  EXPECT_EQ(1, downsample_size(1));
+  EXPECT_EQ(1, downsample_size(2));
+  EXPECT_EQ(2, downsample_size(3));
+  EXPECT_EQ(512, downsample_size(1024));
+}
+
+TEST(Downsample, Area)
+{
+  EXPECT_EQ(gfx::Rect(), downsample_area(gfx::Rect(), DownsampleFilter::Box));
+  EXPECT_EQ(gfx::Rect(0, 0, 1, 1), downsample_area(gfx::Rect(0, 0, 1, 1), DownsampleFilter::Box));
+  EXPECT_EQ(gfx::Rect(1, 2, 2, 1), downsample_area(gfx::Rect(3, 4, 2, 2), DownsampleFilter::Box));
+  EXPECT_EQ(gfx::Rect(-1, 0, 6, 5),
+            downsample_area(gfx::Rect(3, 4, 2, 2), DownsampleFilter::Lanczos));
+}
+
+TEST(Downsample, Box)
+{
+  // clang-format off
+  const std::vector<uint32_t> src = {
+    0xff000000, 0xff000004, 0x00000000, 0x00000000, 0xffffffff,
+    0xff000008, 0xff00000c, 0x00000000, 0x80808080, 0xffffffff,
+    0x10203040, 0x10203040, 0x10203040, 0x10203040, 0x10203040,
+  };
+  // clang-format on
+  const std::vector<uint32_t> dst = downsample(src, 5, 3, DownsampleFilter::Box);
+  ASSERT_EQ(6, dst.size());
+  EXPECT_EQ(0xff000006, dst[0]);
+  EXPECT_EQ(0x20202020, dst[1]);
+  EXPECT_EQ(0xffffffff, dst[2]); // Last column is repeated
+  EXPECT_EQ(0x10203040, dst[3]); // Last row is repeated
+  EXPECT_EQ(0x10203040, dst[4]);
+  EXPECT_EQ(0x10203040, dst[5]);
+}
+
+TEST(Downsample, BoxMatchesReference)
+{
+  std::mt19937 rng(1);
+  for (int iter = 0; iter < 200; ++iter) {
+    const int w = 1 + rng() % 40;
+    const int h = 1 + rng() % 10;
+    std::vector<uint32_t> src(w * h);
+    for (uint32_t& p : src)
+      p = rng();
+
+    const std::vector<uint32_t> dst = downsample(src, w, h, DownsampleFilter::Box);
+    const int dw = downsample_size(w);
+    for (int y = 0; y < downsample_size(h); ++y) {
+      for (int x = 0; x < dw; ++x) {
+        uint32_t expected = 0;
+        for (int c = 0; c < 4; ++c) {
+          int sum = 0;
+          for (int v = 0; v < 2; ++v) {
+            for (int u = 0; u < 2; ++u) {
+              const int sx = std::min(2 * x + u, w - 1);
+              const int sy = std::min(2 * y + v, h - 1);
+              const uint32_t p = src[sy * w + sx];
+              sum += (p >> (c * 8)) & 0xff;
+            }
+          }
+          expected |= uint32_t((sum + 2) / 4) << (c * 8);
+        }
+        ASSERT_EQ(expected, dst[y * dw + x]) << w << "x" << h << " pixel " << x << "," << y;
+      }
+    }
+  }
+}
+
+TEST(Downsample, LanczosKeepsSolidColors)
+{
+  const std::vector<uint32_t> src(17 * 9, 0x80402010);
+  for (const uint32_t p : downsample(src, 17, 9, DownsampleFilter::Lanczos))
+    EXPECT_EQ(0x80402010, p);
+}
+
+TEST(Downsample, LanczosKeepsPremultipliedValues)
+{
+  std::mt19937 rng(2);
+  std::vector<uint32_t> src(32 * 32);
+  for (uint32_t& p : src) {
+    // Opaque white or transparent pixels (sharp edges create
+    // overshoots in the filter)
+    p = (rng() % 2 ? 0xffffffff : 0);
+  }
+  for (const uint32_t p : downsample(src, 32, 32, DownsampleFilter::Lanczos)) {
+    const uint32_t a = p >> 24;
+    EXPECT_LE(p & 0xff, a);
+    EXPECT_LE((p >> 8) & 0xff, a);
+    EXPECT_LE((p >> 16) & 0xff, a);
+  }
+}
+
+TEST(Downsample, OnlyArea)
+{
+  const std::vector<uint32_t> src(8 * 8, 0xffffffff);
+  for (const auto filter : { DownsampleFilter::Box, DownsampleFilter::Lanczos }) {
+    std::vector<uint32_t> dst(4 * 4, 0);
+    downsample_half(src.data(),
+                    8,
+                    8,
+                    8,
+                    dst.data(),
+                    4,
+                    gfx::Rect(1, 1, 2, 3),
+                    rgba_format(PixelAlpha::kPremultiplied),
+                    filter);
+    for (int y = 0; y < 4; ++y) {
+      for (int x = 0; x < 4; ++x) {
+        const bool inside = gfx::Rect(1, 1, 2, 3).contains(gfx::Point(x, y));
+        EXPECT_EQ(inside ? 0xffffffff : 0, dst[y * 4 + x]);
+      }
+    }
+  }
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
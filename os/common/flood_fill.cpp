@@ -0,0 +1,381 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/flood_fill.h"
+
+#include "base/thread_pool.h"
+#include "gfx/hsv.h"
+#include "gfx/rgb.h"
+#include "os/common/surface_utils.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Rows labeled in each task
+constexpr int kRowsPerTask = 64;
+
+// Parent of transparent pixels in the union-find of
+// label_components()
+constexpr uint32_t kBackground = UINT32_MAX;
+
+// Compares pixels with the color of the seed pixel
+class ColorMatcher {
+public:
+  ColorMatcher(const SurfaceFormatData& fd, const uint32_t seed, const FillOptions& options)
+    : m_fd(fd)
+    , m_seed(seed)
+    , m_tolerance(std::clamp(options.tolerance, 0, 255))
+    , m_hsv(options.colorSpace == FillColorSpace::Hsv)
+    , m_lastColor(seed)
+  {
+    m_seedComponents = components(seed);
+  }
+
+  bool operator()(const uint32_t color)
+  {
+    if (color == m_seed)
+      return true;
+
+    // Areas of similar colors usually have runs of the same color
+    if (color != m_lastColor) {
+      m_lastColor = color;
+      m_lastMatch = match(components(color));
+    }
+    return m_lastMatch;
+  }
+
+private:
+  // Unpremultiplied RGBA or HSVA components scaled to [0,255] (the
+  // hue is in degrees)
+  struct Components {
+    double c[4];
+    double saturation;
+  };
+
+  Components components(const uint32_t color) const
+  {
+    const int a = (m_fd.alphaMask ? (color & m_fd.alphaMask) >> m_fd.alphaShift : 255);
+    if (a == 0)
+      return Components{ { 0.0, 0.0, 0.0, 0.0 }, 0.0 };
+
+    int r = (color & m_fd.redMask) >> m_fd.redShift;
+    int g = (color & m_fd.greenMask) >> m_fd.greenShift;
+    int b = (color & m_fd.blueMask) >> m_fd.blueShift;
+    if (m_fd.pixelAlpha == PixelAlpha::kPremultiplied && a < 255) {
+      r = std::min((r * 255 + a / 2) / a, 255);
+      g = std::min((g * 255 + a / 2) / a, 255);
+      b = std::min((b * 255 + a / 2) / a, 255);
+    }
+    if (!m_hsv)
+      return Components{ { double(r), double(g), double(b), double(a) }, 0.0 };
+
+    const gfx::Hsv hsv(gfx::Rgb(r, g, b));
+    return Components{
+      { hsv.hue(), 255.0 * hsv.saturation(), 255.0 * hsv.value(), double(a) },
+      hsv.saturation()
+    };
+  }
+
+  bool match(const Components& k) const
+  {
+    const double tolerance = m_tolerance + 1e-9;
+    if (std::fabs(k.c[3] - m_seedComponents.c[3]) > tolerance)
+      return false;
+
+    int i = 0;
+    if (m_hsv) {
+      double hue = std::fabs(k.c[0] - m_seedComponents.c[0]);
+      hue = std::min(hue, 360.0 - hue) * 255.0 / 180.0;
+      if (hue * std::min(k.saturation, m_seedComponents.saturation) > tolerance)
+        return false;
+      i = 1;
+    }
+    for (; i < 3; ++i) {
+      if (std::fabs(k.c[i] - m_seedComponents.c[i]) > tolerance)
+        return false;
+    }
+    return true;
+  }
+
+  const SurfaceFormatData& m_fd;
+  const uint32_t m_seed;
+  const int m_tolerance;
+  const bool m_hsv;
+  Components m_seedComponents;
+  uint32_t m_lastColor;
+  bool m_lastMatch = true;
+};
+
+// Union-find where the root of each set is its lowest index, so the
+// parent of each element is never after the element itself.
+class DisjointSets {
+public:
+  explicit DisjointSets(const std::size_t n) : m_parent(n) {}
+
+  uint32_t& operator[](const std::size_t i) { return m_parent[i]; }
+
+  uint32_t find(uint32_t i)
+  {
+    while (m_parent[i] != i) {
+      m_parent[i] = m_parent[m_parent[i]];
+      i = m_parent[i];
+    }
+    return i;
+  }
+
+  void unite(uint32_t a, uint32_t b)
+  {
+    a = find(a);
+    b = find(b);
+    if (a < b)
+      m_parent[b] = a;
+    else if (b < a)
+      m_parent[a] = b;
+  }
+
+private:
+  std::vector<uint32_t> m_parent;
+};
+
+// Joins the pixel (x, y) with its neighbors of the previous row
+void unite_above(const uint32_t* row,
+                 const int stride,
+                 const int width,
+                 const int x,
+                 const uint32_t p,
+                 const bool eight,
+                 DisjointSets& components)
+{
+  const uint32_t* above = row - stride;
+  const uint32_t c = row[x];
+  if (above[x] == c)
+    components.unite(p, p - width);
+  if (eight) {
+    if (x > 0 && above[x - 1] == c)
+      components.unite(p, p - width - 1);
+    if (x < width - 1 && above[x + 1] == c)
+      components.unite(p, p - width + 1);
+  }
+}
+
+} // anonymous namespace
+
+gfx::Rect flood_fill(const uint32_t* pixels,
+                     const int stride,
+                     const gfx::Size& size,
+                     const SurfaceFormatData& fd,
+                     const gfx::Point& seed,
+                     const FillOptions& options,
+                     uint8_t* mask,
+                     const int maskStride)
+{
+  if (!gfx::Rect(size).contains(seed))
+    return gfx::Rect();
+
+  ColorMatcher match(fd, pixels[std::size_t(seed.y) * stride + seed.x], options);
+  auto fillable = [&](const int x, const int y) {
+    return (mask[std::size_t(y) * maskStride + x] == 0 &&
+            match(pixels[std::size_t(y) * stride + x]));
+  };
+
+  const int d = (options.connectivity == FillConnectivity::Eight ? 1 : 0);
+  int bx1 = INT_MAX, by1 = INT_MAX;
+  int bx2 = INT_MIN, by2 = INT_MIN;
+
+  // Each point in the stack is the start of a span to fill
+  std::vector<gfx::Point> stack;
+  stack.push_back(seed);
+  while (!stack.empty()) {
+    const gfx::Point pt = stack.back();
+    stack.pop_back();
+    if (!fillable(pt.x, pt.y))
+      continue;
+
+    int x1 = pt.x;
+    int x2 = pt.x;
+    while (x1 > 0 && fillable(x1 - 1, pt.y))
+      --x1;
+    while (x2 < size.w - 1 && fillable(x2 + 1, pt.y))
+      ++x2;
+    std::memset(mask + std::size_t(pt.y) * maskStride + x1, 255, x2 - x1 + 1);
+
+    bx1 = std::min(bx1, x1);
+    bx2 = std::max(bx2, x2);
+    by1 = std::min(by1, pt.y);
+    by2 = std::max(by2, pt.y);
+
+    // Add one point for each span of fillable pixels that touches
+    // this span in the rows above and below
+    for (const int y : { pt.y - 1, pt.y + 1 }) {
+      if (y < 0 || y >= size.h)
+        continue;
+      const int sx2 = std::min(x2 + d, size.w - 1);
+      bool inSpan = false;
+      for (int x = std::max(x1 - d, 0); x <= sx2; ++x) {
+        if (fillable(x, y)) {
+          if (!inSpan)
+            stack.push_back(gfx::Point(x, y));
+          inSpan = true;
+        }
+        else {
+          inSpan = false;
+        }
+      }
+    }
+  }
+
+  if (bx1 > bx2)
+    return gfx::Rect();
+  return gfx::Rect(bx1, by1, bx2 - bx1 + 1, by2 - by1 + 1);
+}
+
+#if LAF_WITH_REGION
+gfx::Region flood_fill_region(const Surface* surface,
+                              const gfx::Point& seed,
+                              const FillOptions& options)
+{
+  gfx::Region region;
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return region;
+
+  SurfaceLock lock(surface);
+  const uint32_t* pixels = (const uint32_t*)surface->getData(0, 0);
+  if (!pixels)
+    return region;
+
+  const int w = surface->width();
+  const int h = surface->height();
+  std::vector<uint8_t> mask(std::size_t(w) * h, 0);
+  const gfx::Rect bounds =
+    flood_fill(pixels, row_stride(surface), gfx::Size(w, h), fd, seed, options, mask.data(), w);
+
+  // Convert the spans of each row to rectangles, merging the spans of
+  // consecutive rows with the same horizontal bounds ("open" are the
+  // rectangles that reach the previous row)
+  std::vector<gfx::Rect> rects, open, next;
+  for (int y = bounds.y; y < bounds.y2(); ++y) {
+    const uint8_t* row = mask.data() + std::size_t(y) * w;
+    next.clear();
+    for (int x = bounds.x; x < bounds.x2();) {
+      if (!row[x]) {
+        ++x;
+        continue;
+      }
+      const int x1 = x;
+      while (x < bounds.x2() && row[x])
+        ++x;
+
+      gfx::Rect rc(x1, y, x - x1, 1);
+      auto it = std::find_if(open.begin(), open.end(), [&rc](const gfx::Rect& prev) {
+        return prev.x == rc.x && prev.w == rc.w;
+      });
+      if (it != open.end()) {
+        rc.y = it->y;
+        rc.h = it->h + 1;
+        open.erase(it);
+      }
+      next.push_back(rc);
+    }
+    // Rectangles that don't continue in this row are finished
+    rects.insert(rects.end(), open.begin(), open.end());
+    open.swap(next);
+  }
+  rects.insert(rects.end(), open.begin(), open.end());
+
+  for (const gfx::Rect& rc : rects)
+    region |= gfx::Region(rc);
+  return region;
+}
+#endif
+
+int label_components(const uint32_t* pixels,
+                     const int stride,
+                     const gfx::Size& size,
+                     const SurfaceFormatData& fd,
+                     const FillConnectivity connectivity,
+                     uint32_t* labels,
+                     const int labelsStride,
+                     base::thread_pool* pool)
+{
+  if (size.w <= 0 || size.h <= 0)
+    return 0;
+
+  const int w = size.w;
+  const bool eight = (connectivity == FillConnectivity::Eight);
+  const uint32_t alphaMask = fd.alphaMask;
+  DisjointSets components(std::size_t(w) * size.h);
+
+  // First pass: each band of rows is labeled independently (sets
+  // only reference pixels of the same band)
+  base::for_each_task(pool, size.h, kRowsPerTask, [&](const int y1, const int y2) {
+    for (int y = y1; y < y2; ++y) {
+      const uint32_t* row = pixels + std::size_t(y) * stride;
+      uint32_t p = uint32_t(y) * w;
+      for (int x = 0; x < w; ++x, ++p) {
+        if (alphaMask && !(row[x] & alphaMask)) {
+          components[p] = kBackground;
+          continue;
+        }
+        components[p] = p;
+        if (x > 0 && row[x - 1] == row[x])
+          components.unite(p, p - 1);
+        if (y > y1)
+          unite_above(row, stride, w, x, p, eight, components);
+      }
+    }
+  });
+
+  // Join the sets of the first row of each band with the previous
+  // band
+  for (int y = kRowsPerTask; pool && y < size.h; y += kRowsPerTask) {
+    const uint32_t* row = pixels + std::size_t(y) * stride;
+    uint32_t p = uint32_t(y) * w;
+    for (int x = 0; x < w; ++x, ++p) {
+      if (components[p] != kBackground)
+        unite_above(row, stride, w, x, p, eight, components);
+    }
+  }
+
+  // Replace the parent of each pixel with its final label (parents
+  // are before their children, so they already have their labels)
+  uint32_t count = 0;
+  const std::size_t n = std::size_t(w) * size.h;
+  for (std::size_t i = 0; i < n; ++i) {
+    const uint32_t parent = components[i];
+    if (parent == kBackground)
+      continue;
+    components[i] = (parent == i ? ++count : components[parent]);
+  }
+
+  // Second pass
+  base::for_each_task(pool, size.h, kRowsPerTask, [&](const int y1, const int y2) {
+    for (int y = y1; y < y2; ++y) {
+      uint32_t* row = labels + std::size_t(y) * labelsStride;
+      uint32_t p = uint32_t(y) * w;
+      for (int x = 0; x < w; ++x, ++p) {
+        const uint32_t label = components[p];
+        row[x] = (label == kBackground ? 0 : label);
+      }
+    }
+  });
+  return int(count);
+}
+
+} // namespace os
@@ -0,0 +1,102 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_FLOOD_FILL_H_INCLUDED
+#define OS_COMMON_FLOOD_FILL_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/surface_format.h"
+
+#if LAF_WITH_REGION
+  #include "gfx/region.h"
+#endif
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+enum class FillConnectivity {
+  Four,  // Only horizontal/vertical neighbors are connected
+  Eight, // Diagonal neighbors are connected too
+};
+
+enum class FillColorSpace {
+  // Each RGBA channel is compared
+  Rgba,
+  // Hue, saturation, value and alpha are compared (scaled to
+  // [0,255]). The hue difference is multiplied by the lowest
+  // saturation of both colors, so the hue of grays is ignored.
+  Hsv,
+};
+
+struct FillOptions {
+  FillConnectivity connectivity = FillConnectivity::Four;
+  FillColorSpace colorSpace = FillColorSpace::Rgba;
+
+  // Maximum difference of each component with the color of the seed
+  // pixel [0,255]. With 0, only the same color is filled. Fully
+  // transparent pixels are equal whatever their RGB values are.
+  int tolerance = 0;
+};
+
+// Fills the area connected to "seed" with colors similar to the
+// color of the seed pixel in the 32bpp image "pixels" (the stride is
+// in pixels). The filled pixels are set to 255 in "mask" (8-bit, the
+// stride is in bytes). Pixels != 0 in "mask" are considered already
+// filled, so it should be cleared before calling this function.
+//
+// The fill walks horizontal spans (each row of the area is scanned
+// once to find the spans of the rows above and below), so it needs
+// memory proportional to the number of spans and not to the number of
+// pixels (like recursive fills). Returns the bounds of the filled
+// pixels (empty if "seed" is outside the image).
+gfx::Rect flood_fill(const uint32_t* pixels,
+                     int stride,
+                     const gfx::Size& size,
+                     const SurfaceFormatData& fd,
+                     const gfx::Point& seed,
+                     const FillOptions& options,
+                     uint8_t* mask,
+                     int maskStride);
+
+#if LAF_WITH_REGION
+// Same as flood_fill() for a 32bpp surface, returning the filled
+// area as a region (e.g. for a "select by color" tool).
+gfx::Region flood_fill_region(const Surface* surface,
+                              const gfx::Point& seed,
+                              const FillOptions& options);
+#endif
+
+// Labels the connected areas of pixels with the same color of the
+// 32bpp image "pixels". Each area gets a different label from 1 to
+// the returned number of areas (labels are given in the order of the
+// top-left pixel of each area), and fully transparent pixels get the
+// label 0 (background).
+//
+// It's a two-pass labeling with union-find: bands of rows are labeled
+// in parallel (if "pool" is not nullptr), the labels of pixels at the
+// border of two bands are merged, and the final labels are written in
+// parallel.
+int label_components(const uint32_t* pixels,
+                     int stride,
+                     const gfx::Size& size,
+                     const SurfaceFormatData& fd,
+                     FillConnectivity connectivity,
+                     uint32_t* labels,
+                     int labelsStride,
+                     base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
@@ -0,0 +1,309 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "os/common/flood_fill.h"
+#include "os/common/test_support.h"
+
+#include <deque>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace os;
+
+static const SurfaceFormatData kRgba = rgba_format(PixelAlpha::kStraight);
+
+static const int kDx[] = { -1, 1, 0, 0, -1, 1, -1, 1 };
+static const int kDy[] = { 0, 0, -1, 1, -1, -1, 1, 1 };
+
+// Breadth-first fill of the pixels connected to "seed" for which
+// "match" is true
+static std::vector<uint8_t> reference_fill(const int w,
+                                           const int h,
+                                           const gfx::Point& seed,
+                                           const FillConnectivity connectivity,
+                                           const std::function<bool(int, int)>& match)
+{
+  std::vector<uint8_t> mask(w * h, 0);
+  std::deque<gfx::Point> queue{ seed };
+  mask[seed.y * w + seed.x] = 255;
+  const int n = (connectivity == FillConnectivity::Eight ? 8 : 4);
+  while (!queue.empty()) {
+    const gfx::Point pt = queue.front();
+    queue.pop_front();
+    for (int i = 0; i < n; ++i) {
+      const int x = pt.x + kDx[i], y = pt.y + kDy[i];
+      if (x >= 0 && y >= 0 && x < w && y < h && !mask[y * w + x] && match(x, y)) {
+        mask[y * w + x] = 255;
+        queue.push_back(gfx::Point(x, y));
+      }
+    }
+  }
+  return mask;
+}
+
+static std::vector<uint8_t> fill(const std::vector<uint32_t>& pixels,
+                                 const int w,
+                                 const int h,
+                                 const gfx::Point& seed,
+                                 const FillOptions& options,
+                                 gfx::Rect* bounds = nullptr)
+{
+  std::vector<uint8_t> mask(w * h, 0);
+  const gfx::Rect rc =
+    flood_fill(pixels.data(), w, gfx::Size(w, h), kRgba, seed, options, mask.data(), w);
+  if (bounds)
+    *bounds = rc;
+  return mask;
+}
+
+TEST(FloodFill, Connectivity)
+{
+  // Two areas touching diagonally
+  const int w = 4, h = 4;
+  const uint32_t X = 0xff0000ff;
+  const uint32_t o = 0xffffffff;
+  const std::vector<uint32_t> pixels = { X, X, o, o, //
+                                         X, X, o, o, //
+                                         o, o, X, X, //
+                                         o, o, X, X };
+  FillOptions options;
+  gfx::Rect bounds;
+  std::vector<uint8_t> mask = fill(pixels, w, h, gfx::Point(0, 0), options, &bounds);
+  EXPECT_EQ(gfx::Rect(0, 0, 2, 2), bounds);
+  EXPECT_EQ(255, mask[1 * w + 1]);
+  EXPECT_EQ(0, mask[2 * w + 2]);
+
+  options.connectivity = FillConnectivity::Eight;
+  mask = fill(pixels, w, h, gfx::Point(0, 0), options, &bounds);
+  EXPECT_EQ(gfx::Rect(0, 0, 4, 4), bounds);
+  EXPECT_EQ(255, mask[3 * w + 3]);
+  EXPECT_EQ(0, mask[3 * w + 0]);
+
+  // Seed outside the image
+  EXPECT_TRUE(fill(pixels, w, h, gfx::Point(4, 0), options, &bounds) ==
+              std::vector<uint8_t>(w * h, 0));
+  EXPECT_TRUE(bounds.isEmpty());
+}
+
+TEST(FloodFill, FilledMaskIsABarrier)
+{
+  const int w = 10, h = 3;
+  const std::vector<uint32_t> pixels(w * h, 0xff000000);
+  std::vector<uint8_t> mask(w * h, 0);
+  for (int y = 0; y < h; ++y)
+    mask[y * w + 5] = 1;
+
+  const gfx::Rect bounds = flood_fill(pixels.data(),
+                                      w,
+                                      gfx::Size(w, h),
+                                      kRgba,
+                                      gfx::Point(7, 1),
+                                      FillOptions(),
+                                      mask.data(),
+                                      w);
+  EXPECT_EQ(gfx::Rect(6, 0, 4, 3), bounds);
+  EXPECT_EQ(0, mask[0]);
+  EXPECT_EQ(1, mask[5]);
+}
+
+TEST(FloodFill, RgbaTolerance)
+{
+  // Horizontal gradient of red
+  const int w = 256, h = 2;
+  std::vector<uint32_t> pixels(w * h);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      pixels[y * w + x] = 0xff000000 | x;
+
+  FillOptions options;
+  options.tolerance = 10;
+  gfx::Rect bounds;
+  fill(pixels, w, h, gfx::Point(100, 1), options, &bounds);
+  EXPECT_EQ(gfx::Rect(90, 0, 21, 2), bounds);
+
+  // Fully transparent pixels are equal
+  std::fill(pixels.begin(), pixels.end(), 0);
+  pixels[5] = 0x00ffffff;
+  options.tolerance = 0;
+  fill(pixels, w, h, gfx::Point(0, 0), options, &bounds);
+  EXPECT_EQ(gfx::Rect(0, 0, w, h), bounds);
+}
+
+TEST(FloodFill, HsvTolerance)
+{
+  const int w = 3, h = 1;
+  FillOptions options;
+  options.colorSpace = FillColorSpace::Hsv;
+  options.tolerance = 20;
+  gfx::Rect bounds;
+
+  // Same saturation and value, hue 0 -> 10 -> 20 degrees (14 and 28
+  // in the [0,255] range)
+  const std::vector<uint32_t> reds = { 0xff0000ff, 0xff002bff, 0xff0055ff };
+  fill(reds, w, h, gfx::Point(0, 0), options, &bounds);
+  EXPECT_EQ(gfx::Rect(0, 0, 2, 1), bounds);
+
+  // Hue of grays is ignored
+  const std::vector<uint32_t> grays = { 0xff808080, 0xff808082, 0xff828080 };
+  fill(grays, w, h, gfx::Point(0, 0), options, &bounds);
+  EXPECT_EQ(gfx::Rect(0, 0, 3, 1), bounds);
+}
+
+TEST(FloodFill, RandomImages)
+{
+  std::mt19937 rng(3);
+  for (const FillConnectivity connectivity : { FillConnectivity::Four, FillConnectivity::Eight }) {
+    for (int i = 0; i < 30; ++i) {
+      const int w = 1 + rng() % 150;
+      const int h = 1 + rng() % 150;
+      std::vector<uint32_t> pixels(w * h);
+      for (uint32_t& c : pixels)
+        c = 0xff000000 | (rng() % 3 == 0 ? 0x40 : rng() % 8);
+
+      FillOptions options;
+      options.connectivity = connectivity;
+      options.tolerance = rng() % 8;
+      const gfx::Point seed(rng() % w, rng() % h);
+      const int seedRed = pixels[seed.y * w + seed.x] & 0xff;
+      const std::vector<uint8_t> expected =
+        reference_fill(w, h, seed, connectivity, [&](const int x, const int y) {
+          return std::abs(int(pixels[y * w + x] & 0xff) - seedRed) <= options.tolerance;
+        });
+      ASSERT_TRUE(expected == fill(pixels, w, h, seed, options));
+    }
+  }
+}
+
+TEST(FloodFill, Maze)
+{
+  // A serpentine path of 1000x1000 pixels (a recursive fill would
+  // overflow the stack)
+  const int w = 1000, h = 1000;
+  std::vector<uint32_t> pixels(w * h, 0xffffffff);
+  for (int y = 1; y < h; y += 2) {
+    for (int x = 0; x < w; ++x)
+      pixels[y * w + x] = 0xff000000;
+    pixels[y * w + ((y / 2) % 2 == 0 ? w - 1 : 0)] = 0xffffffff;
+  }
+
+  gfx::Rect bounds;
+  const std::vector<uint8_t> mask = fill(pixels, w, h, gfx::Point(0, 0), FillOptions(), &bounds);
+  EXPECT_EQ(gfx::Rect(0, 0, w, h), bounds);
+  int filled = 0;
+  for (const uint8_t m : mask)
+    filled += (m ? 1 : 0);
+  EXPECT_EQ(w * h / 2 + h / 2, filled);
+}
+
+// Labels the components with breadth-first fills
+static std::vector<uint32_t> reference_labels(const std::vector<uint32_t>& pixels,
+                                              const int w,
+                                              const int h,
+                                              const FillConnectivity connectivity,
+                                              int& count)
+{
+  std::vector<uint32_t> labels(w * h, 0);
+  count = 0;
+  for (int i = 0; i < w * h; ++i) {
+    if (labels[i] || (pixels[i] >> 24) == 0)
+      continue;
+    ++count;
+    const std::vector<uint8_t> mask =
+      reference_fill(w, h, gfx::Point(i % w, i / w), connectivity, [&](const int x, const int y) {
+        return pixels[y * w + x] == pixels[i];
+      });
+    for (int j = 0; j < w * h; ++j) {
+      if (mask[j])
+        labels[j] = count;
+    }
+  }
+  return labels;
+}
+
+TEST(LabelComponents, RandomImages)
+{
+  base::thread_pool pool(3);
+  std::mt19937 rng(5);
+  for (const FillConnectivity connectivity : { FillConnectivity::Four, FillConnectivity::Eight }) {
+    for (int i = 0; i < 10; ++i) {
+      const int w = 1 + rng() % 100;
+      const int h = 1 + rng() % 300;
+      std::vector<uint32_t> pixels(w * h);
+      for (uint32_t& c : pixels)
+        c = (rng() % 4 == 0 ? rng() % 2 : 0xff000000 | (rng() % 2));
+
+      int expectedCount = 0;
+      const std::vector<uint32_t> expected =
+        reference_labels(pixels, w, h, connectivity, expectedCount);
+
+      // Labels with a stride
+      const int stride = w + 3;
+      for (base::thread_pool* p : { (base::thread_pool*)nullptr, &pool }) {
+        std::vector<uint32_t> labels(stride * h, 0xcdcdcdcd);
+        const int count = label_components(pixels.data(),
+                                           w,
+                                           gfx::Size(w, h),
+                                           kRgba,
+                                           connectivity,
+                                           labels.data(),
+                                           stride,
+                                           p);
+        EXPECT_EQ(expectedCount, count);
+        for (int y = 0; y < h; ++y) {
+          for (int x = 0; x < w; ++x)
+            ASSERT_EQ(expected[y * w + x], labels[y * stride + x]) << x << "," << y;
+          ASSERT_EQ(0xcdcdcdcd, labels[y * stride + w]);
+        }
+      }
+    }
+  }
+}
+
+TEST(LabelComponents, TallImage)
+{
+  // A diagonal zigzag that crosses several bands of rows
+  base::thread_pool pool(2);
+  const int w = 3, h = 500;
+  std::vector<uint32_t> pixels(w * h, 0);
+  for (int y = 0; y < h; ++y)
+    pixels[y * w + (y % 2 == 0 ? 0 : 1)] = 0xff00ff00;
+
+  std::vector<uint32_t> labels(w * h);
+  EXPECT_EQ(500,
+            label_components(pixels.data(),
+                             w,
+                             gfx::Size(w, h),
+                             kRgba,
+                             FillConnectivity::Four,
+                             labels.data(),
+                             w,
+                             &pool));
+  EXPECT_EQ(1,
+            label_components(pixels.data(),
+                             w,
+                             gfx::Size(w, h),
+                             kRgba,
+                             FillConnectivity::Eight,
+                             labels.data(),
+                             w,
+                             &pool));
+  EXPECT_EQ(1, labels[(h - 1) * w + 1]);
+  EXPECT_EQ(0, labels[(h - 1) * w + 2]);
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,341 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/font_index.h"
+
+#include "base/file_content.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/mapped_file.h"
+#include "base/string.h"
+#include "base/time.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace os {
+
+namespace {
+
+// Change the version when the format of the index file changes.
+constexpr char kMagic[4] = { 'L', 'F', 'I', 'X' };
+constexpr uint32_t kVersion = 1;
+
+// Max depth of subdirectories to scan (to avoid symlink loops).
+constexpr int kMaxDirDepth = 8;
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t faceCount;
+  uint32_t stringsSize;
+  uint64_t checksum; // Of the records + strings
+};
+
+struct FileRecord {
+  uint32_t filename; // Offsets in the strings table
+  uint32_t family;
+  uint32_t styleName;
+  int32_t faceIndex;
+  uint16_t weight;
+  uint8_t width;
+  uint8_t slant;
+  uint32_t padding;
+  uint64_t mtime;
+  uint64_t fileSize;
+  uint32_t coverage[FontIndex::kCoveragePages / 32];
+};
+
+// FNV-1a
+uint64_t calc_checksum(const uint8_t* data, const size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint64_t pack_time(const base::Time& t)
+{
+  return ((((uint64_t(t.year) * 13 + t.month) * 32 + t.day) * 24 + t.hour) * 60 + t.minute) * 60 +
+         t.second;
+}
+
+void list_font_files(const std::string& dir, const int depth, base::paths& files)
+{
+  for (const std::string& item : base::list_files(dir)) {
+    const std::string path = base::join_path(dir, item);
+    if (base::is_directory(path)) {
+      if (depth < kMaxDirDepth)
+        list_font_files(path, depth + 1, files);
+    }
+    else if (FontIndex::isFontFile(item))
+      files.push_back(path);
+  }
+}
+
+} // anonymous namespace
+
+void FontIndex::CoverageSummary::addCodePoint(const int codepoint)
+{
+  const int page = (codepoint >> 8);
+  if (page >= 0 && page < kCoveragePages)
+    bits[page / 32] |= (1u << (page % 32));
+}
+
+bool FontIndex::CoverageSummary::mayContain(const int codepoint) const
+{
+  const int page = (codepoint >> 8);
+  if (page < 0 || page >= kCoveragePages)
+    return true;
+  return (bits[page / 32] & (1u << (page % 32))) != 0;
+}
+
+bool FontIndex::load(const std::string& filename)
+{
+  base::MappedFile file = base::map_file(filename);
+  if (!file || file->size() < sizeof(FileHeader))
+    return false;
+
+  FileHeader header;
+  std::memcpy(&header, file->data(), sizeof(FileHeader));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+    return false;
+
+  const uint64_t recordsSize = uint64_t(header.faceCount) * sizeof(FileRecord);
+  if (sizeof(FileHeader) + recordsSize + header.stringsSize != file->size())
+    return false;
+
+  const uint8_t* records = file->data() + sizeof(FileHeader);
+  const char* strings = (const char*)(records + recordsSize);
+  if (calc_checksum(records, file->size() - sizeof(FileHeader)) != header.checksum)
+    return false;
+
+  // Strings must be inside the table and null-terminated
+  auto getString = [&](const uint32_t offset, std::string& str) -> bool {
+    if (offset >= header.stringsSize)
+      return false;
+    const void* end = std::memchr(strings + offset, 0, header.stringsSize - offset);
+    if (!end)
+      return false;
+    str.assign(strings + offset, (const char*)end);
+    return true;
+  };
+
+  std::vector<Face> faces(header.faceCount);
+  for (uint32_t i = 0; i < header.faceCount; ++i) {
+    FileRecord rec;
+    std::memcpy(&rec, records + i * sizeof(FileRecord), sizeof(FileRecord));
+
+    Face& face = faces[i];
+    if (!getString(rec.filename, face.filename) || !getString(rec.family, face.family) ||
+        !getString(rec.styleName, face.styleName))
+      return false;
+
+    face.faceIndex = rec.faceIndex;
+    face.style = FontStyle(FontStyle::Weight(rec.weight),
+                           FontStyle::Width(rec.width),
+                           FontStyle::Slant(rec.slant));
+    face.mtime = rec.mtime;
+    face.fileSize = rec.fileSize;
+    std::copy(std::begin(rec.coverage), std::end(rec.coverage), face.coverage.bits.begin());
+  }
+
+  m_faces = std::move(faces);
+  updateFamilies();
+  return true;
+}
+
+bool FontIndex::save(const std::string& filename) const
+{
+  // Build the strings table (sharing equal strings, e.g. family names)
+  std::vector<char> strings;
+  std::map<std::string, uint32_t> offsets;
+  auto addString = [&](const std::string& str) -> uint32_t {
+    auto it = offsets.find(str);
+    if (it != offsets.end())
+      return it->second;
+    const uint32_t offset = uint32_t(strings.size());
+    strings.insert(strings.end(), str.begin(), str.end());
+    strings.push_back(0);
+    offsets[str] = offset;
+    return offset;
+  };
+
+  std::vector<FileRecord> records(m_faces.size());
+  for (size_t i = 0; i < m_faces.size(); ++i) {
+    const Face& face = m_faces[i];
+    FileRecord& rec = records[i];
+    std::memset(&rec, 0, sizeof(FileRecord));
+    rec.filename = addString(face.filename);
+    rec.family = addString(face.family);
+    rec.styleName = addString(face.styleName);
+    rec.faceIndex = face.faceIndex;
+    rec.weight = uint16_t(face.style.weight());
+    rec.width = uint8_t(face.style.width());
+    rec.slant = uint8_t(face.style.slant());
+    rec.mtime = face.mtime;
+    rec.fileSize = face.fileSize;
+    std::copy(face.coverage.bits.begin(), face.coverage.bits.end(), std::begin(rec.coverage));
+  }
+
+  const size_t recordsSize = records.size() * sizeof(FileRecord);
+  base::buffer buf(sizeof(FileHeader) + recordsSize + strings.size());
+  if (recordsSize)
+    std::memcpy(&buf[sizeof(FileHeader)], records.data(), recordsSize);
+  if (!strings.empty())
+    std::memcpy(&buf[sizeof(FileHeader) + recordsSize], strings.data(), strings.size());
+
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.faceCount = uint32_t(records.size());
+  header.stringsSize = uint32_t(strings.size());
+  header.checksum = calc_checksum(&buf[sizeof(FileHeader)], buf.size() - sizeof(FileHeader));
+  std::memcpy(&buf[0], &header, sizeof(FileHeader));
+
+  const std::string tmpFilename = filename + ".tmp";
+  try {
+    {
+      const base::FileHandle f(base::open_file(tmpFilename, "wb"));
+      if (!f)
+        return false;
+      base::write_file_content(f.get(), buf);
+    }
+#if LAF_WINDOWS
+    // MoveFile() fails if the destination exists
+    if (base::is_file(filename))
+      base::delete_file(filename);
+#endif
+    base::move_file(tmpFilename, filename);
+  }
+  catch (const std::exception&) {
+    if (base::is_file(tmpFilename))
+      base::delete_file(tmpFilename);
+    return false;
+  }
+  return true;
+}
+
+bool FontIndex::update(const base::paths& dirs,
+                       const ScanFile& scan,
+                       const std::atomic<bool>* cancel)
+{
+  base::paths files;
+  for (const std::string& dir : dirs)
+    list_font_files(dir, 0, files);
+  std::sort(files.begin(), files.end());
+  files.erase(std::unique(files.begin(), files.end()), files.end());
+
+  // Current faces of each file
+  std::map<std::string, std::vector<const Face*>> oldFaces;
+  for (const Face& face : m_faces)
+    oldFaces[face.filename].push_back(&face);
+
+  std::vector<Face> faces;
+  bool changed = false;
+  for (const std::string& file : files) {
+    const uint64_t mtime = pack_time(base::get_modification_time(file));
+    const uint64_t fileSize = base::file_size(file);
+
+    auto it = oldFaces.find(file);
+    if (it != oldFaces.end()) {
+      const std::vector<const Face*>& old = it->second;
+      if (old[0]->mtime == mtime && old[0]->fileSize == fileSize) {
+        for (const Face* face : old)
+          faces.push_back(*face);
+        oldFaces.erase(it);
+        continue;
+      }
+    }
+
+    if (cancel && *cancel) {
+      // Keep the old faces of the files that were not scanned
+      if (it != oldFaces.end()) {
+        for (const Face* face : it->second)
+          faces.push_back(*face);
+        oldFaces.erase(it);
+      }
+      continue;
+    }
+
+    if (it != oldFaces.end())
+      oldFaces.erase(it);
+
+    // Invalid font files are kept as a face without family, so they
+    // are not scanned again until they are modified
+    const size_t first = faces.size();
+    if (!scan(file, faces) || faces.size() == first) {
+      faces.resize(first);
+      faces.push_back(Face());
+    }
+    for (size_t i = first; i < faces.size(); ++i) {
+      faces[i].filename = file;
+      faces[i].mtime = mtime;
+      faces[i].fileSize = fileSize;
+    }
+    changed = true;
+  }
+
+  // Removed files (or files that are not fonts anymore)
+  if (!oldFaces.empty())
+    changed = true;
+
+  if (changed) {
+    m_faces = std::move(faces);
+    updateFamilies();
+  }
+  return changed;
+}
+
+const FontIndex::Family* FontIndex::findFamily(const std::string& name) const
+{
+  auto it = std::lower_bound(
+    m_families.begin(),
+    m_families.end(),
+    name,
+    [](const Family& family, const std::string& name) {
+      return base::utf8_icmp(family.name, name) < 0;
+    });
+  if (it != m_families.end() && base::utf8_icmp(it->name, name) == 0)
+    return &(*it);
+  return nullptr;
+}
+
+// static
+bool FontIndex::isFontFile(const std::string& filename)
+{
+  const std::string ext = base::string_to_lower(base::get_file_extension(filename));
+  return (ext == "ttf" || ext == "otf" || ext == "ttc" || ext == "otc");
+}
+
+void FontIndex::updateFamilies()
+{
+  std::vector<int> order(m_faces.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = int(i);
+  std::stable_sort(order.begin(), order.end(), [this](const int a, const int b) {
+    return base::utf8_icmp(m_faces[a].family, m_faces[b].family) < 0;
+  });
+
+  m_families.clear();
+  for (const int i : order) {
+    if (m_faces[i].family.empty())
+      continue;
+    if (m_families.empty() || base::utf8_icmp(m_families.back().name, m_faces[i].family) != 0)
+      m_families.push_back(Family{ m_faces[i].family, {} });
+    m_families.back().faces.push_back(i);
+  }
+}
+
+} // namespace os
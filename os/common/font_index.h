@@ -0,0 +1,103 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_FONT_INDEX_H_INCLUDED
+#define OS_COMMON_FONT_INDEX_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "base/paths.h"
+#include "os/font_style.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace os {
+
+// Information of all the font files in a set of directories, so
+// fonts can be enumerated without opening each font file. The index
+// is saved in a binary file that is mapped in memory and validated
+// with load(), and update() scans only the files that were
+// added/modified since the last update.
+class FontIndex {
+public:
+  // Pages of 256 code points from U+0000 to U+1FFFF (BMP and SMP).
+  static constexpr int kCoveragePages = 512;
+
+  // One bit for each page of code points with at least one glyph.
+  struct CoverageSummary {
+    std::array<uint32_t, kCoveragePages / 32> bits = {};
+
+    void addCodePoint(int codepoint);
+
+    // Returns true if the font could have a glyph for the given code
+    // point (code points outside the summary always return true).
+    bool mayContain(int codepoint) const;
+  };
+
+  struct Face {
+    std::string filename;
+    int faceIndex = 0; // Face index inside the file (.ttc files)
+    std::string family;
+    std::string styleName;
+    FontStyle style;
+    uint64_t mtime = 0; // Modification time of the file when it was scanned
+    uint64_t fileSize = 0;
+    CoverageSummary coverage;
+  };
+
+  struct Family {
+    std::string name;
+    std::vector<int> faces; // Indexes of faces()
+  };
+
+  // Function to read the faces of a font file (appending them to
+  // "faces"), returns false if it's not a valid font file.
+  using ScanFile = std::function<bool(const std::string& filename, std::vector<Face>& faces)>;
+
+  // Loads an index saved with save(). Returns false if the file
+  // doesn't exist, is corrupted, or it's from another version.
+  bool load(const std::string& filename);
+
+  // Saves the index in a temporary file and then replaces the given
+  // file, so an index being loaded is never partially written.
+  bool save(const std::string& filename) const;
+
+  // Updates the index with the font files of the given directories
+  // (and their subdirectories). Only new files and files with a
+  // different size/modification time are scanned with "scan", the
+  // rest of faces are reused. Returns true if the index was modified.
+  // If "cancel" is set to true in another thread, the update is
+  // stopped (and the index keeps the files scanned until then).
+  bool update(const base::paths& dirs,
+              const ScanFile& scan,
+              const std::atomic<bool>* cancel = nullptr);
+
+  // All faces, including files that are not valid fonts (with an
+  // empty family name)
+  const std::vector<Face>& faces() const { return m_faces; }
+
+  // Families sorted by name (case-insensitive)
+  const std::vector<Family>& families() const { return m_families; }
+  const Family* findFamily(const std::string& name) const;
+
+  // Returns true if the file has a known font extension (.ttf, .otf,
+  // .ttc, .otc)
+  static bool isFontFile(const std::string& filename);
+
+private:
+  void updateFamilies();
+
+  std::vector<Face> m_faces;
+  std::vector<Family> m_families;
+};
+
+} // namespace os
+
+#endif
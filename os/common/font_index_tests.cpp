@@ -0,0 +1,229 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "os/common/font_index.h"
+
+#include <string>
+#include <vector>
+
+using namespace os;
+
+namespace {
+
+const char* kIndexFile = "_test_font_index.bin";
+const char* kFontsDir = "_test_fonts";
+
+void write_file(const std::string& filename, const std::string& content)
+{
+  base::write_file_content(filename, (const uint8_t*)content.data(), content.size());
+}
+
+// Fake scanner: the content of each file is "family style"
+struct FakeScanner {
+  std::vector<std::string> scanned;
+
+  bool operator()(const std::string& filename, std::vector<FontIndex::Face>& faces)
+  {
+    scanned.push_back(base::get_file_name(filename));
+
+    const base::buffer buf = base::read_file_content(filename);
+    const std::string content(buf.begin(), buf.end());
+    const size_t space = content.find(' ');
+    if (space == std::string::npos)
+      return false;
+
+    FontIndex::Face face;
+    face.family = content.substr(0, space);
+    face.styleName = content.substr(space + 1);
+    face.style = (face.styleName == "Bold" ? FontStyle::Bold() : FontStyle::Normal());
+    face.coverage.addCodePoint('A');
+    faces.push_back(face);
+    return true;
+  }
+};
+
+class FontIndexTest : public testing::Test {
+protected:
+  void SetUp() override
+  {
+    TearDown();
+    base::make_directory(kFontsDir);
+    write_file(base::join_path(kFontsDir, "a.ttf"), "Arial Regular");
+    write_file(base::join_path(kFontsDir, "b.ttf"), "Arial Bold");
+    write_file(base::join_path(kFontsDir, "c.otf"), "Courier Regular");
+    write_file(base::join_path(kFontsDir, "readme.txt"), "Not a font");
+  }
+
+  void TearDown() override
+  {
+    if (base::is_directory(kFontsDir)) {
+      for (const std::string& fn : base::list_files(kFontsDir))
+        base::delete_file(base::join_path(kFontsDir, fn));
+      base::remove_directory(kFontsDir);
+    }
+    if (base::is_file(kIndexFile))
+      base::delete_file(kIndexFile);
+  }
+
+  bool update(FontIndex& index, FakeScanner& scanner)
+  {
+    return index.update({ kFontsDir }, [&scanner](const std::string& fn, auto& faces) {
+      return scanner(fn, faces);
+    });
+  }
+};
+
+} // anonymous namespace
+
+TEST(FontIndex, CoverageSummary)
+{
+  FontIndex::CoverageSummary cov;
+  EXPECT_FALSE(cov.mayContain('A'));
+  cov.addCodePoint('A');
+  EXPECT_TRUE(cov.mayContain('A'));
+  EXPECT_TRUE(cov.mayContain('z'));
+  EXPECT_FALSE(cov.mayContain(0x4E00));
+  cov.addCodePoint(0x1F600);
+  EXPECT_TRUE(cov.mayContain(0x1F6FF));
+  EXPECT_TRUE(cov.mayContain(0x20000)); // Outside the summary
+}
+
+TEST(FontIndex, IsFontFile)
+{
+  EXPECT_TRUE(FontIndex::isFontFile("a.ttf"));
+  EXPECT_TRUE(FontIndex::isFontFile("dir/A.TTC"));
+  EXPECT_TRUE(FontIndex::isFontFile("a.otf"));
+  EXPECT_FALSE(FontIndex::isFontFile("a.txt"));
+  EXPECT_FALSE(FontIndex::isFontFile("ttf"));
+}
+
+TEST_F(FontIndexTest, UpdateAndFamilies)
+{
+  FontIndex index;
+  FakeScanner scanner;
+  EXPECT_TRUE(update(index, scanner));
+  EXPECT_EQ(3, scanner.scanned.size());
+  ASSERT_EQ(3, index.faces().size());
+
+  ASSERT_EQ(2, index.families().size());
+  EXPECT_EQ("Arial", index.families()[0].name);
+  EXPECT_EQ(2, index.families()[0].faces.size());
+  EXPECT_EQ("Courier", index.families()[1].name);
+  EXPECT_EQ(1, index.families()[1].faces.size());
+
+  const FontIndex::Family* family = index.findFamily("arial");
+  ASSERT_TRUE(family != nullptr);
+  EXPECT_EQ("Arial", family->name);
+  EXPECT_EQ(nullptr, index.findFamily("Times"));
+
+  // Nothing changed
+  scanner.scanned.clear();
+  EXPECT_FALSE(update(index, scanner));
+  EXPECT_TRUE(scanner.scanned.empty());
+}
+
+TEST_F(FontIndexTest, IncrementalUpdate)
+{
+  FontIndex index;
+  FakeScanner scanner;
+  update(index, scanner);
+
+  // Modify one file (with a different size), add one, remove one
+  write_file(base::join_path(kFontsDir, "a.ttf"), "Helvetica Regular");
+  write_file(base::join_path(kFontsDir, "d.ttc"), "Times Bold");
+  base::delete_file(base::join_path(kFontsDir, "c.otf"));
+
+  scanner.scanned.clear();
+  EXPECT_TRUE(update(index, scanner));
+  EXPECT_EQ(std::vector<std::string>({ "a.ttf", "d.ttc" }), scanner.scanned);
+
+  ASSERT_EQ(3, index.families().size());
+  EXPECT_EQ("Arial", index.families()[0].name);
+  EXPECT_EQ("Helvetica", index.families()[1].name);
+  EXPECT_EQ("Times", index.families()[2].name);
+  EXPECT_EQ(nullptr, index.findFamily("Courier"));
+}
+
+TEST_F(FontIndexTest, InvalidFontsAreNotScannedAgain)
+{
+  write_file(base::join_path(kFontsDir, "broken.ttf"), "Broken");
+
+  FontIndex index;
+  FakeScanner scanner;
+  update(index, scanner);
+  EXPECT_EQ(4, scanner.scanned.size());
+  EXPECT_EQ(2, index.families().size());
+
+  scanner.scanned.clear();
+  EXPECT_FALSE(update(index, scanner));
+  EXPECT_TRUE(scanner.scanned.empty());
+}
+
+TEST_F(FontIndexTest, SaveAndLoad)
+{
+  FontIndex index;
+  FakeScanner scanner;
+  update(index, scanner);
+  ASSERT_TRUE(index.save(kIndexFile));
+
+  FontIndex loaded;
+  ASSERT_TRUE(loaded.load(kIndexFile));
+  ASSERT_EQ(index.faces().size(), loaded.faces().size());
+  for (size_t i = 0; i < index.faces().size(); ++i) {
+    const FontIndex::Face& a = index.faces()[i];
+    const FontIndex::Face& b = loaded.faces()[i];
+    EXPECT_EQ(a.filename, b.filename);
+    EXPECT_EQ(a.faceIndex, b.faceIndex);
+    EXPECT_EQ(a.family, b.family);
+    EXPECT_EQ(a.styleName, b.styleName);
+    EXPECT_TRUE(a.style == b.style);
+    EXPECT_EQ(a.mtime, b.mtime);
+    EXPECT_EQ(a.fileSize, b.fileSize);
+    EXPECT_EQ(a.coverage.bits, b.coverage.bits);
+  }
+  EXPECT_EQ(2, loaded.families().size());
+
+  // The loaded index doesn't need to scan anything
+  scanner.scanned.clear();
+  EXPECT_FALSE(update(loaded, scanner));
+  EXPECT_TRUE(scanner.scanned.empty());
+}
+
+TEST_F(FontIndexTest, LoadInvalidFiles)
+{
+  FontIndex index;
+  EXPECT_FALSE(index.load(kIndexFile)); // Doesn't exist
+
+  write_file(kIndexFile, "LFIX");
+  EXPECT_FALSE(index.load(kIndexFile));
+
+  FakeScanner scanner;
+  update(index, scanner);
+  ASSERT_TRUE(index.save(kIndexFile));
+
+  // Corrupt one byte of the strings table
+  base::buffer buf = base::read_file_content(kIndexFile);
+  buf[buf.size() - 2] ^= 1;
+  base::write_file_content(kIndexFile, buf);
+
+  FontIndex loaded;
+  EXPECT_FALSE(loaded.load(kIndexFile));
+  EXPECT_TRUE(loaded.faces().empty());
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
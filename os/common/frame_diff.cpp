@@ -0,0 +1,252 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/frame_diff.h"
+
+#include "base/simd.h"
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+#include "os/common/surface_utils.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace os {
+
+namespace {
+
+// Rows compared in each task
+constexpr int kRowsPerTask = 64;
+
+// Returns the index of the first different pixel of "a" and "b", or
+// "n" if they are equal.
+int first_diff(const uint32_t* a, const uint32_t* b, const int n)
+{
+  int x = 0;
+#if LAF_SSE2
+  for (; x + 4 <= n; x += 4) {
+    const __m128i va = _mm_loadu_si128((const __m128i*)(a + x));
+    const __m128i vb = _mm_loadu_si128((const __m128i*)(b + x));
+    const int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(va, vb));
+    if (mask != 0xffff) {
+      int i = 0;
+      while ((mask >> (4 * i)) & 1)
+        ++i;
+      return x + i;
+    }
+  }
+#endif
+  for (; x < n; ++x) {
+    if (a[x] != b[x])
+      return x;
+  }
+  return n;
+}
+
+// Returns the index of the last different pixel of "a" and "b" (they
+// must have at least one different pixel).
+int last_diff(const uint32_t* a, const uint32_t* b, const int n)
+{
+  int x = n;
+#if LAF_SSE2
+  for (; x - 4 >= 0; x -= 4) {
+    const __m128i va = _mm_loadu_si128((const __m128i*)(a + x - 4));
+    const __m128i vb = _mm_loadu_si128((const __m128i*)(b + x - 4));
+    const int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(va, vb));
+    if (mask != 0xffff) {
+      int i = 3;
+      while ((mask >> (4 * i)) & 1)
+        --i;
+      return x - 4 + i;
+    }
+  }
+#endif
+  while (--x >= 0) {
+    if (a[x] != b[x])
+      return x;
+  }
+  return -1;
+}
+
+// Bounds of the changed pixels of a tile
+struct TileBounds {
+  int x1 = INT_MAX, y1 = INT_MAX;
+  int x2 = INT_MIN, y2 = INT_MIN;
+
+  bool isEmpty() const { return x1 > x2; }
+
+  void add(const int xa, const int xb, const int y)
+  {
+    x1 = std::min(x1, xa);
+    x2 = std::max(x2, xb);
+    y1 = std::min(y1, y);
+    y2 = std::max(y2, y);
+  }
+
+  gfx::Rect rect() const { return gfx::Rect(x1, y1, x2 - x1 + 1, y2 - y1 + 1); }
+};
+
+// Compares the rows [y1, y2) (one row of tiles) and adds the changed
+// areas to "rects" (from left to right).
+void diff_band(const uint32_t* a,
+               const int aStride,
+               const uint32_t* b,
+               const int bStride,
+               const int width,
+               const int y1,
+               const int y2,
+               const int tileSize,
+               std::vector<gfx::Rect>& rects)
+{
+  std::vector<TileBounds> tiles((width + tileSize - 1) / tileSize);
+  bool changed = false;
+
+  for (int y = y1; y < y2; ++y) {
+    const uint32_t* ra = a + std::size_t(y) * aStride;
+    const uint32_t* rb = b + std::size_t(y) * bStride;
+
+    // Each pixel is compared once: the first changed pixel of the row
+    // gives its tile, then the tile is scanned from the right side
+    // to find its last changed pixel.
+    for (int x = 0; x < width;) {
+      x += first_diff(ra + x, rb + x, width - x);
+      if (x >= width)
+        break;
+
+      const int t = x / tileSize;
+      const int tileEnd = std::min((t + 1) * tileSize, width);
+      const int last = x + last_diff(ra + x, rb + x, tileEnd - x);
+      tiles[t].add(x, last, y);
+      changed = true;
+      x = tileEnd;
+    }
+  }
+  if (!changed)
+    return;
+
+  // Merge adjacent tiles with the same vertical bounds
+  for (const TileBounds& tile : tiles) {
+    if (tile.isEmpty())
+      continue;
+    const gfx::Rect rc = tile.rect();
+    if (!rects.empty()) {
+      gfx::Rect& prev = rects.back();
+      if (prev.x2() == rc.x && prev.y == rc.y && prev.h == rc.h) {
+        prev.w += rc.w;
+        continue;
+      }
+    }
+    rects.push_back(rc);
+  }
+}
+
+} // anonymous namespace
+
+std::vector<gfx::Rect> frame_diff(const uint32_t* a,
+                                  const int aStride,
+                                  const uint32_t* b,
+                                  const int bStride,
+                                  const gfx::Size& size,
+                                  int tileSize,
+                                  base::thread_pool* pool)
+{
+  std::vector<gfx::Rect> result;
+  if (size.w <= 0 || size.h <= 0)
+    return result;
+
+  tileSize = std::max(tileSize, 1);
+  const int nbands = (size.h + tileSize - 1) / tileSize;
+  std::vector<std::vector<gfx::Rect>> bands(nbands);
+
+  const int bandsPerTask = std::max(1, kRowsPerTask / tileSize);
+  base::for_each_task(pool, nbands, bandsPerTask, [&](const int band1, const int band2) {
+    for (int i = band1; i < band2; ++i) {
+      diff_band(a,
+                aStride,
+                b,
+                bStride,
+                size.w,
+                i * tileSize,
+                std::min((i + 1) * tileSize, size.h),
+                tileSize,
+                bands[i]);
+    }
+  });
+
+  // Merge rectangles of consecutive bands with the same horizontal
+  // bounds that touch each other ("open" are the indexes of the
+  // rectangles added or extended by the previous band)
+  std::vector<std::size_t> open, next;
+  for (const std::vector<gfx::Rect>& band : bands) {
+    next.clear();
+    for (const gfx::Rect& rc : band) {
+      auto it = std::find_if(open.begin(), open.end(), [&](const std::size_t i) {
+        const gfx::Rect& prev = result[i];
+        return prev.x == rc.x && prev.w == rc.w && prev.y2() == rc.y;
+      });
+      if (it != open.end()) {
+        result[*it].h += rc.h;
+        next.push_back(*it);
+      }
+      else {
+        next.push_back(result.size());
+        result.push_back(rc);
+      }
+    }
+    open.swap(next);
+  }
+  return result;
+}
+
+std::vector<gfx::Rect> frame_diff_surfaces(const Surface* a,
+                                           const Surface* b,
+                                           const int tileSize,
+                                           base::thread_pool* pool)
+{
+  SurfaceFormatData fa, fb;
+  a->getFormat(&fa);
+  b->getFormat(&fb);
+  if (a->width() != b->width() || a->height() != b->height() || fa != fb ||
+      fa.bitsPerPixel != 32) {
+    return { b->bounds() };
+  }
+
+  SurfaceLock lockA(a);
+  SurfaceLock lockB(b);
+
+  const uint32_t* pa = (const uint32_t*)a->getData(0, 0);
+  const uint32_t* pb = (const uint32_t*)b->getData(0, 0);
+  if (!pa || !pb)
+    return { b->bounds() };
+
+  return frame_diff(pa,
+                    row_stride(a),
+                    pb,
+                    row_stride(b),
+                    gfx::Size(b->width(), b->height()),
+                    tileSize,
+                    pool);
+}
+
+#if LAF_WITH_REGION
+gfx::Region frame_diff_region(const Surface* a,
+                              const Surface* b,
+                              const int tileSize,
+                              base::thread_pool* pool)
+{
+  gfx::Region region;
+  for (const gfx::Rect& rc : frame_diff_surfaces(a, b, tileSize, pool))
+    region |= gfx::Region(rc);
+  return region;
+}
+#endif
+
+} // namespace os
@@ -0,0 +1,68 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_FRAME_DIFF_H_INCLUDED
+#define OS_COMMON_FRAME_DIFF_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+
+#if LAF_WITH_REGION
+  #include "gfx/region.h"
+#endif
+
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+// Compares the 32bpp images "a" and "b" of the given "size" (strides
+// are in pixels) and returns the areas with different pixels (e.g.
+// to invalidate/upload only the real changes of a procedurally
+// generated frame).
+//
+// The image is divided in tiles of "tileSize" pixels, and each
+// changed tile is reduced to the bounds of its changed pixels. The
+// returned rectangles don't overlap: adjacent tiles are merged only
+// when their union is a rectangle.
+//
+// Equal rows are skipped comparing 16 bytes at a time (SSE2), and if
+// "pool" is not nullptr, bands of rows are compared in parallel.
+std::vector<gfx::Rect> frame_diff(const uint32_t* a,
+                                  int aStride,
+                                  const uint32_t* b,
+                                  int bStride,
+                                  const gfx::Size& size,
+                                  int tileSize = 32,
+                                  base::thread_pool* pool = nullptr);
+
+// Same as frame_diff() for surfaces. If the surfaces have different
+// sizes or formats (or aren't 32bpp, or their pixels cannot be
+// accessed), the whole bounds of "b" are returned.
+std::vector<gfx::Rect> frame_diff_surfaces(const Surface* a,
+                                           const Surface* b,
+                                           int tileSize = 32,
+                                           base::thread_pool* pool = nullptr);
+
+#if LAF_WITH_REGION
+// Returns the result of frame_diff_surfaces() as a region (e.g. for
+// Window::invalidateRegion()).
+gfx::Region frame_diff_region(const Surface* a,
+                              const Surface* b,
+                              int tileSize = 32,
+                              base::thread_pool* pool = nullptr);
+#endif
+
+} // namespace os
+
+#endif
@@ -0,0 +1,157 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+#include "os/common/frame_diff.h"
+
+#include <random>
+#include <vector>
+
+using namespace os;
+
+static std::vector<gfx::Rect> diff(const std::vector<uint32_t>& a,
+                                   const std::vector<uint32_t>& b,
+                                   const int w,
+                                   const int h,
+                                   const int tileSize = 32,
+                                   base::thread_pool* pool = nullptr)
+{
+  return frame_diff(a.data(), w, b.data(), w, gfx::Size(w, h), tileSize, pool);
+}
+
+// Checks that each changed pixel is inside one rectangle, and that
+// each side of the rectangles has a changed pixel.
+static void expect_tight_cover(const std::vector<uint32_t>& a,
+                               const std::vector<uint32_t>& b,
+                               const int w,
+                               const int h,
+                               const std::vector<gfx::Rect>& rects)
+{
+  std::vector<int> covered(a.size(), 0);
+  for (const gfx::Rect& rc : rects) {
+    ASSERT_TRUE(gfx::Rect(0, 0, w, h).contains(rc));
+    bool left = false, right = false, top = false, bottom = false;
+    for (int y = rc.y; y < rc.y2(); ++y) {
+      for (int x = rc.x; x < rc.x2(); ++x) {
+        const std::size_t i = std::size_t(y) * w + x;
+        ++covered[i];
+        if (a[i] != b[i]) {
+          left |= (x == rc.x);
+          right |= (x == rc.x2() - 1);
+          top |= (y == rc.y);
+          bottom |= (y == rc.y2() - 1);
+        }
+      }
+    }
+    EXPECT_TRUE(left && right && top && bottom)
+      << rc.x << "," << rc.y << "," << rc.w << "," << rc.h;
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    ASSERT_LE(covered[i], 1) << "Overlapping rectangles";
+    if (a[i] != b[i]) {
+      ASSERT_EQ(1, covered[i]) << i;
+    }
+  }
+}
+
+TEST(FrameDiff, EqualFrames)
+{
+  const std::vector<uint32_t> a(100 * 70, 0xff102030);
+  EXPECT_TRUE(diff(a, a, 100, 70).empty());
+  EXPECT_TRUE(frame_diff(a.data(), 100, a.data(), 100, gfx::Size(0, 0)).empty());
+}
+
+TEST(FrameDiff, SinglePixels)
+{
+  const int w = 101, h = 67;
+  const std::vector<uint32_t> a(w * h, 0);
+  for (const gfx::Point& pt :
+       { gfx::Point(0, 0), gfx::Point(100, 66), gfx::Point(31, 32), gfx::Point(35, 3) }) {
+    std::vector<uint32_t> b = a;
+    b[pt.y * w + pt.x] = 1;
+    const std::vector<gfx::Rect> rects = diff(a, b, w, h);
+    ASSERT_EQ(1, rects.size());
+    EXPECT_EQ(gfx::Rect(pt.x, pt.y, 1, 1), rects[0]);
+  }
+}
+
+TEST(FrameDiff, MergedTiles)
+{
+  const int w = 200, h = 100;
+  const std::vector<uint32_t> a(w * h, 0);
+
+  // Whole frame
+  EXPECT_EQ(std::vector<gfx::Rect>{ gfx::Rect(0, 0, w, h) },
+            diff(a, std::vector<uint32_t>(w * h, 1), w, h));
+
+  // Area that crosses several tiles
+  std::vector<uint32_t> b = a;
+  for (int y = 10; y < 90; ++y)
+    for (int x = 16; x < 150; ++x)
+      b[y * w + x] = 2;
+  const std::vector<gfx::Rect> rects = diff(a, b, w, h, 16);
+  EXPECT_EQ(std::vector<gfx::Rect>{ gfx::Rect(16, 10, 134, 80) }, rects);
+
+  // Tiles with different vertical bounds are not merged
+  b[5 * w + 20] = 3;
+  EXPECT_EQ(std::vector<gfx::Rect>({ gfx::Rect(16, 5, 16, 11),
+                                      gfx::Rect(32, 10, 118, 6),
+                                      gfx::Rect(16, 16, 134, 74) }),
+            diff(a, b, w, h, 16));
+}
+
+TEST(FrameDiff, RandomChanges)
+{
+  base::thread_pool pool(3);
+  std::mt19937 rng(7);
+  for (const int tileSize : { 1, 8, 32, 64 }) {
+    for (int i = 0; i < 20; ++i) {
+      const int w = 1 + rng() % 300;
+      const int h = 1 + rng() % 300;
+      std::vector<uint32_t> a(w * h);
+      for (uint32_t& c : a)
+        c = rng() % 4;
+      std::vector<uint32_t> b = a;
+      const int changes = rng() % 50;
+      for (int j = 0; j < changes; ++j) {
+        // Small blocks of changed pixels
+        const int x0 = rng() % w, y0 = rng() % h;
+        for (int y = y0; y < std::min(h, y0 + 3); ++y)
+          for (int x = x0; x < std::min(w, x0 + 5); ++x)
+            b[y * w + x] += 1;
+      }
+
+      const std::vector<gfx::Rect> rects = diff(a, b, w, h, tileSize);
+      expect_tight_cover(a, b, w, h, rects);
+      EXPECT_EQ(rects, diff(a, b, w, h, tileSize, &pool));
+    }
+  }
+}
+
+TEST(FrameDiff, Strides)
+{
+  const int w = 50, h = 40;
+  std::vector<uint32_t> a(60 * h, 0), b(w * h, 0);
+  for (int y = 0; y < h; ++y)
+    a[y * 60 + w + 3] = 5; // Outside the image
+  b[20 * w + 49] = 1;
+  const std::vector<gfx::Rect> rects =
+    frame_diff(a.data(), 60, b.data(), w, gfx::Size(w, h), 32);
+  EXPECT_EQ(std::vector<gfx::Rect>{ gfx::Rect(49, 20, 1, 1) }, rects);
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2020  Igara Studio S.A.
+// Copyright (C) 2020-2025  Igara Studio S.A.
 // Copyright (C) 2016-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,14 +12,25 @@
 #include "os/common/freetype_font.h"
 
 #include "base/string.h"
+#include "base/utf8_decode.h"
 #include "ft/algorithm.h"
+#include "ft/glyph_rasterizer.h"
 #include "gfx/point.h"
 #include "gfx/size.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace os {
 
-FreeTypeFont::FreeTypeFont(ft::Lib& lib, const char* filename, const int height)
-  : m_face(lib.open(filename))
+FreeTypeFont::FreeTypeFont(ft::Lib& lib,
+                           const char* filename,
+                           const int height,
+                           const int faceIndex)
+  : m_face(lib.openShared(filename, faceIndex))
+  , m_filename(filename)
+  , m_faceIndex(faceIndex)
+  , m_size(height)
 {
   if (m_face.isValid())
     m_face.setSize(height);
@@ -27,6 +38,8 @@ FreeTypeFont::FreeTypeFont(ft::Lib& lib, const char* filename, const int height)
 
 FreeTypeFont::~FreeTypeFont()
 {
+  // m_rasterCache is destroyed before m_face
+  m_face.cache().setSharedCache(nullptr);
 }
 
 bool FreeTypeFont::isValid() const
@@ -56,6 +69,7 @@ bool FreeTypeFont::isScalable() const
 
 void FreeTypeFont::setSize(int size)
 {
+  m_size = size;
   m_face.setSize(size);
 }
 
@@ -64,14 +78,57 @@ void FreeTypeFont::setAntialias(bool antialias)
   m_face.setAntialias(antialias);
 }
 
+void FreeTypeFont::setSubpixelPositioning(bool state)
+{
+  m_face.setSubpixelPositioning(state);
+}
+
 bool FreeTypeFont::hasCodePoint(int codepoint) const
 {
-  return m_face.hasCodePoint(codepoint);
+  if (!m_hasCoverage) {
+    m_face.forEachCodePoint([this](int cp) { m_coverage.add(cp); });
+    m_coverage.shrink();
+    m_hasCoverage = true;
+  }
+  return m_coverage.contains(codepoint);
+}
+
+void FreeTypeFont::prerasterizeGlyphs(const std::string& chars, base::thread_pool& pool)
+{
+  if (!m_face.isValid())
+    return;
+
+  if (!m_rasterCache) {
+    m_rasterCache = std::make_unique<ft::ConcurrentGlyphCache>();
+    m_face.cache().setSharedCache(m_rasterCache.get());
+  }
+
+  // Glyphs of individual chars (ligatures created by the shaper are
+  // rasterized on demand)
+  std::vector<FT_UInt> glyphs;
+  base::utf8_decode decode(chars);
+  while (const int chr = decode.next()) {
+    if (const FT_UInt glyph = m_face.cache().getGlyphIndex(m_face, chr))
+      glyphs.push_back(glyph);
+  }
+  std::sort(glyphs.begin(), glyphs.end());
+  glyphs.erase(std::unique(glyphs.begin(), glyphs.end()), glyphs.end());
+
+  ft::GlyphRasterizer rasterizer(pool);
+  rasterizer.rasterize(m_filename,
+                       m_faceIndex,
+                       m_size,
+                       m_face.antialias(),
+                       glyphs,
+                       *m_rasterCache);
 }
 
-Ref<FreeTypeFont> load_free_type_font(ft::Lib& lib, const char* filename, const int height)
+Ref<FreeTypeFont> load_free_type_font(ft::Lib& lib,
+                                      const char* filename,
+                                      const int height,
+                                      const int faceIndex)
 {
-  Ref<FreeTypeFont> font = base::make_ref<FreeTypeFont>(lib, filename, height);
+  Ref<FreeTypeFont> font = base::make_ref<FreeTypeFont>(lib, filename, height, faceIndex);
   if (!font->isValid())
     font.reset(); // delete font
   return font;
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2020  Igara Studio S.A.
+// Copyright (C) 2020-2025  Igara Studio S.A.
 // Copyright (C) 2016-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,10 +9,19 @@
 #define OS_COMMON_FREETYPE_FONT_H_INCLUDED
 #pragma once
 
+#include "ft/concurrent_glyph_cache.h"
 #include "ft/hb_face.h"
 #include "ft/lib.h"
+#include "os/common/codepoint_coverage.h"
 #include "os/font.h"
 
+#include <memory>
+#include <string>
+
+namespace base {
+class thread_pool;
+}
+
 namespace os {
 class Font;
 
@@ -20,7 +29,7 @@ class FreeTypeFont : public Font {
 public:
   using Face = ft::Face;
 
-  FreeTypeFont(ft::Lib& lib, const char* filename, const int height);
+  FreeTypeFont(ft::Lib& lib, const char* filename, const int height, const int faceIndex = 0);
   ~FreeTypeFont();
 
   bool isValid() const;
@@ -30,15 +39,42 @@ public:
   bool isScalable() const override;
   void setSize(int size) override;
   void setAntialias(bool antialias) override;
+  void setSubpixelPositioning(bool state) override;
   bool hasCodePoint(int codepoint) const override;
 
   Face& face() { return m_face; }
 
+  // Used to open other instances of the same font face (e.g. to
+  // shape text from other threads, as a FT_Face cannot be shared
+  // between threads).
+  const std::string& filename() const { return m_filename; }
+  int faceIndex() const { return m_faceIndex; }
+  int size() const { return m_size; }
+
+  // Rasterizes the glyphs of the given chars in parallel with the
+  // threads of the pool, so they are ready to be drawn.
+  void prerasterizeGlyphs(const std::string& chars, base::thread_pool& pool);
+
 private:
   mutable Face m_face;
+  std::string m_filename;
+  int m_faceIndex;
+  int m_size;
+
+  // Code points of the font, created the first time
+  // hasCodePoint() is called.
+  mutable CodePointCoverage m_coverage;
+  mutable bool m_hasCoverage = false;
+
+  // Glyphs rasterized by prerasterizeGlyphs(), used by the glyph
+  // cache of m_face.
+  std::unique_ptr<ft::ConcurrentGlyphCache> m_rasterCache;
 };
 
-Ref<FreeTypeFont> load_free_type_font(ft::Lib& lib, const char* filename, const int height);
+Ref<FreeTypeFont> load_free_type_font(ft::Lib& lib,
+                                      const char* filename,
+                                      const int height,
+                                      const int faceIndex = 0);
 
 } // namespace os
 
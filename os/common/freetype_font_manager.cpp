@@ -0,0 +1,295 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/freetype_font_manager.h"
+
+#include "base/fs.h"
+#include "base/string.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace os {
+
+namespace {
+
+std::string get_env(const char* name)
+{
+#if LAF_WINDOWS
+  const wchar_t* value = _wgetenv(base::from_utf8(name).c_str());
+  return (value ? base::to_utf8(value) : std::string());
+#else
+  const char* value = std::getenv(name);
+  return (value ? std::string(value) : std::string());
+#endif
+}
+
+FontStyle get_face_style(FT_Face face)
+{
+  auto weight = FontStyle::Weight::Normal;
+  auto width = FontStyle::Width::Normal;
+  auto slant = FontStyle::Slant::Upright;
+
+  if (face->style_flags & FT_STYLE_FLAG_BOLD)
+    weight = FontStyle::Weight::Bold;
+  if (face->style_flags & FT_STYLE_FLAG_ITALIC)
+    slant = FontStyle::Slant::Italic;
+
+  if (const auto* os2 = (const TT_OS2*)FT_Get_Sfnt_Table(face, FT_SFNT_OS2)) {
+    int w = os2->usWeightClass;
+    if (w >= 1 && w <= 9) // Some old fonts use 1-9 values
+      w *= 100;
+    if (w >= 1 && w <= 1000)
+      weight = FontStyle::Weight(w);
+    if (os2->usWidthClass >= 1 && os2->usWidthClass <= 9)
+      width = FontStyle::Width(os2->usWidthClass);
+    if (os2->fsSelection & (1 << 9)) // OBLIQUE bit
+      slant = FontStyle::Slant::Oblique;
+  }
+
+  return FontStyle(weight, width, slant);
+}
+
+// Distance used to find the closest style, the slant is the most
+// important property, then the width, and finally the weight.
+int style_distance(const FontStyle& a, const FontStyle& b)
+{
+  return (a.slant() == b.slant() ? 0 : 100000) +
+         std::abs(int(a.width()) - int(b.width())) * 1000 +
+         std::abs(int(a.weight()) - int(b.weight()));
+}
+
+} // anonymous namespace
+
+bool scan_free_type_font_file(ft::Lib& lib,
+                              const std::string& filename,
+                              std::vector<FontIndex::Face>& faces)
+{
+  FT_Long numFaces = 1;
+  for (FT_Long i = 0; i < numFaces; ++i) {
+    FT_Face face = nullptr;
+    if (FT_New_Face(lib, filename.c_str(), i, &face) != 0 || !face)
+      return (i > 0);
+
+    numFaces = face->num_faces;
+    if (face->family_name) {
+      FontIndex::Face info;
+      info.filename = filename;
+      info.faceIndex = int(i);
+      info.family = face->family_name;
+      info.styleName = (face->style_name ? face->style_name : "");
+      info.style = get_face_style(face);
+
+      FT_UInt glyphIndex;
+      FT_ULong codepoint = FT_Get_First_Char(face, &glyphIndex);
+      while (glyphIndex != 0) {
+        info.coverage.addCodePoint(int(codepoint));
+        codepoint = FT_Get_Next_Char(face, codepoint, &glyphIndex);
+      }
+
+      faces.push_back(std::move(info));
+    }
+    FT_Done_Face(face);
+  }
+  return true;
+}
+
+void FreeTypeFontStyleSet::getStyle(const int index, FontStyle& style, std::string& name)
+{
+  style = m_faces[index].style;
+  name = m_faces[index].styleName;
+}
+
+TypefaceRef FreeTypeFontStyleSet::typeface(const int index)
+{
+  return make_ref<FreeTypeTypeface>(m_faces[index]);
+}
+
+TypefaceRef FreeTypeFontStyleSet::matchStyle(const FontStyle& style)
+{
+  if (m_faces.empty())
+    return nullptr;
+
+  auto it = std::min_element(
+    m_faces.begin(),
+    m_faces.end(),
+    [&style](const FontIndex::Face& a, const FontIndex::Face& b) {
+      return style_distance(a.style, style) < style_distance(b.style, style);
+    });
+  return make_ref<FreeTypeTypeface>(*it);
+}
+
+FreeTypeFontManager::FreeTypeFontManager(const std::string& indexFilename,
+                                         const base::paths& dirs)
+  : m_indexFilename(indexFilename)
+  , m_dirs(dirs)
+  , m_cancel(false)
+{
+  FontIndex index;
+  if (index.load(m_indexFilename)) {
+    m_index = std::make_shared<const FontIndex>(index);
+
+    // Update the index in background (the index loaded from disk
+    // is used in the meantime)
+    m_thread = std::thread([this, index]() mutable { updateIndex(std::move(index)); });
+  }
+  // The first time we have to scan all fonts before returning
+  else {
+    m_index = std::make_shared<const FontIndex>();
+    updateIndex(std::move(index));
+    publishIndex();
+  }
+}
+
+FreeTypeFontManager::~FreeTypeFontManager()
+{
+  m_cancel = true;
+  waitUpdate();
+}
+
+int FreeTypeFontManager::countFamilies() const
+{
+  // A new enumeration can start here, so it's safe to use the
+  // updated index
+  publishIndex();
+  return int(index()->families().size());
+}
+
+std::string FreeTypeFontManager::familyName(const int index) const
+{
+  const auto idx = this->index();
+  if (index >= 0 && index < int(idx->families().size()))
+    return idx->families()[index].name;
+  return std::string();
+}
+
+Ref<FontStyleSet> FreeTypeFontManager::familyStyleSet(const int index) const
+{
+  const auto idx = this->index();
+  if (index >= 0 && index < int(idx->families().size()))
+    return makeStyleSet(*idx, &idx->families()[index]);
+  return nullptr;
+}
+
+Ref<FontStyleSet> FreeTypeFontManager::matchFamily(const std::string& familyName) const
+{
+  const auto idx = latestIndex();
+  if (const FontIndex::Family* family = idx->findFamily(familyName))
+    return makeStyleSet(*idx, family);
+  return nullptr;
+}
+
+void FreeTypeFontManager::waitUpdate()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+// static
+std::string FreeTypeFontManager::defaultIndexFilename()
+{
+  std::string dir;
+#if LAF_WINDOWS
+  dir = get_env("LOCALAPPDATA");
+#elif LAF_MACOS
+  dir = get_env("HOME");
+  if (!dir.empty())
+    dir = base::join_path(dir, "Library/Caches");
+#else
+  dir = get_env("XDG_CACHE_HOME");
+  if (dir.empty()) {
+    dir = get_env("HOME");
+    if (!dir.empty())
+      dir = base::join_path(dir, ".cache");
+  }
+#endif
+  if (dir.empty() || !base::is_directory(dir))
+    dir = base::get_temp_path();
+
+  return base::join_path(dir, "laf-font-index.bin");
+}
+
+// static
+base::paths FreeTypeFontManager::systemFontDirs()
+{
+  base::paths dirs;
+#if LAF_WINDOWS
+  const std::string windir = get_env("WINDIR");
+  if (!windir.empty())
+    dirs.push_back(base::join_path(windir, "Fonts"));
+  const std::string localAppData = get_env("LOCALAPPDATA");
+  if (!localAppData.empty())
+    dirs.push_back(base::join_path(localAppData, "Microsoft\\Windows\\Fonts"));
+#elif LAF_MACOS
+  dirs.push_back("/System/Library/Fonts");
+  dirs.push_back("/Library/Fonts");
+  const std::string home = get_env("HOME");
+  if (!home.empty())
+    dirs.push_back(base::join_path(home, "Library/Fonts"));
+#else
+  dirs.push_back("/usr/share/fonts");
+  dirs.push_back("/usr/local/share/fonts");
+  const std::string home = get_env("HOME");
+  if (!home.empty()) {
+    dirs.push_back(base::join_path(home, ".fonts"));
+    dirs.push_back(base::join_path(home, ".local/share/fonts"));
+  }
+#endif
+  return dirs;
+}
+
+std::shared_ptr<const FontIndex> FreeTypeFontManager::index() const
+{
+  const std::lock_guard lock(m_mutex);
+  return m_index;
+}
+
+std::shared_ptr<const FontIndex> FreeTypeFontManager::latestIndex() const
+{
+  const std::lock_guard lock(m_mutex);
+  return (m_updatedIndex ? m_updatedIndex : m_index);
+}
+
+void FreeTypeFontManager::publishIndex() const
+{
+  const std::lock_guard lock(m_mutex);
+  if (m_updatedIndex)
+    m_index = std::move(m_updatedIndex);
+}
+
+Ref<FontStyleSet> FreeTypeFontManager::makeStyleSet(const FontIndex& index,
+                                                    const FontIndex::Family* family) const
+{
+  std::vector<FontIndex::Face> faces;
+  faces.reserve(family->faces.size());
+  for (const int i : family->faces)
+    faces.push_back(index.faces()[i]);
+  return make_ref<FreeTypeFontStyleSet>(std::move(faces));
+}
+
+void FreeTypeFontManager::updateIndex(FontIndex index)
+{
+  ft::Lib lib;
+  const bool changed = index.update(
+    m_dirs,
+    [&lib](const std::string& filename, std::vector<FontIndex::Face>& faces) {
+      return scan_free_type_font_file(lib, filename, faces);
+    },
+    &m_cancel);
+
+  if (changed) {
+    index.save(m_indexFilename);
+
+    const std::lock_guard lock(m_mutex);
+    m_updatedIndex = std::make_shared<const FontIndex>(std::move(index));
+  }
+}
+
+} // namespace os
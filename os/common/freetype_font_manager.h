@@ -0,0 +1,112 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_FREETYPE_FONT_MANAGER_H_INCLUDED
+#define OS_COMMON_FREETYPE_FONT_MANAGER_H_INCLUDED
+#pragma once
+
+#include "ft/lib.h"
+#include "os/common/font_index.h"
+#include "os/font_manager.h"
+#include "os/font_style.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace os {
+
+// Reads the faces of a font file with FreeType (family, style, and
+// a summary of its code points) to be added to a FontIndex.
+bool scan_free_type_font_file(ft::Lib& lib,
+                              const std::string& filename,
+                              std::vector<FontIndex::Face>& faces);
+
+class FreeTypeTypeface : public Typeface {
+public:
+  FreeTypeTypeface(const FontIndex::Face& face) : m_face(face) {}
+
+  FontStyle fontStyle() const override { return m_face.style; }
+
+  // File and index of the face in the file (e.g. for .ttc
+  // collections) to load the font with load_free_type_font()
+  const std::string& filename() const { return m_face.filename; }
+  int faceIndex() const { return m_face.faceIndex; }
+
+  bool mayContain(const int codepoint) const { return m_face.coverage.mayContain(codepoint); }
+
+private:
+  FontIndex::Face m_face;
+};
+
+class FreeTypeFontStyleSet : public FontStyleSet {
+public:
+  FreeTypeFontStyleSet(std::vector<FontIndex::Face>&& faces) : m_faces(std::move(faces)) {}
+
+  int count() override { return int(m_faces.size()); }
+  void getStyle(int index, FontStyle& style, std::string& name) override;
+  TypefaceRef typeface(int index) override;
+  TypefaceRef matchStyle(const FontStyle& style) override;
+
+private:
+  std::vector<FontIndex::Face> m_faces;
+};
+
+// Font manager that enumerates the font files of the given
+// directories without opening them, using a FontIndex saved in disk.
+// The index is loaded at startup (and created the first time), and
+// then updated in a background thread to add/remove the fonts
+// installed/uninstalled since the last time.
+//
+// Family indexes only change when countFamilies() is called, so
+// familyName() and familyStyleSet() use the same index during an
+// enumeration even if the background update finishes in the middle
+// of it.
+//
+// This is the fontManager() of the none backend when laf is compiled
+// with FreeType (the Skia backend uses SkFontMgr).
+class FreeTypeFontManager : public FontManager {
+public:
+  FreeTypeFontManager(const std::string& indexFilename = defaultIndexFilename(),
+                      const base::paths& dirs = systemFontDirs());
+  ~FreeTypeFontManager();
+
+  int countFamilies() const override;
+  std::string familyName(int index) const override;
+  Ref<FontStyleSet> familyStyleSet(int index) const override;
+  Ref<FontStyleSet> matchFamily(const std::string& familyName) const override;
+
+  // Waits the background update of the index, the updated index is
+  // used from the next countFamilies() call.
+  void waitUpdate();
+
+  static std::string defaultIndexFilename();
+  static base::paths systemFontDirs();
+
+private:
+  std::shared_ptr<const FontIndex> index() const;
+  std::shared_ptr<const FontIndex> latestIndex() const;
+  void publishIndex() const;
+  Ref<FontStyleSet> makeStyleSet(const FontIndex& index, const FontIndex::Family* family) const;
+  void updateIndex(FontIndex index);
+
+  std::string m_indexFilename;
+  base::paths m_dirs;
+  mutable std::mutex m_mutex;
+  // Index used to enumerate families, and the result of the last
+  // update that will replace it in the next countFamilies() call
+  mutable std::shared_ptr<const FontIndex> m_index;
+  mutable std::shared_ptr<const FontIndex> m_updatedIndex;
+  std::atomic<bool> m_cancel;
+  std::thread m_thread;
+};
+
+} // namespace os
+
+#endif
@@ -0,0 +1,964 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/image_decoder.h"
+
+#include "base/debug.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/string.h"
+#include "gfx/point.h"
+#include "os/common/inflate.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Bigger images are rejected (they are probably corrupted files)
+constexpr int kMaxImageSize = 65535;
+
+// Size of the read buffer (it's enlarged to read bigger rows)
+constexpr std::size_t kBufferSize = 64 * 1024;
+
+// Max size of the read buffer, bigger reads fail (rows of valid
+// images are smaller)
+constexpr std::size_t kMaxBufferSize = 1024 * 1024;
+
+// Max length of a PNG chunk
+constexpr uint32_t kMaxPngChunkLength = 0x7fffffff;
+
+inline uint16_t get_u16le(const uint8_t* p)
+{
+  return uint16_t(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get_u32le(const uint8_t* p)
+{
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+inline uint32_t get_u32be(const uint8_t* p)
+{
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+inline void set_rgba(uint8_t* p, const int r, const int g, const int b, const int a)
+{
+  p[0] = uint8_t(r);
+  p[1] = uint8_t(g);
+  p[2] = uint8_t(b);
+  p[3] = uint8_t(a);
+}
+
+// Buffered reader of a file
+class Reader {
+public:
+  Reader(FILE* file) : m_file(file), m_buf(kBufferSize) {}
+
+  // Returns a pointer to the next "n" bytes of the file (valid until
+  // the next call), or nullptr if the file is shorter.
+  const uint8_t* read(const std::size_t n)
+  {
+    if (m_end - m_pos < n && !fill(n))
+      return nullptr;
+    const uint8_t* p = &m_buf[m_pos];
+    m_pos += n;
+    return p;
+  }
+
+  // Same as read() but without moving the file position.
+  const uint8_t* peek(const std::size_t n)
+  {
+    if (m_end - m_pos < n && !fill(n))
+      return nullptr;
+    return &m_buf[m_pos];
+  }
+
+  // Returns the next byte or -1 at the end of the file.
+  int byte()
+  {
+    if (m_pos == m_end && !fill(1))
+      return -1;
+    return m_buf[m_pos++];
+  }
+
+  // Returns a pointer to the next bytes of the file (between 1 and
+  // "maxBytes"), or nullptr at the end of the file.
+  const uint8_t* readSome(const std::size_t maxBytes, std::size_t& n)
+  {
+    if (m_pos == m_end && !fill(1))
+      return nullptr;
+    n = std::min(maxBytes, m_end - m_pos);
+    const uint8_t* p = &m_buf[m_pos];
+    m_pos += n;
+    return p;
+  }
+
+  bool skip(std::size_t n)
+  {
+    const std::size_t buffered = m_end - m_pos;
+    if (n <= buffered) {
+      m_pos += n;
+      return true;
+    }
+    n -= buffered;
+    m_pos = m_end = 0;
+    if (n > std::size_t(LONG_MAX))
+      return false;
+    return (std::fseek(m_file, long(n), SEEK_CUR) == 0);
+  }
+
+private:
+  bool fill(const std::size_t n)
+  {
+    // Move the remaining bytes to the beginning of the buffer
+    const std::size_t remaining = m_end - m_pos;
+    if (m_pos > 0) {
+      std::memmove(m_buf.data(), m_buf.data() + m_pos, remaining);
+      m_pos = 0;
+      m_end = remaining;
+    }
+    if (m_buf.size() < n) {
+      if (n > kMaxBufferSize)
+        return false;
+      m_buf.resize(n);
+    }
+
+    while (m_end < n) {
+      const std::size_t bytes = std::fread(m_buf.data() + m_end, 1, m_buf.size() - m_end, m_file);
+      if (bytes == 0)
+        return false;
+      m_end += bytes;
+    }
+    return true;
+  }
+
+  FILE* m_file;
+  std::vector<uint8_t> m_buf;
+  std::size_t m_pos = 0;
+  std::size_t m_end = 0;
+};
+
+// Converts decoded rows (non-premultiplied RGBA, 4 bytes per pixel)
+// to the destination format, only the pixels inside the ROI.
+class RowWriter {
+public:
+  RowWriter(const gfx::Rect& roi, uint32_t* dst, const int dstStride, const SurfaceFormatData& fd)
+    : m_roi(roi)
+    , m_dst(dst)
+    , m_stride(dstStride)
+    , m_premultiplied(fd.pixelAlpha == PixelAlpha::kPremultiplied)
+    , m_shifts{ fd.redShift, fd.greenShift, fd.blueShift, fd.alphaShift }
+    , m_rowsLeft(roi.h)
+  {
+  }
+
+  bool wants(const int y) const { return (y >= m_roi.y && y < m_roi.y2()); }
+  bool done() const { return m_rowsLeft == 0; }
+
+  // Writes the row "y" of the image, "rgba" is the full row.
+  void write(const int y, const uint8_t* rgba)
+  {
+    uint32_t* out = m_dst + std::size_t(y - m_roi.y) * m_stride;
+    const uint8_t* p = rgba + 4 * std::size_t(m_roi.x);
+    for (int x = 0; x < m_roi.w; ++x, p += 4) {
+      uint32_t r = p[0], g = p[1], b = p[2];
+      const uint32_t a = p[3];
+      if (m_premultiplied && a != 255) {
+        r = (r * a + 127) / 255;
+        g = (g * a + 127) / 255;
+        b = (b * a + 127) / 255;
+      }
+      out[x] = (r << m_shifts[0]) | (g << m_shifts[1]) | (b << m_shifts[2]) | (a << m_shifts[3]);
+    }
+    --m_rowsLeft;
+  }
+
+private:
+  gfx::Rect m_roi;
+  uint32_t* m_dst;
+  int m_stride;
+  bool m_premultiplied;
+  uint32_t m_shifts[4];
+  int m_rowsLeft;
+};
+
+class Decoder {
+public:
+  virtual ~Decoder() {}
+  virtual bool readHeader(Reader& reader, ImageInfo& info) = 0;
+  virtual bool decode(Reader& reader, RowWriter& writer) = 0;
+
+protected:
+  int m_width = 0;
+  int m_height = 0;
+  std::vector<uint8_t> m_row; // Decoded row in RGBA format
+
+  bool setSize(const int w, const int h, ImageInfo& info, const ImageFormat format)
+  {
+    if (w <= 0 || h <= 0 || w > kMaxImageSize || h > kMaxImageSize)
+      return false;
+    m_width = info.width = w;
+    m_height = info.height = h;
+    info.format = format;
+    m_row.resize(4 * std::size_t(w));
+    return true;
+  }
+};
+
+//////////////////////////////////////////////////////////////////////
+// BMP
+
+class BmpDecoder : public Decoder {
+public:
+  bool readHeader(Reader& reader, ImageInfo& info) override
+  {
+    const uint8_t* h = reader.read(18);
+    if (!h || h[0] != 'B' || h[1] != 'M')
+      return false;
+
+    m_dataOffset = get_u32le(h + 10);
+    const uint32_t headerSize = get_u32le(h + 14);
+    if (headerSize < 12 || headerSize > 1024)
+      return false;
+    const uint8_t* d = reader.read(headerSize - 4);
+    if (!d)
+      return false;
+    m_bytesRead = 14 + headerSize;
+
+    int w, hgt;
+    uint32_t compression = 0;
+    uint32_t colors = 0;
+    int entrySize = 4;
+    if (headerSize == 12) { // OS/2 BITMAPCOREHEADER
+      w = get_u16le(d);
+      hgt = get_u16le(d + 2);
+      m_bpp = get_u16le(d + 6);
+      entrySize = 3;
+    }
+    else if (headerSize >= 40) {
+      w = int(get_u32le(d));
+      hgt = int(get_u32le(d + 4));
+      m_bpp = get_u16le(d + 10);
+      compression = get_u32le(d + 12);
+      colors = get_u32le(d + 28);
+      if (headerSize >= 52) {
+        m_masks[0] = get_u32le(d + 36);
+        m_masks[1] = get_u32le(d + 40);
+        m_masks[2] = get_u32le(d + 44);
+      }
+      if (headerSize >= 56)
+        m_masks[3] = get_u32le(d + 48);
+    }
+    else
+      return false;
+
+    // BI_RGB, BI_BITFIELDS or BI_ALPHABITFIELDS (RLE is not supported)
+    if (compression != 0 && compression != 3 && compression != 6)
+      return false;
+    if (m_bpp != 1 && m_bpp != 4 && m_bpp != 8 && m_bpp != 16 && m_bpp != 24 && m_bpp != 32)
+      return false;
+
+    // Masks after a BITMAPINFOHEADER
+    if (compression != 0 && headerSize == 40) {
+      const int n = (compression == 6 ? 4 : 3);
+      const uint8_t* m = reader.read(4 * n);
+      if (!m)
+        return false;
+      for (int i = 0; i < n; ++i)
+        m_masks[i] = get_u32le(m + 4 * i);
+      m_bytesRead += 4 * n;
+    }
+    if (compression == 0) {
+      if (m_bpp == 16) {
+        m_masks[0] = 0x7c00;
+        m_masks[1] = 0x03e0;
+        m_masks[2] = 0x001f;
+      }
+      else if (m_bpp == 32) {
+        m_masks[0] = 0x00ff0000;
+        m_masks[1] = 0x0000ff00;
+        m_masks[2] = 0x000000ff;
+      }
+      // The alpha channel of BI_RGB images is ignored
+      m_masks[3] = 0;
+    }
+    for (int i = 0; i < 4; ++i) {
+      m_shifts[i] = 0;
+      if (m_masks[i]) {
+        while (((m_masks[i] >> m_shifts[i]) & 1) == 0)
+          ++m_shifts[i];
+      }
+    }
+
+    if (m_bpp <= 8) {
+      if (colors == 0 || colors > (1u << m_bpp))
+        colors = (1u << m_bpp);
+      const uint8_t* p = reader.read(colors * entrySize);
+      if (!p)
+        return false;
+      m_bytesRead += colors * entrySize;
+      std::fill(std::begin(m_palette), std::end(m_palette), 0xff000000);
+      for (uint32_t i = 0; i < colors; ++i, p += entrySize)
+        set_rgba((uint8_t*)&m_palette[i], p[2], p[1], p[0], 255);
+    }
+
+    // INT_MIN cannot be negated
+    if (hgt == INT_MIN)
+      return false;
+    m_topDown = (hgt < 0);
+    return setSize(w, std::abs(hgt), info, ImageFormat::Bmp);
+  }
+
+  bool decode(Reader& reader, RowWriter& writer) override
+  {
+    if (m_dataOffset < m_bytesRead || !reader.skip(m_dataOffset - m_bytesRead))
+      return false;
+
+    const std::size_t rowBytes = ((std::size_t(m_width) * m_bpp + 31) / 32) * 4;
+    for (int i = 0; i < m_height && !writer.done(); ++i) {
+      const int y = (m_topDown ? i : m_height - 1 - i);
+      if (!writer.wants(y)) {
+        if (!reader.skip(rowBytes))
+          return false;
+        continue;
+      }
+
+      const uint8_t* src = reader.read(rowBytes);
+      if (!src)
+        return false;
+      convertRow(src);
+      writer.write(y, m_row.data());
+    }
+    return true;
+  }
+
+private:
+  void convertRow(const uint8_t* src)
+  {
+    uint8_t* out = m_row.data();
+    switch (m_bpp) {
+      case 1:
+      case 4:
+      case 8: {
+        const int mask = (1 << m_bpp) - 1;
+        for (int x = 0; x < m_width; ++x, out += 4) {
+          const int bit = x * m_bpp;
+          const int index = (src[bit / 8] >> (8 - m_bpp - (bit % 8))) & mask;
+          std::memcpy(out, &m_palette[index], 4);
+        }
+        break;
+      }
+      case 24:
+        for (int x = 0; x < m_width; ++x, out += 4, src += 3)
+          set_rgba(out, src[2], src[1], src[0], 255);
+        break;
+      case 16:
+      case 32:
+        for (int x = 0; x < m_width; ++x, out += 4) {
+          uint32_t v;
+          if (m_bpp == 16) {
+            v = get_u16le(src);
+            src += 2;
+          }
+          else {
+            v = get_u32le(src);
+            src += 4;
+          }
+          set_rgba(out, channel(v, 0), channel(v, 1), channel(v, 2), channel(v, 3));
+        }
+        break;
+    }
+  }
+
+  // Returns the value of a bit field scaled to 8 bits
+  int channel(const uint32_t v, const int i) const
+  {
+    if (!m_masks[i])
+      return (i == 3 ? 255 : 0);
+    const uint32_t max = (m_masks[i] >> m_shifts[i]);
+    return int(uint64_t((v & m_masks[i]) >> m_shifts[i]) * 255 / max);
+  }
+
+  uint32_t m_dataOffset = 0;
+  uint32_t m_bytesRead = 0;
+  int m_bpp = 0;
+  bool m_topDown = false;
+  uint32_t m_masks[4] = { 0, 0, 0, 0 };
+  int m_shifts[4] = { 0, 0, 0, 0 };
+  uint32_t m_palette[256];
+};
+
+//////////////////////////////////////////////////////////////////////
+// TGA
+
+class TgaDecoder : public Decoder {
+public:
+  bool readHeader(Reader& reader, ImageInfo& info) override
+  {
+    const uint8_t* h = reader.read(18);
+    if (!h)
+      return false;
+
+    const int idLength = h[0];
+    const int colorMapType = h[1];
+    m_type = h[2];
+    const int colorMapFirst = get_u16le(h + 3);
+    const int colorMapLength = get_u16le(h + 5);
+    const int colorMapBits = h[7];
+    const int w = get_u16le(h + 12);
+    const int hgt = get_u16le(h + 14);
+    m_bpp = h[16];
+    m_alphaBits = (h[17] & 0x0f);
+    m_topToBottom = (h[17] & 0x20);
+    m_rightToLeft = (h[17] & 0x10);
+
+    switch (m_type & 7) {
+      case 1:
+        if (colorMapType != 1 || (m_bpp != 8 && m_bpp != 16))
+          return false;
+        break;
+      case 2:
+        if (m_bpp != 15 && m_bpp != 16 && m_bpp != 24 && m_bpp != 32)
+          return false;
+        break;
+      case 3:
+        if (m_bpp != 8 && m_bpp != 16)
+          return false;
+        break;
+      default: return false;
+    }
+    if (m_type != 1 && m_type != 2 && m_type != 3 && m_type != 9 && m_type != 10 && m_type != 11)
+      return false;
+    if (colorMapType > 1)
+      return false;
+
+    if (!reader.skip(idLength))
+      return false;
+
+    if (colorMapType == 1) {
+      const int entrySize = (colorMapBits + 7) / 8;
+      if (entrySize < 2 || entrySize > 4)
+        return false;
+      const uint8_t* p = reader.read(std::size_t(colorMapLength) * entrySize);
+      if (!p)
+        return false;
+      m_colorMapFirst = colorMapFirst;
+      m_colorMap.resize(colorMapLength);
+      for (int i = 0; i < colorMapLength; ++i, p += entrySize)
+        truecolor(p, colorMapBits, (uint8_t*)&m_colorMap[i]);
+    }
+
+    return setSize(w, hgt, info, ImageFormat::Tga);
+  }
+
+  bool decode(Reader& reader, RowWriter& writer) override
+  {
+    const int pixelSize = (m_bpp + 7) / 8;
+    const std::size_t rowBytes = std::size_t(m_width) * pixelSize;
+    const bool rle = (m_type >= 9);
+
+    for (int i = 0; i < m_height && !writer.done(); ++i) {
+      const int y = (m_topToBottom ? i : m_height - 1 - i);
+
+      if (!rle) {
+        if (!writer.wants(y)) {
+          if (!reader.skip(rowBytes))
+            return false;
+          continue;
+        }
+        const uint8_t* src = reader.read(rowBytes);
+        if (!src)
+          return false;
+        for (int x = 0; x < m_width; ++x, src += pixelSize)
+          pixel(src, &m_row[4 * x]);
+      }
+      // RLE packets can continue in the next row
+      else {
+        for (int x = 0; x < m_width;) {
+          if (m_packetLeft == 0) {
+            const int header = reader.byte();
+            if (header < 0)
+              return false;
+            m_packetLeft = (header & 0x7f) + 1;
+            m_repeat = (header & 0x80);
+            if (m_repeat) {
+              const uint8_t* src = reader.read(pixelSize);
+              if (!src)
+                return false;
+              pixel(src, m_repeatPixel);
+            }
+          }
+
+          const int n = std::min(m_packetLeft, m_width - x);
+          if (m_repeat) {
+            for (int j = 0; j < n; ++j)
+              std::memcpy(&m_row[4 * (x + j)], m_repeatPixel, 4);
+          }
+          else {
+            const uint8_t* src = reader.read(std::size_t(n) * pixelSize);
+            if (!src)
+              return false;
+            for (int j = 0; j < n; ++j, src += pixelSize)
+              pixel(src, &m_row[4 * (x + j)]);
+          }
+          x += n;
+          m_packetLeft -= n;
+        }
+        if (!writer.wants(y))
+          continue;
+      }
+
+      if (m_rightToLeft) {
+        uint32_t* row = (uint32_t*)m_row.data();
+        std::reverse(row, row + m_width);
+      }
+      writer.write(y, m_row.data());
+    }
+    return true;
+  }
+
+private:
+  void pixel(const uint8_t* src, uint8_t* out) const
+  {
+    switch (m_type & 7) {
+      case 1: {
+        const int index = (m_bpp == 8 ? src[0] : get_u16le(src)) - m_colorMapFirst;
+        if (index >= 0 && index < int(m_colorMap.size()))
+          std::memcpy(out, &m_colorMap[index], 4);
+        else
+          set_rgba(out, 0, 0, 0, 255);
+        break;
+      }
+      case 2: truecolor(src, m_bpp, out); break;
+      case 3:
+        set_rgba(out, src[0], src[0], src[0], (m_bpp == 16 && m_alphaBits ? src[1] : 255));
+        break;
+    }
+  }
+
+  void truecolor(const uint8_t* src, const int bits, uint8_t* out) const
+  {
+    switch (bits) {
+      case 15:
+      case 16: {
+        const int v = get_u16le(src);
+        const int r = (v >> 10) & 0x1f;
+        const int g = (v >> 5) & 0x1f;
+        const int b = v & 0x1f;
+        const int a = (bits == 16 && m_alphaBits && !(v & 0x8000) ? 0 : 255);
+        set_rgba(out, (r << 3) | (r >> 2), (g << 3) | (g >> 2), (b << 3) | (b >> 2), a);
+        break;
+      }
+      case 24: set_rgba(out, src[2], src[1], src[0], 255); break;
+      case 32: set_rgba(out, src[2], src[1], src[0], (m_alphaBits ? src[3] : 255)); break;
+      default: set_rgba(out, 0, 0, 0, 255); break;
+    }
+  }
+
+  int m_type = 0;
+  int m_bpp = 0;
+  int m_alphaBits = 0;
+  bool m_topToBottom = false;
+  bool m_rightToLeft = false;
+  int m_colorMapFirst = 0;
+  std::vector<uint32_t> m_colorMap;
+
+  // Current RLE packet
+  int m_packetLeft = 0;
+  bool m_repeat = false;
+  uint8_t m_repeatPixel[4];
+};
+
+//////////////////////////////////////////////////////////////////////
+// QOI
+
+class QoiDecoder : public Decoder {
+public:
+  bool readHeader(Reader& reader, ImageInfo& info) override
+  {
+    const uint8_t* h = reader.read(14);
+    if (!h || std::memcmp(h, "qoif", 4) != 0)
+      return false;
+    const uint32_t w = get_u32be(h + 4);
+    const uint32_t hgt = get_u32be(h + 8);
+    if (w > uint32_t(kMaxImageSize) || hgt > uint32_t(kMaxImageSize) || (h[12] != 3 && h[12] != 4))
+      return false;
+    return setSize(int(w), int(hgt), info, ImageFormat::Qoi);
+  }
+
+  bool decode(Reader& reader, RowWriter& writer) override
+  {
+    uint8_t index[64][4] = {};
+    uint8_t px[4] = { 0, 0, 0, 255 };
+    int run = 0;
+
+    for (int y = 0; y < m_height && !writer.done(); ++y) {
+      uint8_t* out = m_row.data();
+      for (int x = 0; x < m_width; ++x, out += 4) {
+        if (run > 0) {
+          --run;
+        }
+        else {
+          const int b1 = reader.byte();
+          if (b1 < 0)
+            return false;
+
+          if (b1 == 0xfe || b1 == 0xff) { // QOI_OP_RGB/RGBA
+            const uint8_t* p = reader.read(b1 == 0xfe ? 3 : 4);
+            if (!p)
+              return false;
+            std::memcpy(px, p, (b1 == 0xfe ? 3 : 4));
+          }
+          else {
+            switch (b1 & 0xc0) {
+              case 0x00: // QOI_OP_INDEX
+                std::memcpy(px, index[b1], 4);
+                break;
+              case 0x40: // QOI_OP_DIFF
+                px[0] += ((b1 >> 4) & 3) - 2;
+                px[1] += ((b1 >> 2) & 3) - 2;
+                px[2] += (b1 & 3) - 2;
+                break;
+              case 0x80: { // QOI_OP_LUMA
+                const int b2 = reader.byte();
+                if (b2 < 0)
+                  return false;
+                const int vg = (b1 & 0x3f) - 32;
+                px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+                px[1] += vg;
+                px[2] += vg - 8 + (b2 & 0x0f);
+                break;
+              }
+              case 0xc0: // QOI_OP_RUN
+                run = (b1 & 0x3f);
+                break;
+            }
+          }
+          std::memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+        std::memcpy(out, px, 4);
+      }
+      if (writer.wants(y))
+        writer.write(y, m_row.data());
+    }
+    return true;
+  }
+};
+
+//////////////////////////////////////////////////////////////////////
+// PNG
+
+class PngDecoder : public Decoder {
+public:
+  bool readHeader(Reader& reader, ImageInfo& info) override
+  {
+    static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    const uint8_t* h = reader.read(8 + 8 + 13 + 4);
+    if (!h || std::memcmp(h, kSignature, 8) != 0 || get_u32be(h + 8) != 13 ||
+        std::memcmp(h + 12, "IHDR", 4) != 0) {
+      return false;
+    }
+    const uint8_t* ihdr = h + 16;
+    const uint32_t w = get_u32be(ihdr);
+    const uint32_t hgt = get_u32be(ihdr + 4);
+    m_depth = ihdr[8];
+    m_colorType = ihdr[9];
+    // Interlaced images are not supported
+    if (ihdr[10] != 0 || ihdr[11] != 0 || ihdr[12] != 0)
+      return false;
+
+    switch (m_colorType) {
+      case 0: m_channels = 1; break;
+      case 2: m_channels = 3; break;
+      case 3: m_channels = 1; break;
+      case 4: m_channels = 2; break;
+      case 6: m_channels = 4; break;
+      default: return false;
+    }
+    const bool validDepth =
+      (m_colorType == 0 ?
+         (m_depth == 1 || m_depth == 2 || m_depth == 4 || m_depth == 8 || m_depth == 16) :
+       m_colorType == 3 ? (m_depth == 1 || m_depth == 2 || m_depth == 4 || m_depth == 8) :
+                          (m_depth == 8 || m_depth == 16));
+    if (!validDepth || w > uint32_t(kMaxImageSize) || hgt > uint32_t(kMaxImageSize))
+      return false;
+
+    return setSize(int(w), int(hgt), info, ImageFormat::Png);
+  }
+
+  bool decode(Reader& reader, RowWriter& writer) override
+  {
+    std::fill(std::begin(m_palette), std::end(m_palette), 0xff000000);
+
+    // Read chunks until the first IDAT
+    uint32_t len;
+    while (true) {
+      const uint8_t* chunk = reader.read(8);
+      if (!chunk)
+        return false;
+      len = get_u32be(chunk);
+      if (len > kMaxPngChunkLength)
+        return false;
+      if (std::memcmp(chunk + 4, "IDAT", 4) == 0)
+        break;
+
+      // Only the palette (up to 256 RGB entries) and the transparency
+      // (up to 256 alpha values) are read, other chunks are skipped
+      const bool isPalette = (std::memcmp(chunk + 4, "PLTE", 4) == 0);
+      const bool isTransparency = (std::memcmp(chunk + 4, "tRNS", 4) == 0);
+      if ((isPalette && (len > 3 * 256 || len % 3 != 0)) || (isTransparency && len > 256))
+        return false;
+      if (isPalette || isTransparency) {
+        const uint8_t* data = reader.read(len);
+        if (!data)
+          return false;
+        if (isPalette)
+          readPalette(data, len);
+        else
+          readTransparency(data, len);
+        len = 0;
+      }
+      if (!reader.skip(std::size_t(len) + 4)) // Data + CRC
+        return false;
+    }
+
+    // The compressed data is read from consecutive IDAT chunks
+    uint32_t idatLeft = len;
+    Inflater inflater([&reader, &idatLeft](const uint8_t*& data, std::size_t& size) {
+      while (idatLeft == 0) {
+        const uint8_t* chunk;
+        if (!reader.skip(4) || !(chunk = reader.read(8)) || std::memcmp(chunk + 4, "IDAT", 4) != 0)
+          return false;
+        idatLeft = get_u32be(chunk);
+        if (idatLeft > kMaxPngChunkLength)
+          return false;
+      }
+      data = reader.readSome(idatLeft, size);
+      if (!data)
+        return false;
+      idatLeft -= uint32_t(size);
+      return true;
+    });
+
+    const int bitsPerPixel = m_channels * m_depth;
+    const std::size_t rowBytes = (std::size_t(m_width) * bitsPerPixel + 7) / 8;
+    const int bpp = std::max(1, bitsPerPixel / 8);
+    std::vector<uint8_t> prev(rowBytes + 1, 0);
+    std::vector<uint8_t> cur(rowBytes + 1);
+
+    for (int y = 0; y < m_height && !writer.done(); ++y) {
+      if (!inflater.read(cur.data(), cur.size()))
+        return false;
+      if (!unfilter(cur[0], cur.data() + 1, prev.data() + 1, rowBytes, bpp))
+        return false;
+      if (writer.wants(y)) {
+        convertRow(cur.data() + 1);
+        writer.write(y, m_row.data());
+      }
+      std::swap(prev, cur);
+    }
+    return true;
+  }
+
+private:
+  static bool unfilter(const int filter,
+                       uint8_t* cur,
+                       const uint8_t* prev,
+                       const std::size_t n,
+                       const int bpp)
+  {
+    switch (filter) {
+      case 0: break;
+      case 1: // Sub
+        for (std::size_t i = bpp; i < n; ++i)
+          cur[i] += cur[i - bpp];
+        break;
+      case 2: // Up
+        for (std::size_t i = 0; i < n; ++i)
+          cur[i] += prev[i];
+        break;
+      case 3: // Average
+        for (std::size_t i = 0; i < n; ++i)
+          cur[i] += ((i >= std::size_t(bpp) ? cur[i - bpp] : 0) + prev[i]) / 2;
+        break;
+      case 4: // Paeth
+        for (std::size_t i = 0; i < n; ++i) {
+          const int a = (i >= std::size_t(bpp) ? cur[i - bpp] : 0);
+          const int b = prev[i];
+          const int c = (i >= std::size_t(bpp) ? prev[i - bpp] : 0);
+          const int p = a + b - c;
+          const int pa = std::abs(p - a);
+          const int pb = std::abs(p - b);
+          const int pc = std::abs(p - c);
+          cur[i] += (pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+        }
+        break;
+      default: return false;
+    }
+    return true;
+  }
+
+  void readPalette(const uint8_t* data, const uint32_t len)
+  {
+    const uint32_t n = std::min(len / 3, 256u);
+    for (uint32_t i = 0; i < n; ++i)
+      set_rgba((uint8_t*)&m_palette[i], data[3 * i], data[3 * i + 1], data[3 * i + 2], 255);
+  }
+
+  void readTransparency(const uint8_t* data, const uint32_t len)
+  {
+    if (m_colorType == 3) {
+      for (uint32_t i = 0; i < std::min(len, 256u); ++i)
+        ((uint8_t*)&m_palette[i])[3] = data[i];
+    }
+    else if ((m_colorType == 0 && len >= 2) || (m_colorType == 2 && len >= 6)) {
+      m_hasTransparentColor = true;
+      for (uint32_t i = 0; i < len / 2 && i < 3; ++i)
+        m_transparentColor[i] = (data[2 * i] << 8) | data[2 * i + 1];
+    }
+  }
+
+  // Returns the sample "i" of the row (with its original depth)
+  int sample(const uint8_t* row, const std::size_t i) const
+  {
+    switch (m_depth) {
+      case 8:  return row[i];
+      case 16: return (row[2 * i] << 8) | row[2 * i + 1];
+      default: {
+        const std::size_t bit = i * m_depth;
+        return (row[bit / 8] >> (8 - m_depth - (bit % 8))) & ((1 << m_depth) - 1);
+      }
+    }
+  }
+
+  // Scales a sample to 8 bits
+  int to8(const int v) const
+  {
+    switch (m_depth) {
+      case 16: return v >> 8;
+      case 8:  return v;
+      default: return v * 255 / ((1 << m_depth) - 1);
+    }
+  }
+
+  void convertRow(const uint8_t* row)
+  {
+    uint8_t* out = m_row.data();
+    for (int x = 0; x < m_width; ++x, out += 4) {
+      const std::size_t i = std::size_t(x) * m_channels;
+      switch (m_colorType) {
+        case 0: {
+          const int v = sample(row, i);
+          const int g = to8(v);
+          set_rgba(out, g, g, g, (m_hasTransparentColor && v == m_transparentColor[0] ? 0 : 255));
+          break;
+        }
+        case 2: {
+          const int r = sample(row, i);
+          const int g = sample(row, i + 1);
+          const int b = sample(row, i + 2);
+          const bool transparent = (m_hasTransparentColor && r == m_transparentColor[0] &&
+                                    g == m_transparentColor[1] && b == m_transparentColor[2]);
+          set_rgba(out, to8(r), to8(g), to8(b), (transparent ? 0 : 255));
+          break;
+        }
+        case 3: std::memcpy(out, &m_palette[sample(row, i)], 4); break;
+        case 4: {
+          const int g = to8(sample(row, i));
+          set_rgba(out, g, g, g, to8(sample(row, i + 1)));
+          break;
+        }
+        case 6:
+          set_rgba(out,
+                   to8(sample(row, i)),
+                   to8(sample(row, i + 1)),
+                   to8(sample(row, i + 2)),
+                   to8(sample(row, i + 3)));
+          break;
+      }
+    }
+  }
+
+  int m_depth = 0;
+  int m_colorType = 0;
+  int m_channels = 0;
+  uint32_t m_palette[256];
+  bool m_hasTransparentColor = false;
+  int m_transparentColor[3] = { 0, 0, 0 };
+};
+
+//////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<Decoder> make_decoder(Reader& reader, const char* filename)
+{
+  static const uint8_t kPngSignature[4] = { 0x89, 'P', 'N', 'G' };
+  if (const uint8_t* h = reader.peek(4)) {
+    if (std::memcmp(h, kPngSignature, 4) == 0)
+      return std::make_unique<PngDecoder>();
+    if (std::memcmp(h, "qoif", 4) == 0)
+      return std::make_unique<QoiDecoder>();
+    if (h[0] == 'B' && h[1] == 'M')
+      return std::make_unique<BmpDecoder>();
+  }
+  if (base::string_to_lower(base::get_file_extension(filename)) == "tga")
+    return std::make_unique<TgaDecoder>();
+  return nullptr;
+}
+
+} // anonymous namespace
+
+bool read_image_info(const char* filename, ImageInfo& info)
+{
+  base::FileHandle file = base::open_file(filename, "rb");
+  if (!file)
+    return false;
+
+  Reader reader(file.get());
+  std::unique_ptr<Decoder> decoder = make_decoder(reader, filename);
+  return (decoder && decoder->readHeader(reader, info));
+}
+
+bool decode_image(const char* filename,
+                  const gfx::Rect& roi,
+                  uint32_t* dst,
+                  const int dstStride,
+                  const SurfaceFormatData& fd)
+{
+  ASSERT(fd.bitsPerPixel == 32);
+
+  base::FileHandle file = base::open_file(filename, "rb");
+  if (!file)
+    return false;
+
+  Reader reader(file.get());
+  std::unique_ptr<Decoder> decoder = make_decoder(reader, filename);
+  ImageInfo info;
+  if (!decoder || !decoder->readHeader(reader, info))
+    return false;
+
+  const gfx::Rect bounds(0, 0, info.width, info.height);
+  const gfx::Rect area = (roi.isEmpty() ? bounds : roi);
+  if (!bounds.contains(area))
+    return false;
+
+  RowWriter writer(area, dst, dstStride, fd);
+  return decoder->decode(reader, writer);
+}
+
+} // namespace os
@@ -0,0 +1,53 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_IMAGE_DECODER_H_INCLUDED
+#define OS_COMMON_IMAGE_DECODER_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/rect.h"
+#include "os/surface_format.h"
+
+namespace os {
+
+// Formats of the built-in image decoders
+enum class ImageFormat {
+  Unknown,
+  Bmp, // Uncompressed 1/4/8/16/24/32 bpp (no RLE)
+  Tga, // Color-mapped, true-color and grayscale, uncompressed or RLE
+  Qoi,
+  Png, // Non-interlaced PNG files
+};
+
+struct ImageInfo {
+  ImageFormat format = ImageFormat::Unknown;
+  int width = 0;
+  int height = 0;
+};
+
+// Reads the format and size of an image file (only its header is
+// read). Returns false if the file cannot be decoded with the
+// built-in decoders. TGA files don't have a signature, so they are
+// detected by the .tga extension.
+bool read_image_info(const char* filename, ImageInfo& info);
+
+// Decodes the "roi" area of the image file (or the whole image if
+// "roi" is empty) to "dst", a roi.w x roi.h image of 32bpp pixels in
+// the "fd" format ("dstStride" in pixels). The file is read with a
+// small buffer and decoded row by row straight to "dst", rows
+// outside the "roi" are skipped or not converted, and decoding stops
+// after the last "roi" row. Different files can be decoded from
+// different threads at the same time.
+bool decode_image(const char* filename,
+                  const gfx::Rect& roi,
+                  uint32_t* dst,
+                  int dstStride,
+                  const SurfaceFormatData& fd);
+
+} // namespace os
+
+#endif
@@ -0,0 +1,461 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "os/common/image_decoder.h"
+#include "os/common/test_support.h"
+
+#include <string>
+#include <vector>
+
+using namespace os;
+
+// Prefix of the names of temporary files
+static const std::string kTempName = "_test_image_.tmp.";
+
+static const SurfaceFormatData kStraightRgba = rgba_format(PixelAlpha::kStraight);
+
+// Images of 7x5 pixels with the test_pixel() colors, generated with
+// a QOI encoder and zlib (each PNG row uses a different filter).
+
+// clang-format off
+static const uint8_t kQoi[] = {
+  0x71, 0x6f, 0x69, 0x66, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x05, 0x04, 0x00, 0xff, 0x00,
+  0x00, 0x00, 0x80, 0xff, 0x24, 0x01, 0x00, 0xff, 0xfe, 0x48, 0x02, 0x00, 0xff, 0x6c, 0x03, 0x00,
+  0x80, 0xff, 0x90, 0x04, 0x00, 0xff, 0xfe, 0xb4, 0x05, 0x00, 0xff, 0xd8, 0x06, 0x00, 0x80, 0xff,
+  0x00, 0x32, 0x00, 0xff, 0xfe, 0x24, 0x33, 0x14, 0xff, 0x48, 0x34, 0x28, 0x80, 0xff, 0x6c, 0x35,
+  0x3c, 0xff, 0xfe, 0x90, 0x36, 0x50, 0xff, 0xb4, 0x37, 0x64, 0x80, 0xff, 0xd8, 0x38, 0x78, 0xff,
+  0xfe, 0x0a, 0x14, 0x1e, 0xc5, 0xff, 0x00, 0x96, 0x00, 0x80, 0xff, 0x24, 0x97, 0x3c, 0xff, 0xfe,
+  0x48, 0x98, 0x78, 0xff, 0x6c, 0x99, 0xb4, 0x80, 0xff, 0x90, 0x9a, 0xf0, 0xff, 0xfe, 0xb4, 0x9b,
+  0x2c, 0xff, 0xd8, 0x9c, 0x68, 0x80, 0xff, 0x00, 0xc8, 0x00, 0xff, 0xfe, 0x24, 0xc9, 0x50, 0xff,
+  0x48, 0xca, 0xa0, 0x80, 0xff, 0x6c, 0xcb, 0xf0, 0xff, 0xfe, 0x90, 0xcc, 0x40, 0xff, 0xb4, 0xcd,
+  0x90, 0x80, 0xff, 0xd8, 0xce, 0xe0, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+};
+
+static const uint8_t kPngRgba[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+  0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x05, 0x08, 0x06, 0x00, 0x00, 0x00, 0x89, 0x9a, 0xf6,
+  0xd8, 0x00, 0x00, 0x00, 0x89, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0x60, 0x68,
+  0x50, 0x61, 0x64, 0xf8, 0xef, 0xc1, 0xc4, 0xf0, 0x3f, 0x87, 0x99, 0xa1, 0x61, 0x02, 0x0b, 0xc3,
+  0xff, 0x2d, 0xac, 0x0c, 0xff, 0x6f, 0xb0, 0x31, 0x34, 0x30, 0x32, 0x18, 0x31, 0xfc, 0x57, 0x61,
+  0x14, 0x61, 0x00, 0xe2, 0x46, 0x20, 0xae, 0x47, 0x66, 0x33, 0x71, 0x3d, 0x92, 0x63, 0x78, 0xf6,
+  0x90, 0x8b, 0xe1, 0xd0, 0x83, 0x6f, 0xf5, 0xf3, 0xee, 0x3f, 0x62, 0xa8, 0xba, 0x77, 0x8e, 0x21,
+  0xec, 0xee, 0xae, 0x7a, 0xa3, 0x3b, 0xcb, 0x18, 0x98, 0x7f, 0xf7, 0x7c, 0x64, 0x94, 0x77, 0xd2,
+  0x75, 0x30, 0x74, 0xf6, 0x66, 0x70, 0x76, 0xce, 0x6c, 0x0c, 0x75, 0x69, 0x77, 0x48, 0x77, 0x59,
+  0xca, 0x50, 0xe9, 0xea, 0xdc, 0xc8, 0x02, 0x34, 0xb6, 0x9e, 0x01, 0x68, 0x14, 0x03, 0xa3, 0x46,
+  0x23, 0x03, 0xa3, 0x0d, 0x90, 0x1d, 0x00, 0x64, 0xa7, 0x00, 0xd9, 0x01, 0xf5, 0x00, 0x0c, 0xaa,
+  0x29, 0x89, 0xd1, 0x01, 0x39, 0x64, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42,
+  0x60, 0x82,
+};
+
+static const uint8_t kPngRgbaSplitIdat[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+  0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x05, 0x08, 0x06, 0x00, 0x00, 0x00, 0x89, 0x9a, 0xf6,
+  0xd8, 0x00, 0x00, 0x00, 0x0a, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0x60, 0x68,
+  0x50, 0x61, 0x64, 0xa4, 0x75, 0x4c, 0xe8, 0x00, 0x00, 0x00, 0x7f, 0x49, 0x44, 0x41, 0x54, 0xf8,
+  0xef, 0xc1, 0xc4, 0xf0, 0x3f, 0x87, 0x99, 0xa1, 0x61, 0x02, 0x0b, 0xc3, 0xff, 0x2d, 0xac, 0x0c,
+  0xff, 0x6f, 0xb0, 0x31, 0x34, 0x30, 0x32, 0x18, 0x31, 0xfc, 0x57, 0x61, 0x14, 0x61, 0x00, 0xe2,
+  0x46, 0x20, 0xae, 0x47, 0x66, 0x33, 0x71, 0x3d, 0x92, 0x63, 0x78, 0xf6, 0x90, 0x8b, 0xe1, 0xd0,
+  0x83, 0x6f, 0xf5, 0xf3, 0xee, 0x3f, 0x62, 0xa8, 0xba, 0x77, 0x8e, 0x21, 0xec, 0xee, 0xae, 0x7a,
+  0xa3, 0x3b, 0xcb, 0x18, 0x98, 0x7f, 0xf7, 0x7c, 0x64, 0x94, 0x77, 0xd2, 0x75, 0x30, 0x74, 0xf6,
+  0x66, 0x70, 0x76, 0xce, 0x6c, 0x0c, 0x75, 0x69, 0x77, 0x48, 0x77, 0x59, 0xca, 0x50, 0xe9, 0xea,
+  0xdc, 0xc8, 0x02, 0x34, 0xb6, 0x9e, 0x01, 0x68, 0x14, 0x03, 0xa3, 0x46, 0x23, 0x03, 0xa3, 0x0d,
+  0x90, 0x1d, 0x00, 0x64, 0xa7, 0x00, 0xd9, 0x01, 0xf5, 0x00, 0x0c, 0xaa, 0x29, 0x89, 0x59, 0x1c,
+  0x68, 0x36, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+static const uint8_t kPngPalette[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+  0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03, 0x02, 0x03, 0x00, 0x00, 0x00, 0x26, 0x58, 0x2d,
+  0x6b, 0x00, 0x00, 0x00, 0x0c, 0x50, 0x4c, 0x54, 0x45, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00,
+  0x00, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x60, 0xf6, 0x00, 0x00, 0x00, 0x03, 0x74, 0x52, 0x4e,
+  0x53, 0xff, 0x00, 0x80, 0xa9, 0x56, 0x73, 0x13, 0x00, 0x00, 0x00, 0x11, 0x49, 0x44, 0x41, 0x54,
+  0x78, 0xda, 0x63, 0x90, 0x66, 0x60, 0xc8, 0x71, 0x60, 0xd8, 0xd8, 0x00, 0x00, 0x05, 0xdf, 0x01,
+  0xf9, 0xdc, 0xe6, 0x2e, 0x67, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60,
+  0x82,
+};
+
+static const uint8_t kPngGray16[] = {
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+  0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0xe8, 0x8f, 0xe5,
+  0x85, 0x00, 0x00, 0x00, 0x02, 0x74, 0x52, 0x4e, 0x53, 0x4e, 0x20, 0x23, 0x07, 0x8f, 0x7b, 0x00,
+  0x00, 0x00, 0x16, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0xf0, 0x53, 0x98, 0xe3,
+  0xc0, 0xc8, 0xfc, 0xc2, 0x5f, 0xc1, 0x4f, 0x01, 0x00, 0x13, 0x1d, 0x03, 0x14, 0x10, 0x0b, 0x24,
+  0xd2, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// clang-format on
+
+// Palette of 4 colors (2 bits per pixel) with index (x+y)%4 on a
+// 5x3 image, with alpha values 255, 0, 128 (and 255 for the last one).
+static const uint32_t kPaletteColors[4] = { 0xff0000ff, 0x0000ff00, 0x80ff0000, 0xffffffff };
+
+static uint32_t rgba(const int r, const int g, const int b, const int a)
+{
+  return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+}
+
+static uint32_t test_pixel(const int x, const int y)
+{
+  if (y == 2)
+    return rgba(10, 20, 30, 255);
+  return rgba(x * 36, y * 50 + x, (x * y * 20) & 255, ((x + y) % 3 == 0 ? 128 : 255));
+}
+
+static void put16(std::vector<uint8_t>& buf, const int v)
+{
+  buf.push_back(v & 0xff);
+  buf.push_back((v >> 8) & 0xff);
+}
+
+static void put32(std::vector<uint8_t>& buf, const uint32_t v)
+{
+  put16(buf, v & 0xffff);
+  put16(buf, v >> 16);
+}
+
+// Creates a BMP file with the test_pixel() colors
+static std::vector<uint8_t> make_bmp(const int bpp, const bool topDown)
+{
+  const int w = 7, h = 5;
+  const int rowBytes = ((w * bpp + 31) / 32) * 4;
+  const int headerSize = (bpp == 32 ? 56 : 40);
+  const int paletteSize = (bpp == 8 ? 4 * 256 : 0);
+  const int offset = 14 + headerSize + paletteSize;
+
+  std::vector<uint8_t> buf = { 'B', 'M' };
+  put32(buf, offset + rowBytes * h);
+  put32(buf, 0);
+  put32(buf, offset);
+  put32(buf, headerSize);
+  put32(buf, w);
+  put32(buf, topDown ? -h : h);
+  put16(buf, 1);
+  put16(buf, bpp);
+  put32(buf, bpp == 32 ? 3 : 0); // BI_BITFIELDS or BI_RGB
+  put32(buf, rowBytes * h);
+  put32(buf, 2835);
+  put32(buf, 2835);
+  put32(buf, 0);
+  put32(buf, 0);
+  if (bpp == 32) {
+    put32(buf, 0x000000ff);
+    put32(buf, 0x0000ff00);
+    put32(buf, 0x00ff0000);
+    put32(buf, 0xff000000);
+  }
+  if (bpp == 8) {
+    // Gray palette
+    for (int i = 0; i < 256; ++i)
+      put32(buf, (i << 16) | (i << 8) | i);
+  }
+  for (int i = 0; i < h; ++i) {
+    const int y = (topDown ? i : h - 1 - i);
+    const std::size_t start = buf.size();
+    for (int x = 0; x < w; ++x) {
+      const uint32_t c = test_pixel(x, y);
+      switch (bpp) {
+        case 8:  buf.push_back(c & 0xff); break;
+        case 24:
+          buf.push_back((c >> 16) & 0xff);
+          buf.push_back((c >> 8) & 0xff);
+          buf.push_back(c & 0xff);
+          break;
+        case 32: put32(buf, c); break;
+      }
+    }
+    buf.resize(start + rowBytes, 0);
+  }
+  return buf;
+}
+
+// Creates a 32bpp TGA file with the test_pixel() colors, RLE files
+// are encoded with packets that cross rows.
+static std::vector<uint8_t> make_tga(const bool rle, const bool topToBottom)
+{
+  const int w = 7, h = 5;
+  std::vector<uint8_t> buf = { 0, 0, uint8_t(rle ? 10 : 2), 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  put16(buf, w);
+  put16(buf, h);
+  buf.push_back(32);
+  buf.push_back(8 | (topToBottom ? 0x20 : 0));
+
+  std::vector<uint32_t> pixels;
+  for (int i = 0; i < h; ++i) {
+    const int y = (topToBottom ? i : h - 1 - i);
+    for (int x = 0; x < w; ++x)
+      pixels.push_back(test_pixel(x, y));
+  }
+  auto put_pixel = [&buf](const uint32_t c) {
+    buf.push_back((c >> 16) & 0xff);
+    buf.push_back((c >> 8) & 0xff);
+    buf.push_back(c & 0xff);
+    buf.push_back(c >> 24);
+  };
+  if (!rle) {
+    for (const uint32_t c : pixels)
+      put_pixel(c);
+    return buf;
+  }
+  for (std::size_t i = 0; i < pixels.size();) {
+    std::size_t n = 1;
+    while (i + n < pixels.size() && pixels[i + n] == pixels[i] && n < 128)
+      ++n;
+    if (n > 1) {
+      buf.push_back(0x80 | (n - 1));
+      put_pixel(pixels[i]);
+    }
+    else {
+      // Raw packets of up to 10 pixels
+      while (i + n < pixels.size() && n < 10 && pixels[i + n] != pixels[i + n - 1])
+        ++n;
+      buf.push_back(n - 1);
+      for (std::size_t j = 0; j < n; ++j)
+        put_pixel(pixels[i + j]);
+    }
+    i += n;
+  }
+  return buf;
+}
+
+static std::vector<uint32_t> decode(const char* filename,
+                                    const gfx::Rect& roi,
+                                    const SurfaceFormatData& fd = kStraightRgba)
+{
+  ImageInfo info;
+  if (!read_image_info(filename, info))
+    return {};
+  const gfx::Rect area = (roi.isEmpty() ? gfx::Rect(0, 0, info.width, info.height) : roi);
+  std::vector<uint32_t> pixels(area.w * area.h, 0);
+  if (!decode_image(filename, roi, pixels.data(), area.w, fd))
+    return {};
+  return pixels;
+}
+
+// Expects a 7x5 image with the test_pixel() colors, also checks the
+// decoding of different ROIs.
+static void expect_test_pixels(const char* filename,
+                               const ImageFormat format,
+                               const bool hasAlpha = true)
+{
+  ImageInfo info;
+  ASSERT_TRUE(read_image_info(filename, info));
+  EXPECT_EQ(format, info.format);
+  EXPECT_EQ(7, info.width);
+  EXPECT_EQ(5, info.height);
+
+  for (const gfx::Rect& roi :
+       { gfx::Rect(), gfx::Rect(0, 0, 7, 5), gfx::Rect(2, 1, 3, 3), gfx::Rect(6, 4, 1, 1) }) {
+    const gfx::Rect area = (roi.isEmpty() ? gfx::Rect(0, 0, 7, 5) : roi);
+    const std::vector<uint32_t> pixels = decode(filename, roi);
+    ASSERT_EQ(std::size_t(area.w * area.h), pixels.size());
+    for (int y = 0; y < area.h; ++y) {
+      for (int x = 0; x < area.w; ++x) {
+        uint32_t expected = test_pixel(area.x + x, area.y + y);
+        if (!hasAlpha)
+          expected |= 0xff000000;
+        ASSERT_EQ(expected, pixels[y * area.w + x]) << area.x + x << "," << area.y + y;
+      }
+    }
+  }
+}
+
+TEST(ImageDecoder, Bmp)
+{
+  {
+    TempFile f(kTempName + "bmp", make_bmp(24, false));
+    expect_test_pixels(f.filename(), ImageFormat::Bmp, false);
+  }
+  {
+    TempFile f(kTempName + "bmp", make_bmp(32, true));
+    expect_test_pixels(f.filename(), ImageFormat::Bmp);
+  }
+  {
+    TempFile f(kTempName + "bmp", make_bmp(8, false));
+    const std::vector<uint32_t> pixels = decode(f.filename(), gfx::Rect());
+    ASSERT_EQ(35, pixels.size());
+    for (int y = 0; y < 5; ++y) {
+      for (int x = 0; x < 7; ++x) {
+        const int v = test_pixel(x, y) & 0xff;
+        EXPECT_EQ(rgba(v, v, v, 255), pixels[y * 7 + x]);
+      }
+    }
+  }
+}
+
+TEST(ImageDecoder, Tga)
+{
+  for (const bool rle : { false, true }) {
+    for (const bool topToBottom : { false, true }) {
+      TempFile f(kTempName + "tga", make_tga(rle, topToBottom));
+      expect_test_pixels(f.filename(), ImageFormat::Tga);
+    }
+  }
+}
+
+TEST(ImageDecoder, Qoi)
+{
+  TempFile f(kTempName + "qoi", std::vector<uint8_t>(std::begin(kQoi), std::end(kQoi)));
+  expect_test_pixels(f.filename(), ImageFormat::Qoi);
+}
+
+TEST(ImageDecoder, Png)
+{
+  {
+    TempFile f(kTempName + "png", std::vector<uint8_t>(std::begin(kPngRgba), std::end(kPngRgba)));
+    expect_test_pixels(f.filename(), ImageFormat::Png);
+  }
+  {
+    TempFile f(kTempName + "png",
+               std::vector<uint8_t>(std::begin(kPngRgbaSplitIdat), std::end(kPngRgbaSplitIdat)));
+    expect_test_pixels(f.filename(), ImageFormat::Png);
+  }
+}
+
+TEST(ImageDecoder, PngPalette)
+{
+  TempFile f(kTempName + "png",
+             std::vector<uint8_t>(std::begin(kPngPalette), std::end(kPngPalette)));
+  const std::vector<uint32_t> pixels = decode(f.filename(), gfx::Rect());
+  ASSERT_EQ(15, pixels.size());
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 5; ++x)
+      EXPECT_EQ(kPaletteColors[(x + y) % 4], pixels[y * 5 + x]) << x << "," << y;
+  }
+}
+
+TEST(ImageDecoder, PngGray16)
+{
+  // 3x2 image with values x*20000 + y*1000, the 20000 value is
+  // transparent
+  TempFile f(kTempName + "png", std::vector<uint8_t>(std::begin(kPngGray16), std::end(kPngGray16)));
+  const std::vector<uint32_t> pixels = decode(f.filename(), gfx::Rect());
+  ASSERT_EQ(6, pixels.size());
+  for (int y = 0; y < 2; ++y) {
+    for (int x = 0; x < 3; ++x) {
+      const int v = x * 20000 + y * 1000;
+      const int g = v >> 8;
+      EXPECT_EQ(rgba(g, g, g, v == 20000 ? 0 : 255), pixels[y * 3 + x]) << x << "," << y;
+    }
+  }
+}
+
+TEST(ImageDecoder, Premultiplied)
+{
+  TempFile f(kTempName + "qoi", std::vector<uint8_t>(std::begin(kQoi), std::end(kQoi)));
+  const std::vector<uint32_t> pixels =
+    decode(f.filename(), gfx::Rect(), rgba_format(PixelAlpha::kPremultiplied));
+  ASSERT_EQ(35, pixels.size());
+  for (int y = 0; y < 5; ++y) {
+    for (int x = 0; x < 7; ++x) {
+      const uint32_t c = test_pixel(x, y);
+      const uint32_t a = (c >> 24);
+      uint32_t expected = (a << 24);
+      for (int i = 0; i < 3; ++i)
+        expected |= ((((c >> (8 * i)) & 0xff) * a + 127) / 255) << (8 * i);
+      EXPECT_EQ(expected, pixels[y * 7 + x]) << x << "," << y;
+    }
+  }
+}
+
+TEST(ImageDecoder, InvalidFiles)
+{
+  ImageInfo info;
+  EXPECT_FALSE(read_image_info("_test_image_.tmp.does_not_exist.png", info));
+  {
+    TempFile f(kTempName + "png", { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+    EXPECT_FALSE(read_image_info(f.filename(), info));
+  }
+  {
+    // Unknown extension without a known signature
+    TempFile f(kTempName + "xyz", make_tga(false, false));
+    EXPECT_FALSE(read_image_info(f.filename(), info));
+  }
+
+  // Truncated files
+  for (const std::vector<uint8_t>& data :
+       { std::vector<uint8_t>(std::begin(kQoi), std::end(kQoi)),
+         std::vector<uint8_t>(std::begin(kPngRgba), std::end(kPngRgba)),
+         make_bmp(24, false) }) {
+    TempFile f(kTempName + "img",
+               std::vector<uint8_t>(data.begin(), data.begin() + data.size() / 2));
+    ASSERT_TRUE(read_image_info(f.filename(), info));
+    std::vector<uint32_t> pixels(info.width * info.height);
+    EXPECT_FALSE(decode_image(f.filename(), gfx::Rect(), pixels.data(), info.width, kStraightRgba));
+  }
+  {
+    TempFile f(kTempName + "tga", make_tga(true, false));
+    ASSERT_TRUE(read_image_info(f.filename(), info));
+    // The ROI must be inside the image
+    std::vector<uint32_t> pixels(8 * 5);
+    EXPECT_FALSE(
+      decode_image(f.filename(), gfx::Rect(0, 0, 8, 5), pixels.data(), 8, kStraightRgba));
+  }
+}
+
+// kPngRgba with a chunk inserted after IHDR (with "len" bytes of data
+// or less if it's too big)
+static std::vector<uint8_t> make_png_chunk(const uint32_t len, const char* type)
+{
+  const auto afterIhdr = std::begin(kPngRgba) + 33;
+  std::vector<uint8_t> buf(std::begin(kPngRgba), afterIhdr);
+  for (int i = 3; i >= 0; --i)
+    buf.push_back((len >> (8 * i)) & 0xff);
+  buf.insert(buf.end(), type, type + 4);
+  buf.resize(buf.size() + std::min(len, 1024u) + 4, 0); // Data + CRC
+  buf.insert(buf.end(), afterIhdr, std::end(kPngRgba));
+  return buf;
+}
+
+TEST(ImageDecoder, MalformedPngChunks)
+{
+  const struct {
+    uint32_t len;
+    const char* type;
+  } chunks[] = {
+    { 0xffffff00, "PLTE" }, // Huge palette
+    { 769, "PLTE" },        // More than 256 entries
+    { 10, "PLTE" },         // Not a multiple of 3
+    { 257, "tRNS" },        // More than 256 alpha values
+    { 0xffffff00, "tEXt" }, // Huge chunk
+    { 0xffffff00, "IDAT" }, // Huge data chunk
+  };
+  // Valid chunks are ignored
+  {
+    TempFile f(kTempName + "png", make_png_chunk(3, "PLTE"));
+    expect_test_pixels(f.filename(), ImageFormat::Png);
+  }
+  for (const auto& chunk : chunks) {
+    TempFile f(kTempName + "png", make_png_chunk(chunk.len, chunk.type));
+    ImageInfo info;
+    ASSERT_TRUE(read_image_info(f.filename(), info));
+    std::vector<uint32_t> pixels(info.width * info.height);
+    EXPECT_FALSE(decode_image(f.filename(), gfx::Rect(), pixels.data(), info.width, kStraightRgba))
+      << chunk.type << " " << chunk.len;
+  }
+}
+
+TEST(ImageDecoder, BmpMinHeight)
+{
+  // A height of INT_MIN cannot be negated to get a bottom-up image
+  std::vector<uint8_t> bmp = make_bmp(24, false);
+  bmp[22] = bmp[23] = bmp[24] = 0;
+  bmp[25] = 0x80;
+  TempFile f(kTempName + "bmp", bmp);
+  ImageInfo info;
+  EXPECT_FALSE(read_image_info(f.filename(), info));
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
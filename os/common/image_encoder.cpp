@@ -0,0 +1,559 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/image_encoder.h"
+
+#include "base/debug.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/string.h"
+#include "base/thread_pool.h"
+#include "os/common/deflate.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Uncompressed bytes of each PNG stripe (each one is compressed as
+// an independent deflate stream)
+constexpr std::size_t kPngStripeBytes = 256 * 1024;
+
+// Number of PNG stripes compressed before writing them (to limit
+// the memory used for compressed data)
+constexpr int kPngStripesPerBatch = 16;
+
+void put_u16le(std::vector<uint8_t>& buf, const uint32_t v)
+{
+  buf.push_back(uint8_t(v));
+  buf.push_back(uint8_t(v >> 8));
+}
+
+void put_u32le(std::vector<uint8_t>& buf, const uint32_t v)
+{
+  put_u16le(buf, v & 0xffff);
+  put_u16le(buf, v >> 16);
+}
+
+void put_u32be(std::vector<uint8_t>& buf, const uint32_t v)
+{
+  buf.push_back(uint8_t(v >> 24));
+  buf.push_back(uint8_t(v >> 16));
+  buf.push_back(uint8_t(v >> 8));
+  buf.push_back(uint8_t(v));
+}
+
+uint32_t crc32(uint32_t crc, const uint8_t* data, const std::size_t size)
+{
+  static const struct Table {
+    uint32_t values[256];
+    Table()
+    {
+      for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+          c = (c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1);
+        values[i] = c;
+      }
+    }
+  } table;
+
+  crc = ~crc;
+  for (std::size_t i = 0; i < size; ++i)
+    crc = table.values[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+// Reads rows of the source image as non-premultiplied RGBA
+class Source {
+public:
+  Source(const uint32_t* src,
+         const int width,
+         const int height,
+         const int stride,
+         const SurfaceFormatData& fd)
+    : m_src(src)
+    , m_width(width)
+    , m_height(height)
+    , m_stride(stride)
+    , m_premultiplied(fd.pixelAlpha == PixelAlpha::kPremultiplied)
+    , m_shifts{ fd.redShift, fd.greenShift, fd.blueShift, fd.alphaShift }
+    , m_alphaMask(fd.alphaMask)
+  {
+  }
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+
+  bool isOpaque() const
+  {
+    if (m_alphaMask == 0)
+      return true;
+    for (int y = 0; y < m_height; ++y) {
+      const uint32_t* p = m_src + std::size_t(y) * m_stride;
+      for (int x = 0; x < m_width; ++x) {
+        if ((p[x] & m_alphaMask) != m_alphaMask)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  // Converts the row "y" to RGBA (4 bytes per pixel)
+  void row(const int y, uint8_t* out) const
+  {
+    const uint32_t* p = m_src + std::size_t(y) * m_stride;
+    for (int x = 0; x < m_width; ++x, out += 4) {
+      const uint32_t c = p[x];
+      uint32_t r = (c >> m_shifts[0]) & 0xff;
+      uint32_t g = (c >> m_shifts[1]) & 0xff;
+      uint32_t b = (c >> m_shifts[2]) & 0xff;
+      const uint32_t a = (m_alphaMask ? (c >> m_shifts[3]) & 0xff : 255);
+      if (m_premultiplied && a != 255) {
+        if (a == 0) {
+          r = g = b = 0;
+        }
+        else {
+          r = std::min<uint32_t>(255, (r * 255 + a / 2) / a);
+          g = std::min<uint32_t>(255, (g * 255 + a / 2) / a);
+          b = std::min<uint32_t>(255, (b * 255 + a / 2) / a);
+        }
+      }
+      out[0] = uint8_t(r);
+      out[1] = uint8_t(g);
+      out[2] = uint8_t(b);
+      out[3] = uint8_t(a);
+    }
+  }
+
+private:
+  const uint32_t* m_src;
+  int m_width;
+  int m_height;
+  int m_stride;
+  bool m_premultiplied;
+  uint32_t m_shifts[4];
+  uint32_t m_alphaMask;
+};
+
+bool write(FILE* f, const std::vector<uint8_t>& buf)
+{
+  return (buf.empty() || std::fwrite(buf.data(), 1, buf.size(), f) == buf.size());
+}
+
+//////////////////////////////////////////////////////////////////////
+// BMP
+
+bool encode_bmp(FILE* f, const Source& src)
+{
+  const bool alpha = !src.isOpaque();
+  const int bpp = (alpha ? 32 : 24);
+  const uint32_t rowBytes = ((uint32_t(src.width()) * bpp + 31) / 32) * 4;
+  const uint32_t headerSize = (alpha ? 56 : 40); // BITMAPV3INFOHEADER or BITMAPINFOHEADER
+  const uint32_t offset = 14 + headerSize;
+  const uint32_t imageSize = rowBytes * src.height();
+
+  std::vector<uint8_t> buf = { 'B', 'M' };
+  put_u32le(buf, offset + imageSize);
+  put_u32le(buf, 0);
+  put_u32le(buf, offset);
+  put_u32le(buf, headerSize);
+  put_u32le(buf, src.width());
+  put_u32le(buf, src.height()); // Bottom-up
+  put_u16le(buf, 1);
+  put_u16le(buf, bpp);
+  put_u32le(buf, alpha ? 3 : 0); // BI_BITFIELDS or BI_RGB
+  put_u32le(buf, imageSize);
+  put_u32le(buf, 2835); // 72 DPI
+  put_u32le(buf, 2835);
+  put_u32le(buf, 0);
+  put_u32le(buf, 0);
+  if (alpha) {
+    put_u32le(buf, 0x00ff0000);
+    put_u32le(buf, 0x0000ff00);
+    put_u32le(buf, 0x000000ff);
+    put_u32le(buf, 0xff000000);
+  }
+  if (!write(f, buf))
+    return false;
+
+  std::vector<uint8_t> rgba(4 * std::size_t(src.width()));
+  buf.resize(rowBytes);
+  for (int y = src.height() - 1; y >= 0; --y) {
+    src.row(y, rgba.data());
+    uint8_t* out = buf.data();
+    for (int x = 0; x < src.width(); ++x) {
+      const uint8_t* p = &rgba[4 * x];
+      *out++ = p[2];
+      *out++ = p[1];
+      *out++ = p[0];
+      if (alpha)
+        *out++ = p[3];
+    }
+    std::fill(out, buf.data() + rowBytes, 0);
+    if (!write(f, buf))
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// TGA
+
+bool encode_tga(FILE* f, const Source& src)
+{
+  const bool alpha = !src.isOpaque();
+  const int pixelSize = (alpha ? 4 : 3);
+
+  std::vector<uint8_t> buf = { 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // RLE true-color
+  put_u16le(buf, src.width());
+  put_u16le(buf, src.height());
+  buf.push_back(uint8_t(8 * pixelSize));
+  buf.push_back(0x20 | (alpha ? 8 : 0)); // Top-left origin + alpha bits
+  if (!write(f, buf))
+    return false;
+
+  std::vector<uint8_t> rgba(4 * std::size_t(src.width()));
+  const uint32_t* pixels = (const uint32_t*)rgba.data();
+  auto put_pixel = [&buf, &rgba, alpha](const int x) {
+    const uint8_t* p = &rgba[4 * x];
+    buf.push_back(p[2]);
+    buf.push_back(p[1]);
+    buf.push_back(p[0]);
+    if (alpha)
+      buf.push_back(p[3]);
+  };
+
+  // RLE packets don't cross rows
+  for (int y = 0; y < src.height(); ++y) {
+    src.row(y, rgba.data());
+    buf.clear();
+    for (int x = 0; x < src.width();) {
+      int n = 1;
+      while (x + n < src.width() && n < 128 && pixels[x + n] == pixels[x])
+        ++n;
+      if (n > 1) {
+        buf.push_back(uint8_t(0x80 | (n - 1)));
+        put_pixel(x);
+      }
+      else {
+        // Raw packet until the next run of 2 equal pixels
+        while (x + n < src.width() && n < 128 &&
+               (x + n + 1 >= src.width() || pixels[x + n] != pixels[x + n + 1])) {
+          ++n;
+        }
+        buf.push_back(uint8_t(n - 1));
+        for (int i = 0; i < n; ++i)
+          put_pixel(x + i);
+      }
+      x += n;
+    }
+    if (!write(f, buf))
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// QOI
+
+bool encode_qoi(FILE* f, const Source& src)
+{
+  const bool alpha = !src.isOpaque();
+
+  std::vector<uint8_t> buf = { 'q', 'o', 'i', 'f' };
+  put_u32be(buf, src.width());
+  put_u32be(buf, src.height());
+  buf.push_back(alpha ? 4 : 3);
+  buf.push_back(0); // sRGB with linear alpha
+
+  uint8_t index[64][4] = {};
+  uint8_t prev[4] = { 0, 0, 0, 255 };
+  int run = 0;
+  std::vector<uint8_t> rgba(4 * std::size_t(src.width()));
+
+  for (int y = 0; y < src.height(); ++y) {
+    src.row(y, rgba.data());
+    for (int x = 0; x < src.width(); ++x) {
+      const uint8_t* px = &rgba[4 * x];
+      if (std::memcmp(px, prev, 4) == 0) {
+        if (++run == 62) {
+          buf.push_back(0xc0 | (run - 1)); // QOI_OP_RUN
+          run = 0;
+        }
+        continue;
+      }
+      if (run > 0) {
+        buf.push_back(0xc0 | (run - 1));
+        run = 0;
+      }
+
+      const int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+      if (std::memcmp(index[hash], px, 4) == 0) {
+        buf.push_back(uint8_t(hash)); // QOI_OP_INDEX
+      }
+      else {
+        std::memcpy(index[hash], px, 4);
+        if (px[3] == prev[3]) {
+          const int dr = int8_t(px[0] - prev[0]);
+          const int dg = int8_t(px[1] - prev[1]);
+          const int db = int8_t(px[2] - prev[2]);
+          const int drg = dr - dg;
+          const int dbg = db - dg;
+          if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+            buf.push_back(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)); // QOI_OP_DIFF
+          }
+          else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+            buf.push_back(0x80 | (dg + 32)); // QOI_OP_LUMA
+            buf.push_back(((drg + 8) << 4) | (dbg + 8));
+          }
+          else {
+            buf.insert(buf.end(), { 0xfe, px[0], px[1], px[2] }); // QOI_OP_RGB
+          }
+        }
+        else {
+          buf.insert(buf.end(), { 0xff, px[0], px[1], px[2], px[3] }); // QOI_OP_RGBA
+        }
+      }
+      std::memcpy(prev, px, 4);
+    }
+    if (!write(f, buf))
+      return false;
+    buf.clear();
+  }
+  if (run > 0)
+    buf.push_back(0xc0 | (run - 1));
+  buf.insert(buf.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+  return write(f, buf);
+}
+
+//////////////////////////////////////////////////////////////////////
+// PNG
+
+class PngEncoder {
+public:
+  PngEncoder(FILE* f, const Source& src) : m_file(f), m_src(src)
+  {
+    m_alpha = !src.isOpaque();
+    m_pixelSize = (m_alpha ? 4 : 3);
+    m_rowBytes = std::size_t(src.width()) * m_pixelSize;
+    m_rowsPerStripe = int(std::max<std::size_t>(1, kPngStripeBytes / (m_rowBytes + 1)));
+  }
+
+  bool encode(base::thread_pool* pool)
+  {
+    static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    if (std::fwrite(kSignature, 1, 8, m_file) != 8)
+      return false;
+
+    std::vector<uint8_t> ihdr;
+    put_u32be(ihdr, m_src.width());
+    put_u32be(ihdr, m_src.height());
+    ihdr.push_back(8);               // Bit depth
+    ihdr.push_back(m_alpha ? 6 : 2); // RGBA or RGB
+    ihdr.push_back(0);               // Deflate compression
+    ihdr.push_back(0);               // Adaptive filtering
+    ihdr.push_back(0);               // No interlace
+    if (!writeChunk("IHDR", ihdr))
+      return false;
+
+    const int nstripes = (m_src.height() + m_rowsPerStripe - 1) / m_rowsPerStripe;
+    uint32_t adler = 1;
+    bool first = true;
+
+    for (int batch = 0; batch < nstripes; batch += kPngStripesPerBatch) {
+      const int n = std::min(kPngStripesPerBatch, nstripes - batch);
+      std::vector<Stripe> stripes(n);
+      base::for_each_task(pool, n, 1, [&](const int i, const int j) {
+        for (int k = i; k < j; ++k)
+          compressStripe(batch + k, nstripes, stripes[k]);
+      });
+
+      for (Stripe& stripe : stripes) {
+        adler = adler32_combine(adler, stripe.adler, stripe.size);
+        std::vector<uint8_t> data;
+        if (first) {
+          data = { 0x78, 0x9c }; // zlib header
+          first = false;
+        }
+        data.insert(data.end(), stripe.compressed.begin(), stripe.compressed.end());
+        if (&stripe == &stripes.back() && batch + n == nstripes)
+          put_u32be(data, adler);
+        if (!writeChunk("IDAT", data))
+          return false;
+      }
+    }
+    return writeChunk("IEND", {});
+  }
+
+private:
+  struct Stripe {
+    std::vector<uint8_t> compressed;
+    uint32_t adler = 1;
+    std::size_t size = 0;
+  };
+
+  // Filters and compresses the rows of the stripe "index"
+  void compressStripe(const int index, const int nstripes, Stripe& stripe) const
+  {
+    const int y0 = index * m_rowsPerStripe;
+    const int y1 = std::min(y0 + m_rowsPerStripe, m_src.height());
+
+    std::vector<uint8_t> rgba(4 * std::size_t(m_src.width()));
+    std::vector<uint8_t> prev(m_rowBytes, 0);
+    std::vector<uint8_t> cur(m_rowBytes);
+    if (y0 > 0)
+      convertRow(y0 - 1, rgba, prev);
+
+    std::vector<uint8_t> filtered((m_rowBytes + 1) * (y1 - y0));
+    uint8_t* out = filtered.data();
+    for (int y = y0; y < y1; ++y, out += m_rowBytes + 1) {
+      convertRow(y, rgba, cur);
+      filterRow(cur.data(), prev.data(), out);
+      std::swap(cur, prev);
+    }
+
+    stripe.size = filtered.size();
+    stripe.adler = adler32(1, filtered.data(), filtered.size());
+    deflate_piece(filtered.data(), filtered.size(), index == nstripes - 1, stripe.compressed);
+  }
+
+  void convertRow(const int y, std::vector<uint8_t>& rgba, std::vector<uint8_t>& out) const
+  {
+    m_src.row(y, rgba.data());
+    if (m_alpha) {
+      out = rgba;
+      return;
+    }
+    for (int x = 0; x < m_src.width(); ++x)
+      std::memcpy(&out[3 * x], &rgba[4 * x], 3);
+  }
+
+  // Chooses the filter with the minimum sum of absolute differences
+  // (the heuristic recommended by the PNG specification)
+  void filterRow(const uint8_t* cur, const uint8_t* prev, uint8_t* out) const
+  {
+    const std::size_t n = m_rowBytes;
+    const int bpp = m_pixelSize;
+    std::vector<uint8_t> tmp(n);
+    uint64_t bestSum = UINT64_MAX;
+
+    for (int filter = 0; filter < 5; ++filter) {
+      uint64_t sum = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        const int a = (i >= std::size_t(bpp) ? cur[i - bpp] : 0);
+        const int b = prev[i];
+        const int c = (i >= std::size_t(bpp) ? prev[i - bpp] : 0);
+        int predictor;
+        switch (filter) {
+          case 0:  predictor = 0; break;
+          case 1:  predictor = a; break;
+          case 2:  predictor = b; break;
+          case 3:  predictor = (a + b) / 2; break;
+          default: {
+            const int p = a + b - c;
+            const int pa = std::abs(p - a);
+            const int pb = std::abs(p - b);
+            const int pc = std::abs(p - c);
+            predictor = (pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+            break;
+          }
+        }
+        tmp[i] = uint8_t(cur[i] - predictor);
+        sum += std::abs(int(int8_t(tmp[i])));
+      }
+      if (sum < bestSum) {
+        bestSum = sum;
+        out[0] = uint8_t(filter);
+        std::memcpy(out + 1, tmp.data(), n);
+      }
+    }
+  }
+
+  bool writeChunk(const char* type, const std::vector<uint8_t>& data)
+  {
+    std::vector<uint8_t> header;
+    put_u32be(header, uint32_t(data.size()));
+    header.insert(header.end(), type, type + 4);
+    uint32_t crc = crc32(0, header.data() + 4, 4);
+    crc = crc32(crc, data.data(), data.size());
+    std::vector<uint8_t> footer;
+    put_u32be(footer, crc);
+    return (write(m_file, header) && write(m_file, data) && write(m_file, footer));
+  }
+
+  FILE* m_file;
+  const Source& m_src;
+  bool m_alpha;
+  int m_pixelSize;
+  std::size_t m_rowBytes;
+  int m_rowsPerStripe;
+};
+
+} // anonymous namespace
+
+ImageFormat image_format_from_extension(const char* filename)
+{
+  const std::string ext = base::string_to_lower(base::get_file_extension(filename));
+  if (ext == "bmp")
+    return ImageFormat::Bmp;
+  if (ext == "tga")
+    return ImageFormat::Tga;
+  if (ext == "qoi")
+    return ImageFormat::Qoi;
+  if (ext == "png")
+    return ImageFormat::Png;
+  return ImageFormat::Unknown;
+}
+
+bool encode_image(const char* filename,
+                  const ImageFormat format,
+                  const uint32_t* src,
+                  const int width,
+                  const int height,
+                  const int srcStride,
+                  const SurfaceFormatData& fd,
+                  base::thread_pool* pool)
+{
+  ASSERT(fd.bitsPerPixel == 32);
+  if (format == ImageFormat::Unknown || width <= 0 || height <= 0 || width > 65535 ||
+      height > 65535) {
+    return false;
+  }
+
+  bool ok;
+  {
+    base::FileHandle file = base::open_file(filename, "wb");
+    if (!file)
+      return false;
+
+    const Source source(src, width, height, srcStride, fd);
+    switch (format) {
+      case ImageFormat::Bmp: ok = encode_bmp(file.get(), source); break;
+      case ImageFormat::Tga: ok = encode_tga(file.get(), source); break;
+      case ImageFormat::Qoi: ok = encode_qoi(file.get(), source); break;
+      case ImageFormat::Png: ok = PngEncoder(file.get(), source).encode(pool); break;
+      default:               ok = false; break;
+    }
+    ok = ok && (std::fflush(file.get()) == 0);
+  }
+
+  // Don't leave incomplete files
+  if (!ok && base::is_file(filename))
+    base::delete_file(filename);
+  return ok;
+}
+
+} // namespace os
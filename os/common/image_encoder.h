@@ -0,0 +1,44 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_IMAGE_ENCODER_H_INCLUDED
+#define OS_COMMON_IMAGE_ENCODER_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "os/common/image_decoder.h"
+#include "os/surface_format.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+// Returns the format of the built-in encoders/decoders that matches
+// the file extension (.bmp, .tga, .qoi, or .png).
+ImageFormat image_format_from_extension(const char* filename);
+
+// Encodes a "width" x "height" image of 32bpp pixels in the "fd"
+// format ("srcStride" in pixels) to a BMP, TGA (RLE), QOI, or PNG
+// file. Rows are converted and written one by one (the image is not
+// copied). Opaque images are saved without alpha channel.
+//
+// PNG files are compressed in stripes of rows that are independent
+// deflate streams. If "pool" is not nullptr, stripes are compressed
+// in parallel (the output is the same with or without a pool).
+bool encode_image(const char* filename,
+                  ImageFormat format,
+                  const uint32_t* src,
+                  int width,
+                  int height,
+                  int srcStride,
+                  const SurfaceFormatData& fd,
+                  base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
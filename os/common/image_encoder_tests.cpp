@@ -0,0 +1,248 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/thread_pool.h"
+#include "gfx/size.h"
+#include "os/common/image_decoder.h"
+#include "os/common/image_encoder.h"
+#include "os/common/test_support.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace os;
+
+static const ImageFormat kFormats[] = { ImageFormat::Bmp,
+                                        ImageFormat::Tga,
+                                        ImageFormat::Qoi,
+                                        ImageFormat::Png };
+
+static const SurfaceFormatData kStraightRgba = rgba_format(PixelAlpha::kStraight);
+
+static const char* extension(const ImageFormat format)
+{
+  switch (format) {
+    case ImageFormat::Bmp: return "bmp";
+    case ImageFormat::Tga: return "tga";
+    case ImageFormat::Qoi: return "qoi";
+    case ImageFormat::Png: return "png";
+    default:               return "img";
+  }
+}
+
+// Name of the temporary file to test the given format
+static std::string temp_filename(const ImageFormat format)
+{
+  return std::string("_test_encoder_.tmp.") + extension(format);
+}
+
+// Image with gradients, flat areas (for RLE/runs), and noise. Rows
+// have "stride" pixels (the extra pixels are garbage).
+static std::vector<uint32_t> make_image(const int w,
+                                        const int h,
+                                        const int stride,
+                                        const bool opaque)
+{
+  std::mt19937 rng(w * h);
+  std::vector<uint32_t> pixels(std::size_t(stride) * h);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < stride; ++x) {
+      uint32_t& c = pixels[std::size_t(y) * stride + x];
+      if (x >= w)
+        c = rng();
+      else if (y % 7 == 3)
+        c = 0xff204060;
+      else
+        c = ((x * 255 / w) | ((y * 255 / h) << 8) | ((rng() & 0x1f) << 16) | 0xff000000);
+      if (!opaque && x < w)
+        c = (c & 0xffffff) | (uint32_t((x + y) * 13 & 255) << 24);
+    }
+  }
+  return pixels;
+}
+
+static uint32_t premultiply(const uint32_t c)
+{
+  const uint32_t a = (c >> 24);
+  uint32_t result = (a << 24);
+  for (int i = 0; i < 3; ++i)
+    result |= ((((c >> (8 * i)) & 0xff) * a + 127) / 255) << (8 * i);
+  return result;
+}
+
+static std::vector<uint32_t> decode(const char* filename,
+                                    const SurfaceFormatData& fd = kStraightRgba)
+{
+  ImageInfo info;
+  if (!read_image_info(filename, info))
+    return {};
+  std::vector<uint32_t> pixels(std::size_t(info.width) * info.height, 0);
+  if (!decode_image(filename, gfx::Rect(), pixels.data(), info.width, fd))
+    return {};
+  return pixels;
+}
+
+static void expect_pixels(const std::vector<uint32_t>& expected,
+                          const int w,
+                          const int h,
+                          const int stride,
+                          const std::vector<uint32_t>& actual)
+{
+  ASSERT_EQ(std::size_t(w) * h, actual.size());
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      ASSERT_EQ(expected[std::size_t(y) * stride + x], actual[std::size_t(y) * w + x])
+        << x << "," << y;
+    }
+  }
+}
+
+TEST(ImageEncoder, FormatFromExtension)
+{
+  EXPECT_EQ(ImageFormat::Bmp, image_format_from_extension("a.bmp"));
+  EXPECT_EQ(ImageFormat::Tga, image_format_from_extension("dir/a.TGA"));
+  EXPECT_EQ(ImageFormat::Qoi, image_format_from_extension("a.b.qoi"));
+  EXPECT_EQ(ImageFormat::Png, image_format_from_extension("a.Png"));
+  EXPECT_EQ(ImageFormat::Unknown, image_format_from_extension("a.jpg"));
+  EXPECT_EQ(ImageFormat::Unknown, image_format_from_extension("png"));
+}
+
+TEST(ImageEncoder, RoundTrip)
+{
+  for (const ImageFormat format : kFormats) {
+    for (const bool opaque : { true, false }) {
+      for (const gfx::Size& size : { gfx::Size(1, 1), gfx::Size(7, 5), gfx::Size(301, 97) }) {
+        const int stride = size.w + 3;
+        const std::vector<uint32_t> pixels = make_image(size.w, size.h, stride, opaque);
+        TempFile f(temp_filename(format));
+        ASSERT_TRUE(
+          encode_image(f.filename(), format, pixels.data(), size.w, size.h, stride, kStraightRgba));
+        SCOPED_TRACE(std::string(extension(format)) + (opaque ? " opaque" : " alpha"));
+        expect_pixels(pixels, size.w, size.h, stride, decode(f.filename()));
+      }
+    }
+  }
+}
+
+TEST(ImageEncoder, OpaqueImagesWithoutAlpha)
+{
+  const std::vector<uint32_t> opaque = make_image(64, 64, 64, true);
+  std::vector<uint32_t> alpha = opaque;
+  alpha[100] &= 0x80ffffff;
+
+  for (const ImageFormat format : kFormats) {
+    TempFile f(temp_filename(format));
+    ASSERT_TRUE(encode_image(f.filename(), format, opaque.data(), 64, 64, 64, kStraightRgba));
+    const std::size_t opaqueSize = base::read_file_content(f.filename()).size();
+    ASSERT_TRUE(encode_image(f.filename(), format, alpha.data(), 64, 64, 64, kStraightRgba));
+    const std::size_t alphaSize = base::read_file_content(f.filename()).size();
+    EXPECT_LT(opaqueSize, alphaSize) << extension(format);
+  }
+}
+
+TEST(ImageEncoder, SourceFormats)
+{
+  const int w = 40, h = 30;
+  const std::vector<uint32_t> pixels = make_image(w, h, w, false);
+
+  // Premultiplied source
+  std::vector<uint32_t> premultiplied(pixels.size());
+  for (std::size_t i = 0; i < pixels.size(); ++i)
+    premultiplied[i] = premultiply(pixels[i]);
+
+  // BGRA source
+  SurfaceFormatData bgra = kStraightRgba;
+  bgra.redShift = 16;
+  bgra.blueShift = 0;
+  bgra.redMask = 0x00ff0000;
+  bgra.blueMask = 0x000000ff;
+  std::vector<uint32_t> swapped(pixels.size());
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    const uint32_t c = pixels[i];
+    swapped[i] = (c & 0xff00ff00) | ((c >> 16) & 0xff) | ((c & 0xff) << 16);
+  }
+
+  for (const ImageFormat format : kFormats) {
+    SCOPED_TRACE(extension(format));
+    TempFile f(temp_filename(format));
+
+    // Colors are unpremultiplied, so only the premultiplied values
+    // can be compared
+    ASSERT_TRUE(encode_image(f.filename(),
+                             format,
+                             premultiplied.data(),
+                             w,
+                             h,
+                             w,
+                             rgba_format(PixelAlpha::kPremultiplied)));
+    expect_pixels(premultiplied,
+                  w,
+                  h,
+                  w,
+                  decode(f.filename(), rgba_format(PixelAlpha::kPremultiplied)));
+
+    ASSERT_TRUE(encode_image(f.filename(), format, swapped.data(), w, h, w, bgra));
+    expect_pixels(pixels, w, h, w, decode(f.filename()));
+  }
+}
+
+TEST(ImageEncoder, ParallelPng)
+{
+  // Big enough to have several batches of stripes
+  const int w = 1100, h = 1100;
+  const std::vector<uint32_t> pixels = make_image(w, h, w, false);
+
+  TempFile f(temp_filename(ImageFormat::Png));
+  ASSERT_TRUE(encode_image(f.filename(), ImageFormat::Png, pixels.data(), w, h, w, kStraightRgba));
+  const base::buffer serial = base::read_file_content(f.filename());
+
+  base::thread_pool pool(4);
+  ASSERT_TRUE(
+    encode_image(f.filename(), ImageFormat::Png, pixels.data(), w, h, w, kStraightRgba, &pool));
+  const base::buffer parallel = base::read_file_content(f.filename());
+  EXPECT_EQ(serial, parallel);
+
+  expect_pixels(pixels, w, h, w, decode(f.filename()));
+}
+
+TEST(ImageEncoder, Errors)
+{
+  const std::vector<uint32_t> pixels(16, 0xff000000);
+  {
+    TempFile f(temp_filename(ImageFormat::Unknown));
+    EXPECT_FALSE(
+      encode_image(f.filename(), ImageFormat::Unknown, pixels.data(), 4, 4, 4, kStraightRgba));
+    EXPECT_FALSE(base::is_file(f.filename()));
+  }
+  {
+    TempFile f(temp_filename(ImageFormat::Png));
+    EXPECT_FALSE(
+      encode_image(f.filename(), ImageFormat::Png, pixels.data(), 0, 4, 4, kStraightRgba));
+    EXPECT_FALSE(base::is_file(f.filename()));
+  }
+  EXPECT_FALSE(encode_image("_test_encoder_.does_not_exist/a.png",
+                            ImageFormat::Png,
+                            pixels.data(),
+                            4,
+                            4,
+                            4,
+                            kStraightRgba));
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
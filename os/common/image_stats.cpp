@@ -0,0 +1,247 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/image_stats.h"
+
+#include "base/simd.h"
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+#include "os/common/surface_utils.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <mutex>
+
+namespace os {
+
+namespace {
+
+// Rows calculated in each task
+constexpr int kRowsPerTask = 64;
+
+// Index of the luma histogram in BandStats::histogram
+constexpr int kLuma = 4;
+
+// Returns the index of the first pixel with alpha != 0, or "n" if
+// all pixels are transparent.
+int first_visible(const uint32_t* row, const int n, const uint32_t alphaMask)
+{
+  int x = 0;
+#if LAF_SSE2
+  const __m128i mask = _mm_set1_epi32(int(alphaMask));
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 4 <= n; x += 4) {
+    const __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + x)), mask);
+    const int transparent = _mm_movemask_epi8(_mm_cmpeq_epi32(v, zero));
+    if (transparent != 0xffff) {
+      int i = 0;
+      while ((transparent >> (4 * i)) & 1)
+        ++i;
+      return x + i;
+    }
+  }
+#endif
+  for (; x < n; ++x) {
+    if (row[x] & alphaMask)
+      return x;
+  }
+  return n;
+}
+
+// Returns the index of the last pixel with alpha != 0, or -1 if all
+// pixels are transparent.
+int last_visible(const uint32_t* row, const int n, const uint32_t alphaMask)
+{
+  int x = n;
+#if LAF_SSE2
+  const __m128i mask = _mm_set1_epi32(int(alphaMask));
+  const __m128i zero = _mm_setzero_si128();
+  for (; x - 4 >= 0; x -= 4) {
+    const __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + x - 4)), mask);
+    const int transparent = _mm_movemask_epi8(_mm_cmpeq_epi32(v, zero));
+    if (transparent != 0xffff) {
+      int i = 3;
+      while ((transparent >> (4 * i)) & 1)
+        --i;
+      return x - 4 + i;
+    }
+  }
+#endif
+  while (--x >= 0) {
+    if (row[x] & alphaMask)
+      return x;
+  }
+  return -1;
+}
+
+// Private statistics of a band of rows. Consecutive pixels are
+// counted in two different sets of histograms, so a run of pixels
+// with the same color doesn't have to wait for the previous
+// increment of the same counter.
+struct BandStats {
+  uint32_t histogram[2][5][256] = {};
+  uint32_t transparent = 0;
+  int x1 = INT_MAX, y1 = INT_MAX;
+  int x2 = INT_MIN, y2 = INT_MIN;
+};
+
+void band_stats(const uint32_t* pixels,
+                const int stride,
+                const int width,
+                const int y1,
+                const int y2,
+                const SurfaceFormatData& fd,
+                BandStats& stats)
+{
+  const uint32_t alphaMask = fd.alphaMask;
+  const bool premultiplied = (fd.pixelAlpha == PixelAlpha::kPremultiplied);
+
+  for (int y = y1; y < y2; ++y) {
+    const uint32_t* row = pixels + std::size_t(y) * stride;
+    int x1 = 0;
+    int x2 = width - 1;
+    if (alphaMask) {
+      x1 = first_visible(row, width, alphaMask);
+      if (x1 == width) {
+        stats.transparent += width;
+        continue;
+      }
+      x2 = x1 + last_visible(row + x1, width - x1, alphaMask);
+      stats.transparent += x1 + (width - 1 - x2);
+    }
+    stats.x1 = std::min(stats.x1, x1);
+    stats.x2 = std::max(stats.x2, x2);
+    stats.y1 = std::min(stats.y1, y);
+    stats.y2 = y;
+
+    for (int x = x1; x <= x2; ++x) {
+      const uint32_t c = row[x];
+      const uint32_t a = (alphaMask ? (c & alphaMask) >> fd.alphaShift : 255);
+      if (a == 0) {
+        ++stats.transparent;
+        continue;
+      }
+      uint32_t r = (c & fd.redMask) >> fd.redShift;
+      uint32_t g = (c & fd.greenMask) >> fd.greenShift;
+      uint32_t b = (c & fd.blueMask) >> fd.blueShift;
+      if (premultiplied && a < 255) {
+        r = std::min<uint32_t>((r * 255 + a / 2) / a, 255);
+        g = std::min<uint32_t>((g * 255 + a / 2) / a, 255);
+        b = std::min<uint32_t>((b * 255 + a / 2) / a, 255);
+      }
+
+      uint32_t(&h)[5][256] = stats.histogram[x & 1];
+      ++h[ImageStats::Red][r];
+      ++h[ImageStats::Green][g];
+      ++h[ImageStats::Blue][b];
+      ++h[ImageStats::Alpha][a];
+      ++h[kLuma][(77 * r + 150 * g + 29 * b) >> 8];
+    }
+  }
+}
+
+} // anonymous namespace
+
+int ImageStats::min(const Channel channel) const
+{
+  for (int i = 0; i < 256; ++i) {
+    if (histogram[channel][i])
+      return i;
+  }
+  return 0;
+}
+
+int ImageStats::max(const Channel channel) const
+{
+  for (int i = 255; i >= 0; --i) {
+    if (histogram[channel][i])
+      return i;
+  }
+  return 0;
+}
+
+double ImageStats::mean(const Channel channel) const
+{
+  uint64_t sum = 0;
+  uint64_t count = 0;
+  for (int i = 0; i < 256; ++i) {
+    sum += histogram[channel][i] * i;
+    count += histogram[channel][i];
+  }
+  return (count ? double(sum) / double(count) : 0.0);
+}
+
+ImageStats image_stats(const uint32_t* pixels,
+                       const int stride,
+                       const gfx::Size& size,
+                       const SurfaceFormatData& fd,
+                       base::thread_pool* pool)
+{
+  ImageStats result;
+  if (size.w <= 0 || size.h <= 0)
+    return result;
+
+  int x1 = INT_MAX, y1 = INT_MAX;
+  int x2 = INT_MIN, y2 = INT_MIN;
+  uint64_t transparent = 0;
+  std::mutex mutex;
+
+  base::for_each_task(pool, size.h, kRowsPerTask, [&](const int band1, const int band2) {
+    auto stats = std::make_unique<BandStats>();
+    band_stats(pixels, stride, size.w, band1, band2, fd, *stats);
+
+    const std::lock_guard lock(mutex);
+    for (const auto& h : stats->histogram) {
+      for (int i = 0; i < 256; ++i) {
+        for (int c = 0; c < 4; ++c)
+          result.histogram[c][i] += h[c][i];
+        result.luma[i] += h[kLuma][i];
+      }
+    }
+    transparent += stats->transparent;
+    x1 = std::min(x1, stats->x1);
+    y1 = std::min(y1, stats->y1);
+    x2 = std::max(x2, stats->x2);
+    y2 = std::max(y2, stats->y2);
+  });
+
+  result.histogram[ImageStats::Alpha][0] += transparent;
+  result.pixels = uint64_t(size.w) * size.h;
+  result.visiblePixels = result.pixels - transparent;
+  if (x1 <= x2)
+    result.bounds = gfx::Rect(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+  return result;
+}
+
+ImageStats surface_stats(const Surface* surface, const gfx::Rect& area, base::thread_pool* pool)
+{
+  const gfx::Rect rc = area & surface->bounds();
+  if (rc.isEmpty())
+    return ImageStats();
+
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return ImageStats();
+
+  SurfaceLock lock(surface);
+  const uint32_t* pixels = (const uint32_t*)surface->getData(rc.x, rc.y);
+  if (!pixels)
+    return ImageStats();
+
+  ImageStats result = image_stats(pixels, row_stride(surface), rc.size(), fd, pool);
+  if (!result.bounds.isEmpty())
+    result.bounds.offset(rc.origin());
+  return result;
+}
+
+} // namespace os
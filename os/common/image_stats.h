@@ -0,0 +1,74 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_IMAGE_STATS_H_INCLUDED
+#define OS_COMMON_IMAGE_STATS_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/surface_format.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+// Histograms and statistics of an image (e.g. for auto-levels,
+// palette extraction, or to crop the transparent borders).
+struct ImageStats {
+  enum Channel { Red, Green, Blue, Alpha };
+
+  // Histograms of each channel. Colors are unpremultiplied, and fully
+  // transparent pixels are counted only in the alpha histogram.
+  uint64_t histogram[4][256] = {};
+
+  // Histogram of the luma of non-transparent pixels (Rec. 601
+  // weights: (77*r + 150*g + 29*b) / 256).
+  uint64_t luma[256] = {};
+
+  // Number of pixels of the image and non-transparent pixels.
+  uint64_t pixels = 0;
+  uint64_t visiblePixels = 0;
+
+  // Bounds of the non-transparent pixels (empty if the whole image
+  // is transparent).
+  gfx::Rect bounds;
+
+  // Minimum/maximum value and mean of a channel (0 if there are no
+  // pixels in its histogram).
+  int min(Channel channel) const;
+  int max(Channel channel) const;
+  double mean(Channel channel) const;
+};
+
+// Calculates the statistics of the 32bpp image "pixels" with the
+// format "fd" (the stride is in pixels). Formats without an alpha
+// mask are opaque.
+//
+// Transparent pixels at both sides of each row are skipped with SIMD
+// compares (giving the bounds too), the rest are counted in private
+// histograms for each band of rows, merged at the end. If "pool" is
+// not nullptr, bands are calculated in parallel.
+ImageStats image_stats(const uint32_t* pixels,
+                       int stride,
+                       const gfx::Size& size,
+                       const SurfaceFormatData& fd,
+                       base::thread_pool* pool = nullptr);
+
+// Calculates the statistics of the given area of a 32bpp surface.
+// The bounds are in surface coordinates.
+ImageStats surface_stats(const Surface* surface,
+                         const gfx::Rect& area,
+                         base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
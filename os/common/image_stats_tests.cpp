@@ -0,0 +1,166 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+#include "os/common/image_stats.h"
+#include "os/common/test_support.h"
+
+#include <random>
+#include <vector>
+
+using namespace os;
+
+// Statistics calculated with getPixel()-like loops
+static ImageStats reference_stats(const std::vector<uint32_t>& pixels,
+                                  const int w,
+                                  const int h,
+                                  const SurfaceFormatData& fd)
+{
+  ImageStats stats;
+  stats.pixels = uint64_t(w) * h;
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      const uint32_t c = pixels[y * w + x];
+      const int a = (fd.alphaMask ? c >> 24 : 255);
+      ++stats.histogram[ImageStats::Alpha][a];
+      if (a == 0)
+        continue;
+
+      int rgb[3] = { int(c & 0xff), int((c >> 8) & 0xff), int((c >> 16) & 0xff) };
+      if (fd.pixelAlpha == PixelAlpha::kPremultiplied) {
+        for (int& v : rgb)
+          v = std::min(255, int(v * 255.0 / a + 0.5));
+      }
+      for (int i = 0; i < 3; ++i)
+        ++stats.histogram[i][rgb[i]];
+      ++stats.luma[(77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) / 256];
+      ++stats.visiblePixels;
+      stats.bounds |= gfx::Rect(x, y, 1, 1);
+    }
+  }
+  return stats;
+}
+
+static void expect_equal_stats(const ImageStats& a, const ImageStats& b)
+{
+  for (int c = 0; c < 4; ++c) {
+    for (int i = 0; i < 256; ++i)
+      ASSERT_EQ(a.histogram[c][i], b.histogram[c][i]) << "channel " << c << " bin " << i;
+  }
+  for (int i = 0; i < 256; ++i)
+    ASSERT_EQ(a.luma[i], b.luma[i]) << "bin " << i;
+  EXPECT_EQ(a.pixels, b.pixels);
+  EXPECT_EQ(a.visiblePixels, b.visiblePixels);
+  EXPECT_EQ(a.bounds, b.bounds);
+}
+
+TEST(ImageStats, MinMaxMean)
+{
+  const int w = 4, h = 2;
+  const SurfaceFormatData fd = rgba_format(PixelAlpha::kStraight);
+  const std::vector<uint32_t> pixels = { 0xff000010, 0xff000020, 0x00ffffff, 0x80000030,
+                                         0xff000040, 0xff000050, 0xff000060, 0xff000070 };
+  const ImageStats stats = image_stats(pixels.data(), w, gfx::Size(w, h), fd);
+  EXPECT_EQ(8, stats.pixels);
+  EXPECT_EQ(7, stats.visiblePixels);
+  EXPECT_EQ(gfx::Rect(0, 0, 4, 2), stats.bounds);
+  EXPECT_EQ(0x10, stats.min(ImageStats::Red));
+  EXPECT_EQ(0x70, stats.max(ImageStats::Red));
+  EXPECT_DOUBLE_EQ(double(0x10 + 0x20 + 0x30 + 0x40 + 0x50 + 0x60 + 0x70) / 7,
+                   stats.mean(ImageStats::Red));
+  EXPECT_EQ(0, stats.max(ImageStats::Blue));
+  EXPECT_EQ(0, stats.min(ImageStats::Alpha));
+  EXPECT_EQ(255, stats.max(ImageStats::Alpha));
+
+  const ImageStats empty = image_stats(pixels.data(), w, gfx::Size(0, 0), fd);
+  EXPECT_EQ(0, empty.pixels);
+  EXPECT_TRUE(empty.bounds.isEmpty());
+  EXPECT_EQ(0.0, empty.mean(ImageStats::Red));
+}
+
+TEST(ImageStats, Bounds)
+{
+  const int w = 77, h = 50;
+  const SurfaceFormatData fd = rgba_format(PixelAlpha::kPremultiplied);
+  std::vector<uint32_t> pixels(w * h, 0);
+  EXPECT_TRUE(image_stats(pixels.data(), w, gfx::Size(w, h), fd).bounds.isEmpty());
+
+  pixels[10 * w + 33] = 0x01000000;
+  pixels[42 * w + 5] = 0xff00ff00;
+  pixels[20 * w + 70] = 0x80808080;
+  const ImageStats stats = image_stats(pixels.data(), w, gfx::Size(w, h), fd);
+  EXPECT_EQ(gfx::Rect(5, 10, 66, 33), stats.bounds);
+  EXPECT_EQ(3, stats.visiblePixels);
+  EXPECT_EQ(w * h - 3, stats.histogram[ImageStats::Alpha][0]);
+  EXPECT_EQ(2, stats.histogram[ImageStats::Green][255]); // 0x80808080 is white
+  EXPECT_EQ(1, stats.histogram[ImageStats::Red][255]);
+  expect_equal_stats(reference_stats(pixels, w, h, fd), stats);
+
+  // Opaque formats ignore the alpha channel
+  const ImageStats opaque =
+    image_stats(pixels.data(), w, gfx::Size(w, h), rgba_format(PixelAlpha::kOpaque));
+  EXPECT_EQ(gfx::Rect(0, 0, w, h), opaque.bounds);
+  EXPECT_EQ(w * h, opaque.visiblePixels);
+  EXPECT_EQ(w * h, opaque.histogram[ImageStats::Alpha][255]);
+}
+
+TEST(ImageStats, RandomImages)
+{
+  base::thread_pool pool(3);
+  std::mt19937 rng(11);
+  for (const PixelAlpha pixelAlpha :
+       { PixelAlpha::kOpaque, PixelAlpha::kPremultiplied, PixelAlpha::kStraight }) {
+    const SurfaceFormatData fd = rgba_format(pixelAlpha);
+    for (int i = 0; i < 10; ++i) {
+      const int w = 1 + rng() % 300;
+      const int h = 1 + rng() % 300;
+      std::vector<uint32_t> pixels(w * h, 0);
+
+      // A random sprite with some transparent pixels inside
+      const int x0 = rng() % w, y0 = rng() % h;
+      const int y1 = h - rng() % (h - y0);
+      for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < w; ++x) {
+          const uint32_t a = (rng() % 4 == 0 ? 0 : rng() % 256);
+          const uint32_t m = (pixelAlpha == PixelAlpha::kPremultiplied ? a + 1 : 256);
+          pixels[y * w + x] = (rng() % m) | ((rng() % m) << 8) | ((rng() % m) << 16) | (a << 24);
+        }
+      }
+
+      const ImageStats stats = image_stats(pixels.data(), w, gfx::Size(w, h), fd);
+      expect_equal_stats(reference_stats(pixels, w, h, fd), stats);
+      expect_equal_stats(stats, image_stats(pixels.data(), w, gfx::Size(w, h), fd, &pool));
+    }
+  }
+}
+
+TEST(ImageStats, Stride)
+{
+  const int w = 10, h = 3, stride = 16;
+  const SurfaceFormatData fd = rgba_format(PixelAlpha::kStraight);
+  std::vector<uint32_t> pixels(stride * h, 0xffffffff);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      pixels[y * stride + x] = (x == 4 && y == 1 ? 0xff000000 : 0);
+
+  const ImageStats stats = image_stats(pixels.data(), stride, gfx::Size(w, h), fd);
+  EXPECT_EQ(gfx::Rect(4, 1, 1, 1), stats.bounds);
+  EXPECT_EQ(1, stats.visiblePixels);
+  EXPECT_EQ(1, stats.luma[0]);
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
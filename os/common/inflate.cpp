@@ -0,0 +1,357 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/inflate.h"
+
+#include "os/common/deflate_tables.h"
+
+#include <algorithm>
+
+namespace os {
+
+namespace {
+
+constexpr int kMaxBits = 15;
+
+int reverse_bits(int code, const int len)
+{
+  int result = 0;
+  for (int i = 0; i < len; ++i, code >>= 1)
+    result = (result << 1) | (code & 1);
+  return result;
+}
+
+} // anonymous namespace
+
+bool Inflater::Huffman::build(const uint8_t* lengths, const int n)
+{
+  std::fill(std::begin(count), std::end(count), 0);
+  for (int i = 0; i < n; ++i)
+    ++count[lengths[i]];
+  count[0] = 0;
+
+  // Over-subscribed codes are invalid (incomplete codes are valid,
+  // e.g. a distance code with only one symbol)
+  int left = 1;
+  for (int len = 1; len <= kMaxBits; ++len) {
+    left <<= 1;
+    left -= count[len];
+    if (left < 0)
+      return false;
+  }
+
+  int offsets[kMaxBits + 1];
+  offsets[1] = 0;
+  for (int len = 1; len < kMaxBits; ++len)
+    offsets[len + 1] = offsets[len] + count[len];
+  for (int i = 0; i < n; ++i) {
+    if (lengths[i])
+      symbols[offsets[lengths[i]]++] = uint16_t(i);
+  }
+
+  // Lookup table for codes of up to kFastBits
+  std::fill(std::begin(fast), std::end(fast), 0xffff);
+  int next[kMaxBits + 1];
+  int code = 0;
+  for (int len = 1; len <= kMaxBits; ++len) {
+    code = (code + count[len - 1]) << 1;
+    next[len] = code;
+  }
+  for (int i = 0; i < n; ++i) {
+    const int len = lengths[i];
+    if (len == 0)
+      continue;
+    const int c = next[len]++;
+    if (len <= kFastBits) {
+      for (int k = reverse_bits(c, len); k < (1 << kFastBits); k += (1 << len))
+        fast[k] = uint16_t(i | (len << kFastBits));
+    }
+  }
+  return true;
+}
+
+Inflater::Inflater(Input&& input) : m_input(std::move(input)), m_window(kWindowSize)
+{
+}
+
+int Inflater::nextInputByte()
+{
+  while (m_size == 0) {
+    if (m_inputEnd || !m_input(m_data, m_size)) {
+      m_inputEnd = true;
+      return -1;
+    }
+  }
+  --m_size;
+  return *m_data++;
+}
+
+int Inflater::bits(const int n)
+{
+  while (m_nbits < n) {
+    const int b = nextInputByte();
+    if (b < 0)
+      return -1;
+    m_bits |= uint32_t(b) << m_nbits;
+    m_nbits += 8;
+  }
+  const int value = int(m_bits & ((1u << n) - 1));
+  m_bits >>= n;
+  m_nbits -= n;
+  return value;
+}
+
+int Inflater::decode(const Huffman& h)
+{
+  while (m_nbits <= kMaxBits + 8) {
+    const int b = nextInputByte();
+    if (b < 0)
+      break;
+    m_bits |= uint32_t(b) << m_nbits;
+    m_nbits += 8;
+  }
+
+  const uint16_t entry = h.fast[m_bits & ((1 << Huffman::kFastBits) - 1)];
+  if (entry != 0xffff) {
+    const int len = (entry >> Huffman::kFastBits);
+    if (len > m_nbits)
+      return -1;
+    m_bits >>= len;
+    m_nbits -= len;
+    return entry & ((1 << Huffman::kFastBits) - 1);
+  }
+
+  // Codes longer than kFastBits are decoded bit by bit
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for (int len = 1; len <= kMaxBits; ++len) {
+    if (m_nbits == 0)
+      return -1;
+    code |= int(m_bits & 1);
+    m_bits >>= 1;
+    --m_nbits;
+    const int count = h.count[len];
+    if (code - count < first)
+      return h.symbols[index + (code - first)];
+    index += count;
+    first += count;
+    first <<= 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+bool Inflater::startBlock()
+{
+  if (m_final) {
+    m_state = State::Done;
+    return false;
+  }
+
+  const int header = bits(3);
+  if (header < 0)
+    return false;
+  m_final = (header & 1);
+
+  switch (header >> 1) {
+    case 0: {
+      // Stored block, aligned to the next byte
+      m_bits >>= (m_nbits & 7);
+      m_nbits -= (m_nbits & 7);
+      const int len = bits(16);
+      const int nlen = bits(16);
+      if (len < 0 || nlen < 0 || len != (~nlen & 0xffff))
+        return false;
+      m_storedLeft = len;
+      m_state = State::Stored;
+      return true;
+    }
+    case 1: {
+      uint8_t lengths[288 + 30];
+      std::fill(lengths, lengths + 144, 8);
+      std::fill(lengths + 144, lengths + 256, 9);
+      std::fill(lengths + 256, lengths + 280, 7);
+      std::fill(lengths + 280, lengths + 288, 8);
+      std::fill(lengths + 288, lengths + 318, 5);
+      m_lit.build(lengths, 288);
+      m_dist.build(lengths + 288, 30);
+      m_state = State::Compressed;
+      return true;
+    }
+    case 2:
+      if (!readDynamicTables())
+        return false;
+      m_state = State::Compressed;
+      return true;
+  }
+  return false;
+}
+
+bool Inflater::readDynamicTables()
+{
+  const int hlit = bits(5);
+  const int hdist = bits(5);
+  const int hclen = bits(4);
+  if (hlit < 0 || hdist < 0 || hclen < 0)
+    return false;
+
+  const int nlit = hlit + 257;
+  const int ndist = hdist + 1;
+  if (nlit > 286 || ndist > 30)
+    return false;
+
+  uint8_t codeLengths[19] = {};
+  for (int i = 0; i < hclen + 4; ++i) {
+    const int len = bits(3);
+    if (len < 0)
+      return false;
+    codeLengths[kCodeLengthOrder[i]] = uint8_t(len);
+  }
+  Huffman codeLengthCode;
+  if (!codeLengthCode.build(codeLengths, 19))
+    return false;
+
+  uint8_t lengths[286 + 30] = {};
+  for (int i = 0; i < nlit + ndist;) {
+    const int sym = decode(codeLengthCode);
+    if (sym < 0)
+      return false;
+    if (sym < 16) {
+      lengths[i++] = uint8_t(sym);
+      continue;
+    }
+
+    int value = 0;
+    int repeat;
+    if (sym == 16) {
+      if (i == 0)
+        return false;
+      value = lengths[i - 1];
+      repeat = bits(2);
+      repeat = (repeat < 0 ? -1 : repeat + 3);
+    }
+    else if (sym == 17) {
+      repeat = bits(3);
+      repeat = (repeat < 0 ? -1 : repeat + 3);
+    }
+    else {
+      repeat = bits(7);
+      repeat = (repeat < 0 ? -1 : repeat + 11);
+    }
+    if (repeat < 0 || i + repeat > nlit + ndist)
+      return false;
+    std::fill(lengths + i, lengths + i + repeat, uint8_t(value));
+    i += repeat;
+  }
+
+  // The end-of-block code is required
+  if (lengths[256] == 0)
+    return false;
+
+  return (m_lit.build(lengths, nlit) && m_dist.build(lengths + nlit, ndist));
+}
+
+bool Inflater::read(uint8_t* out, const std::size_t n)
+{
+  std::size_t i = 0;
+  while (i < n) {
+    // Pending bytes of a back reference
+    if (m_copyLeft > 0) {
+      for (; m_copyLeft > 0 && i < n; --m_copyLeft) {
+        const uint8_t value = m_window[(m_pos - m_copyDist) & kWindowMask];
+        put(value);
+        out[i++] = value;
+      }
+      continue;
+    }
+
+    switch (m_state) {
+      case State::Header: {
+        const int cmf = bits(8);
+        const int flg = bits(8);
+        // Deflate compression, window <= 32K, without preset
+        // dictionary
+        if (cmf < 0 || flg < 0 || (cmf & 0x0f) != 8 || (cmf >> 4) > 7 || (flg & 0x20) ||
+            ((cmf << 8) | flg) % 31 != 0) {
+          m_state = State::Error;
+          return false;
+        }
+        m_state = State::BlockStart;
+        break;
+      }
+
+      case State::BlockStart:
+        if (!startBlock()) {
+          if (m_state != State::Done)
+            m_state = State::Error;
+          return false;
+        }
+        break;
+
+      case State::Stored:
+        if (m_storedLeft == 0) {
+          m_state = State::BlockStart;
+        }
+        else {
+          const int value = bits(8);
+          if (value < 0) {
+            m_state = State::Error;
+            return false;
+          }
+          put(uint8_t(value));
+          out[i++] = uint8_t(value);
+          --m_storedLeft;
+        }
+        break;
+
+      case State::Compressed: {
+        const int sym = decode(m_lit);
+        if (sym < 0 || sym > 285) {
+          m_state = State::Error;
+          return false;
+        }
+        if (sym < 256) {
+          put(uint8_t(sym));
+          out[i++] = uint8_t(sym);
+        }
+        else if (sym == 256) {
+          m_state = State::BlockStart;
+        }
+        else {
+          const int extra = bits(kLengthExtra[sym - 257]);
+          const int distSym = decode(m_dist);
+          if (extra < 0 || distSym < 0 || distSym >= 30) {
+            m_state = State::Error;
+            return false;
+          }
+          const int distExtra = bits(kDistExtra[distSym]);
+          if (distExtra < 0) {
+            m_state = State::Error;
+            return false;
+          }
+          m_copyLeft = kLengthBase[sym - 257] + extra;
+          m_copyDist = kDistBase[distSym] + distExtra;
+          if (uint32_t(m_copyDist) > m_available) {
+            m_state = State::Error;
+            return false;
+          }
+        }
+        break;
+      }
+
+      case State::Done:
+      case State::Error: return false;
+    }
+  }
+  return true;
+}
+
+} // namespace os
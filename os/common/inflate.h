@@ -0,0 +1,87 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_INFLATE_H_INCLUDED
+#define OS_COMMON_INFLATE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace os {
+
+// Streaming decompressor of zlib data (RFC 1950/1951) used by the
+// built-in PNG decoder. The compressed data is pulled from the input
+// function as it's needed, and the decompressed data is read in
+// small pieces (e.g. one row of pixels), so the whole stream is
+// never loaded in memory. The Adler-32 checksum is not verified.
+class Inflater {
+public:
+  // Must return the next block of compressed data in "data"/"size",
+  // or false if there is no more data.
+  using Input = std::function<bool(const uint8_t*& data, std::size_t& size)>;
+
+  Inflater(Input&& input);
+
+  // Reads exactly "n" decompressed bytes. Returns false if the
+  // stream ends before or it's invalid.
+  bool read(uint8_t* out, std::size_t n);
+
+private:
+  enum class State { Header, BlockStart, Stored, Compressed, Done, Error };
+
+  // Canonical Huffman code
+  struct Huffman {
+    static constexpr int kFastBits = 9;
+    uint16_t fast[1 << kFastBits]; // (length << 9) | symbol, or 0xffff
+    uint16_t count[16];            // Number of codes of each length
+    uint16_t symbols[288];         // Symbols sorted by code
+
+    bool build(const uint8_t* lengths, int n);
+  };
+
+  int nextInputByte();
+  int bits(int n);
+  int decode(const Huffman& h);
+  bool startBlock();
+  bool readDynamicTables();
+  void put(const uint8_t value)
+  {
+    m_window[m_pos++ & kWindowMask] = value;
+    if (m_available < kWindowSize)
+      ++m_available;
+  }
+
+  static constexpr uint32_t kWindowSize = 32768;
+  static constexpr uint32_t kWindowMask = kWindowSize - 1;
+
+  Input m_input;
+  const uint8_t* m_data = nullptr;
+  std::size_t m_size = 0;
+  bool m_inputEnd = false;
+
+  uint32_t m_bits = 0;
+  int m_nbits = 0;
+
+  State m_state = State::Header;
+  bool m_final = false;
+  int m_storedLeft = 0;
+  int m_copyLeft = 0;
+  int m_copyDist = 0;
+
+  std::vector<uint8_t> m_window;
+  uint32_t m_pos = 0;       // Number of decompressed bytes
+  uint32_t m_available = 0; // Bytes in the window for back references
+  Huffman m_lit;
+  Huffman m_dist;
+};
+
+} // namespace os
+
+#endif
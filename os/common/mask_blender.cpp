@@ -0,0 +1,254 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/mask_blender.h"
+
+#include "base/simd.h"
+#include "os/common/generic_surface.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace os {
+
+namespace {
+
+#if LAF_SSE2
+
+// Four pixels with one channel per register (each 32-bit lane
+// contains a value from 0 to 255).
+struct Pixels4 {
+  __m128i r, g, b, a;
+};
+
+// Same as MUL_UN8() for each 32-bit lane (a and b must be <= 255).
+inline __m128i mul_un8_4(const __m128i a, const __m128i b)
+{
+  // As both values are <= 255, the 16-bit low part of the product
+  // is the whole 32-bit product.
+  __m128i t = _mm_add_epi32(_mm_mullo_epi16(a, b), _mm_set1_epi32(0x80));
+  return _mm_srli_epi32(_mm_add_epi32(_mm_srli_epi32(t, 8), t), 8);
+}
+
+inline __m128i select_4(const __m128i mask, const __m128i a, const __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Returns Bc + (Sc - Bc) * Sa / Ra truncating the division result
+// towards zero (as the scalar version does with integers). All
+// values are exact in float, and the quotient is never closer than
+// 1/255 to an integer (unless it's an integer), so truncating the
+// float result gives the same value.
+inline __m128i lerp_div_4(const __m128i Bc, const __m128i Sc, const __m128 Sa, const __m128 Ra)
+{
+  const __m128 d = _mm_cvtepi32_ps(_mm_sub_epi32(Sc, Bc));
+  return _mm_add_epi32(Bc, _mm_cvttps_epi32(_mm_div_ps(_mm_mul_ps(d, Sa), Ra)));
+}
+
+// Same as os::blend() for four pixels at the same time.
+inline Pixels4 blend_4(const Pixels4& B, const Pixels4& S)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i Ra = _mm_sub_epi32(_mm_add_epi32(B.a, S.a), mul_un8_4(B.a, S.a));
+  // Ra is zero only when both alphas are zero (ignored lanes)
+  const __m128 RaF = _mm_max_ps(_mm_cvtepi32_ps(Ra), _mm_set1_ps(1.0f));
+  const __m128 SaF = _mm_cvtepi32_ps(S.a);
+
+  Pixels4 R;
+  R.r = lerp_div_4(B.r, S.r, SaF, RaF);
+  R.g = lerp_div_4(B.g, S.g, SaF, RaF);
+  R.b = lerp_div_4(B.b, S.b, SaF, RaF);
+  R.a = Ra;
+
+  // if (Sa == 0) return backdrop
+  const __m128i srcTransparent = _mm_cmpeq_epi32(S.a, zero);
+  R.r = select_4(srcTransparent, B.r, R.r);
+  R.g = select_4(srcTransparent, B.g, R.g);
+  R.b = select_4(srcTransparent, B.b, R.b);
+  R.a = select_4(srcTransparent, B.a, R.a);
+
+  // if (Ba == 0) return src (this check goes first in blend())
+  const __m128i backdropTransparent = _mm_cmpeq_epi32(B.a, zero);
+  R.r = select_4(backdropTransparent, S.r, R.r);
+  R.g = select_4(backdropTransparent, S.g, R.g);
+  R.b = select_4(backdropTransparent, S.b, R.b);
+  R.a = select_4(backdropTransparent, S.a, R.a);
+  return R;
+}
+
+inline __m128i unpack_channel_4(const __m128i px, const uint32_t mask, const uint32_t shift)
+{
+  return _mm_srl_epi32(_mm_and_si128(px, _mm_set1_epi32(int(mask))),
+                       _mm_cvtsi32_si128(int(shift)));
+}
+
+inline __m128i pack_channel_4(const __m128i c, const uint32_t mask, const uint32_t shift)
+{
+  return _mm_and_si128(_mm_sll_epi32(c, _mm_cvtsi32_si128(int(shift))),
+                       _mm_set1_epi32(int(mask)));
+}
+
+inline Pixels4 broadcast_color_4(const gfx::Color c)
+{
+  return Pixels4{ _mm_set1_epi32(gfx::getr(c)),
+                  _mm_set1_epi32(gfx::getg(c)),
+                  _mm_set1_epi32(gfx::getb(c)),
+                  _mm_set1_epi32(gfx::geta(c)) };
+}
+
+#endif // LAF_SSE2
+
+} // anonymous namespace
+
+MaskBlender::MaskBlender(const SurfaceFormatData& fd, gfx::Color fg, gfx::Color bg)
+  : m_fd(fd)
+  , m_fg(fg)
+  , m_bg(bg)
+  , m_fgAlpha(gfx::geta(fg))
+  , m_hasBg(gfx::geta(bg) > 0)
+  , m_opaqueFg(gfx::geta(fg) == 255)
+  , m_packedFg(pack(gfx::seta(fg, 255)))
+{
+  ASSERT(fd.bitsPerPixel == 32);
+}
+
+uint32_t MaskBlender::blendPixel(const uint32_t backdrop, const int alpha) const
+{
+  // Nothing to paint in this pixel
+  if (alpha == 0 && !m_hasBg)
+    return backdrop;
+
+  // Full coverage with an opaque color replaces the pixel
+  if (alpha == 255 && m_opaqueFg)
+    return m_packedFg;
+
+  int t;
+  gfx::Color output =
+    gfx::rgba(gfx::getr(m_fg), gfx::getg(m_fg), gfx::getb(m_fg), MUL_UN8(m_fgAlpha, alpha, t));
+  if (m_hasBg)
+    output = blend(blend(unpack(backdrop), m_bg), output);
+  else
+    output = blend(unpack(backdrop), output);
+  return pack(output);
+}
+
+void MaskBlender::blendGrayRow(uint32_t* dst, const uint8_t* mask, int n) const
+{
+#if LAF_SSE2
+  const Pixels4 fg4 = broadcast_color_4(m_fg);
+  const Pixels4 bg4 = broadcast_color_4(m_bg);
+  const __m128i fgAlpha4 = _mm_set1_epi32(m_fgAlpha);
+  const __m128i packedFg4 = _mm_set1_epi32(int(m_packedFg));
+
+  for (; n >= 4; n -= 4, dst += 4, mask += 4) {
+    uint32_t coverage;
+    std::memcpy(&coverage, mask, 4);
+
+    if (coverage == 0 && !m_hasBg)
+      continue;
+
+    if (coverage == 0xffffffff && m_opaqueFg) {
+      _mm_storeu_si128((__m128i*)dst, packedFg4);
+      continue;
+    }
+
+    const __m128i px = _mm_loadu_si128((const __m128i*)dst);
+    Pixels4 B = { unpack_channel_4(px, m_fd.redMask, m_fd.redShift),
+                  unpack_channel_4(px, m_fd.greenMask, m_fd.greenShift),
+                  unpack_channel_4(px, m_fd.blueMask, m_fd.blueShift),
+                  unpack_channel_4(px, m_fd.alphaMask, m_fd.alphaShift) };
+    if (m_hasBg)
+      B = blend_4(B, bg4);
+
+    // Expand the 4 coverage bytes to 4 32-bit lanes
+    __m128i alpha4 = _mm_cvtsi32_si128(int(coverage));
+    alpha4 = _mm_unpacklo_epi8(alpha4, _mm_setzero_si128());
+    alpha4 = _mm_unpacklo_epi16(alpha4, _mm_setzero_si128());
+
+    Pixels4 S = fg4;
+    S.a = mul_un8_4(fgAlpha4, alpha4);
+
+    const Pixels4 R = blend_4(B, S);
+    __m128i out = _mm_or_si128(_mm_or_si128(pack_channel_4(R.r, m_fd.redMask, m_fd.redShift),
+                                            pack_channel_4(R.g, m_fd.greenMask, m_fd.greenShift)),
+                               _mm_or_si128(pack_channel_4(R.b, m_fd.blueMask, m_fd.blueShift),
+                                            pack_channel_4(R.a, m_fd.alphaMask, m_fd.alphaShift)));
+
+    // Keep untouched pixels without coverage (same as blendPixel())
+    if (!m_hasBg) {
+      const __m128i untouched = _mm_cmpeq_epi32(alpha4, _mm_setzero_si128());
+      out = select_4(untouched, px, out);
+    }
+    _mm_storeu_si128((__m128i*)dst, out);
+  }
+#endif
+
+  for (; n > 0; --n, ++dst, ++mask)
+    *dst = blendPixel(*dst, *mask);
+}
+
+void MaskBlender::blendMonoRow(uint32_t* dst, const uint8_t* bits, int bit, int n) const
+{
+  // Expand bits to bytes in small chunks to re-use the gray kernel
+  uint8_t mask[64];
+  bits += (bit >> 3);
+  bit &= 7;
+  while (n > 0) {
+    const int m = std::min(n, int(sizeof(mask)));
+    for (int u = 0; u < m; ++u, ++bit)
+      mask[u] = ((bits[bit >> 3] & (0x80 >> (bit & 7))) ? 255 : 0);
+    blendGrayRow(dst, mask, m);
+    dst += m;
+    n -= m;
+  }
+}
+
+void MaskBlender::blendColorRow(uint32_t* dst, const uint8_t* bgra, int n) const
+{
+  int t;
+  for (; n > 0; --n, ++dst, bgra += 4) {
+    const int alpha = bgra[3];
+    if (alpha == 0 && !m_hasBg)
+      continue;
+
+    // Unpremultiply the glyph color
+    gfx::Color output = gfx::ColorNone;
+    if (alpha > 0) {
+      output = gfx::rgba(std::min(255, bgra[2] * 255 / alpha),
+                         std::min(255, bgra[1] * 255 / alpha),
+                         std::min(255, bgra[0] * 255 / alpha),
+                         MUL_UN8(m_fgAlpha, alpha, t));
+    }
+
+    gfx::Color backdrop = unpack(*dst);
+    if (m_hasBg)
+      backdrop = blend(backdrop, m_bg);
+    *dst = pack(blend(backdrop, output));
+  }
+}
+
+gfx::Color MaskBlender::unpack(const uint32_t c) const
+{
+  return gfx::rgba(((c & m_fd.redMask) >> m_fd.redShift),
+                   ((c & m_fd.greenMask) >> m_fd.greenShift),
+                   ((c & m_fd.blueMask) >> m_fd.blueShift),
+                   ((c & m_fd.alphaMask) >> m_fd.alphaShift));
+}
+
+uint32_t MaskBlender::pack(const gfx::Color c) const
+{
+  return ((gfx::getr(c) << m_fd.redShift) & m_fd.redMask) |
+         ((gfx::getg(c) << m_fd.greenShift) & m_fd.greenMask) |
+         ((gfx::getb(c) << m_fd.blueShift) & m_fd.blueMask) |
+         ((gfx::geta(c) << m_fd.alphaShift) & m_fd.alphaMask);
+}
+
+} // namespace os
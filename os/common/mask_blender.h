@@ -0,0 +1,62 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_MASK_BLENDER_H_INCLUDED
+#define OS_COMMON_MASK_BLENDER_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/color.h"
+#include "os/surface_format.h"
+
+namespace os {
+
+// Blends coverage masks (e.g. glyphs rendered by FreeType) with a
+// foreground/background color into rows of 32bpp pixels. All the
+// values that depend on the color/format are calculated once in the
+// constructor, so the row functions don't have to branch on each
+// pixel. Rows must be already clipped by the caller.
+class MaskBlender {
+public:
+  MaskBlender(const SurfaceFormatData& fd, gfx::Color fg, gfx::Color bg);
+
+  gfx::Color fg() const { return m_fg; }
+  gfx::Color bg() const { return m_bg; }
+
+  // Blends "n" pixels using an 8-bit coverage mask (one byte per
+  // pixel, FT_PIXEL_MODE_GRAY).
+  void blendGrayRow(uint32_t* dst, const uint8_t* mask, int n) const;
+
+  // Blends "n" pixels using a 1-bit coverage mask
+  // (FT_PIXEL_MODE_MONO), starting from the given "bit" index of the
+  // "bits" array (MSB first).
+  void blendMonoRow(uint32_t* dst, const uint8_t* bits, int bit, int n) const;
+
+  // Blends "n" pixels of a color glyph (FT_PIXEL_MODE_BGRA, 4 bytes
+  // per pixel with premultiplied alpha, e.g. emoji). The glyph has its
+  // own colors, only the alpha of the foreground color is used.
+  void blendColorRow(uint32_t* dst, const uint8_t* bgra, int n) const;
+
+  // Blends just one pixel. The row functions produce the same
+  // result than calling this function for each pixel.
+  uint32_t blendPixel(uint32_t backdrop, int alpha) const;
+
+private:
+  gfx::Color unpack(uint32_t c) const;
+  uint32_t pack(gfx::Color c) const;
+
+  SurfaceFormatData m_fd;
+  gfx::Color m_fg;
+  gfx::Color m_bg;
+  int m_fgAlpha;
+  bool m_hasBg;
+  bool m_opaqueFg;
+  uint32_t m_packedFg;
+};
+
+} // namespace os
+
+#endif
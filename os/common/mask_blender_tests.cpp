@@ -0,0 +1,115 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "os/common/mask_blender.h"
+
+#include <random>
+#include <vector>
+
+using namespace os;
+
+static SurfaceFormatData bgra_format()
+{
+  SurfaceFormatData fd;
+  fd.format = kRgbaSurfaceFormat;
+  fd.bitsPerPixel = 32;
+  fd.redShift = 16;
+  fd.greenShift = 8;
+  fd.blueShift = 0;
+  fd.alphaShift = 24;
+  fd.redMask = 0x00ff0000;
+  fd.greenMask = 0x0000ff00;
+  fd.blueMask = 0x000000ff;
+  fd.alphaMask = 0xff000000;
+  fd.pixelAlpha = PixelAlpha::kPremultiplied;
+  return fd;
+}
+
+TEST(MaskBlender, OpaqueCoverage)
+{
+  MaskBlender mb(bgra_format(), gfx::rgba(255, 128, 0), gfx::ColorNone);
+
+  std::vector<uint32_t> dst(9, 0xff000000);
+  const uint8_t mask[9] = { 0, 255, 255, 255, 255, 255, 0, 0, 255 };
+  mb.blendGrayRow(dst.data(), mask, 9);
+
+  for (int i = 0; i < 9; ++i)
+    EXPECT_EQ(mask[i] ? 0xffff8000 : 0xff000000, dst[i]) << "pixel " << i;
+}
+
+TEST(MaskBlender, GrayRowMatchesPixel)
+{
+  std::mt19937 rng(1);
+  const SurfaceFormatData fd = bgra_format();
+
+  for (int iter = 0; iter < 1000; ++iter) {
+    const int n = rng() % 37;
+    std::vector<uint32_t> a(n), b(n);
+    std::vector<uint8_t> mask(n);
+    for (int i = 0; i < n; ++i) {
+      a[i] = b[i] = rng();
+      switch (rng() % 3) {
+        case 0:  mask[i] = 0; break;
+        case 1:  mask[i] = 255; break;
+        default: mask[i] = rng(); break;
+      }
+    }
+
+    const gfx::Color fg = rng();
+    const gfx::Color bg = (rng() % 2 ? rng() : gfx::ColorNone);
+    MaskBlender mb(fd, fg, bg);
+    mb.blendGrayRow(a.data(), mask.data(), n);
+    for (int i = 0; i < n; ++i)
+      b[i] = mb.blendPixel(b[i], mask[i]);
+
+    ASSERT_EQ(b, a);
+  }
+}
+
+TEST(MaskBlender, MonoRow)
+{
+  MaskBlender mb(bgra_format(), gfx::rgba(255, 255, 255), gfx::ColorNone);
+
+  // Start from bit 3 of the first byte: 0b00010011 0b01000000
+  const uint8_t bits[2] = { 0x13, 0x40 };
+  std::vector<uint32_t> dst(7, 0xff000000);
+  mb.blendMonoRow(dst.data(), bits, 3, 7);
+
+  const bool expected[7] = { true, false, false, true, true, false, true };
+  for (int i = 0; i < 7; ++i)
+    EXPECT_EQ(expected[i] ? 0xffffffff : 0xff000000, dst[i]) << "pixel " << i;
+}
+
+TEST(MaskBlender, ColorRow)
+{
+  // Premultiplied BGRA pixels: opaque blue, transparent, red with 50% alpha
+  const uint8_t bgra[12] = { 255, 0, 0, 255, 0, 0, 0, 0, 0, 0, 128, 128 };
+
+  MaskBlender mb(bgra_format(), gfx::rgba(255, 255, 255), gfx::ColorNone);
+  std::vector<uint32_t> dst(3, 0xff000000);
+  mb.blendColorRow(dst.data(), bgra, 3);
+  EXPECT_EQ(0xff0000ff, dst[0]);
+  EXPECT_EQ(0xff000000, dst[1]);
+  EXPECT_EQ(0xff800000, dst[2]);
+
+  // Only the alpha of the foreground color is used
+  MaskBlender mb2(bgra_format(), gfx::rgba(0, 255, 0, 0), gfx::ColorNone);
+  dst.assign(3, 0xff000000);
+  mb2.blendColorRow(dst.data(), bgra, 3);
+  EXPECT_EQ(std::vector<uint32_t>(3, 0xff000000), dst);
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
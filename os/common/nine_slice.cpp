@@ -0,0 +1,168 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/nine_slice.h"
+
+#include "gfx/point.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Limits of the three pieces (left/center/right or top/middle/bottom)
+// of a nine-slice in one axis.
+struct Axis {
+  int src[4]; // Source coordinates
+  int dst[4]; // Destination coordinates (relative to the nine-slice)
+  bool repeat;
+
+  Axis(const int srcPos,
+       const int srcLen,
+       const int center0,
+       const int center1,
+       const int dstLen,
+       const NineSliceMode mode)
+    : repeat(mode == NineSliceMode::Repeat)
+  {
+    const int c0 = std::clamp(center0, 0, srcLen);
+    const int c1 = std::clamp(center1, c0, srcLen);
+    int side0 = c0;
+    int side1 = srcLen - c1;
+
+    // Reduce the sides proportionally if they don't fit
+    if (side0 + side1 > dstLen) {
+      side0 = int((int64_t(side0) * dstLen + (side0 + side1) / 2) / (side0 + side1));
+      side1 = dstLen - side0;
+    }
+
+    src[0] = srcPos;
+    src[1] = srcPos + c0;
+    src[2] = srcPos + c1;
+    src[3] = srcPos + srcLen;
+    dst[0] = 0;
+    dst[1] = side0;
+    dst[2] = dstLen - side1;
+    dst[3] = dstLen;
+  }
+
+  int srcLen(const int i) const { return src[i + 1] - src[i]; }
+  int dstLen(const int i) const { return dst[i + 1] - dst[i]; }
+
+  int piece(const int d) const { return (d < dst[1] ? 0 : (d < dst[2] ? 1 : 2)); }
+
+  // Returns the source coordinate for the destination coordinate "d"
+  // of the piece "i", or -1 if the piece is empty in the source.
+  int map(const int i, const int d) const
+  {
+    const int sl = srcLen(i);
+    const int dl = dstLen(i);
+    if (sl == 0)
+      return -1;
+    const int offset = d - dst[i];
+    if (sl == dl)
+      return src[i] + offset;
+    if (repeat && i == 1)
+      return src[i] + offset % sl;
+    // Nearest neighbor sampling at the center of the pixel
+    return src[i] + int((2 * int64_t(offset) + 1) * sl / (2 * int64_t(dl)));
+  }
+};
+
+} // anonymous namespace
+
+void render_nine_slice(const uint32_t* src,
+                       const int srcStride,
+                       const gfx::Rect& srcRect,
+                       const gfx::Rect& center,
+                       const bool drawCenter,
+                       uint32_t* dst,
+                       const int dstStride,
+                       const gfx::Size& dstSize,
+                       const gfx::Rect& dstArea,
+                       const NineSliceMode mode)
+{
+  const gfx::Rect area = (dstArea & gfx::Rect(dstSize));
+  if (area.isEmpty() || srcRect.isEmpty())
+    return;
+
+  const Axis ax(srcRect.x, srcRect.w, center.x, center.x2(), dstSize.w, mode);
+  const Axis ay(srcRect.y, srcRect.h, center.y, center.y2(), dstSize.h, mode);
+
+  // Source column of each stretched destination column
+  std::vector<int> xmap(area.w);
+  for (int x = area.x; x < area.x2(); ++x)
+    xmap[x - area.x] = ax.map(ax.piece(x), x);
+
+  int prevV = -1;
+  int prevSy = -1;
+  for (int y = area.y; y < area.y2(); ++y) {
+    uint32_t* dstRow = dst + std::size_t(y - area.y) * dstStride;
+    const int v = ay.piece(y);
+    const int sy = ay.map(v, y);
+
+    // Stretched rows are equal to the previous one
+    if (y > area.y && v == prevV && sy == prevSy) {
+      std::memcpy(dstRow, dstRow - dstStride, 4 * std::size_t(area.w));
+      continue;
+    }
+    prevV = v;
+    prevSy = sy;
+
+    const uint32_t* srcRow = (sy >= 0 ? src + std::size_t(sy) * srcStride : nullptr);
+    for (int u = 0; u < 3; ++u) {
+      const int x0 = std::max(ax.dst[u], area.x);
+      const int x1 = std::min(ax.dst[u + 1], area.x2());
+      if (x0 >= x1)
+        continue;
+
+      uint32_t* out = dstRow + (x0 - area.x);
+      const int n = x1 - x0;
+      const int sl = ax.srcLen(u);
+      if (!srcRow || sl == 0 || (u == 1 && v == 1 && !drawCenter)) {
+        std::fill(out, out + n, 0);
+      }
+      else if (sl == ax.dstLen(u)) {
+        std::memcpy(out, srcRow + ax.src[u] + (x0 - ax.dst[u]), 4 * std::size_t(n));
+      }
+      else if (ax.repeat && u == 1) {
+        // Copy spans of the source piece
+        for (int x = x0; x < x1;) {
+          const int offset = (x - ax.dst[u]) % sl;
+          const int m = std::min(x1 - x, sl - offset);
+          std::memcpy(out, srcRow + ax.src[u] + offset, 4 * std::size_t(m));
+          out += m;
+          x += m;
+        }
+      }
+      else {
+        const int* xs = &xmap[x0 - area.x];
+        for (int i = 0; i < n; ++i)
+          out[i] = srcRow[xs[i]];
+      }
+    }
+  }
+}
+
+std::size_t NineSliceKeyHash::operator()(const NineSliceKey& key) const
+{
+  const int64_t values[] = { key.src.x,    key.src.y,    key.src.w,      key.src.h,
+                             key.center.x, key.center.y, key.center.w,   key.center.h,
+                             key.size.w,   key.size.h,   key.drawCenter, key.color };
+  uint64_t h = key.sourceId * 0x9e3779b97f4a7c15ull;
+  for (const int64_t v : values)
+    h = (h ^ uint64_t(v)) * 0x100000001b3ull;
+  return std::size_t(h ^ (h >> 32));
+}
+
+} // namespace os
@@ -0,0 +1,174 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_NINE_SLICE_H_INCLUDED
+#define OS_COMMON_NINE_SLICE_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/ints.h"
+#include "gfx/color.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace os {
+
+// How the center column/row of a nine-slice fills the destination.
+enum class NineSliceMode {
+  Stretch, // Nearest neighbor scaling
+  Repeat,  // Tiled from the left/top side
+};
+
+// Draws the "srcRect" area of the 32bpp image "src" as a nine-slice
+// of "dstSize" pixels, calculating only the "dstArea" pixels of it.
+// "dst" points to the first pixel of "dstArea" (strides are in
+// pixels). "center" is relative to "srcRect" (like in
+// Surface::drawSurfaceNine()): the corners keep their size, and the
+// sides and the center are stretched or repeated. If the
+// destination is smaller than the corners, they are reduced
+// proportionally. Destination pixels are replaced (there is no
+// blending), the center is transparent if "drawCenter" is false.
+//
+// Pieces that keep their source size are copied by spans, and
+// stretched rows are copied from the previous destination row.
+void render_nine_slice(const uint32_t* src,
+                       int srcStride,
+                       const gfx::Rect& srcRect,
+                       const gfx::Rect& center,
+                       bool drawCenter,
+                       uint32_t* dst,
+                       int dstStride,
+                       const gfx::Size& dstSize,
+                       const gfx::Rect& dstArea,
+                       NineSliceMode mode = NineSliceMode::Stretch);
+
+// Identifies a rendered nine-slice. "sourceId" must change each time
+// the source pixels are modified (e.g. a generation ID). "color" is
+// the tint applied to the rendered pixels, or gfx::ColorNone if the
+// cached result is tinted when it's drawn.
+struct NineSliceKey {
+  uint64_t sourceId = 0;
+  gfx::Rect src;
+  gfx::Rect center;
+  gfx::Size size;
+  bool drawCenter = true;
+  gfx::Color color = gfx::ColorNone;
+
+  bool operator==(const NineSliceKey& o) const
+  {
+    return sourceId == o.sourceId && src == o.src && center == o.center && size == o.size &&
+           drawCenter == o.drawCenter && color == o.color;
+  }
+};
+
+struct NineSliceKeyHash {
+  std::size_t operator()(const NineSliceKey& key) const;
+};
+
+// Thread-safe LRU cache of rendered nine-slices (T is a pointer-like
+// type, e.g. a shared_ptr or sk_sp, where an empty T means "not
+// found"). Themed UIs draw the same nine-slices (buttons, frames,
+// etc.) with the same sizes in each frame, so the result of
+// render_nine_slice() (or the backend equivalent) can be reused
+// until the source changes (entries of old generations are evicted
+// when the cache is full).
+template<typename T>
+class NineSliceCache {
+public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    std::size_t bytes = 0;
+    std::size_t entries = 0;
+  };
+
+  explicit NineSliceCache(const std::size_t maxBytes) : m_maxBytes(maxBytes) {}
+
+  std::size_t maxBytes() const { return m_maxBytes; }
+
+  T find(const NineSliceKey& key)
+  {
+    const std::lock_guard lock(m_mutex);
+    auto it = m_items.find(key);
+    if (it == m_items.end()) {
+      ++m_stats.misses;
+      return T();
+    }
+    ++m_stats.hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return it->second.value;
+  }
+
+  // Adds a rendered nine-slice which uses "bytes" of memory. Items
+  // bigger than the whole cache are not added.
+  void insert(const NineSliceKey& key, T value, const std::size_t bytes)
+  {
+    if (bytes > m_maxBytes)
+      return;
+
+    const std::lock_guard lock(m_mutex);
+    auto it = m_items.find(key);
+    if (it != m_items.end()) {
+      m_stats.bytes -= it->second.bytes;
+      m_lru.erase(it->second.lru);
+      m_items.erase(it);
+    }
+
+    while (m_stats.bytes + bytes > m_maxBytes && !m_lru.empty()) {
+      auto last = m_items.find(m_lru.back());
+      m_stats.bytes -= last->second.bytes;
+      m_items.erase(last);
+      m_lru.pop_back();
+    }
+
+    m_lru.push_front(key);
+    m_items.emplace(key, Item{ std::move(value), bytes, m_lru.begin() });
+    m_stats.bytes += bytes;
+    m_stats.entries = m_items.size();
+  }
+
+  void clear()
+  {
+    const std::lock_guard lock(m_mutex);
+    m_items.clear();
+    m_lru.clear();
+    m_stats.bytes = 0;
+    m_stats.entries = 0;
+  }
+
+  Stats stats() const
+  {
+    const std::lock_guard lock(m_mutex);
+    Stats stats = m_stats;
+    stats.entries = m_items.size();
+    return stats;
+  }
+
+private:
+  struct Item {
+    T value;
+    std::size_t bytes;
+    typename std::list<NineSliceKey>::iterator lru;
+  };
+
+  const std::size_t m_maxBytes;
+  mutable std::mutex m_mutex;
+  std::unordered_map<NineSliceKey, Item, NineSliceKeyHash> m_items;
+  std::list<NineSliceKey> m_lru; // Most recently used first
+  Stats m_stats;
+
+  DISABLE_COPYING(NineSliceCache);
+};
+
+} // namespace os
+
+#endif
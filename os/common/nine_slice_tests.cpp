@@ -0,0 +1,210 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/point.h"
+#include "os/common/nine_slice.h"
+
+#include <memory>
+#include <vector>
+
+using namespace os;
+
+// Each pixel has its own coordinates (x in red, y in green).
+static std::vector<uint32_t> make_image(const int w, const int h)
+{
+  std::vector<uint32_t> pixels(std::size_t(w) * h);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      pixels[std::size_t(y) * w + x] = x | (y << 8) | 0xff000000;
+  return pixels;
+}
+
+static std::vector<uint32_t> render(const std::vector<uint32_t>& src,
+                                    const int srcStride,
+                                    const gfx::Rect& srcRect,
+                                    const gfx::Rect& center,
+                                    const bool drawCenter,
+                                    const gfx::Size& size,
+                                    const gfx::Rect& area,
+                                    const NineSliceMode mode)
+{
+  std::vector<uint32_t> dst(std::size_t(area.w) * area.h, 0x12345678);
+  render_nine_slice(src.data(),
+                    srcStride,
+                    srcRect,
+                    center,
+                    drawCenter,
+                    dst.data(),
+                    area.w,
+                    size,
+                    area,
+                    mode);
+  return dst;
+}
+
+// Source coordinate of the destination coordinate "d" (one pixel at
+// a time, without spans).
+static int expected_coord(const int d,
+                          const int srcLen,
+                          const int c0,
+                          const int c1,
+                          const int dstLen,
+                          const NineSliceMode mode)
+{
+  if (d < c0)
+    return d;
+  if (d >= dstLen - (srcLen - c1))
+    return c1 + d - (dstLen - (srcLen - c1));
+  const int offset = d - c0;
+  const int sl = c1 - c0;
+  const int dl = dstLen - c0 - (srcLen - c1);
+  if (mode == NineSliceMode::Repeat)
+    return c0 + offset % sl;
+  return c0 + (2 * offset + 1) * sl / (2 * dl);
+}
+
+TEST(NineSlice, SameSize)
+{
+  const std::vector<uint32_t> src = make_image(8, 6);
+  const gfx::Rect rc(0, 0, 8, 6);
+  EXPECT_EQ(src,
+            render(src, 8, rc, gfx::Rect(2, 2, 3, 1), true, rc.size(), rc, NineSliceMode::Stretch));
+}
+
+TEST(NineSlice, StretchAndRepeat)
+{
+  // The nine-slice is in the (3, 2, 7, 6) area of a bigger image
+  const std::vector<uint32_t> src = make_image(12, 9);
+  const gfx::Rect srcRect(3, 2, 7, 6);
+  const gfx::Rect center(2, 1, 3, 2);
+
+  for (const NineSliceMode mode : { NineSliceMode::Stretch, NineSliceMode::Repeat }) {
+    for (const gfx::Size& size : { gfx::Size(7, 6), gfx::Size(31, 17), gfx::Size(8, 100) }) {
+      const gfx::Rect all(size);
+      const std::vector<uint32_t> dst =
+        render(src, 12, srcRect, center, true, size, all, mode);
+      for (int y = 0; y < size.h; ++y) {
+        for (int x = 0; x < size.w; ++x) {
+          const int sx = expected_coord(x, srcRect.w, center.x, center.x2(), size.w, mode);
+          const int sy = expected_coord(y, srcRect.h, center.y, center.y2(), size.h, mode);
+          ASSERT_EQ(src[std::size_t(srcRect.y + sy) * 12 + srcRect.x + sx],
+                    dst[std::size_t(y) * size.w + x])
+            << x << "," << y;
+        }
+      }
+
+      // Partial areas are equal to the same area of the whole image
+      const gfx::Rect area(3, 1, size.w - 5, size.h - 3);
+      const std::vector<uint32_t> part =
+        render(src, 12, srcRect, center, true, size, area, mode);
+      for (int y = 0; y < area.h; ++y)
+        for (int x = 0; x < area.w; ++x)
+          ASSERT_EQ(dst[std::size_t(area.y + y) * size.w + area.x + x], part[y * area.w + x]);
+    }
+  }
+}
+
+TEST(NineSlice, WithoutCenter)
+{
+  const std::vector<uint32_t> src = make_image(6, 6);
+  const gfx::Size size(20, 10);
+  const std::vector<uint32_t> dst = render(src,
+                                           6,
+                                           gfx::Rect(0, 0, 6, 6),
+                                           gfx::Rect(2, 2, 2, 2),
+                                           false,
+                                           size,
+                                           gfx::Rect(size),
+                                           NineSliceMode::Stretch);
+  for (int y = 0; y < size.h; ++y) {
+    for (int x = 0; x < size.w; ++x) {
+      const bool inCenter = (x >= 2 && x < 18 && y >= 2 && y < 8);
+      EXPECT_EQ(inCenter, dst[y * size.w + x] == 0) << x << "," << y;
+    }
+  }
+}
+
+TEST(NineSlice, SmallerThanCorners)
+{
+  const std::vector<uint32_t> src = make_image(6, 6);
+  const std::vector<uint32_t> dst = render(src,
+                                           6,
+                                           gfx::Rect(0, 0, 6, 6),
+                                           gfx::Rect(2, 2, 2, 2),
+                                           true,
+                                           gfx::Size(3, 2),
+                                           gfx::Rect(0, 0, 3, 2),
+                                           NineSliceMode::Stretch);
+  // Corners are reduced proportionally (2+1 columns and 1+1 rows
+  // sampled from the center of the source corners)
+  const std::vector<uint32_t> expected = { src[1 * 6],     src[1 * 6 + 1], src[1 * 6 + 5],
+                                           src[5 * 6 + 0], src[5 * 6 + 1], src[5 * 6 + 5] };
+  EXPECT_EQ(expected, dst);
+}
+
+TEST(NineSlice, Cache)
+{
+  using Pixels = std::shared_ptr<std::vector<uint32_t>>;
+  NineSliceCache<Pixels> cache(1000);
+
+  auto key = [](const int sourceId, const int w) {
+    NineSliceKey key;
+    key.sourceId = sourceId;
+    key.src = gfx::Rect(0, 0, 6, 6);
+    key.center = gfx::Rect(2, 2, 2, 2);
+    key.size = gfx::Size(w, 10);
+    return key;
+  };
+
+  EXPECT_EQ(nullptr, cache.find(key(1, 10)));
+  cache.insert(key(1, 10), std::make_shared<std::vector<uint32_t>>(1), 400);
+  cache.insert(key(1, 20), std::make_shared<std::vector<uint32_t>>(2), 400);
+  ASSERT_NE(nullptr, cache.find(key(1, 10)));
+  EXPECT_EQ(1, cache.find(key(1, 10))->size());
+  EXPECT_EQ(nullptr, cache.find(key(2, 10))); // Other generation
+
+  NineSliceKey noCenter = key(1, 10);
+  noCenter.drawCenter = false;
+  EXPECT_EQ(nullptr, cache.find(noCenter));
+
+  NineSliceKey tinted = key(1, 10);
+  tinted.color = gfx::rgba(255, 0, 0);
+  EXPECT_EQ(nullptr, cache.find(tinted));
+  EXPECT_NE(NineSliceKeyHash()(key(1, 10)), NineSliceKeyHash()(tinted));
+
+  // The least recently used item is evicted
+  cache.insert(key(1, 30), std::make_shared<std::vector<uint32_t>>(3), 400);
+  EXPECT_NE(nullptr, cache.find(key(1, 10)));
+  EXPECT_EQ(nullptr, cache.find(key(1, 20)));
+  EXPECT_NE(nullptr, cache.find(key(1, 30)));
+
+  // Too big
+  cache.insert(key(1, 40), std::make_shared<std::vector<uint32_t>>(4), 1001);
+  EXPECT_EQ(nullptr, cache.find(key(1, 40)));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(4, stats.hits);
+  EXPECT_EQ(6, stats.misses);
+  EXPECT_EQ(800, stats.bytes);
+  EXPECT_EQ(2, stats.entries);
+
+  cache.clear();
+  EXPECT_EQ(0, cache.stats().entries);
+  EXPECT_EQ(0, cache.stats().bytes);
+  EXPECT_EQ(nullptr, cache.find(key(1, 10)));
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,288 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/palette_index.h"
+
+#include "base/debug.h"
+#include "base/thread_pool.h"
+#include "os/common/surface_utils.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace os {
+
+namespace {
+
+// Rows mapped in each task
+constexpr int kRowsPerTask = 64;
+
+// Values of each component in a cell, and in a box of 4x4x4 cells
+constexpr int kCellSide = 8;
+constexpr int kBoxSide = 32;
+constexpr int kBoxes = 256 / kBoxSide;
+
+inline int cell_index(const int r, const int g, const int b)
+{
+  return ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+}
+
+// Returns the minimum and maximum of |p-c| for c in [lo, hi]
+inline void axis_range(const int p, const int lo, const int hi, int& dmin, int& dmax)
+{
+  dmin = (p < lo ? lo - p : (p > hi ? p - hi : 0));
+  dmax = std::max(std::abs(p - lo), std::abs(p - hi));
+}
+
+// Adds to "result" the entries (of the given "entries") that can be
+// the nearest one to some color of the box of "side" values at (r0,
+// g0, b0). These are the entries nearer to the box than the farthest
+// color of the box to its nearest entry. The weights of the Redmean
+// metric are bounded with the range of the mean red.
+void box_candidates(const std::vector<gfx::Color>& palette,
+                    const ColorMetric& metric,
+                    const int r0,
+                    const int g0,
+                    const int b0,
+                    const int side,
+                    const std::vector<uint16_t>& entries,
+                    std::vector<int>& dmin,
+                    std::vector<uint16_t>& result)
+{
+  const int n = int(entries.size());
+  dmin.resize(n);
+
+  int nearest = INT_MAX;
+  for (int k = 0; k < n; ++k) {
+    const gfx::Color c = palette[entries[k]];
+    const int pr = gfx::getr(c);
+    int rmin, rmax, gmin, gmax, bmin, bmax;
+    axis_range(pr, r0, r0 + side - 1, rmin, rmax);
+    axis_range(gfx::getg(c), g0, g0 + side - 1, gmin, gmax);
+    axis_range(gfx::getb(c), b0, b0 + side - 1, bmin, bmax);
+
+    int dmax;
+    if (metric.type == ColorMetric::Redmean) {
+      const int rmean1 = (pr + r0) / 2;
+      const int rmean2 = (pr + r0 + side - 1) / 2;
+      dmin[k] =
+        (512 + rmean1) * rmin * rmin + 1024 * gmin * gmin + (767 - rmean2) * bmin * bmin;
+      dmax = (512 + rmean2) * rmax * rmax + 1024 * gmax * gmax + (767 - rmean1) * bmax * bmax;
+    }
+    else {
+      dmin[k] = metric.red * rmin * rmin + metric.green * gmin * gmin + metric.blue * bmin * bmin;
+      dmax = metric.red * rmax * rmax + metric.green * gmax * gmax + metric.blue * bmax * bmax;
+    }
+    nearest = std::min(nearest, dmax);
+  }
+
+  for (int k = 0; k < n; ++k) {
+    if (dmin[k] <= nearest)
+      result.push_back(entries[k]);
+  }
+}
+
+} // anonymous namespace
+
+int ColorMetric::distance(const gfx::Color a, const gfx::Color b) const
+{
+  const int dr = int(gfx::getr(a)) - int(gfx::getr(b));
+  const int dg = int(gfx::getg(a)) - int(gfx::getg(b));
+  const int db = int(gfx::getb(a)) - int(gfx::getb(b));
+  if (type == Redmean) {
+    const int rmean = (gfx::getr(a) + gfx::getr(b)) / 2;
+    return (512 + rmean) * dr * dr + 1024 * dg * dg + (767 - rmean) * db * db;
+  }
+  return red * dr * dr + green * dg * dg + blue * db * db;
+}
+
+PaletteIndex::PaletteIndex(const gfx::Color* palette,
+                           const int size,
+                           const ColorMetric& metric,
+                           base::thread_pool* pool)
+  : m_palette(palette, palette + std::max(size, 0))
+  , m_metric(metric)
+  , m_offsets(kCells + 1, 0)
+{
+  ASSERT(size <= 65536);
+  const int n = int(m_palette.size());
+  if (n == 0)
+    return;
+
+  // Candidates of each slice of cells with the same red, "ends" is
+  // the end of the candidates of each cell
+  struct Slice {
+    std::vector<uint32_t> ends;
+    std::vector<uint16_t> candidates;
+  };
+  std::vector<Slice> slices(kBoxes);
+
+  std::vector<uint16_t> all(n);
+  for (int i = 0; i < n; ++i)
+    all[i] = uint16_t(i);
+
+  // The candidates of a cell are a subset of the candidates of any
+  // box that contains the cell, so first the candidates of big boxes
+  // (of 4x4x4 cells) are calculated from the whole palette, and then
+  // the candidates of each cell from the candidates of its box.
+  base::for_each_task(pool, kBoxes, 1, [&](const int slice1, const int slice2) {
+    std::vector<int> dmin;
+    std::vector<std::vector<uint16_t>> boxes(kBoxes * kBoxes);
+    for (int slice = slice1; slice < slice2; ++slice) {
+      const int r0 = slice * kBoxSide;
+      for (int g = 0; g < kBoxes; ++g) {
+        for (int b = 0; b < kBoxes; ++b) {
+          boxes[g * kBoxes + b].clear();
+          box_candidates(m_palette,
+                         m_metric,
+                         r0,
+                         g * kBoxSide,
+                         b * kBoxSide,
+                         kBoxSide,
+                         all,
+                         dmin,
+                         boxes[g * kBoxes + b]);
+        }
+      }
+
+      Slice& result = slices[slice];
+      for (int r = r0; r < r0 + kBoxSide; r += kCellSide) {
+        for (int g = 0; g < 256; g += kCellSide) {
+          for (int b = 0; b < 256; b += kCellSide) {
+            const auto& box = boxes[(g / kBoxSide) * kBoxes + (b / kBoxSide)];
+            box_candidates(m_palette, m_metric, r, g, b, kCellSide, box, dmin, result.candidates);
+            result.ends.push_back(uint32_t(result.candidates.size()));
+          }
+        }
+      }
+    }
+  });
+
+  // Join the candidates of all slices
+  std::size_t total = 0;
+  for (const Slice& slice : slices)
+    total += slice.candidates.size();
+  m_candidates.reserve(total);
+
+  int cell = 0;
+  for (const Slice& slice : slices) {
+    const uint32_t base = uint32_t(m_candidates.size());
+    for (const uint32_t end : slice.ends)
+      m_offsets[++cell] = base + end;
+    m_candidates.insert(m_candidates.end(), slice.candidates.begin(), slice.candidates.end());
+  }
+}
+
+int PaletteIndex::find(const gfx::Color color) const
+{
+  if (m_palette.empty())
+    return -1;
+
+  const int cell = cell_index(gfx::getr(color), gfx::getg(color), gfx::getb(color));
+  const uint16_t* it = m_candidates.data() + m_offsets[cell];
+  const uint16_t* end = m_candidates.data() + m_offsets[cell + 1];
+  int best = *it;
+  if (++it == end)
+    return best;
+
+  int bestDistance = m_metric.distance(color, m_palette[best]);
+  for (; it != end && bestDistance > 0; ++it) {
+    const int distance = m_metric.distance(color, m_palette[*it]);
+    if (distance < bestDistance) {
+      best = *it;
+      bestDistance = distance;
+    }
+  }
+  return best;
+}
+
+void PaletteIndex::map(const uint32_t* src,
+                       const int srcStride,
+                       const gfx::Size& size,
+                       const SurfaceFormatData& fd,
+                       uint8_t* dst,
+                       const int dstStride,
+                       const int transparentIndex,
+                       base::thread_pool* pool) const
+{
+  ASSERT(m_palette.size() <= 256);
+  if (m_palette.empty() || size.w <= 0 || size.h <= 0)
+    return;
+
+  const bool premultiplied = (fd.pixelAlpha == PixelAlpha::kPremultiplied);
+  base::for_each_task(pool, size.h, kRowsPerTask, [&, fd](const int y1, const int y2) {
+    // Last pixel, consecutive pixels usually have the same color
+    uint32_t lastPixel = src[std::size_t(y1) * srcStride] ^ 1;
+    uint8_t lastIndex = 0;
+
+    for (int y = y1; y < y2; ++y) {
+      const uint32_t* s = src + std::size_t(y) * srcStride;
+      uint8_t* d = dst + std::size_t(y) * dstStride;
+      for (int x = 0; x < size.w; ++x) {
+        const uint32_t c = s[x];
+        if (c != lastPixel) {
+          lastPixel = c;
+
+          const int a = (fd.alphaMask ? (c & fd.alphaMask) >> fd.alphaShift : 255);
+          if (a < 128 && transparentIndex >= 0) {
+            lastIndex = uint8_t(transparentIndex);
+          }
+          else {
+            int r = (c & fd.redMask) >> fd.redShift;
+            int g = (c & fd.greenMask) >> fd.greenShift;
+            int b = (c & fd.blueMask) >> fd.blueShift;
+            if (premultiplied && a > 0 && a < 255) {
+              r = std::min((r * 255 + a / 2) / a, 255);
+              g = std::min((g * 255 + a / 2) / a, 255);
+              b = std::min((b * 255 + a / 2) / a, 255);
+            }
+            lastIndex = uint8_t(find(gfx::rgba(r, g, b)));
+          }
+        }
+        d[x] = lastIndex;
+      }
+    }
+  });
+}
+
+void PaletteIndex::mapSurface(const Surface* surface,
+                              uint8_t* dst,
+                              const int dstStride,
+                              const int transparentIndex,
+                              base::thread_pool* pool) const
+{
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return;
+
+  SurfaceLock lock(surface);
+  const uint32_t* pixels = (const uint32_t*)surface->getData(0, 0);
+  if (!pixels)
+    return;
+
+  map(pixels,
+      row_stride(surface),
+      gfx::Size(surface->width(), surface->height()),
+      fd,
+      dst,
+      dstStride,
+      transparentIndex,
+      pool);
+}
+
+double PaletteIndex::averageCandidates() const
+{
+  return double(m_candidates.size()) / kCells;
+}
+
+} // namespace os
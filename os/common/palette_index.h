@@ -0,0 +1,115 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_PALETTE_INDEX_H_INCLUDED
+#define OS_COMMON_PALETTE_INDEX_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/color.h"
+#include "gfx/size.h"
+#include "os/surface_format.h"
+
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+// Distance between two colors used to find the nearest palette entry
+struct ColorMetric {
+  enum Type {
+    // Weighted squared difference of each RGB component
+    Rgb,
+    // Low-cost perceptual distance ("redmean"), where the weights of
+    // red and blue depend on the mean red of both colors
+    Redmean,
+  };
+
+  Type type = Rgb;
+
+  // Weights of each component for the Rgb metric (e.g. 2, 4, 3)
+  int red = 1;
+  int green = 1;
+  int blue = 1;
+
+  // Returns the distance between two colors (the alpha is ignored)
+  int distance(gfx::Color a, gfx::Color b) const;
+};
+
+// Finds the nearest color of a palette without comparing each color
+// with all palette entries.
+//
+// The RGB cube is divided in 32x32x32 cells, and each cell has the
+// list of entries that can be the nearest one to some color of the
+// cell: the entries that are nearer to the cell than the farthest
+// corner of the cell to its nearest entry. So only a few entries (or
+// only one) are compared to find the nearest color, and the result is
+// the same as a linear search (with the lowest index on ties). The
+// lists are refined from the lists of bigger boxes of 4x4x4 cells, so
+// creating the index is fast too (a few milliseconds for 256 colors).
+class PaletteIndex {
+public:
+  // Creates the index of the given palette (the alpha of the palette
+  // colors is ignored). If "pool" is not nullptr, cells are calculated
+  // in parallel.
+  PaletteIndex(const gfx::Color* palette,
+               int size,
+               const ColorMetric& metric = ColorMetric(),
+               base::thread_pool* pool = nullptr);
+
+  int size() const { return int(m_palette.size()); }
+  const ColorMetric& metric() const { return m_metric; }
+
+  // Returns the index of the nearest palette entry to the RGB
+  // components of "color" (-1 if the palette is empty).
+  int find(gfx::Color color) const;
+
+  // Maps each pixel of the 32bpp image "src" with the format "fd"
+  // (the stride is in pixels) to the index of its nearest color in
+  // "dst" (8-bit, the stride is in bytes). The palette must have 256
+  // colors or less. Pixels with alpha < 128 are mapped to
+  // "transparentIndex" if it's >= 0. Bands of rows are mapped in
+  // parallel if "pool" is not nullptr.
+  void map(const uint32_t* src,
+           int srcStride,
+           const gfx::Size& size,
+           const SurfaceFormatData& fd,
+           uint8_t* dst,
+           int dstStride,
+           int transparentIndex = -1,
+           base::thread_pool* pool = nullptr) const;
+
+  // Same as map() for a 32bpp surface ("dst" must have the size of
+  // the surface).
+  void mapSurface(const Surface* surface,
+                  uint8_t* dst,
+                  int dstStride,
+                  int transparentIndex = -1,
+                  base::thread_pool* pool = nullptr) const;
+
+  // Average number of candidates in each cell (for profiling)
+  double averageCandidates() const;
+
+private:
+  static constexpr int kCells = 32 * 32 * 32;
+
+  std::vector<gfx::Color> m_palette;
+  ColorMetric m_metric;
+
+  // Candidates of cell "i" are m_candidates[m_offsets[i]] to
+  // m_candidates[m_offsets[i+1]-1]
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint16_t> m_candidates;
+};
+
+} // namespace os
+
+#endif
@@ -0,0 +1,156 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "os/common/palette_index.h"
+#include "os/common/test_support.h"
+
+#include <climits>
+#include <random>
+#include <vector>
+
+using namespace os;
+
+static int linear_search(const std::vector<gfx::Color>& palette,
+                         const ColorMetric& metric,
+                         const gfx::Color color)
+{
+  int best = -1;
+  int bestDistance = INT_MAX;
+  for (int i = 0; i < int(palette.size()); ++i) {
+    const int distance = metric.distance(color, palette[i]);
+    if (distance < bestDistance) {
+      best = i;
+      bestDistance = distance;
+    }
+  }
+  return best;
+}
+
+static std::vector<gfx::Color> random_palette(std::mt19937& rng, const int n)
+{
+  std::vector<gfx::Color> palette(n);
+  for (gfx::Color& c : palette)
+    c = gfx::rgba(rng() % 256, rng() % 256, rng() % 256);
+  return palette;
+}
+
+TEST(PaletteIndex, Empty)
+{
+  PaletteIndex index(nullptr, 0);
+  EXPECT_EQ(0, index.size());
+  EXPECT_EQ(-1, index.find(gfx::rgba(1, 2, 3)));
+}
+
+TEST(PaletteIndex, SameAsLinearSearch)
+{
+  std::mt19937 rng(1);
+  base::thread_pool pool(3);
+
+  ColorMetric weighted;
+  weighted.red = 2;
+  weighted.green = 4;
+  weighted.blue = 3;
+  ColorMetric redmean;
+  redmean.type = ColorMetric::Redmean;
+
+  for (const ColorMetric& metric : { ColorMetric(), weighted, redmean }) {
+    for (const int n : { 1, 2, 16, 100, 256 }) {
+      std::vector<gfx::Color> palette = random_palette(rng, n);
+      if (n > 2)
+        palette[n / 2] = palette[n - 1]; // Duplicated entry
+
+      const PaletteIndex index(palette.data(), n, metric, (n == 100 ? &pool : nullptr));
+      EXPECT_LE(index.averageCandidates(), n);
+      for (int i = 0; i < 20000; ++i) {
+        const gfx::Color c = gfx::rgba(rng() % 256, rng() % 256, rng() % 256);
+        ASSERT_EQ(linear_search(palette, metric, c), index.find(c)) << std::hex << c;
+      }
+      for (const gfx::Color c : palette)
+        ASSERT_EQ(linear_search(palette, metric, c), index.find(c));
+    }
+  }
+}
+
+TEST(PaletteIndex, FewCandidates)
+{
+  // Palette of 6x6x6 colors
+  std::vector<gfx::Color> palette;
+  for (int r = 0; r < 6; ++r)
+    for (int g = 0; g < 6; ++g)
+      for (int b = 0; b < 6; ++b)
+        palette.push_back(gfx::rgba(r * 51, g * 51, b * 51));
+
+  const PaletteIndex index(palette.data(), int(palette.size()));
+  EXPECT_LT(index.averageCandidates(), 4.0);
+  EXPECT_EQ(0, index.find(gfx::rgba(10, 10, 10)));
+  EXPECT_EQ(215, index.find(gfx::rgba(250, 240, 255)));
+}
+
+TEST(PaletteIndex, Map)
+{
+  const std::vector<gfx::Color> palette = { gfx::rgba(0, 0, 0),
+                                            gfx::rgba(255, 0, 0),
+                                            gfx::rgba(0, 0, 255),
+                                            gfx::rgba(0, 0, 0, 0) };
+  const PaletteIndex index(palette.data(), int(palette.size()));
+
+  const int w = 4, h = 2, dstStride = 6;
+  const std::vector<uint32_t> pixels = {
+    gfx::rgba(10, 0, 0),       gfx::rgba(200, 30, 0),      gfx::rgba(0, 0, 200),
+    gfx::rgba(255, 0, 0, 0),   gfx::rgba(0, 0, 0),         gfx::rgba(100, 0, 0, 200),
+    gfx::rgba(0, 0, 130, 127), gfx::rgba(0, 0, 0, 127),
+  };
+  const gfx::Size size(w, h);
+
+  // Premultiplied: (100,0,0,200) is (128,0,0) so it's red
+  std::vector<uint8_t> dst(dstStride * h, 9);
+  index.map(pixels.data(),
+            w,
+            size,
+            rgba_format(PixelAlpha::kPremultiplied),
+            dst.data(),
+            dstStride,
+            3);
+  EXPECT_EQ(std::vector<uint8_t>({ 0, 1, 2, 3, 9, 9, 0, 1, 3, 3, 9, 9 }), dst);
+
+  // Straight alpha without transparent index: (100,0,0) is black
+  index.map(pixels.data(), w, size, rgba_format(PixelAlpha::kStraight), dst.data(), dstStride);
+  EXPECT_EQ(std::vector<uint8_t>({ 0, 1, 2, 1, 9, 9, 0, 0, 2, 0, 9, 9 }), dst);
+}
+
+TEST(PaletteIndex, MapInParallel)
+{
+  std::mt19937 rng(2);
+  const std::vector<gfx::Color> palette = random_palette(rng, 64);
+  const PaletteIndex index(palette.data(), int(palette.size()));
+
+  const int w = 123, h = 456;
+  std::vector<uint32_t> pixels(w * h);
+  for (uint32_t& c : pixels)
+    c = gfx::rgba(rng() % 256, rng() % 256, rng() % 256);
+  const SurfaceFormatData fd = rgba_format(PixelAlpha::kStraight);
+
+  base::thread_pool pool(3);
+  std::vector<uint8_t> a(w * h), b(w * h);
+  index.map(pixels.data(), w, gfx::Size(w, h), fd, a.data(), w);
+  index.map(pixels.data(), w, gfx::Size(w, h), fd, b.data(), w, -1, &pool);
+  EXPECT_EQ(a, b);
+  for (int i = 0; i < w * h; ++i)
+    ASSERT_EQ(linear_search(palette, ColorMetric(), pixels[i]), a[i]);
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
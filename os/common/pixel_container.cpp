@@ -0,0 +1,562 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/pixel_container.h"
+
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/process.h"
+#include "base/thread_pool.h"
+#include "gfx/color_space.h"
+#include "gfx/rect.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+constexpr char kMagic[8] = { 'L', 'A', 'F', 'P', 'I', 'X', 'E', 'L' };
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kCompressedFlag = 1;
+constexpr int kTileSize = 128;
+constexpr std::size_t kRowAlignment = 64;
+
+// Minimum match, maximum distance, and hash table size of the LZ
+// compressor
+constexpr std::size_t kLzMinMatch = 4;
+constexpr std::size_t kLzMaxDistance = 65535;
+constexpr int kLzHashBits = 14;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t headerSize;
+  uint32_t flags;
+  uint32_t width;
+  uint32_t height;
+  uint32_t rowBytes; // Bytes between rows (uncompressed pixels)
+  uint32_t tileSize; // Size of the tiles (compressed pixels)
+  // SurfaceFormatData fields
+  uint32_t format;
+  uint32_t bitsPerPixel;
+  uint32_t redShift;
+  uint32_t greenShift;
+  uint32_t blueShift;
+  uint32_t alphaShift;
+  uint32_t redMask;
+  uint32_t greenMask;
+  uint32_t blueMask;
+  uint32_t alphaMask;
+  uint32_t pixelAlpha;
+  uint32_t reserved1;
+  uint64_t colorSpaceHash;
+  uint64_t fileSize;
+  uint8_t reserved2[24];
+};
+
+// The pixels start after the header aligned to 64 bytes
+static_assert(sizeof(Header) == 128, "Invalid pixel container header size");
+
+uint64_t fnv1a(uint64_t hash, const void* data, const std::size_t size)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  for (std::size_t i = 0; i < size; ++i)
+    hash = (hash ^ p[i]) * 0x100000001b3ull;
+  return hash;
+}
+
+uint32_t load32(const uint8_t* p)
+{
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+void put_length(std::vector<uint8_t>& out, std::size_t n)
+{
+  for (; n >= 255; n -= 255)
+    out.push_back(255);
+  out.push_back(uint8_t(n));
+}
+
+// Compresses "src" with a greedy LZ77 compressor. The output is a
+// sequence of: a token (4 bits for the number of literals, 4 bits
+// for the match length), extra length bytes, literals, 16-bit match
+// distance, extra match length bytes. The last sequence only has
+// literals (like LZ4 blocks).
+void lz_compress(const uint8_t* src, const std::size_t n, std::vector<uint8_t>& out)
+{
+  std::vector<int> table(1 << kLzHashBits, -1);
+  std::size_t anchor = 0;
+  std::size_t pos = 0;
+  int misses = 0;
+
+  auto emit = [&out, src](const std::size_t literalsPos,
+                          const std::size_t literals,
+                          const std::size_t distance,
+                          const std::size_t matchLen) {
+    const std::size_t m = (matchLen ? matchLen - kLzMinMatch : 0);
+    out.push_back(uint8_t((std::min<std::size_t>(literals, 15) << 4) |
+                          std::min<std::size_t>(m, 15)));
+    if (literals >= 15)
+      put_length(out, literals - 15);
+    out.insert(out.end(), src + literalsPos, src + literalsPos + literals);
+    if (matchLen) {
+      out.push_back(uint8_t(distance));
+      out.push_back(uint8_t(distance >> 8));
+      if (m >= 15)
+        put_length(out, m - 15);
+    }
+  };
+
+  while (pos + kLzMinMatch <= n) {
+    const uint32_t seq = load32(src + pos);
+    const uint32_t h = (seq * 2654435761u) >> (32 - kLzHashBits);
+    const int candidate = table[h];
+    table[h] = int(pos);
+
+    if (candidate >= 0 && pos - std::size_t(candidate) <= kLzMaxDistance &&
+        load32(src + candidate) == seq) {
+      std::size_t len = kLzMinMatch;
+      while (pos + len < n && src[candidate + len] == src[pos + len])
+        ++len;
+      emit(anchor, pos - anchor, pos - candidate, len);
+      pos += len;
+      anchor = pos;
+      misses = 0;
+    }
+    else {
+      // Skip faster through incompressible data
+      pos += 1 + (misses++ >> 5);
+    }
+  }
+  emit(anchor, n - anchor, 0, 0);
+}
+
+bool read_length(const uint8_t* src, const std::size_t n, std::size_t& ip, std::size_t& len)
+{
+  uint8_t b;
+  do {
+    if (ip >= n)
+      return false;
+    b = src[ip++];
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+bool lz_decompress(const uint8_t* src,
+                   const std::size_t n,
+                   uint8_t* dst,
+                   const std::size_t dstSize)
+{
+  std::size_t ip = 0;
+  std::size_t op = 0;
+  while (ip < n) {
+    const uint8_t token = src[ip++];
+    std::size_t literals = (token >> 4);
+    if (literals == 15 && !read_length(src, n, ip, literals))
+      return false;
+    if (literals > n - ip || literals > dstSize - op)
+      return false;
+    std::memcpy(dst + op, src + ip, literals);
+    ip += literals;
+    op += literals;
+
+    // Last sequence
+    if (ip == n)
+      break;
+
+    if (n - ip < 2)
+      return false;
+    const std::size_t distance = src[ip] | (src[ip + 1] << 8);
+    ip += 2;
+    std::size_t len = (token & 15);
+    if (len == 15 && !read_length(src, n, ip, len))
+      return false;
+    len += kLzMinMatch;
+    if (distance == 0 || distance > op || len > dstSize - op)
+      return false;
+
+    const uint8_t* match = dst + op - distance;
+    if (distance >= len) {
+      std::memcpy(dst + op, match, len);
+    }
+    else {
+      // Overlapped copy (repeated pattern)
+      for (std::size_t i = 0; i < len; ++i)
+        dst[op + i] = match[i];
+    }
+    op += len;
+  }
+  return (op == dstSize);
+}
+
+void convert_row(const uint32_t* src,
+                 const SurfaceFormatData& sf,
+                 uint32_t* dst,
+                 const SurfaceFormatData& df,
+                 const int n)
+{
+  if (sf == df) {
+    std::memcpy(dst, src, 4 * std::size_t(n));
+    return;
+  }
+
+  const bool srcPremultiplied = (sf.pixelAlpha == PixelAlpha::kPremultiplied);
+  const bool dstPremultiplied = (df.pixelAlpha == PixelAlpha::kPremultiplied);
+  for (int x = 0; x < n; ++x) {
+    const uint32_t c = src[x];
+    uint32_t r = (c >> sf.redShift) & 0xff;
+    uint32_t g = (c >> sf.greenShift) & 0xff;
+    uint32_t b = (c >> sf.blueShift) & 0xff;
+    const uint32_t a = (sf.alphaMask ? (c >> sf.alphaShift) & 0xff : 255);
+    if (a < 255 && srcPremultiplied != dstPremultiplied) {
+      if (dstPremultiplied) {
+        r = (r * a + 127) / 255;
+        g = (g * a + 127) / 255;
+        b = (b * a + 127) / 255;
+      }
+      else if (a == 0) {
+        r = g = b = 0;
+      }
+      else {
+        r = std::min<uint32_t>(255, (r * 255 + a / 2) / a);
+        g = std::min<uint32_t>(255, (g * 255 + a / 2) / a);
+        b = std::min<uint32_t>(255, (b * 255 + a / 2) / a);
+      }
+    }
+    dst[x] = (r << df.redShift) | (g << df.greenShift) | (b << df.blueShift) |
+             (df.alphaMask ? a << df.alphaShift : 0);
+  }
+}
+
+int tiles_count(const int size)
+{
+  return (size + kTileSize - 1) / kTileSize;
+}
+
+gfx::Rect tile_bounds(const int index, const int width, const int height)
+{
+  const int cols = tiles_count(width);
+  const int x = (index % cols) * kTileSize;
+  const int y = (index / cols) * kTileSize;
+  return gfx::Rect(x, y, std::min(kTileSize, width - x), std::min(kTileSize, height - y));
+}
+
+bool write_tiles(FILE* f,
+                 const uint32_t* src,
+                 const int width,
+                 const int height,
+                 const int srcStride,
+                 base::thread_pool* pool)
+{
+  const int cols = tiles_count(width);
+  const int ntiles = cols * tiles_count(height);
+
+  // Table of offsets of each tile (and the end of the last one)
+  std::vector<uint64_t> offsets(ntiles + 1);
+  uint64_t offset = sizeof(Header) + offsets.size() * sizeof(uint64_t);
+  if (std::fseek(f, long(offset), SEEK_SET) != 0)
+    return false;
+
+  // Tiles are compressed one row of tiles at a time
+  for (int first = 0; first < ntiles; first += cols) {
+    std::vector<std::vector<uint8_t>> compressed(cols);
+    base::for_each_task(pool, cols, 1, [&](const int i1, const int i2) {
+      for (int i = i1; i < i2; ++i) {
+        const gfx::Rect rc = tile_bounds(first + i, width, height);
+        std::vector<uint8_t> raw(4 * std::size_t(rc.w) * rc.h);
+        for (int y = 0; y < rc.h; ++y) {
+          std::memcpy(&raw[4 * std::size_t(y) * rc.w],
+                      src + std::size_t(rc.y + y) * srcStride + rc.x,
+                      4 * std::size_t(rc.w));
+        }
+        lz_compress(raw.data(), raw.size(), compressed[i]);
+        // Tiles that cannot be compressed are stored as they are
+        if (compressed[i].size() >= raw.size())
+          compressed[i] = std::move(raw);
+      }
+    });
+
+    for (int i = 0; i < cols; ++i) {
+      offsets[first + i] = offset;
+      offset += compressed[i].size();
+      if (std::fwrite(compressed[i].data(), 1, compressed[i].size(), f) != compressed[i].size())
+        return false;
+    }
+  }
+  offsets[ntiles] = offset;
+
+  return (std::fseek(f, sizeof(Header), SEEK_SET) == 0 &&
+          std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), f) == offsets.size());
+}
+
+bool write_rows(FILE* f,
+                const uint32_t* src,
+                const int width,
+                const int height,
+                const int srcStride,
+                const std::size_t rowBytes)
+{
+  std::vector<uint8_t> row(rowBytes, 0);
+  for (int y = 0; y < height; ++y) {
+    std::memcpy(row.data(), src + std::size_t(y) * srcStride, 4 * std::size_t(width));
+    if (std::fwrite(row.data(), 1, rowBytes, f) != rowBytes)
+      return false;
+  }
+  return true;
+}
+
+const Header* header_of(const base::MappedFile& file)
+{
+  return (const Header*)file->data();
+}
+
+const uint64_t* tile_offsets(const base::MappedFile& file)
+{
+  return (const uint64_t*)(file->data() + sizeof(Header));
+}
+
+// Returns a name for the temporary file where a container is written
+// (unique for each thread/process writing the same file).
+std::string temp_filename(const char* filename)
+{
+  static std::atomic<uint32_t> counter(0);
+  return std::string(filename) + "." + std::to_string(base::get_current_process_id()) + "." +
+         std::to_string(counter++) + ".tmp";
+}
+
+} // anonymous namespace
+
+uint64_t color_space_hash(const gfx::ColorSpace* colorSpace)
+{
+  if (!colorSpace)
+    return 0;
+
+  const uint32_t type = colorSpace->type();
+  const uint32_t flags = colorSpace->flags();
+  const float gamma = colorSpace->gamma();
+  uint64_t hash = 0xcbf29ce484222325ull;
+  hash = fnv1a(hash, &type, sizeof(type));
+  hash = fnv1a(hash, &flags, sizeof(flags));
+  hash = fnv1a(hash, &gamma, sizeof(gamma));
+  hash = fnv1a(hash, colorSpace->rawData().data(), colorSpace->rawData().size());
+  return (hash ? hash : 1);
+}
+
+bool write_pixel_container(const char* filename,
+                           const uint32_t* src,
+                           const int width,
+                           const int height,
+                           const int srcStride,
+                           const SurfaceFormatData& fd,
+                           const uint64_t colorSpaceHash,
+                           const bool compress,
+                           base::thread_pool* pool)
+{
+  if (fd.bitsPerPixel != 32 || width <= 0 || height <= 0 || srcStride < width)
+    return false;
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byteOrder = kByteOrder;
+  header.headerSize = sizeof(Header);
+  header.flags = (compress ? kCompressedFlag : 0);
+  header.width = width;
+  header.height = height;
+  header.rowBytes = uint32_t((4 * std::size_t(width) + kRowAlignment - 1) / kRowAlignment *
+                             kRowAlignment);
+  header.tileSize = kTileSize;
+  header.format = fd.format;
+  header.bitsPerPixel = fd.bitsPerPixel;
+  header.redShift = fd.redShift;
+  header.greenShift = fd.greenShift;
+  header.blueShift = fd.blueShift;
+  header.alphaShift = fd.alphaShift;
+  header.redMask = fd.redMask;
+  header.greenMask = fd.greenMask;
+  header.blueMask = fd.blueMask;
+  header.alphaMask = fd.alphaMask;
+  header.pixelAlpha = uint32_t(fd.pixelAlpha);
+  header.colorSpaceHash = colorSpaceHash;
+
+  // The file is written in a temporary file and then replaced, so
+  // surfaces loaded with load_raw_surface() that still map the old
+  // file are not modified
+  const std::string tmp = temp_filename(filename);
+  bool ok;
+  {
+    base::FileHandle file = base::open_file(tmp, "wb");
+    if (!file)
+      return false;
+
+    FILE* f = file.get();
+    if (compress)
+      ok = write_tiles(f, src, width, height, srcStride, pool);
+    else
+      ok = (std::fseek(f, sizeof(Header), SEEK_SET) == 0 &&
+            write_rows(f, src, width, height, srcStride, header.rowBytes));
+
+    // The header is written at the end with the file size (the
+    // table of tiles is written before), so a partially written file
+    // is never valid
+    if (ok) {
+      const long size = (std::fseek(f, 0, SEEK_END) == 0 ? std::ftell(f) : -1);
+      header.fileSize = uint64_t(size);
+      ok = (size > 0 && std::fseek(f, 0, SEEK_SET) == 0 &&
+            std::fwrite(&header, sizeof(header), 1, f) == 1 && std::fflush(f) == 0);
+    }
+  }
+
+  ok = (ok && base::replace_file(tmp, filename));
+  if (!ok && base::is_file(tmp))
+    base::delete_file(tmp);
+  return ok;
+}
+
+bool PixelContainer::open(const char* filename)
+{
+  close();
+
+  base::MappedFile file = base::map_file(filename);
+  if (!file || file->size() < sizeof(Header))
+    return false;
+
+  const Header* h = header_of(file);
+  if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion ||
+      h->byteOrder != kByteOrder || h->headerSize != sizeof(Header) ||
+      h->fileSize != file->size() || h->bitsPerPixel != 32 || h->width == 0 || h->height == 0 ||
+      h->width > 0x7fff'ffff / 4 || h->height > 0x7fff'ffff || h->tileSize != kTileSize ||
+      h->pixelAlpha > uint32_t(PixelAlpha::kStraight)) {
+    return false;
+  }
+
+  const bool compressed = (h->flags & kCompressedFlag ? true : false);
+  const uint64_t size = file->size();
+  if (compressed) {
+    const uint64_t ntiles = uint64_t(tiles_count(h->width)) * tiles_count(h->height);
+    if ((size - sizeof(Header)) / sizeof(uint64_t) < ntiles + 1)
+      return false;
+
+    // Offsets must be inside the file and in order
+    const uint64_t* offsets = tile_offsets(file);
+    uint64_t prev = sizeof(Header) + (ntiles + 1) * sizeof(uint64_t);
+    for (uint64_t i = 0; i <= ntiles; ++i) {
+      if (offsets[i] < prev || offsets[i] > size)
+        return false;
+      prev = offsets[i];
+    }
+  }
+  else {
+    if (h->rowBytes % kRowAlignment != 0 || h->rowBytes < 4 * uint64_t(h->width) ||
+        (size - sizeof(Header)) / h->rowBytes < h->height) {
+      return false;
+    }
+  }
+
+  m_file = std::move(file);
+  m_rowBytes = h->rowBytes;
+  m_info.width = int(h->width);
+  m_info.height = int(h->height);
+  m_info.format.format = SurfaceFormat(h->format);
+  m_info.format.bitsPerPixel = h->bitsPerPixel;
+  m_info.format.redShift = h->redShift;
+  m_info.format.greenShift = h->greenShift;
+  m_info.format.blueShift = h->blueShift;
+  m_info.format.alphaShift = h->alphaShift;
+  m_info.format.redMask = h->redMask;
+  m_info.format.greenMask = h->greenMask;
+  m_info.format.blueMask = h->blueMask;
+  m_info.format.alphaMask = h->alphaMask;
+  m_info.format.pixelAlpha = PixelAlpha(h->pixelAlpha);
+  m_info.colorSpaceHash = h->colorSpaceHash;
+  m_info.compressed = compressed;
+  return true;
+}
+
+void PixelContainer::close()
+{
+  m_file.reset();
+  m_info = PixelContainerInfo();
+  m_rowBytes = 0;
+}
+
+const uint32_t* PixelContainer::pixels() const
+{
+  if (!m_file || m_info.compressed)
+    return nullptr;
+  return (const uint32_t*)(m_file->data() + sizeof(Header));
+}
+
+bool PixelContainer::read(uint32_t* dst,
+                          const int dstStride,
+                          const SurfaceFormatData& dstFormat,
+                          base::thread_pool* pool) const
+{
+  if (!m_file || dstFormat.bitsPerPixel != 32)
+    return false;
+
+  const int w = m_info.width;
+  const int h = m_info.height;
+  if (!m_info.compressed) {
+    const uint8_t* src = (const uint8_t*)pixels();
+    for (int y = 0; y < h; ++y, src += m_rowBytes)
+      convert_row((const uint32_t*)src,
+                  m_info.format,
+                  dst + std::size_t(y) * dstStride,
+                  dstFormat,
+                  w);
+    return true;
+  }
+
+  const uint64_t* offsets = tile_offsets(m_file);
+  const int ntiles = tiles_count(w) * tiles_count(h);
+  std::atomic<bool> ok(true);
+  base::for_each_task(pool, ntiles, 1, [&](const int i1, const int i2) {
+    for (int i = i1; i < i2; ++i) {
+      const gfx::Rect rc = tile_bounds(i, w, h);
+      const std::size_t rawSize = 4 * std::size_t(rc.w) * rc.h;
+      const uint8_t* data = m_file->data() + offsets[i];
+      const std::size_t size = std::size_t(offsets[i + 1] - offsets[i]);
+
+      // Tiles are not aligned in the file, so even stored tiles are
+      // copied
+      std::vector<uint32_t> tile(rawSize / 4);
+      if (size == rawSize) {
+        std::memcpy(tile.data(), data, rawSize);
+      }
+      else if (!lz_decompress(data, size, (uint8_t*)tile.data(), rawSize)) {
+        ok = false;
+        return;
+      }
+      for (int y = 0; y < rc.h; ++y) {
+        convert_row(&tile[std::size_t(y) * rc.w],
+                    m_info.format,
+                    dst + std::size_t(rc.y + y) * dstStride + rc.x,
+                    dstFormat,
+                    rc.w);
+      }
+    }
+  });
+  return ok;
+}
+
+} // namespace os
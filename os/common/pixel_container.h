@@ -0,0 +1,100 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_PIXEL_CONTAINER_H_INCLUDED
+#define OS_COMMON_PIXEL_CONTAINER_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "base/mapped_file.h"
+#include "os/surface_format.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace gfx {
+class ColorSpace;
+}
+
+namespace os {
+
+// Raw pixel container files are used to cache surfaces between
+// sessions (thumbnails, previews, atlas pages, etc.). They have a
+// versioned header (with the SurfaceFormatData of the pixels and a
+// hash of their color space) and the 32bpp pixels:
+//
+// * Uncompressed: rows are aligned to 64 bytes, so the file can be
+//   mapped in memory and used directly as the surface pixels.
+// * Compressed: tiles of 128x128 pixels are compressed with a fast
+//   LZ77 compressor (LZ4-like, without entropy coding) so they can
+//   be decompressed in parallel.
+//
+// Files are written in the byte order of the current machine and
+// rejected when they are loaded in a machine with a different byte
+// order (they are caches, not an interchange format).
+
+struct PixelContainerInfo {
+  int width = 0;
+  int height = 0;
+  SurfaceFormatData format = {};
+  uint64_t colorSpaceHash = 0;
+  bool compressed = false;
+};
+
+// Returns a hash of the color space to detect if cached pixels were
+// saved with a different color space (returns 0 for nullptr).
+uint64_t color_space_hash(const gfx::ColorSpace* colorSpace);
+
+// Writes a "width" x "height" image of 32bpp pixels in the "fd"
+// format ("srcStride" in pixels) in a pixel container file. Rows are
+// written one by one (or tile by tile) from "src". If "pool" is not
+// nullptr, tiles are compressed in parallel.
+bool write_pixel_container(const char* filename,
+                           const uint32_t* src,
+                           int width,
+                           int height,
+                           int srcStride,
+                           const SurfaceFormatData& fd,
+                           uint64_t colorSpaceHash,
+                           bool compress,
+                           base::thread_pool* pool = nullptr);
+
+// Read-only pixel container mapped in memory.
+class PixelContainer {
+public:
+  // Maps and validates the file header (pixels are not read).
+  bool open(const char* filename);
+  void close();
+
+  bool isOpen() const { return m_file != nullptr; }
+  const PixelContainerInfo& info() const { return m_info; }
+
+  // Returns the mapped pixels (rows of rowBytes() bytes aligned to
+  // 64 bytes), or nullptr if the pixels are compressed.
+  const uint32_t* pixels() const;
+  std::size_t rowBytes() const { return m_rowBytes; }
+
+  // The mapped file, it can be used as the owner of the pixels.
+  const base::MappedFile& file() const { return m_file; }
+
+  // Copies or decompresses the pixels to "dst" ("dstStride" in
+  // pixels) converting them to the "dstFormat" (32bpp) if needed.
+  // Returns false if the compressed data is corrupted.
+  bool read(uint32_t* dst,
+            int dstStride,
+            const SurfaceFormatData& dstFormat,
+            base::thread_pool* pool = nullptr) const;
+
+private:
+  base::MappedFile m_file;
+  PixelContainerInfo m_info;
+  std::size_t m_rowBytes = 0;
+};
+
+} // namespace os
+
+#endif
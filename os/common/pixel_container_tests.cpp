@@ -0,0 +1,270 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/thread_pool.h"
+#include "gfx/color_space.h"
+#include "gfx/size.h"
+#include "os/common/pixel_container.h"
+#include "os/common/test_support.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace os;
+
+static const char* kFilename = "_test_pixels_.tmp";
+
+static const SurfaceFormatData kRgba = rgba_format(PixelAlpha::kPremultiplied);
+
+// Premultiplied image with flat areas, gradients, and some noise.
+static std::vector<uint32_t> make_image(const int w, const int h, const int stride)
+{
+  std::mt19937 rng(w + h);
+  std::vector<uint32_t> pixels(std::size_t(stride) * h);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      uint32_t c;
+      if ((x / 16 + y / 16) % 3 == 0)
+        c = 0xff336699;
+      else if (y % 5 == 0)
+        c = rng() | 0xff000000;
+      else
+        c = (x & 255) | ((y & 255) << 8) | 0xff000000;
+      pixels[std::size_t(y) * stride + x] = c;
+    }
+  }
+  return pixels;
+}
+
+static void write_file(const std::vector<uint8_t>& data)
+{
+  base::write_file_content(kFilename, data.data(), data.size());
+}
+
+static void expect_pixels(const std::vector<uint32_t>& expected,
+                          const int w,
+                          const int h,
+                          const int stride,
+                          const std::vector<uint32_t>& actual)
+{
+  ASSERT_EQ(std::size_t(w) * h, actual.size());
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      ASSERT_EQ(expected[std::size_t(y) * stride + x], actual[std::size_t(y) * w + x])
+        << x << "," << y;
+    }
+  }
+}
+
+TEST(PixelContainer, Uncompressed)
+{
+  TempFile tmp(kFilename);
+  for (const gfx::Size& size : { gfx::Size(1, 1), gfx::Size(17, 3), gfx::Size(300, 200) }) {
+    const int stride = size.w + 5;
+    const std::vector<uint32_t> pixels = make_image(size.w, size.h, stride);
+    ASSERT_TRUE(write_pixel_container(kFilename,
+                                      pixels.data(),
+                                      size.w,
+                                      size.h,
+                                      stride,
+                                      kRgba,
+                                      1234,
+                                      false));
+
+    PixelContainer container;
+    ASSERT_TRUE(container.open(kFilename));
+    const PixelContainerInfo& info = container.info();
+    EXPECT_EQ(size.w, info.width);
+    EXPECT_EQ(size.h, info.height);
+    EXPECT_TRUE(info.format == kRgba);
+    EXPECT_EQ(1234, info.colorSpaceHash);
+    EXPECT_FALSE(info.compressed);
+
+    // Mapped rows are aligned to 64 bytes
+    const uint32_t* mapped = container.pixels();
+    ASSERT_NE(nullptr, mapped);
+    EXPECT_EQ(0, container.rowBytes() % 64);
+    EXPECT_EQ(0, uintptr_t(mapped) % 64);
+    for (int y = 0; y < size.h; ++y) {
+      const uint32_t* row = (const uint32_t*)((const uint8_t*)mapped + y * container.rowBytes());
+      ASSERT_EQ(0, std::memcmp(row, &pixels[std::size_t(y) * stride], 4 * size.w)) << y;
+    }
+
+    std::vector<uint32_t> result(std::size_t(size.w) * size.h);
+    ASSERT_TRUE(container.read(result.data(), size.w, kRgba));
+    expect_pixels(pixels, size.w, size.h, stride, result);
+  }
+}
+
+TEST(PixelContainer, RewriteMappedFile)
+{
+  TempFile tmp(kFilename);
+  const int w = 70, h = 30;
+  const std::vector<uint32_t> a = make_image(w, h, w);
+  const std::vector<uint32_t> b(std::size_t(w) * h, 0xff00ff00);
+  ASSERT_TRUE(write_pixel_container(kFilename, a.data(), w, h, w, kRgba, 0, false));
+
+  PixelContainer mapped;
+  ASSERT_TRUE(mapped.open(kFilename));
+
+  // The file is replaced (on Windows a mapped file cannot be
+  // replaced), but the mapped pixels are not modified
+  const bool written = write_pixel_container(kFilename, b.data(), w, h, w, kRgba, 0, false);
+#if !LAF_WINDOWS
+  EXPECT_TRUE(written);
+#endif
+  for (int y = 0; y < h; ++y) {
+    const uint32_t* row =
+      (const uint32_t*)((const uint8_t*)mapped.pixels() + y * mapped.rowBytes());
+    ASSERT_EQ(0, std::memcmp(row, &a[std::size_t(y) * w], 4 * w)) << y;
+  }
+
+  PixelContainer container;
+  ASSERT_TRUE(container.open(kFilename));
+  std::vector<uint32_t> result(std::size_t(w) * h);
+  ASSERT_TRUE(container.read(result.data(), w, kRgba));
+  expect_pixels(written ? b : a, w, h, w, result);
+}
+
+TEST(PixelContainer, Compressed)
+{
+  TempFile tmp(kFilename);
+  base::thread_pool pool(3);
+  for (const gfx::Size& size :
+       { gfx::Size(1, 1), gfx::Size(128, 128), gfx::Size(129, 257), gfx::Size(500, 300) }) {
+    for (base::thread_pool* p : { (base::thread_pool*)nullptr, &pool }) {
+      const std::vector<uint32_t> pixels = make_image(size.w, size.h, size.w);
+      ASSERT_TRUE(write_pixel_container(kFilename,
+                                        pixels.data(),
+                                        size.w,
+                                        size.h,
+                                        size.w,
+                                        kRgba,
+                                        0,
+                                        true,
+                                        p));
+
+      PixelContainer container;
+      ASSERT_TRUE(container.open(kFilename));
+      EXPECT_TRUE(container.info().compressed);
+      EXPECT_EQ(nullptr, container.pixels());
+
+      std::vector<uint32_t> result(std::size_t(size.w) * size.h);
+      ASSERT_TRUE(container.read(result.data(), size.w, kRgba, p));
+      expect_pixels(pixels, size.w, size.h, size.w, result);
+    }
+  }
+
+  // Compressible pixels use less space
+  const std::vector<uint32_t> flat(512 * 512, 0xff00ff00);
+  ASSERT_TRUE(write_pixel_container(kFilename, flat.data(), 512, 512, 512, kRgba, 0, true, &pool));
+  EXPECT_LT(base::read_file_content(kFilename).size(), flat.size() * 4 / 50);
+}
+
+TEST(PixelContainer, ConvertFormat)
+{
+  TempFile tmp(kFilename);
+  const int w = 130, h = 40;
+  std::vector<uint32_t> pixels = make_image(w, h, w);
+  for (std::size_t i = 0; i < pixels.size(); i += 3)
+    pixels[i] = 0x80402010; // Premultiplied with alpha=128
+  pixels[1] = 0;
+
+  // BGRA straight alpha
+  SurfaceFormatData bgra = rgba_format(PixelAlpha::kStraight);
+  bgra.redShift = 16;
+  bgra.blueShift = 0;
+  bgra.redMask = 0x00ff0000;
+  bgra.blueMask = 0x000000ff;
+
+  for (const bool compress : { false, true }) {
+    ASSERT_TRUE(write_pixel_container(kFilename, pixels.data(), w, h, w, kRgba, 0, compress));
+    PixelContainer container;
+    ASSERT_TRUE(container.open(kFilename));
+    std::vector<uint32_t> result(std::size_t(w) * h);
+    ASSERT_TRUE(container.read(result.data(), w, bgra));
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      const uint32_t c = pixels[i];
+      uint32_t expected = c;
+      if (c == 0x80402010)
+        expected = 0x80204080; // Unpremultiplied and swapped
+      else if (c != 0)
+        expected = (c & 0xff00ff00) | ((c >> 16) & 0xff) | ((c & 0xff) << 16);
+      ASSERT_EQ(expected, result[i]) << i;
+    }
+  }
+}
+
+TEST(PixelContainer, ColorSpaceHash)
+{
+  EXPECT_EQ(0, color_space_hash(nullptr));
+  const gfx::ColorSpaceRef srgb = gfx::ColorSpace::MakeSRGB();
+  EXPECT_NE(0, color_space_hash(srgb.get()));
+  EXPECT_EQ(color_space_hash(srgb.get()), color_space_hash(gfx::ColorSpace::MakeSRGB().get()));
+  EXPECT_NE(color_space_hash(srgb.get()),
+            color_space_hash(gfx::ColorSpace::MakeLinearSRGB().get()));
+  EXPECT_NE(color_space_hash(gfx::ColorSpace::MakeSRGBWithGamma(2.2f).get()),
+            color_space_hash(gfx::ColorSpace::MakeSRGBWithGamma(1.8f).get()));
+}
+
+TEST(PixelContainer, InvalidFiles)
+{
+  TempFile tmp(kFilename);
+  PixelContainer container;
+  EXPECT_FALSE(container.open("_test_pixels_.does_not_exist.tmp"));
+
+  const int w = 200, h = 150;
+  const std::vector<uint32_t> pixels = make_image(w, h, w);
+  for (const bool compress : { false, true }) {
+    ASSERT_TRUE(write_pixel_container(kFilename, pixels.data(), w, h, w, kRgba, 0, compress));
+    const std::vector<uint8_t> data = base::read_file_content(kFilename);
+
+    // Truncated file
+    write_file(std::vector<uint8_t>(data.begin(), data.end() - 1));
+    EXPECT_FALSE(container.open(kFilename));
+    write_file(std::vector<uint8_t>(data.begin(), data.begin() + 64));
+    EXPECT_FALSE(container.open(kFilename));
+
+    // Bad signature and version
+    for (const int i : { 0, 8 }) {
+      std::vector<uint8_t> bad = data;
+      bad[i] ^= 1;
+      write_file(bad);
+      EXPECT_FALSE(container.open(kFilename)) << i;
+    }
+  }
+
+  // Corrupted compressed tiles can be opened but not read
+  ASSERT_TRUE(write_pixel_container(kFilename, pixels.data(), w, h, w, kRgba, 0, true));
+  std::vector<uint8_t> data = base::read_file_content(kFilename);
+  std::mt19937 rng(1);
+  for (std::size_t i = data.size() / 2; i < data.size(); ++i)
+    data[i] = uint8_t(rng());
+  write_file(data);
+  ASSERT_TRUE(container.open(kFilename));
+  std::vector<uint32_t> result(std::size_t(w) * h);
+  EXPECT_FALSE(container.read(result.data(), w, kRgba));
+
+  // Invalid arguments
+  EXPECT_FALSE(write_pixel_container(kFilename, pixels.data(), 0, h, w, kRgba, 0, false));
+  EXPECT_FALSE(write_pixel_container(kFilename, pixels.data(), w, h, w - 1, kRgba, 0, false));
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,417 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/resample.h"
+
+#include "base/debug.h"
+#include "base/simd.h"
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+#include "os/common/surface_utils.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace os {
+
+namespace {
+
+// Weights are fixed point numbers with this number of fractional
+// bits (1.0 = 16384 fits in a int16_t, and 255*16384*taps fits in a
+// int32_t accumulator).
+constexpr int kPrecisionBits = 14;
+constexpr int kOne = (1 << kPrecisionBits);
+
+// Number of destination rows calculated by each task sent to the
+// thread pool.
+constexpr int kRowsPerTask = 64;
+
+class FilterKernel {
+public:
+  enum class Type { Nearest, Box, Linear, Cubic, Lanczos };
+
+  FilterKernel(const Sampling& sampling)
+  {
+    if (sampling.kernel == Sampling::Kernel::Box)
+      m_type = Type::Box;
+    else if (sampling.kernel == Sampling::Kernel::Lanczos)
+      m_type = Type::Lanczos;
+    else if (sampling.useCubic) {
+      m_type = Type::Cubic;
+      m_B = sampling.cubic.B;
+      m_C = sampling.cubic.C;
+    }
+    else if (sampling.filter == Sampling::Filter::Linear)
+      m_type = Type::Linear;
+    else
+      m_type = Type::Nearest;
+  }
+
+  Type type() const { return m_type; }
+
+  // Radius of the filter in source pixels (when the image is not
+  // reduced).
+  double support() const
+  {
+    switch (m_type) {
+      case Type::Nearest:
+      case Type::Box:     return 0.5;
+      case Type::Linear:  return 1.0;
+      case Type::Cubic:   return 2.0;
+      case Type::Lanczos: return 3.0;
+    }
+    return 0.0;
+  }
+
+  double operator()(const double x) const
+  {
+    switch (m_type) {
+      // Same pixel as Skia: floor() of the sampling position
+      case Type::Nearest: return (x > -0.5 && x <= 0.5 ? 1.0 : 0.0);
+      case Type::Box:     return (x >= -0.5 && x < 0.5 ? 1.0 : 0.0);
+      case Type::Linear:  return std::max(0.0, 1.0 - std::fabs(x));
+      case Type::Cubic:   return cubic(std::fabs(x));
+      case Type::Lanczos: return lanczos3(x);
+    }
+    return 0.0;
+  }
+
+private:
+  // Mitchell-Netravali family of cubic filters
+  double cubic(const double x) const
+  {
+    const double B = m_B;
+    const double C = m_C;
+    if (x < 1.0) {
+      return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) /
+             6.0;
+    }
+    if (x < 2.0) {
+      return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x +
+              (8 * B + 24 * C)) /
+             6.0;
+    }
+    return 0.0;
+  }
+
+  static double lanczos3(const double x)
+  {
+    constexpr double kPi = 3.14159265358979323846;
+    if (x == 0.0)
+      return 1.0;
+    if (x <= -3.0 || x >= 3.0)
+      return 0.0;
+    const double px = kPi * x;
+    return 3.0 * std::sin(px) * std::sin(px / 3.0) / (px * px);
+  }
+
+  Type m_type;
+  double m_B = 0.0;
+  double m_C = 0.0;
+};
+
+// Source pixels and weights used to calculate each destination
+// column (or row).
+struct WeightTable {
+  int taps = 0;                 // Number of weights of each destination pixel
+  std::vector<int> first;       // First source pixel of each destination pixel
+  std::vector<int16_t> weights; // "taps" weights of each destination pixel
+
+  const int16_t* at(const int i) const { return &weights[std::size_t(i) * taps]; }
+};
+
+// Creates the weight table to calculate "count" destination pixels
+// starting from "dstFirst" (when a "srcSize" line is scaled to
+// "dstSize").
+WeightTable make_weights(const FilterKernel& kernel,
+                         const int srcSize,
+                         const int dstSize,
+                         const int dstFirst,
+                         const int count)
+{
+  const double scale = double(srcSize) / dstSize;
+  // The filter is widened when the image is reduced to use all
+  // source pixels.
+  const double filterScale = (kernel.type() == FilterKernel::Type::Nearest ? 1.0 :
+                                                                             std::max(1.0, scale));
+  const double support = kernel.support() * filterScale;
+
+  WeightTable table;
+  table.taps = std::min(srcSize, 2 * int(std::ceil(support)) + 1);
+  table.first.resize(count);
+  table.weights.resize(std::size_t(count) * table.taps);
+
+  std::vector<double> w(table.taps);
+  for (int i = 0; i < count; ++i) {
+    // Center of the destination pixel in source coordinates
+    const double center = (dstFirst + i + 0.5) * scale - 0.5;
+    const int j1 = int(std::floor(center - support));
+    const int j2 = int(std::ceil(center + support));
+    const int first = std::min(std::clamp(j1, 0, srcSize - 1), srcSize - table.taps);
+
+    std::fill(w.begin(), w.end(), 0.0);
+    double total = 0.0;
+    for (int j = j1; j <= j2; ++j) {
+      const double v = kernel((j - center) / filterScale);
+      const int k = std::clamp(j, 0, srcSize - 1) - first;
+      if (v == 0.0 || k < 0 || k >= table.taps)
+        continue;
+      w[k] += v;
+      total += v;
+    }
+    if (total == 0.0) {
+      const int k = std::clamp(int(std::lround(center)), 0, srcSize - 1) - first;
+      w[std::clamp(k, 0, table.taps - 1)] = total = 1.0;
+    }
+
+    // Convert to fixed point, the rounding error is added to the
+    // biggest weight so the sum is exactly 1.0 (and solid colors
+    // keep their exact value).
+    int16_t* out = &table.weights[std::size_t(i) * table.taps];
+    int sum = 0;
+    int biggest = 0;
+    for (int k = 0; k < table.taps; ++k) {
+      out[k] = int16_t(std::lround(w[k] / total * kOne));
+      sum += out[k];
+      if (out[k] > out[biggest])
+        biggest = k;
+    }
+    out[biggest] += int16_t(kOne - sum);
+    table.first[i] = first;
+  }
+  return table;
+}
+
+inline uint32_t to_pixel(const int acc[4])
+{
+  uint32_t result = 0;
+  for (int c = 0; c < 4; ++c)
+    result |= uint32_t(std::clamp(acc[c] >> kPrecisionBits, 0, 255)) << (c * 8);
+  return result;
+}
+
+// Makes each color channel <= alpha (negative lobes of the filters
+// can create invalid premultiplied colors).
+inline uint32_t fix_premultiplied(const uint32_t p, const int alphaShift)
+{
+  const uint32_t a = (p >> alphaShift) & 0xff;
+  uint32_t result = 0;
+  for (int c = 0; c < 4; ++c)
+    result |= std::min((p >> (c * 8)) & 0xff, a) << (c * 8);
+  return result;
+}
+
+#if LAF_SSE2
+// Returns a (w0, w1) pair of 16-bit weights in each 32-bit lane to
+// multiply them with _mm_madd_epi16().
+inline __m128i weight_pair(const int16_t w0, const int16_t w1)
+{
+  return _mm_set1_epi32(int(uint32_t(uint16_t(w0)) | (uint32_t(uint16_t(w1)) << 16)));
+}
+#endif
+
+void horizontal_pass(const uint32_t* srcRow, const WeightTable& wx, uint32_t* out, const int count)
+{
+  const int taps = wx.taps;
+  for (int i = 0; i < count; ++i) {
+    const uint32_t* p = srcRow + wx.first[i];
+    const int16_t* w = wx.at(i);
+
+#if LAF_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_set1_epi32(kOne / 2);
+    int t = 0;
+    for (; t + 2 <= taps; t += 2) {
+      // Channels of two pixels interleaved as 16-bit values (p0c0,
+      // p1c0, p0c1, p1c1, ...) to multiply them with (w0, w1) pairs
+      const __m128i pix = _mm_loadl_epi64((const __m128i*)(p + t));
+      const __m128i pair = _mm_unpacklo_epi8(_mm_unpacklo_epi8(pix, _mm_srli_si128(pix, 4)), zero);
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(pair, weight_pair(w[t], w[t + 1])));
+    }
+    if (t < taps) {
+      const __m128i pix = _mm_cvtsi32_si128(int(p[t]));
+      const __m128i single = _mm_unpacklo_epi8(_mm_unpacklo_epi8(pix, zero), zero);
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(single, weight_pair(w[t], 0)));
+    }
+    acc = _mm_srai_epi32(acc, kPrecisionBits);
+    acc = _mm_packs_epi32(acc, acc);
+    out[i] = uint32_t(_mm_cvtsi128_si32(_mm_packus_epi16(acc, acc)));
+#else
+    int acc[4] = { kOne / 2, kOne / 2, kOne / 2, kOne / 2 };
+    for (int t = 0; t < taps; ++t) {
+      for (int c = 0; c < 4; ++c)
+        acc[c] += int((p[t] >> (c * 8)) & 0xff) * w[t];
+    }
+    out[i] = to_pixel(acc);
+#endif
+  }
+}
+
+void vertical_pass(const uint32_t* rows,
+                   const int rowStride,
+                   const int16_t* w,
+                   const int taps,
+                   uint32_t* out,
+                   const int count,
+                   const bool premultiplied,
+                   const int alphaShift)
+{
+  int x = 0;
+
+#if LAF_SSE2
+  // Four pixels in each iteration
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 4 <= count; x += 4) {
+    __m128i acc0 = _mm_set1_epi32(kOne / 2);
+    __m128i acc1 = acc0;
+    __m128i acc2 = acc0;
+    __m128i acc3 = acc0;
+    for (int t = 0; t < taps; t += 2) {
+      const bool pair = (t + 1 < taps);
+      const __m128i r0 = _mm_loadu_si128((const __m128i*)(rows + std::size_t(t) * rowStride + x));
+      const __m128i r1 =
+        (pair ? _mm_loadu_si128((const __m128i*)(rows + std::size_t(t + 1) * rowStride + x)) :
+                zero);
+      const __m128i wv = weight_pair(w[t], pair ? w[t + 1] : 0);
+      // Same channel of both rows interleaved as 16-bit values
+      const __m128i lo = _mm_unpacklo_epi8(r0, r1);
+      const __m128i hi = _mm_unpackhi_epi8(r0, r1);
+      acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), wv));
+      acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), wv));
+      acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), wv));
+      acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), wv));
+    }
+    acc0 = _mm_srai_epi32(acc0, kPrecisionBits);
+    acc1 = _mm_srai_epi32(acc1, kPrecisionBits);
+    acc2 = _mm_srai_epi32(acc2, kPrecisionBits);
+    acc3 = _mm_srai_epi32(acc3, kPrecisionBits);
+    __m128i pixels = _mm_packus_epi16(_mm_packs_epi32(acc0, acc1), _mm_packs_epi32(acc2, acc3));
+
+    if (premultiplied) {
+      // Alpha of each pixel in its 4 bytes
+      __m128i a = _mm_srl_epi32(pixels, _mm_cvtsi32_si128(alphaShift));
+      a = _mm_and_si128(a, _mm_set1_epi32(0xff));
+      a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+      a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+      pixels = _mm_min_epu8(pixels, a);
+    }
+    _mm_storeu_si128((__m128i*)(out + x), pixels);
+  }
+#endif
+
+  for (; x < count; ++x) {
+    int acc[4] = { kOne / 2, kOne / 2, kOne / 2, kOne / 2 };
+    for (int t = 0; t < taps; ++t) {
+      const uint32_t p = rows[std::size_t(t) * rowStride + x];
+      for (int c = 0; c < 4; ++c)
+        acc[c] += int((p >> (c * 8)) & 0xff) * w[t];
+    }
+    out[x] = to_pixel(acc);
+    if (premultiplied)
+      out[x] = fix_premultiplied(out[x], alphaShift);
+  }
+}
+
+} // anonymous namespace
+
+void resample(const uint32_t* src,
+              const int srcStride,
+              const gfx::Rect& srcRect,
+              uint32_t* dst,
+              const int dstStride,
+              const gfx::Size& dstSize,
+              const gfx::Rect& dstArea,
+              const SurfaceFormatData& fd,
+              const Sampling& sampling,
+              base::thread_pool* pool)
+{
+  const gfx::Rect area = dstArea & gfx::Rect(dstSize);
+  if (srcRect.isEmpty() || area.isEmpty())
+    return;
+
+  ASSERT(area == dstArea);
+  ASSERT(fd.bitsPerPixel == 32);
+
+  const FilterKernel kernel(sampling);
+  const WeightTable wx = make_weights(kernel, srcRect.w, dstSize.w, area.x, area.w);
+  const WeightTable wy = make_weights(kernel, srcRect.h, dstSize.h, area.y, area.h);
+  const bool premultiplied = (fd.pixelAlpha == PixelAlpha::kPremultiplied &&
+                              fd.alphaMask != 0 && (fd.alphaShift % 8) == 0);
+  const int alphaShift = int(fd.alphaShift);
+
+  // Calculates the destination rows [y1, y2) of the area: first the
+  // source rows that they need are scaled horizontally, then the
+  // vertical pass creates each destination row.
+  auto resampleRows = [&](const int y1, const int y2) {
+    const int firstRow = wy.first[y1];
+    const int nrows = wy.first[y2 - 1] + wy.taps - firstRow;
+    std::vector<uint32_t> tmp(std::size_t(nrows) * area.w);
+
+    for (int r = 0; r < nrows; ++r) {
+      horizontal_pass(src + std::size_t(srcRect.y + firstRow + r) * srcStride + srcRect.x,
+                      wx,
+                      &tmp[std::size_t(r) * area.w],
+                      area.w);
+    }
+    for (int y = y1; y < y2; ++y) {
+      vertical_pass(&tmp[std::size_t(wy.first[y] - firstRow) * area.w],
+                    area.w,
+                    wy.at(y),
+                    wy.taps,
+                    dst + std::size_t(y) * dstStride,
+                    area.w,
+                    premultiplied,
+                    alphaShift);
+    }
+  };
+
+  // Calculate bands of rows in parallel
+  base::for_each_task(pool, area.h, kRowsPerTask, resampleRows);
+}
+
+void resample_surface(const Surface* src,
+                      const gfx::Rect& srcRect,
+                      Surface* dst,
+                      const gfx::Rect& dstRect,
+                      const Sampling& sampling,
+                      base::thread_pool* pool)
+{
+  const gfx::Rect area = dstRect & dst->bounds();
+  if (area.isEmpty() || srcRect.isEmpty() || !src->bounds().contains(srcRect))
+    return;
+
+  SurfaceLock lockSrc(src);
+  SurfaceLock lockDst(dst);
+
+  SurfaceFormatData fd;
+  dst->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return;
+
+  const uint32_t* srcPixels = (const uint32_t*)src->getData(0, 0);
+  uint32_t* dstPixels = (uint32_t*)dst->getData(area.x, area.y);
+  if (!srcPixels || !dstPixels)
+    return;
+
+  resample(srcPixels,
+           row_stride(src),
+           srcRect,
+           dstPixels,
+           row_stride(dst),
+           dstRect.size(),
+           gfx::Rect(area).offset(-dstRect.origin()),
+           fd,
+           sampling,
+           pool);
+}
+
+} // namespace os
@@ -0,0 +1,66 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_RESAMPLE_H_INCLUDED
+#define OS_COMMON_RESAMPLE_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/sampling.h"
+#include "os/surface_format.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+// Scales the "srcRect" area of the 32bpp image "src" to an image of
+// "dstSize" pixels, calculating only the "dstArea" pixels of it.
+// "dst" points to the first pixel of "dstArea" (strides are in
+// pixels). Pixels outside "srcRect" are never read (the edge pixels
+// are repeated). Both images use the "fd" format.
+//
+// The filter is selected from "sampling":
+// - Kernel::Box: average of the covered source pixels,
+// - Kernel::Lanczos: Lanczos-3 windowed sinc,
+// - useCubic: bicubic with the given B/C parameters,
+// - Filter::Linear: bilinear,
+// - Filter::Nearest: nearest neighbor.
+// Mipmaps are not used: when the image is reduced, the filters are
+// widened to cover all the source pixels (so there is no aliasing).
+//
+// The filters are separable: a horizontal and a vertical pass with
+// weight tables calculated once for each column/row. If "pool" is
+// not nullptr, bands of rows are calculated in parallel.
+void resample(const uint32_t* src,
+              int srcStride,
+              const gfx::Rect& srcRect,
+              uint32_t* dst,
+              int dstStride,
+              const gfx::Size& dstSize,
+              const gfx::Rect& dstArea,
+              const SurfaceFormatData& fd,
+              const Sampling& sampling,
+              base::thread_pool* pool = nullptr);
+
+// Same as resample() for surfaces: scales "srcRect" of "src" to
+// "dstRect" of "dst", replacing the destination pixels (there is no
+// blending). Both surfaces must be 32bpp with the same format.
+void resample_surface(const Surface* src,
+                      const gfx::Rect& srcRect,
+                      Surface* dst,
+                      const gfx::Rect& dstRect,
+                      const Sampling& sampling,
+                      base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
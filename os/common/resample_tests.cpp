@@ -0,0 +1,220 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "gfx/point.h"
+#include "os/common/resample.h"
+#include "os/common/test_support.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace os;
+
+static const Sampling kAllSamplings[] = {
+  Sampling(),
+  Sampling(Sampling::Filter::Linear),
+  Sampling(Sampling::Cubic::Mitchell()),
+  Sampling(Sampling::Cubic::CatmullRom()),
+  Sampling(Sampling::Kernel::Box),
+  Sampling(Sampling::Kernel::Lanczos),
+};
+
+static std::vector<uint32_t> scale(const std::vector<uint32_t>& src,
+                                   const int w,
+                                   const int h,
+                                   const int dw,
+                                   const int dh,
+                                   const Sampling& sampling,
+                                   base::thread_pool* pool = nullptr)
+{
+  std::vector<uint32_t> dst(dw * dh, 0);
+  resample(src.data(),
+           w,
+           gfx::Rect(0, 0, w, h),
+           dst.data(),
+           dw,
+           gfx::Size(dw, dh),
+           gfx::Rect(0, 0, dw, dh),
+           rgba_format(PixelAlpha::kPremultiplied),
+           sampling,
+           pool);
+  return dst;
+}
+
+// Returns a random valid premultiplied RGBA value
+static uint32_t random_pixel(std::mt19937& rng)
+{
+  const uint32_t a = rng() % 256;
+  return (a << 24) | ((rng() % (a + 1)) << 16) | ((rng() % (a + 1)) << 8) | (rng() % (a + 1));
+}
+
+static int max_channel_diff(const uint32_t a, const uint32_t b)
+{
+  int diff = 0;
+  for (int c = 0; c < 4; ++c)
+    diff = std::max(diff, std::abs(int((a >> (c * 8)) & 0xff) - int((b >> (c * 8)) & 0xff)));
+  return diff;
+}
+
+TEST(Resample, SolidColors)
+{
+  const std::vector<uint32_t> src(13 * 7, 0x80402010);
+  for (const Sampling& sampling : kAllSamplings) {
+    for (const gfx::Size& size : { gfx::Size(1, 1), gfx::Size(5, 3), gfx::Size(13, 7),
+                                  gfx::Size(40, 9), gfx::Size(100, 100) }) {
+      for (const uint32_t p : scale(src, 13, 7, size.w, size.h, sampling))
+        ASSERT_EQ(0x80402010, p) << size.w << "x" << size.h;
+    }
+  }
+}
+
+TEST(Resample, SameSize)
+{
+  std::mt19937 rng(1);
+  std::vector<uint32_t> src(17 * 11);
+  for (uint32_t& p : src)
+    p = random_pixel(rng);
+
+  // Interpolating filters must keep the same pixels
+  for (const Sampling& sampling : { Sampling(),
+                                    Sampling(Sampling::Filter::Linear),
+                                    Sampling(Sampling::Cubic::CatmullRom()),
+                                    Sampling(Sampling::Kernel::Box),
+                                    Sampling(Sampling::Kernel::Lanczos) }) {
+    EXPECT_EQ(src, scale(src, 17, 11, 17, 11, sampling));
+  }
+}
+
+TEST(Resample, Nearest)
+{
+  const uint32_t a = 0xff000001, b = 0xff000002, c = 0xff000003, d = 0xff000004;
+  const std::vector<uint32_t> src = { a, b, c, d };
+  const std::vector<uint32_t> expected = { a, a, b, b, a, a, b, b, c, c, d, d, c, c, d, d };
+  EXPECT_EQ(expected, scale(src, 2, 2, 4, 4, Sampling()));
+  EXPECT_EQ(std::vector<uint32_t>{ d }, scale(src, 2, 2, 1, 1, Sampling()));
+}
+
+TEST(Resample, Linear)
+{
+  const std::vector<uint32_t> src = { 0xff000000, 0xff0000ff };
+  const std::vector<uint32_t> expected = { 0xff000000, 0xff000040, 0xff0000bf, 0xff0000ff };
+  EXPECT_EQ(expected, scale(src, 2, 1, 4, 1, Sampling(Sampling::Filter::Linear)));
+}
+
+TEST(Resample, BoxIsAverage)
+{
+  std::mt19937 rng(2);
+  const int w = 24, h = 12;
+  std::vector<uint32_t> src(w * h);
+  for (uint32_t& p : src)
+    p = random_pixel(rng);
+
+  for (const int factor : { 2, 3, 4 }) {
+    const int dw = w / factor;
+    const int dh = h / factor;
+    const std::vector<uint32_t> dst = scale(src, w, h, dw, dh, Sampling(Sampling::Kernel::Box));
+    for (int y = 0; y < dh; ++y) {
+      for (int x = 0; x < dw; ++x) {
+        uint32_t expected = 0;
+        for (int c = 0; c < 4; ++c) {
+          int sum = 0;
+          for (int v = 0; v < factor; ++v) {
+            for (int u = 0; u < factor; ++u)
+              sum += (src[(y * factor + v) * w + x * factor + u] >> (c * 8)) & 0xff;
+          }
+          expected |= uint32_t((sum + factor * factor / 2) / (factor * factor)) << (c * 8);
+        }
+        // The rounding of the horizontal pass can add an error of 1
+        EXPECT_LE(max_channel_diff(expected, dst[y * dw + x]), 1)
+          << factor << " " << x << "," << y;
+      }
+    }
+  }
+}
+
+TEST(Resample, PremultipliedValues)
+{
+  std::mt19937 rng(3);
+  std::vector<uint32_t> src(16 * 16);
+  for (uint32_t& p : src) {
+    // Opaque white or transparent pixels (sharp edges create
+    // overshoots in the filters)
+    p = (rng() % 2 ? 0xffffffff : 0);
+  }
+  for (const Sampling& sampling : kAllSamplings) {
+    for (const gfx::Size& size : { gfx::Size(5, 7), gfx::Size(37, 41) }) {
+      for (const uint32_t p : scale(src, 16, 16, size.w, size.h, sampling)) {
+        const uint32_t a = p >> 24;
+        ASSERT_LE(p & 0xff, a);
+        ASSERT_LE((p >> 8) & 0xff, a);
+        ASSERT_LE((p >> 16) & 0xff, a);
+      }
+    }
+  }
+}
+
+TEST(Resample, SrcRectAndDstArea)
+{
+  // Pixels outside the source rectangle must not be used
+  const int w = 10, h = 10;
+  std::vector<uint32_t> src(w * h, 0xffffffff);
+  const gfx::Rect srcRect(2, 3, 5, 4);
+  for (int y = srcRect.y; y < srcRect.y2(); ++y)
+    for (int x = srcRect.x; x < srcRect.x2(); ++x)
+      src[y * w + x] = 0xff0000ff;
+
+  const gfx::Size dstSize(12, 9);
+  const gfx::Rect dstArea(3, 2, 6, 5);
+  for (const Sampling& sampling : kAllSamplings) {
+    std::vector<uint32_t> dst(dstSize.w * dstSize.h, 0);
+    resample(src.data(),
+             w,
+             srcRect,
+             &dst[dstArea.y * dstSize.w + dstArea.x],
+             dstSize.w,
+             dstSize,
+             dstArea,
+             rgba_format(PixelAlpha::kPremultiplied),
+             sampling);
+    for (int y = 0; y < dstSize.h; ++y) {
+      for (int x = 0; x < dstSize.w; ++x) {
+        const bool inside = dstArea.contains(gfx::Point(x, y));
+        ASSERT_EQ(inside ? 0xff0000ff : 0, dst[y * dstSize.w + x]) << x << "," << y;
+      }
+    }
+  }
+}
+
+TEST(Resample, Parallel)
+{
+  std::mt19937 rng(4);
+  const int w = 300, h = 250;
+  std::vector<uint32_t> src(w * h);
+  for (uint32_t& p : src)
+    p = random_pixel(rng);
+
+  base::thread_pool pool(3);
+  for (const Sampling& sampling : kAllSamplings) {
+    for (const gfx::Size& size : { gfx::Size(97, 83), gfx::Size(450, 700) }) {
+      EXPECT_EQ(scale(src, w, h, size.w, size.h, sampling),
+                scale(src, w, h, size.w, size.h, sampling, &pool));
+    }
+  }
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,204 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/sprite_sheet_font.h"
+
+#include "base/file_handle.h"
+#include "base/simd.h"
+#include "os/common/surface_utils.h"
+#include "os/surface_format.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace os {
+
+namespace {
+
+constexpr const char* kCharsFileHeader = "laf-sprite-sheet-chars";
+constexpr int kCharsFileVersion = 1;
+
+// Returns the index of the first pixel that is equal (or different
+// if "equal" is false) to the given key, or "n" if there is no such
+// pixel.
+int find_pixel(const uint32_t* p, const int n, const uint32_t key, const bool equal)
+{
+  int i = 0;
+#if LAF_SSE2
+  const __m128i k = _mm_set1_epi32(int(key));
+  for (; i + 4 <= n; i += 4) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, k)));
+    if (!equal)
+      mask = ~mask & 0xf;
+    if (mask) {
+      while (!(mask & 1)) {
+        mask >>= 1;
+        ++i;
+      }
+      return i;
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    if ((p[i] == key) == equal)
+      return i;
+  }
+  return n;
+}
+
+} // anonymous namespace
+
+// static
+FontRef SpriteSheetFont::fromSurface(const SurfaceRef& sur)
+{
+  std::vector<gfx::Rect> chars;
+  const int width = sur->width();
+  const int height = sur->height();
+  if (width > 0 && height > 0) {
+    SurfaceLock lock(sur.get(), SurfaceLock::ReadOnly);
+    SurfaceFormatData fd;
+    sur->getFormat(&fd);
+
+    if (fd.bitsPerPixel == 32) {
+      // Opaque red in the surface format
+      const uint32_t red = ((255 << fd.redShift) & fd.redMask) | fd.alphaMask;
+      find_sprite_sheet_chars((const uint32_t*)sur->getData(0, 0),
+                              width,
+                              height,
+                              row_stride(sur.get()),
+                              red,
+                              chars);
+    }
+    // Convert other formats to 32bpp colors
+    else {
+      std::vector<uint32_t> pixels(width * height);
+      for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+          pixels[y * width + x] = sur->getPixel(x, y);
+      find_sprite_sheet_chars(pixels.data(), width, height, width, gfx::rgba(255, 0, 0), chars);
+    }
+  }
+  return fromSurface(sur, chars);
+}
+
+// static
+FontRef SpriteSheetFont::fromSurface(const SurfaceRef& sur, const std::vector<gfx::Rect>& chars)
+{
+  auto font = make_ref<SpriteSheetFont>();
+  font->m_sheet = sur;
+  font->setChars(chars);
+  return font;
+}
+
+void SpriteSheetFont::setChars(const std::vector<gfx::Rect>& chars)
+{
+  m_chars = chars;
+
+  const int missing = 128 - int(' ');
+  m_missingChar = (missing < int(m_chars.size()) ? m_chars[missing] : gfx::Rect());
+}
+
+void find_sprite_sheet_chars(const uint32_t* pixels,
+                             const int width,
+                             const int height,
+                             const int rowStride,
+                             const uint32_t invalidColor,
+                             std::vector<gfx::Rect>& chars)
+{
+  chars.clear();
+  if (width <= 0 || height <= 0)
+    return;
+
+  const uint32_t keyColor = pixels[0];
+
+  // Glyphs are searched in the first row of each band of glyphs, the
+  // next band starts below the last glyph found in the band.
+  gfx::Rect bounds(0, 0, 0, 1);
+  while (true) {
+    const uint32_t* row = pixels + bounds.y * rowStride;
+
+    // Skip the key color
+    bounds.x += find_pixel(row + bounds.x, width - bounds.x, keyColor, false);
+    if (bounds.x >= width) {
+      bounds.x = 0;
+      bounds.y += bounds.h;
+      bounds.h = 1;
+      if (bounds.y >= height)
+        break;
+      continue;
+    }
+
+    bounds.w = find_pixel(row + bounds.x, width - bounds.x, keyColor, true);
+
+    const uint32_t* col = row + bounds.x;
+    bounds.h = 0;
+    while (bounds.y + bounds.h < height && *col != keyColor) {
+      ++bounds.h;
+      col += rowStride;
+    }
+
+    // Using red color in the first pixel of the char indicates that
+    // this glyph shouldn't be used as a valid one.
+    if (row[bounds.x] != invalidColor)
+      chars.push_back(bounds);
+    else
+      chars.push_back(gfx::Rect());
+
+    bounds.x += bounds.w;
+  }
+}
+
+bool save_sprite_sheet_chars(const std::string& filename,
+                             const gfx::Size& sheetSize,
+                             const std::vector<gfx::Rect>& chars)
+{
+  base::FileHandle f(base::open_file(filename, "wb"));
+  if (!f)
+    return false;
+
+  std::fprintf(f.get(), "%s %d\n", kCharsFileHeader, kCharsFileVersion);
+  std::fprintf(f.get(), "%d %d %d\n", sheetSize.w, sheetSize.h, int(chars.size()));
+  for (const gfx::Rect& rc : chars)
+    std::fprintf(f.get(), "%d %d %d %d\n", rc.x, rc.y, rc.w, rc.h);
+  return (std::ferror(f.get()) == 0);
+}
+
+bool load_sprite_sheet_chars(const std::string& filename,
+                             const gfx::Size& sheetSize,
+                             std::vector<gfx::Rect>& chars)
+{
+  base::FileHandle f(base::open_file(filename, "rb"));
+  if (!f)
+    return false;
+
+  char header[32];
+  int version, w, h, n;
+  if (std::fscanf(f.get(), "%31s %d", header, &version) != 2 ||
+      std::strcmp(header, kCharsFileHeader) != 0 || version != kCharsFileVersion ||
+      std::fscanf(f.get(), "%d %d %d", &w, &h, &n) != 3 || w != sheetSize.w ||
+      h != sheetSize.h || n < 0 || n > w * h) {
+    return false;
+  }
+
+  const gfx::Rect sheetBounds(0, 0, w, h);
+  std::vector<gfx::Rect> result(n);
+  for (gfx::Rect& rc : result) {
+    if (std::fscanf(f.get(), "%d %d %d %d", &rc.x, &rc.y, &rc.w, &rc.h) != 4 ||
+        (!rc.isEmpty() && !sheetBounds.contains(rc))) {
+      return false;
+    }
+  }
+
+  chars = std::move(result);
+  return true;
+}
+
+} // namespace os
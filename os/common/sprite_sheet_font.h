@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2012-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,17 +13,17 @@
 #include "base/string.h"
 #include "base/utf8_decode.h"
 #include "gfx/rect.h"
+#include "gfx/size.h"
 #include "os/font.h"
 #include "os/ref.h"
 #include "os/surface.h"
 
+#include <string>
 #include <vector>
 
 namespace os {
 
 class SpriteSheetFont : public Font {
-  static constexpr auto kRedColor = gfx::rgba(255, 0, 0);
-
 public:
   SpriteSheetFont() : m_sheet(nullptr) {}
   ~SpriteSheetFont() {}
@@ -53,6 +53,11 @@ public:
     // Do nothing
   }
 
+  void setSubpixelPositioning(bool state) override
+  {
+    // Do nothing
+  }
+
   bool hasCodePoint(int codepoint) const override
   {
     codepoint -= (int)' ';
@@ -66,73 +71,55 @@ public:
     chr -= (int)' ';
     if (chr >= 0 && chr < (int)m_chars.size())
       return m_chars[chr];
-    if (chr != 128)
-      return getCharBounds(128);
-    return gfx::Rect();
+    return m_missingChar;
   }
 
-  static FontRef fromSurface(const SurfaceRef& sur)
-  {
-    auto font = make_ref<SpriteSheetFont>();
-    font->m_sheet = sur;
+  // All the char bounds (the index 0 is the ' ' char)
+  const std::vector<gfx::Rect>& charsBounds() const { return m_chars; }
 
-    SurfaceLock lock(sur.get());
-    gfx::Rect bounds(0, 0, 1, 1);
-    gfx::Rect charBounds;
+  // Creates the font scanning the sprite sheet to find the glyphs.
+  static FontRef fromSurface(const SurfaceRef& sur);
 
-    while (font->findChar(sur.get(), sur->width(), sur->height(), bounds, charBounds)) {
-      font->m_chars.push_back(charBounds);
-      bounds.x += bounds.w;
-    }
-
-    return font;
-  }
+  // Creates the font with the glyph bounds already known (e.g. loaded
+  // with load_sprite_sheet_chars()), the sheet is not scanned.
+  static FontRef fromSurface(const SurfaceRef& sur, const std::vector<gfx::Rect>& chars);
 
 private:
-  bool findChar(const Surface* sur, int width, int height, gfx::Rect& bounds, gfx::Rect& charBounds)
-  {
-    gfx::Color keyColor = sur->getPixel(0, 0);
-
-    while (sur->getPixel(bounds.x, bounds.y) == keyColor) {
-      bounds.x++;
-      if (bounds.x >= width) {
-        bounds.x = 0;
-        bounds.y += bounds.h;
-        bounds.h = 1;
-        if (bounds.y >= height)
-          return false;
-      }
-    }
-
-    gfx::Color firstCharPixel = sur->getPixel(bounds.x, bounds.y);
-
-    bounds.w = 0;
-    while ((bounds.x + bounds.w < width) &&
-           (sur->getPixel(bounds.x + bounds.w, bounds.y) != keyColor)) {
-      bounds.w++;
-    }
-
-    bounds.h = 0;
-    while ((bounds.y + bounds.h < height) &&
-           (sur->getPixel(bounds.x, bounds.y + bounds.h) != keyColor)) {
-      bounds.h++;
-    }
-
-    // Using red color in the first pixel of the char indicates that
-    // this glyph shouldn't be used as a valid one.
-    if (firstCharPixel != kRedColor)
-      charBounds = bounds;
-    else
-      charBounds = gfx::Rect();
-
-    return !bounds.isEmpty();
-  }
+  void setChars(const std::vector<gfx::Rect>& chars);
 
-private:
   Ref<Surface> m_sheet;
+
+  // Bounds of each char from ' ' (all ASCII chars are in a dense
+  // table), and the char 128 used for missing chars.
   std::vector<gfx::Rect> m_chars;
+  gfx::Rect m_missingChar;
 };
 
+// Finds the bounds of the glyphs in the pixels of a 32bpp sprite
+// sheet ("rowStride" is in pixels). The first pixel is the key color
+// that separates glyphs, and a glyph with "invalidColor" in its first
+// pixel is an empty/unused glyph. Rows are compared in blocks of
+// pixels (with SSE2 when available) instead of pixel by pixel.
+void find_sprite_sheet_chars(const uint32_t* pixels,
+                             int width,
+                             int height,
+                             int rowStride,
+                             uint32_t invalidColor,
+                             std::vector<gfx::Rect>& chars);
+
+// Saves/loads the glyph bounds of a sprite sheet in a text file, so
+// they can be distributed next to the sheet image (as
+// "<sheet-filename>.rects") and the sheet is not scanned when the
+// font is loaded. The size of the sheet is saved to validate the
+// file when it's loaded. System::loadSpriteSheetFont() creates this
+// file the first time it has to scan the sheet.
+bool save_sprite_sheet_chars(const std::string& filename,
+                             const gfx::Size& sheetSize,
+                             const std::vector<gfx::Rect>& chars);
+bool load_sprite_sheet_chars(const std::string& filename,
+                             const gfx::Size& sheetSize,
+                             std::vector<gfx::Rect>& chars);
+
 } // namespace os
 
 #endif
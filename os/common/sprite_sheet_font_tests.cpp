@@ -0,0 +1,148 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "base/fs.h"
+#include "os/common/sprite_sheet_font.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace os;
+
+namespace {
+
+constexpr uint32_t K = 0xff000000; // Key color
+constexpr uint32_t R = 0xff0000ff; // Invalid glyph
+constexpr uint32_t W = 0xffffffff;
+
+// Same algorithm as the previous SpriteSheetFont::findChar() (pixel
+// by pixel, but without reading outside the sheet when a glyph ends
+// at the right edge) to compare the results.
+std::vector<gfx::Rect> find_chars_pixel_by_pixel(const std::vector<uint32_t>& pixels,
+                                                 const int width,
+                                                 const int height)
+{
+  auto getPixel = [&](int x, int y) { return pixels[y * width + x]; };
+  std::vector<gfx::Rect> chars;
+  const uint32_t keyColor = getPixel(0, 0);
+  gfx::Rect bounds(0, 0, 1, 1);
+  while (true) {
+    if (bounds.x >= width) {
+      bounds.x = 0;
+      bounds.y += bounds.h;
+      bounds.h = 1;
+      if (bounds.y >= height)
+        break;
+    }
+    if (getPixel(bounds.x, bounds.y) == keyColor) {
+      bounds.x++;
+      continue;
+    }
+
+    const uint32_t first = getPixel(bounds.x, bounds.y);
+    bounds.w = 0;
+    while (bounds.x + bounds.w < width && getPixel(bounds.x + bounds.w, bounds.y) != keyColor)
+      bounds.w++;
+    bounds.h = 0;
+    while (bounds.y + bounds.h < height && getPixel(bounds.x, bounds.y + bounds.h) != keyColor)
+      bounds.h++;
+
+    chars.push_back(first != R ? bounds : gfx::Rect());
+    bounds.x += bounds.w;
+  }
+  return chars;
+}
+
+std::vector<gfx::Rect> find_chars(const std::vector<uint32_t>& pixels,
+                                  const int width,
+                                  const int height)
+{
+  std::vector<gfx::Rect> chars;
+  find_sprite_sheet_chars(pixels.data(), width, height, width, R, chars);
+  return chars;
+}
+
+} // anonymous namespace
+
+TEST(SpriteSheetFont, FindChars)
+{
+  // clang-format off
+  const std::vector<uint32_t> pixels = {
+    K, K, K, K, K, K, K, K, K, K,
+    K, W, W, K, W, K, R, R, K, K,
+    K, W, W, K, W, K, R, R, K, K,
+    K, K, K, K, K, K, K, K, K, K,
+    K, W, W, W, W, W, W, W, W, K,
+    K, K, K, K, K, K, K, K, K, K,
+  };
+  // clang-format on
+
+  const std::vector<gfx::Rect> chars = find_chars(pixels, 10, 6);
+  ASSERT_EQ(4, chars.size());
+  EXPECT_EQ(gfx::Rect(1, 1, 2, 2), chars[0]);
+  EXPECT_EQ(gfx::Rect(4, 1, 1, 2), chars[1]);
+  EXPECT_EQ(gfx::Rect(), chars[2]);
+  EXPECT_EQ(gfx::Rect(1, 4, 8, 1), chars[3]);
+  EXPECT_EQ(find_chars_pixel_by_pixel(pixels, 10, 6), chars);
+}
+
+TEST(SpriteSheetFont, FindCharsEmpty)
+{
+  const std::vector<uint32_t> pixels(64, K);
+  EXPECT_TRUE(find_chars(pixels, 8, 8).empty());
+}
+
+TEST(SpriteSheetFont, FindCharsSameAsPixelByPixel)
+{
+  std::srand(1);
+  for (int i = 0; i < 200; ++i) {
+    const int w = 1 + std::rand() % 40;
+    const int h = 1 + std::rand() % 20;
+    std::vector<uint32_t> pixels(w * h);
+    for (uint32_t& p : pixels) {
+      const int r = std::rand() % 10;
+      p = (r < 5 ? K : (r < 9 ? W : R));
+    }
+    EXPECT_EQ(find_chars_pixel_by_pixel(pixels, w, h), find_chars(pixels, w, h));
+  }
+}
+
+TEST(SpriteSheetFont, SaveAndLoadChars)
+{
+  const char* fn = "_test_sprite_sheet.rects";
+  const std::vector<gfx::Rect> chars = { gfx::Rect(1, 1, 5, 8),
+                                         gfx::Rect(),
+                                         gfx::Rect(7, 1, 4, 8) };
+  ASSERT_TRUE(save_sprite_sheet_chars(fn, gfx::Size(16, 10), chars));
+
+  std::vector<gfx::Rect> loaded;
+  EXPECT_TRUE(load_sprite_sheet_chars(fn, gfx::Size(16, 10), loaded));
+  EXPECT_EQ(chars, loaded);
+
+  // Different sheet size
+  loaded.clear();
+  EXPECT_FALSE(load_sprite_sheet_chars(fn, gfx::Size(32, 10), loaded));
+  EXPECT_TRUE(loaded.empty());
+
+  // Rectangle outside the sheet
+  ASSERT_TRUE(save_sprite_sheet_chars(fn, gfx::Size(8, 10), chars));
+  EXPECT_FALSE(load_sprite_sheet_chars(fn, gfx::Size(8, 10), loaded));
+
+  base::delete_file(fn);
+  EXPECT_FALSE(load_sprite_sheet_chars(fn, gfx::Size(16, 10), loaded));
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
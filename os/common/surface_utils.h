@@ -0,0 +1,27 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_SURFACE_UTILS_H_INCLUDED
+#define OS_COMMON_SURFACE_UTILS_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "os/surface.h"
+
+namespace os {
+
+// Returns the distance (in pixels) between two consecutive rows of a
+// locked 32bpp surface.
+inline int row_stride(const Surface* surface)
+{
+  if (surface->height() < 2)
+    return surface->width();
+  return int((const uint32_t*)surface->getData(0, 1) - (const uint32_t*)surface->getData(0, 0));
+}
+
+} // namespace os
+
+#endif
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2019-2024  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2012-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,9 @@
 
 #include "os/common/system.h"
 
+#include "base/fs.h"
+#include "base/time.h"
+
 #if LAF_WINDOWS
   #include "os/win/native_dialogs.h"
 #elif LAF_MACOS
@@ -54,9 +57,27 @@ FontRef CommonSystem::loadSpriteSheetFont(const char* filename, int scale)
   SurfaceRef sheet = loadRgbaSurface(filename);
   FontRef font = nullptr;
   if (sheet) {
+    // Use the glyph bounds saved next to the sheet (if they are
+    // up-to-date) to avoid scanning the whole sheet
+    const std::string charsFilename = std::string(filename) + ".rects";
+    const gfx::Size sheetSize(sheet->width(), sheet->height());
+    std::vector<gfx::Rect> chars;
+    if (!base::is_file(charsFilename) ||
+        base::get_modification_time(charsFilename) < base::get_modification_time(filename) ||
+        !load_sprite_sheet_chars(charsFilename, sheetSize, chars)) {
+      // Scan the sheet and save the bounds for the next time (errors
+      // are ignored, e.g. the font can be in a read-only directory)
+      FontRef scanned = SpriteSheetFont::fromSurface(sheet);
+      chars = static_cast<SpriteSheetFont*>(scanned.get())->charsBounds();
+      save_sprite_sheet_chars(charsFilename, sheetSize, chars);
+    }
+
     sheet->applyScale(scale);
     sheet->setImmutable();
-    font = SpriteSheetFont::fromSurface(sheet);
+
+    for (gfx::Rect& rc : chars)
+      rc *= scale;
+    font = SpriteSheetFont::fromSurface(sheet, chars);
   }
   return font;
 }
@@ -0,0 +1,69 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_TEST_SUPPORT_H_INCLUDED
+#define OS_COMMON_TEST_SUPPORT_H_INCLUDED
+#pragma once
+
+// Utilities shared by the tests of os/common
+
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/ints.h"
+#include "os/surface_format.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace os {
+
+// Format of 32bpp RGBA pixels (R in the lowest byte). Opaque pixels
+// don't have an alpha mask.
+inline SurfaceFormatData rgba_format(const PixelAlpha pixelAlpha)
+{
+  SurfaceFormatData fd;
+  fd.format = kRgbaSurfaceFormat;
+  fd.bitsPerPixel = 32;
+  fd.redShift = 0;
+  fd.greenShift = 8;
+  fd.blueShift = 16;
+  fd.alphaShift = 24;
+  fd.redMask = 0x000000ff;
+  fd.greenMask = 0x0000ff00;
+  fd.blueMask = 0x00ff0000;
+  fd.alphaMask = (pixelAlpha == PixelAlpha::kOpaque ? 0 : 0xff000000);
+  fd.pixelAlpha = pixelAlpha;
+  return fd;
+}
+
+// File deleted (if it exists) when the object is destroyed
+class TempFile {
+public:
+  explicit TempFile(const std::string& filename) : m_filename(filename) {}
+
+  // Creates the file with the given content
+  TempFile(const std::string& filename, const std::vector<uint8_t>& data) : m_filename(filename)
+  {
+    base::FileHandle f = base::open_file(m_filename, "wb");
+    std::fwrite(data.data(), 1, data.size(), f.get());
+  }
+
+  ~TempFile()
+  {
+    if (base::is_file(m_filename))
+      base::delete_file(m_filename);
+  }
+
+  const char* filename() const { return m_filename.c_str(); }
+
+private:
+  std::string m_filename;
+};
+
+} // namespace os
+
+#endif
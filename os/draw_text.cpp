@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2020-2022  Igara Studio S.A.
+// Copyright (C) 2020-2025  Igara Studio S.A.
 // Copyright (C) 2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -15,49 +15,133 @@
 #include "ft/hb_shaper.h"
 #include "gfx/clip.h"
 #include "os/common/freetype_font.h"
-#include "os/common/generic_surface.h"
+#include "os/common/mask_blender.h"
 #include "os/common/sprite_sheet_font.h"
+#include "os/text_layout.h"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
 
 namespace os {
 
-gfx::Rect draw_text(Surface* surface,
-                    Font* font,
-                    const std::string& text,
-                    gfx::Color fg,
-                    gfx::Color bg,
-                    int x,
-                    int y,
-                    DrawTextDelegate* delegate)
+namespace {
+
+// Draws the visible part (dstBounds) of a glyph bitmap placed in
+// origDstBounds.
+void draw_glyph_bitmap(Surface* surface,
+                       const MaskBlender& blender,
+                       const FT_Bitmap* bitmap,
+                       const gfx::Rect& origDstBounds,
+                       const gfx::Rect& dstBounds)
+{
+  // Clipped rows/columns are skipped here so the row kernels only
+  // see visible pixels.
+  const int clippedRows = dstBounds.y - origDstBounds.y;
+  const int clippedCols = dstBounds.x - origDstBounds.x;
+  const uint8_t* p = bitmap->buffer + clippedRows * bitmap->pitch;
+
+  for (int v = 0; v < dstBounds.h; ++v, p += bitmap->pitch) {
+    uint32_t* dst_address = (uint32_t*)surface->getData(dstBounds.x, dstBounds.y + v);
+
+    // TODO maybe if we are trying to draw in a SkiaSurface with a nullptr m_bitmap
+    //      (when GPU-acceleration is enabled)
+    if (!dst_address)
+      break;
+
+    switch (bitmap->pixel_mode) {
+      case FT_PIXEL_MODE_GRAY:
+        blender.blendGrayRow(dst_address, p + clippedCols, dstBounds.w);
+        break;
+      case FT_PIXEL_MODE_MONO:
+        blender.blendMonoRow(dst_address, p, clippedCols, dstBounds.w);
+        break;
+      case FT_PIXEL_MODE_BGRA:
+        blender.blendColorRow(dst_address, p + clippedCols * 4, dstBounds.w);
+        break;
+      default:
+        // Unsupported pixel mode
+        break;
+    }
+  }
+}
+
+// A range of bytes of a UTF-8 string that is drawn with one font.
+struct FontRun {
+  Font* font;
+  int begin;
+  int end;
+};
+
+// Splits the text in runs of chars that can be drawn with the same
+// font in just one pass: chars go to the given font when it has them,
+// or to the first font of its fallback chain that has them. As
+// hasCodePoint() is a lookup in the font coverage set, this is cheap
+// even for long strings.
+void split_font_runs(Font* font, const std::string& text, std::vector<FontRun>& runs)
 {
   base::utf8_decode decode(text);
-  gfx::Rect textBounds;
+  Font* runFont = nullptr;
+  int runBegin = 0;
 
-retry:;
-  // Check if this font is enough to draw the given string or we will
-  // need the fallback for some special Unicode chars
-  if (font->fallback()) {
-    // TODO compose unicode characters and check those codepoints, the
-    //      same in the drawing code of sprite sheet font
-    while (const uint32_t code = decode.next()) {
-      if (code && !font->hasCodePoint(code)) {
-        Font* newFont = font->fallback();
-
-        // Search a valid fallback
-        while (newFont && !newFont->hasCodePoint(code))
-          newFont = newFont->fallback();
-        if (!newFont)
-          break;
+  while (true) {
+    const int i = decode.pos() - text.begin();
+    const int code = decode.next();
+    if (!code)
+      break;
 
-        y += font->height() / 2 - newFont->height() / 2;
+    Font* chrFont = font;
+    // Spaces don't break the current run
+    if (runFont && code == ' ' && runFont->hasCodePoint(code)) {
+      chrFont = runFont;
+    }
+    else if (!font->hasCodePoint(code)) {
+      Font* newFont = font->fallback();
+      while (newFont && !newFont->hasCodePoint(code))
+        newFont = newFont->fallback();
+
+      // If no font has this char, we keep drawing with the same font
+      if (newFont)
+        chrFont = newFont;
+      else if (runFont)
+        chrFont = runFont;
+    }
 
-        font = newFont;
-        goto retry;
-      }
+    if (chrFont != runFont) {
+      if (runFont)
+        runs.push_back(FontRun{ runFont, runBegin, i });
+      runFont = chrFont;
+      runBegin = i;
     }
   }
 
+  if (runFont)
+    runs.push_back(FontRun{ runFont, runBegin, int(text.size()) });
+}
+
+// Draws the whole "text" with the given font. "charOffset" is the
+// byte index of "text" in the original string (to report the right
+// char indexes to the delegate), and "advance" is set to the width of
+// the drawn run. Returns false if the delegate stopped the drawing.
+bool draw_text_run(Surface* surface,
+                   Font* font,
+                   const std::string& text,
+                   const int charOffset,
+                   gfx::Color& fg,
+                   gfx::Color& bg,
+                   int x,
+                   const int y,
+                   DrawTextDelegate* delegate,
+                   gfx::Rect& textBounds,
+                   int& advance)
+{
+  const int initialX = x;
+  bool result = true;
+  advance = 0;
+
   switch (font->type()) {
     case FontType::Unknown:
+    case FontType::Native:
       // Do nothing
       break;
 
@@ -66,11 +150,11 @@ retry:;
       Surface* sheet = ssFont->sheetSurface();
 
       if (surface) {
-        sheet->lock();
+        sheet->lockReadOnly();
         surface->lock();
       }
 
-      decode = base::utf8_decode(text);
+      base::utf8_decode decode(text);
       while (true) {
         const int i = decode.pos() - text.begin();
         const int chr = decode.next();
@@ -81,10 +165,12 @@ retry:;
         const gfx::Rect outCharBounds(x, y, charBounds.w, charBounds.h);
 
         if (delegate)
-          delegate->preProcessChar(i, chr, fg, bg, outCharBounds);
+          delegate->preProcessChar(charOffset + i, chr, fg, bg, outCharBounds);
 
-        if (delegate && !delegate->preDrawChar(outCharBounds))
+        if (delegate && !delegate->preDrawChar(outCharBounds)) {
+          result = false;
           break;
+        }
 
         if (!charBounds.isEmpty()) {
           if (surface)
@@ -97,17 +183,17 @@ retry:;
 
         x += charBounds.w;
       }
+      advance = x - initialX;
 
       if (surface) {
         surface->unlock();
-        sheet->unlock();
+        sheet->unlockReadOnly();
       }
       break;
     }
 
     case FontType::FreeType: {
       FreeTypeFont* ttFont = static_cast<FreeTypeFont*>(font);
-      const int fg_alpha = gfx::geta(fg);
 
       gfx::Rect clipBounds;
       os::SurfaceFormatData fd;
@@ -116,26 +202,35 @@ retry:;
         surface->getFormat(&fd);
         surface->lock();
       }
+      std::optional<MaskBlender> blender;
 
       ft::ForEachGlyph<FreeTypeFont::Face> feg(ttFont->face(), text);
       while (feg.next()) {
         gfx::Rect origDstBounds;
         const auto* glyph = feg.glyph();
-        if (glyph)
+        if (glyph) {
           origDstBounds = gfx::Rect(x + int(glyph->startX),
                                     y + int(glyph->y),
                                     int(glyph->endX) - int(glyph->startX),
                                     int(glyph->bitmap->rows) ? int(glyph->bitmap->rows) : 1);
+          advance = std::max(advance, int(glyph->endX));
+        }
 
         if (delegate) {
-          delegate->preProcessChar(feg.charIndex(), feg.unicodeChar(), fg, bg, origDstBounds);
+          delegate->preProcessChar(charOffset + feg.charIndex(),
+                                   feg.unicodeChar(),
+                                   fg,
+                                   bg,
+                                   origDstBounds);
         }
 
         if (!glyph)
           continue;
 
-        if (delegate && !delegate->preDrawChar(origDstBounds))
+        if (delegate && !delegate->preDrawChar(origDstBounds)) {
+          result = false;
           break;
+        }
 
         origDstBounds.x = x + int(glyph->x);
         origDstBounds.w = int(glyph->bitmap->width);
@@ -146,70 +241,11 @@ retry:;
           dstBounds &= clipBounds;
 
         if (surface && !dstBounds.isEmpty()) {
-          const int clippedRows = dstBounds.y - origDstBounds.y;
-          int dst_y = dstBounds.y;
-          int t;
-          for (int v = 0; v < dstBounds.h; ++v, ++dst_y) {
-            int bit = 0;
-            const uint8_t* p = glyph->bitmap->buffer + (v + clippedRows) * glyph->bitmap->pitch;
-            int dst_x = dstBounds.x;
-            uint32_t* dst_address = (uint32_t*)surface->getData(dst_x, dst_y);
-
-            // TODO maybe if we are trying to draw in a SkiaSurface with a nullptr m_bitmap
-            //      (when GPU-acceleration is enabled)
-            if (!dst_address)
-              break;
-
-            // Skip first clipped pixels
-            for (int u = 0; u < dstBounds.x - origDstBounds.x; ++u) {
-              if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
-                ++p;
-              }
-              else if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
-                if (++bit == 8) {
-                  bit = 0;
-                  ++p;
-                }
-              }
-            }
-
-            for (int u = 0; u < dstBounds.w; ++u, ++dst_x) {
-              ASSERT(clipBounds.contains(gfx::Point(dst_x, dst_y)));
-
-              int alpha;
-              if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
-                alpha = *(p++);
-              }
-              else if (glyph->bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
-                alpha = ((*p) & (1 << (7 - (bit++))) ? 255 : 0);
-                if (bit == 8) {
-                  bit = 0;
-                  ++p;
-                }
-              }
-
-              const uint32_t backdrop = *dst_address;
-              const gfx::Color backdropColor = gfx::rgba(
-                ((backdrop & fd.redMask) >> fd.redShift),
-                ((backdrop & fd.greenMask) >> fd.greenShift),
-                ((backdrop & fd.blueMask) >> fd.blueShift),
-                ((backdrop & fd.alphaMask) >> fd.alphaShift));
-
-              gfx::Color output =
-                gfx::rgba(gfx::getr(fg), gfx::getg(fg), gfx::getb(fg), MUL_UN8(fg_alpha, alpha, t));
-              if (gfx::geta(bg) > 0)
-                output = blend(blend(backdropColor, bg), output);
-              else
-                output = blend(backdropColor, output);
-
-              *dst_address = ((gfx::getr(output) << fd.redShift) & fd.redMask) |
-                             ((gfx::getg(output) << fd.greenShift) & fd.greenMask) |
-                             ((gfx::getb(output) << fd.blueShift) & fd.blueMask) |
-                             ((gfx::geta(output) << fd.alphaShift) & fd.alphaMask);
-
-              ++dst_address;
-            }
-          }
+          // The delegate can change fg/bg colors for each char
+          if (!blender || blender->fg() != fg || blender->bg() != bg)
+            blender.emplace(fd, fg, bg);
+
+          draw_glyph_bitmap(surface, *blender, glyph->bitmap, origDstBounds, dstBounds);
         }
 
         if (!origDstBounds.w)
@@ -227,6 +263,158 @@ retry:;
     }
   }
 
+  return result;
+}
+
+} // anonymous namespace
+
+gfx::Rect draw_text(Surface* surface,
+                    Font* font,
+                    const std::string& text,
+                    gfx::Color fg,
+                    gfx::Color bg,
+                    int x,
+                    int y,
+                    DrawTextDelegate* delegate)
+{
+  gfx::Rect textBounds;
+  int advance;
+
+  if (!font->fallback()) {
+    draw_text_run(surface, font, text, 0, fg, bg, x, y, delegate, textBounds, advance);
+    return textBounds;
+  }
+
+  std::vector<FontRun> runs;
+  split_font_runs(font, text, runs);
+
+  for (const FontRun& run : runs) {
+    // Center vertically the fallback fonts
+    const int runY = y + font->height() / 2 - run.font->height() / 2;
+    bool continueDrawing;
+    if (runs.size() == 1) {
+      continueDrawing =
+        draw_text_run(surface, run.font, text, 0, fg, bg, x, runY, delegate, textBounds, advance);
+    }
+    else {
+      continueDrawing = draw_text_run(surface,
+                                      run.font,
+                                      text.substr(run.begin, run.end - run.begin),
+                                      run.begin,
+                                      fg,
+                                      bg,
+                                      x,
+                                      runY,
+                                      delegate,
+                                      textBounds,
+                                      advance);
+    }
+    if (!continueDrawing)
+      break;
+    x += advance;
+  }
+
+  return textBounds;
+}
+
+gfx::Rect draw_text_layout(Surface* surface,
+                           Font* font,
+                           const TextLayout& layout,
+                           gfx::Color fg,
+                           gfx::Color bg,
+                           int x,
+                           int y)
+{
+  gfx::Rect textBounds;
+
+  switch (font->type()) {
+    case FontType::Unknown:
+    case FontType::Native:
+      // Do nothing
+      break;
+
+    case FontType::SpriteSheet: {
+      SpriteSheetFont* ssFont = static_cast<SpriteSheetFont*>(font);
+      Surface* sheet = ssFont->sheetSurface();
+
+      if (surface) {
+        sheet->lockReadOnly();
+        surface->lock();
+      }
+
+      for (const TextLayout::Glyph& g : layout.glyphs) {
+        const gfx::Rect charBounds = ssFont->getCharBounds(g.glyph);
+        const int charX = x + int(g.x);
+
+        if (surface && !charBounds.isEmpty())
+          surface->drawColoredRgbaSurface(sheet, fg, bg, gfx::Clip(charX, y, charBounds));
+
+        textBounds |= gfx::Rect(charX, y, charBounds.w, charBounds.h);
+      }
+
+      if (surface) {
+        surface->unlock();
+        sheet->unlockReadOnly();
+      }
+      break;
+    }
+
+    case FontType::FreeType: {
+      FreeTypeFont* ttFont = static_cast<FreeTypeFont*>(font);
+      FreeTypeFont::Face& face = ttFont->face();
+      ASSERT(layout.fontSize == ttFont->size());
+
+      gfx::Rect clipBounds;
+      std::optional<MaskBlender> blender;
+      if (surface) {
+        os::SurfaceFormatData fd;
+        clipBounds = surface->getClipBounds();
+        surface->getFormat(&fd);
+        surface->lock();
+        blender.emplace(fd, fg, bg);
+      }
+
+      // Same calculation as ForEachGlyph::prepareGlyph() (descender is negative)
+      const double baseY = face.height() + face.descender();
+
+      for (const TextLayout::Glyph& g : layout.glyphs) {
+        double pixelX = g.x;
+        int subpixel = 0;
+        if (face.subpixelPositioning())
+          subpixel = ft::subpixel_step(g.x, pixelX);
+
+        auto* glyph = face.cache().loadGlyph(face, g.glyph, face.antialias(), subpixel);
+        if (!glyph)
+          continue;
+
+        const FT_Bitmap* bitmap = &FT_BitmapGlyph(glyph->ft_glyph)->bitmap;
+        gfx::Rect origDstBounds(x + int(pixelX + glyph->bearingX),
+                                y + int(g.y + baseY - glyph->bearingY),
+                                int(bitmap->width),
+                                int(bitmap->rows));
+
+        gfx::Rect dstBounds = origDstBounds;
+        if (surface) {
+          dstBounds &= clipBounds;
+          if (!dstBounds.isEmpty())
+            draw_glyph_bitmap(surface, *blender, bitmap, origDstBounds, dstBounds);
+        }
+
+        face.cache().doneGlyph(glyph);
+
+        if (!origDstBounds.w)
+          origDstBounds.w = 1;
+        if (!origDstBounds.h)
+          origDstBounds.h = 1;
+        textBounds |= origDstBounds;
+      }
+
+      if (surface)
+        surface->unlock();
+      break;
+    }
+  }
+
   return textBounds;
 }
 
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2019-2020  Igara Studio S.A.
+// Copyright (c) 2019-2025  Igara Studio S.A.
 // Copyright (c) 2012-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -38,6 +38,10 @@ public:
   virtual bool isScalable() const = 0;
   virtual void setSize(int size) = 0;
   virtual void setAntialias(bool antialias) = 0;
+
+  // Draws antialiased glyphs in fractional x positions (instead of
+  // truncating each glyph position to an integer pixel).
+  virtual void setSubpixelPositioning(bool state) = 0;
   virtual bool hasCodePoint(int codepoint) const = 0;
 
   Font* fallback() const { return m_fallback; }
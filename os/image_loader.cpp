@@ -0,0 +1,133 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/image_loader.h"
+
+#include "base/thread_pool.h"
+#include "os/common/image_decoder.h"
+#include "os/common/surface_utils.h"
+#include "os/system.h"
+
+namespace os {
+
+namespace {
+
+// Creates the surface to decode the "roi" of the given image with
+// the built-in decoders, or returns nullptr if the image cannot be
+// decoded with them.
+SurfaceRef make_decoding_surface(const char* filename, gfx::Rect& roi)
+{
+  ImageInfo info;
+  if (!read_image_info(filename, info))
+    return nullptr;
+
+  const gfx::Rect bounds(0, 0, info.width, info.height);
+  if (roi.isEmpty())
+    roi = bounds;
+  else if (!bounds.contains(roi))
+    return nullptr;
+
+  SurfaceRef surface = instance()->makeRgbaSurface(roi.w, roi.h);
+  if (!surface)
+    return nullptr;
+
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32 || !surface->getData(0, 0))
+    return nullptr;
+  return surface;
+}
+
+bool decode_to_surface(const char* filename, const gfx::Rect& roi, Surface* surface)
+{
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+
+  const SurfaceLock lock(surface);
+  return decode_image(filename,
+                      roi,
+                      (uint32_t*)surface->getData(0, 0),
+                      row_stride(surface),
+                      fd);
+}
+
+// Loads the file with the System implementation (e.g. for formats
+// that are not supported by the built-in decoders).
+SurfaceRef load_with_system(const char* filename, const gfx::Rect& roi)
+{
+  SurfaceRef surface = instance()->loadRgbaSurface(filename);
+  if (!surface || roi.isEmpty())
+    return surface;
+  if (!surface->bounds().contains(roi))
+    return nullptr;
+
+  SurfaceRef area = instance()->makeRgbaSurface(roi.w, roi.h, surface->colorSpace());
+  if (area)
+    surface->blitTo(area.get(), roi.x, roi.y, 0, 0, roi.w, roi.h);
+  return area;
+}
+
+} // anonymous namespace
+
+SurfaceRef load_surface(const char* filename, const gfx::Rect& roi)
+{
+  gfx::Rect area = roi;
+  SurfaceRef surface = make_decoding_surface(filename, area);
+  if (!surface)
+    return load_with_system(filename, roi);
+
+  if (!decode_to_surface(filename, area, surface.get()))
+    return nullptr;
+  return surface;
+}
+
+std::vector<SurfaceRef> load_surfaces(const std::vector<std::string>& filenames,
+                                      base::thread_pool* pool)
+{
+  std::vector<SurfaceRef> surfaces(filenames.size());
+  if (!pool) {
+    for (std::size_t i = 0; i < filenames.size(); ++i)
+      surfaces[i] = load_surface(filenames[i].c_str());
+    return surfaces;
+  }
+
+  // Surfaces are created in this thread (only the pixels are
+  // written from other threads)
+  std::vector<std::size_t> decodable;
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    gfx::Rect area;
+    surfaces[i] = make_decoding_surface(filenames[i].c_str(), area);
+    if (surfaces[i])
+      decodable.push_back(i);
+  }
+
+  std::vector<char> failed(filenames.size(), false);
+  base::for_each_task(pool, int(decodable.size()), 1, [&](const int j1, const int j2) {
+    for (int j = j1; j < j2; ++j) {
+      const std::size_t i = decodable[j];
+      failed[i] = !decode_to_surface(filenames[i].c_str(), gfx::Rect(), surfaces[i].get());
+    }
+  });
+
+  // Files that cannot be decoded with the built-in decoders are
+  // loaded in this thread
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    if (!surfaces[i])
+      surfaces[i] = load_with_system(filenames[i].c_str(), gfx::Rect());
+  }
+
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    if (failed[i])
+      surfaces[i].reset();
+  }
+  return surfaces;
+}
+
+} // namespace os
@@ -0,0 +1,40 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_IMAGE_LOADER_H_INCLUDED
+#define OS_IMAGE_LOADER_H_INCLUDED
+#pragma once
+
+#include "gfx/rect.h"
+#include "os/surface.h"
+
+#include <string>
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+// Loads an image file in a new RGBA surface. BMP, TGA, QOI and PNG
+// files are decoded row by row straight to the surface memory with
+// the built-in decoders (see os/common/image_decoder.h), other
+// formats are loaded with System::loadRgbaSurface(). If "roi" is not
+// empty, only that area of the image is loaded (the surface will
+// have the "roi" size). Returns nullptr if the file cannot be loaded.
+SurfaceRef load_surface(const char* filename, const gfx::Rect& roi = gfx::Rect());
+
+// Loads several image files, decoding them in parallel with the
+// threads of the "pool" (if it's not nullptr). Surfaces are created
+// in the calling thread. The result has one surface (or nullptr)
+// for each file.
+std::vector<SurfaceRef> load_surfaces(const std::vector<std::string>& filenames,
+                                      base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
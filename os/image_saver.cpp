@@ -0,0 +1,50 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/image_saver.h"
+
+#include "os/common/image_encoder.h"
+#include "os/common/surface_utils.h"
+
+namespace os {
+
+bool save_surface(Surface* surface, const char* filename, base::thread_pool* pool)
+{
+  if (!surface)
+    return false;
+
+  const ImageFormat format = image_format_from_extension(filename);
+  if (format == ImageFormat::Unknown)
+    return false;
+
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return false;
+
+  const SurfaceLock lock(surface, SurfaceLock::ReadOnly);
+  const uint32_t* pixels = (const uint32_t*)surface->getData(0, 0);
+  if (!pixels)
+    return false;
+
+  // Distance between rows in pixels
+  const int stride = row_stride(surface);
+
+  return encode_image(filename,
+                      format,
+                      pixels,
+                      surface->width(),
+                      surface->height(),
+                      stride,
+                      fd,
+                      pool);
+}
+
+} // namespace os
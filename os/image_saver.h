@@ -0,0 +1,29 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_IMAGE_SAVER_H_INCLUDED
+#define OS_IMAGE_SAVER_H_INCLUDED
+#pragma once
+
+#include "os/surface.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+// Saves the surface in a BMP, TGA, QOI or PNG file (the format is
+// chosen from the file extension) with the built-in encoders (see
+// os/common/image_encoder.h). Rows are read straight from the
+// surface memory. If "pool" is not nullptr, PNG files are compressed
+// in parallel with the threads of the pool. Returns false if the
+// file cannot be saved.
+bool save_surface(Surface* surface, const char* filename, base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
@@ -0,0 +1,658 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/none/none_surface.h"
+
+#include "gfx/matrix.h"
+#include "os/common/nine_slice.h"
+#include "os/common/resample.h"
+#include "os/common/surface_utils.h"
+#include "os/paint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace os {
+
+namespace {
+
+// Rendered nine-slices (only the small ones are cached)
+constexpr std::size_t kNineSliceCacheSize = 8 * 1024 * 1024;
+constexpr std::size_t kMaxCachedNineSlice = 256 * 1024;
+
+using NineSlicePixels = std::shared_ptr<const std::vector<uint32_t>>;
+
+NineSliceCache<NineSlicePixels>& nine_slice_cache()
+{
+  static NineSliceCache<NineSlicePixels> cache(kNineSliceCacheSize);
+  return cache;
+}
+
+std::atomic<uint64_t> g_generation(0);
+
+inline uint32_t premultiply(const gfx::Color c)
+{
+  const uint32_t a = gfx::geta(c);
+  return ((gfx::getr(c) * a + 127) / 255) | (((gfx::getg(c) * a + 127) / 255) << 8) |
+         (((gfx::getb(c) * a + 127) / 255) << 16) | (a << 24);
+}
+
+inline uint32_t src_over(const uint32_t d, const uint32_t s)
+{
+  const uint32_t sa = (s >> 24);
+  if (sa == 255)
+    return s;
+  if (sa == 0)
+    return d;
+  uint32_t result = 0;
+  for (int i = 0; i < 32; i += 8) {
+    const uint32_t v = ((s >> i) & 0xff) + (((d >> i) & 0xff) * (255 - sa) + 127) / 255;
+    result |= std::min(v, 255u) << i;
+  }
+  return result;
+}
+
+inline uint32_t blend_pixel(const uint32_t d, const uint32_t s, const BlendMode blendMode)
+{
+  switch (blendMode) {
+    case BlendMode::Clear:   return 0;
+    case BlendMode::Src:     return s;
+    case BlendMode::Dst:     return d;
+    case BlendMode::DstOver: return src_over(s, d);
+    default:                 return src_over(d, s);
+  }
+}
+
+// Replaces the color of "s" with "tint" keeping its alpha (like
+// SkBlendMode::kSrcIn color filter).
+inline uint32_t tint_pixel(const uint32_t s, const gfx::Color tint)
+{
+  const uint32_t a = ((s >> 24) * gfx::geta(tint) + 127) / 255;
+  return premultiply(gfx::rgba(gfx::getr(tint), gfx::getg(tint), gfx::getb(tint), a));
+}
+
+} // anonymous namespace
+
+NoneSurface::NoneSurface(const int width, const int height, const os::ColorSpaceRef& colorSpace)
+  : m_width(std::max(0, width))
+  , m_height(std::max(0, height))
+  , m_pixels(std::size_t(m_width) * m_height, 0)
+  , m_data(m_pixels.empty() ? nullptr : m_pixels.data())
+  , m_stride(m_width)
+  , m_colorSpace(colorSpace)
+  , m_clip(0, 0, m_width, m_height)
+  , m_generation(++g_generation)
+{
+}
+
+NoneSurface::NoneSurface(const int width,
+                         const int height,
+                         const uint32_t* pixels,
+                         const int stride,
+                         std::shared_ptr<const void> owner,
+                         const os::ColorSpaceRef& colorSpace)
+  : m_width(std::max(0, width))
+  , m_height(std::max(0, height))
+  , m_data(const_cast<uint32_t*>(pixels))
+  , m_stride(stride)
+  , m_owner(std::move(owner))
+  , m_readOnly(true)
+  , m_colorSpace(colorSpace)
+  , m_clip(0, 0, m_width, m_height)
+  , m_generation(++g_generation)
+{
+  ASSERT(stride >= m_width);
+}
+
+// static
+void NoneSurface::getNoneFormat(SurfaceFormatData* formatData)
+{
+  formatData->format = kRgbaSurfaceFormat;
+  formatData->bitsPerPixel = 32;
+  formatData->redShift = 0;
+  formatData->greenShift = 8;
+  formatData->blueShift = 16;
+  formatData->alphaShift = 24;
+  formatData->redMask = 0x000000ff;
+  formatData->greenMask = 0x0000ff00;
+  formatData->blueMask = 0x00ff0000;
+  formatData->alphaMask = 0xff000000;
+  formatData->pixelAlpha = PixelAlpha::kPremultiplied;
+}
+
+int NoneSurface::getSaveCount() const
+{
+  return int(m_clipStack.size()) + 1;
+}
+
+gfx::Rect NoneSurface::getClipBounds() const
+{
+  return m_clip;
+}
+
+void NoneSurface::saveClip()
+{
+  m_clipStack.push_back(m_clip);
+}
+
+void NoneSurface::restoreClip()
+{
+  if (!m_clipStack.empty()) {
+    m_clip = m_clipStack.back();
+    m_clipStack.pop_back();
+  }
+}
+
+bool NoneSurface::clipRect(const gfx::Rect& rc)
+{
+  m_clip &= rc;
+  return !m_clip.isEmpty();
+}
+
+void NoneSurface::clipPath(const gfx::Path& path)
+{
+  // Paths are not supported
+}
+
+void NoneSurface::save()
+{
+  saveClip();
+}
+
+void NoneSurface::concat(const gfx::Matrix& matrix)
+{
+  // Matrices are not supported
+}
+
+void NoneSurface::setMatrix(const gfx::Matrix& matrix)
+{
+}
+
+void NoneSurface::resetMatrix()
+{
+}
+
+void NoneSurface::restore()
+{
+  restoreClip();
+}
+
+gfx::Matrix NoneSurface::matrix() const
+{
+  return gfx::Matrix();
+}
+
+void NoneSurface::lock()
+{
+  // Read-only pixels cannot be modified with getData()
+  ASSERT(!m_readOnly);
+  lockReadOnly();
+}
+
+void NoneSurface::unlock()
+{
+  ASSERT(m_lock > 0);
+  --m_lock;
+  changed();
+}
+
+void NoneSurface::lockReadOnly()
+{
+  ASSERT(m_lock >= 0);
+  ++m_lock;
+}
+
+void NoneSurface::unlockReadOnly()
+{
+  ASSERT(m_lock > 0);
+  --m_lock;
+}
+
+void NoneSurface::clear()
+{
+  fillRect(bounds(), 0, BlendMode::Src);
+}
+
+uint8_t* NoneSurface::getData(const int x, const int y) const
+{
+  if (!m_data)
+    return nullptr;
+  return (uint8_t*)(row(y) + x);
+}
+
+void NoneSurface::getFormat(SurfaceFormatData* formatData) const
+{
+  getNoneFormat(formatData);
+}
+
+gfx::Color NoneSurface::getPixel(const int x, const int y) const
+{
+  if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+    return 0;
+
+  const uint32_t c = row(y)[x];
+  const uint32_t a = (c >> 24);
+  if (a == 0)
+    return 0;
+  auto unpremultiply = [a](const uint32_t v) {
+    return std::min<uint32_t>(255, (v * 255 + a / 2) / a);
+  };
+  return gfx::rgba(unpremultiply(c & 0xff),
+                   unpremultiply((c >> 8) & 0xff),
+                   unpremultiply((c >> 16) & 0xff),
+                   a);
+}
+
+void NoneSurface::putPixel(const gfx::Color color, const int x, const int y)
+{
+  if (x >= 0 && y >= 0 && x < m_width && y < m_height && !m_readOnly) {
+    row(y)[x] = premultiply(color);
+    changed();
+  }
+}
+
+void NoneSurface::drawLine(const float x0,
+                           const float y0,
+                           const float x1,
+                           const float y1,
+                           const os::Paint& paint)
+{
+  if (m_readOnly)
+    return;
+
+  const uint32_t color = premultiply(paint.color());
+  const BlendMode blendMode = paint.blendMode();
+
+  // Bresenham's algorithm
+  int x = int(std::floor(x0));
+  int y = int(std::floor(y0));
+  const int xEnd = int(std::floor(x1));
+  const int yEnd = int(std::floor(y1));
+  const int dx = std::abs(xEnd - x);
+  const int dy = -std::abs(yEnd - y);
+  const int sx = (x < xEnd ? 1 : -1);
+  const int sy = (y < yEnd ? 1 : -1);
+  int err = dx + dy;
+  changed();
+  while (true) {
+    if (m_clip.contains(gfx::Point(x, y))) {
+      uint32_t& p = row(y)[x];
+      p = blend_pixel(p, color, blendMode);
+    }
+    if (x == xEnd && y == yEnd)
+      break;
+    const int e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y += sy;
+    }
+  }
+}
+
+void NoneSurface::drawRect(const gfx::RectF& rc, const os::Paint& paint)
+{
+  const gfx::Rect irc(int(std::round(rc.x)),
+                      int(std::round(rc.y)),
+                      int(std::round(rc.x2())) - int(std::round(rc.x)),
+                      int(std::round(rc.y2())) - int(std::round(rc.y)));
+  const uint32_t color = premultiply(paint.color());
+
+  if (paint.style() != Paint::Stroke) {
+    fillRect(irc, color, paint.blendMode());
+    return;
+  }
+
+  // Border of "strokeWidth" pixels inside the rectangle
+  const int t = std::max(1, int(paint.strokeWidth()));
+  if (irc.w <= 2 * t || irc.h <= 2 * t) {
+    fillRect(irc, color, paint.blendMode());
+    return;
+  }
+  fillRect(gfx::Rect(irc.x, irc.y, irc.w, t), color, paint.blendMode());
+  fillRect(gfx::Rect(irc.x, irc.y2() - t, irc.w, t), color, paint.blendMode());
+  fillRect(gfx::Rect(irc.x, irc.y + t, t, irc.h - 2 * t), color, paint.blendMode());
+  fillRect(gfx::Rect(irc.x2() - t, irc.y + t, t, irc.h - 2 * t), color, paint.blendMode());
+}
+
+void NoneSurface::drawCircle(const float cx,
+                             const float cy,
+                             const float radius,
+                             const os::Paint& paint)
+{
+  const uint32_t color = premultiply(paint.color());
+  const bool stroke = (paint.style() == Paint::Stroke);
+  const float halfStroke = std::max(1.0f, paint.strokeWidth()) / 2.0f;
+  const float outer = (stroke ? radius + halfStroke : radius);
+  const float inner = (stroke ? radius - halfStroke : 0.0f);
+
+  // Scanlines of the pixels with centers inside the circle (or the
+  // ring when the circle is stroked)
+  const int y0 = int(std::floor(cy - outer));
+  const int y1 = int(std::ceil(cy + outer));
+  for (int y = y0; y <= y1; ++y) {
+    const float dy = float(y) + 0.5f - cy;
+    if (std::fabs(dy) > outer)
+      continue;
+    const float wo = std::sqrt(outer * outer - dy * dy);
+    const int xo0 = int(std::ceil(cx - wo - 0.5f));
+    const int xo1 = int(std::floor(cx + wo - 0.5f));
+    if (inner > 0.0f && std::fabs(dy) < inner) {
+      const float wi = std::sqrt(inner * inner - dy * dy);
+      drawSpan(xo0, int(std::ceil(cx - wi - 0.5f)) - 1, y, color, paint.blendMode());
+      drawSpan(int(std::floor(cx + wi - 0.5f)) + 1, xo1, y, color, paint.blendMode());
+    }
+    else {
+      drawSpan(xo0, xo1, y, color, paint.blendMode());
+    }
+  }
+}
+
+void NoneSurface::drawPath(const gfx::Path& path, const os::Paint& paint)
+{
+  // Paths are not supported
+}
+
+void NoneSurface::blitTo(Surface* dest,
+                         const int srcx,
+                         const int srcy,
+                         const int dstx,
+                         const int dsty,
+                         const int width,
+                         const int height) const
+{
+  dest->drawSurface(this,
+                    gfx::Rect(srcx, srcy, width, height),
+                    gfx::Rect(dstx, dsty, width, height),
+                    Sampling(),
+                    nullptr);
+}
+
+void NoneSurface::scrollTo(const gfx::Rect& rc, const int dx, const int dy)
+{
+  gfx::Clip clip(rc.x + dx, rc.y + dy, rc);
+  if (m_readOnly || !clip.clip(m_width, m_height, m_width, m_height))
+    return;
+
+  changed();
+  if (dy > 0) {
+    for (int v = clip.size.h - 1; v >= 0; --v)
+      std::memmove(row(clip.dst.y + v) + clip.dst.x,
+                   row(clip.src.y + v) + clip.src.x,
+                   4 * std::size_t(clip.size.w));
+  }
+  else {
+    for (int v = 0; v < clip.size.h; ++v)
+      std::memmove(row(clip.dst.y + v) + clip.dst.x,
+                   row(clip.src.y + v) + clip.src.x,
+                   4 * std::size_t(clip.size.w));
+  }
+}
+
+void NoneSurface::drawSurface(const Surface* src, const int dstx, const int dsty)
+{
+  compose((const uint32_t*)src->getData(0, 0),
+          row_stride(src),
+          gfx::Rect(dstx, dsty, src->width(), src->height()),
+          BlendMode::Src);
+}
+
+void NoneSurface::drawSurface(const Surface* src,
+                              const gfx::Rect& srcRect,
+                              const gfx::Rect& dstRect,
+                              const Sampling& sampling,
+                              const os::Paint* paint)
+{
+  drawScaled(src,
+             srcRect,
+             dstRect,
+             sampling,
+             (paint ? paint->blendMode() : BlendMode::Src),
+             gfx::ColorNone);
+}
+
+void NoneSurface::drawRgbaSurface(const Surface* src, const int dstx, const int dsty)
+{
+  compose((const uint32_t*)src->getData(0, 0),
+          row_stride(src),
+          gfx::Rect(dstx, dsty, src->width(), src->height()),
+          BlendMode::SrcOver);
+}
+
+void NoneSurface::drawRgbaSurface(const Surface* src,
+                                  const int srcx,
+                                  const int srcy,
+                                  const int dstx,
+                                  const int dsty,
+                                  const int width,
+                                  const int height)
+{
+  gfx::Clip clip(dstx, dsty, srcx, srcy, width, height);
+  if (!clip.clip(m_width, m_height, src->width(), src->height()))
+    return;
+
+  compose((const uint32_t*)src->getData(clip.src.x, clip.src.y),
+          row_stride(src),
+          gfx::Rect(clip.dst.x, clip.dst.y, clip.size.w, clip.size.h),
+          BlendMode::SrcOver);
+}
+
+void NoneSurface::drawSurfaceNine(os::Surface* surface,
+                                  const gfx::Rect& src,
+                                  const gfx::Rect& center,
+                                  const gfx::Rect& dst,
+                                  const bool drawCenter,
+                                  const os::Paint* paint)
+{
+  const gfx::Rect visible = (dst & m_clip);
+  if (visible.isEmpty() || src.isEmpty() || (src & surface->bounds()) != src)
+    return;
+
+  const auto* source = static_cast<const NoneSurface*>(surface);
+  const uint32_t* srcPixels = source->row(0);
+  const gfx::Color tint = (paint ? paint->color() : gfx::ColorNone);
+
+  // Small nine-slices are rendered (and tinted) once and reused
+  // until the source is modified
+  const std::size_t bytes = 4 * std::size_t(dst.w) * dst.h;
+  if (bytes <= kMaxCachedNineSlice) {
+    NineSliceCache<NineSlicePixels>& cache = nine_slice_cache();
+    NineSliceKey key;
+    key.sourceId = source->generation();
+    key.src = src;
+    key.center = center;
+    key.size = dst.size();
+    key.drawCenter = drawCenter;
+    key.color = tint;
+
+    NineSlicePixels pixels = cache.find(key);
+    if (!pixels) {
+      auto buf = std::make_shared<std::vector<uint32_t>>(std::size_t(dst.w) * dst.h);
+      render_nine_slice(srcPixels,
+                        source->m_stride,
+                        src,
+                        center,
+                        drawCenter,
+                        buf->data(),
+                        dst.w,
+                        dst.size(),
+                        gfx::Rect(dst.size()));
+      if (tint != gfx::ColorNone) {
+        for (uint32_t& c : *buf)
+          c = tint_pixel(c, tint);
+      }
+      cache.insert(key, buf, bytes);
+      pixels = std::move(buf);
+    }
+    compose(pixels->data(), dst.w, dst, BlendMode::SrcOver);
+    return;
+  }
+
+  // Render only the visible part of big nine-slices
+  std::vector<uint32_t> tmp(std::size_t(visible.w) * visible.h);
+  render_nine_slice(srcPixels,
+                    source->m_stride,
+                    src,
+                    center,
+                    drawCenter,
+                    tmp.data(),
+                    visible.w,
+                    dst.size(),
+                    gfx::Rect(visible).offset(-dst.x, -dst.y));
+  compose(tmp.data(), visible.w, visible, BlendMode::SrcOver, tint);
+}
+
+void NoneSurface::applyScale(const int scaleFactor)
+{
+  if (scaleFactor <= 1)
+    return;
+
+  const int w = m_width * scaleFactor;
+  const int h = m_height * scaleFactor;
+  std::vector<uint32_t> pixels(std::size_t(w) * h);
+  for (int y = 0; y < h; ++y) {
+    const uint32_t* src = row(y / scaleFactor);
+    uint32_t* dst = &pixels[std::size_t(y) * w];
+    for (int x = 0; x < w; ++x)
+      dst[x] = src[x / scaleFactor];
+  }
+
+  m_pixels.swap(pixels);
+  m_data = m_pixels.data();
+  m_stride = w;
+  m_owner.reset();
+  m_readOnly = false;
+  m_width = w;
+  m_height = h;
+  m_clip = bounds();
+  m_clipStack.clear();
+  changed();
+}
+
+void* NoneSurface::nativeHandle()
+{
+  return (void*)this;
+}
+
+void NoneSurface::drawScaled(const Surface* src,
+                             const gfx::Rect& srcRect,
+                             const gfx::Rect& dstRect,
+                             const Sampling& sampling,
+                             const BlendMode blendMode,
+                             const gfx::Color tint)
+{
+  const gfx::Rect srcBounds = (srcRect & src->bounds());
+  if (srcBounds.isEmpty() || dstRect.isEmpty())
+    return;
+
+  const uint32_t* srcPixels = (const uint32_t*)src->getData(0, 0);
+  const int srcStride = row_stride(src);
+
+  if (srcRect.size() == dstRect.size()) {
+    const gfx::Rect dst(dstRect.x + srcBounds.x - srcRect.x,
+                        dstRect.y + srcBounds.y - srcRect.y,
+                        srcBounds.w,
+                        srcBounds.h);
+    compose(srcPixels + std::size_t(srcBounds.y) * srcStride + srcBounds.x,
+            srcStride,
+            dst,
+            blendMode,
+            tint);
+    return;
+  }
+
+  // Scale only the visible part of the destination rectangle
+  const gfx::Rect visible = (dstRect & m_clip);
+  if (visible.isEmpty())
+    return;
+  const gfx::Rect area(visible.x - dstRect.x, visible.y - dstRect.y, visible.w, visible.h);
+  std::vector<uint32_t> tmp(std::size_t(area.w) * area.h);
+
+  SurfaceFormatData fd;
+  src->getFormat(&fd);
+  resample(srcPixels,
+           srcStride,
+           srcBounds,
+           tmp.data(),
+           area.w,
+           dstRect.size(),
+           area,
+           fd,
+           sampling);
+  compose(tmp.data(), area.w, visible, blendMode, tint);
+}
+
+void NoneSurface::fillRect(const gfx::Rect& rc, const uint32_t color, const BlendMode blendMode)
+{
+  const gfx::Rect area = (rc & m_clip);
+  for (int y = area.y; y < area.y2(); ++y)
+    drawSpan(area.x, area.x2() - 1, y, color, blendMode);
+}
+
+void NoneSurface::drawSpan(int x0,
+                           int x1,
+                           const int y,
+                           const uint32_t color,
+                           const BlendMode blendMode)
+{
+  if (m_readOnly || y < m_clip.y || y >= m_clip.y2())
+    return;
+  x0 = std::max(x0, m_clip.x);
+  x1 = std::min(x1, m_clip.x2() - 1);
+  if (x0 > x1)
+    return;
+
+  changed();
+  uint32_t* p = row(y);
+  if (blendMode == BlendMode::Src || (blendMode == BlendMode::SrcOver && (color >> 24) == 255)) {
+    std::fill(p + x0, p + x1 + 1, color);
+    return;
+  }
+  for (int x = x0; x <= x1; ++x)
+    p[x] = blend_pixel(p[x], color, blendMode);
+}
+
+void NoneSurface::compose(const uint32_t* src,
+                          const int srcStride,
+                          const gfx::Rect& dst,
+                          const BlendMode blendMode,
+                          const gfx::Color tint)
+{
+  const gfx::Rect area = (dst & m_clip);
+  if (m_readOnly || area.isEmpty() || !src)
+    return;
+
+  changed();
+  src += std::size_t(area.y - dst.y) * srcStride + (area.x - dst.x);
+  for (int y = area.y; y < area.y2(); ++y, src += srcStride) {
+    uint32_t* d = row(y) + area.x;
+    if (blendMode == BlendMode::Src && tint == gfx::ColorNone) {
+      std::memcpy(d, src, 4 * std::size_t(area.w));
+      continue;
+    }
+    for (int x = 0; x < area.w; ++x) {
+      const uint32_t s = (tint == gfx::ColorNone ? src[x] : tint_pixel(src[x], tint));
+      d[x] = blend_pixel(d[x], s, blendMode);
+    }
+  }
+}
+
+void NoneSurface::changed()
+{
+  m_generation = ++g_generation;
+}
+
+} // namespace os
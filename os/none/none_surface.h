@@ -0,0 +1,157 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_NONE_NONE_SURFACE_H_INCLUDED
+#define OS_NONE_NONE_SURFACE_H_INCLUDED
+#pragma once
+
+#include "os/common/generic_surface.h"
+
+#include <memory>
+#include <vector>
+
+namespace os {
+
+// Software surface of the "none" backend (non-GUI apps/laf) with
+// 32bpp premultiplied RGBA pixels in memory. It implements the basic
+// drawing operations (without anti-aliasing, matrices, or paths) so
+// images can be loaded and processed headless (e.g. in command line
+// tools or benchmarks).
+class NoneSurface final : public GenericDrawColoredRgbaSurface<Surface> {
+public:
+  NoneSurface(int width, int height, const os::ColorSpaceRef& colorSpace = nullptr);
+
+  // Read-only surface that uses external "pixels" (rows of "stride"
+  // pixels) without copying them, "owner" is kept alive while the
+  // surface exists (see System::makeRgbaSurfaceFromData()). Drawing
+  // functions don't modify these pixels.
+  NoneSurface(int width,
+              int height,
+              const uint32_t* pixels,
+              int stride,
+              std::shared_ptr<const void> owner,
+              const os::ColorSpaceRef& colorSpace = nullptr);
+
+  // The pixel format of all surfaces
+  static void getNoneFormat(SurfaceFormatData* formatData);
+
+  // Unique ID of the current pixels, it changes each time the surface
+  // is modified (or locked to be modified with getData()).
+  uint64_t generation() const { return m_generation; }
+
+  int width() const override { return m_width; }
+  int height() const override { return m_height; }
+  const ColorSpaceRef& colorSpace() const override { return m_colorSpace; }
+  bool isDirectToScreen() const override { return false; }
+  void setImmutable() override {}
+
+  int getSaveCount() const override;
+  gfx::Rect getClipBounds() const override;
+  void saveClip() override;
+  void restoreClip() override;
+  bool clipRect(const gfx::Rect& rc) override;
+  void clipPath(const gfx::Path& path) override;
+
+  void save() override;
+  void concat(const gfx::Matrix& matrix) override;
+  void setMatrix(const gfx::Matrix& matrix) override;
+  void resetMatrix() override;
+  void restore() override;
+  gfx::Matrix matrix() const override;
+
+  void lock() override;
+  void unlock() override;
+  void lockReadOnly() override;
+  void unlockReadOnly() override;
+
+  void clear() override;
+
+  uint8_t* getData(int x, int y) const override;
+  void getFormat(SurfaceFormatData* formatData) const override;
+
+  gfx::Color getPixel(int x, int y) const override;
+  void putPixel(gfx::Color color, int x, int y) override;
+
+  void drawLine(float x0, float y0, float x1, float y1, const os::Paint& paint) override;
+  void drawRect(const gfx::RectF& rc, const os::Paint& paint) override;
+  void drawCircle(float cx, float cy, float radius, const os::Paint& paint) override;
+  void drawPath(const gfx::Path& path, const os::Paint& paint) override;
+
+  void blitTo(Surface* dest, int srcx, int srcy, int dstx, int dsty, int width, int height)
+    const override;
+  void scrollTo(const gfx::Rect& rc, int dx, int dy) override;
+  void drawSurface(const Surface* src, int dstx, int dsty) override;
+  void drawSurface(const Surface* src,
+                   const gfx::Rect& srcRect,
+                   const gfx::Rect& dstRect,
+                   const os::Sampling& sampling,
+                   const os::Paint* paint) override;
+  void drawRgbaSurface(const Surface* src, int dstx, int dsty) override;
+  void drawRgbaSurface(const Surface* src,
+                       int srcx,
+                       int srcy,
+                       int dstx,
+                       int dsty,
+                       int width,
+                       int height) override;
+  void drawSurfaceNine(os::Surface* surface,
+                       const gfx::Rect& src,
+                       const gfx::Rect& center,
+                       const gfx::Rect& dst,
+                       bool drawCenter,
+                       const os::Paint* paint) override;
+
+  void applyScale(int scaleFactor) override;
+  void* nativeHandle() override;
+
+private:
+  uint32_t* row(const int y) const { return m_data + std::size_t(y) * m_stride; }
+
+  // Draws the "srcRect" of "src" scaled to "dstRect", optionally
+  // replacing its color with "tint".
+  void drawScaled(const Surface* src,
+                  const gfx::Rect& srcRect,
+                  const gfx::Rect& dstRect,
+                  const Sampling& sampling,
+                  BlendMode blendMode,
+                  gfx::Color tint);
+
+  // Fills the "rc" rectangle (intersected with the clip) with the
+  // given premultiplied color.
+  void fillRect(const gfx::Rect& rc, uint32_t color, BlendMode blendMode);
+  void drawSpan(int x0, int x1, int y, uint32_t color, BlendMode blendMode);
+
+  // Composites the "src" pixels (in the same format as this surface)
+  // in the "dst" position (clipped), "src" is a "srcStride" pixels
+  // wide image.
+  void compose(const uint32_t* src,
+               int srcStride,
+               const gfx::Rect& dst,
+               BlendMode blendMode,
+               gfx::Color tint = gfx::ColorNone);
+
+  // Called when pixels are modified to generate a new generation().
+  void changed();
+
+  int m_width;
+  int m_height;
+  std::vector<uint32_t> m_pixels;
+  // Pixels of the surface (m_pixels or external pixels)
+  uint32_t* m_data;
+  int m_stride;
+  std::shared_ptr<const void> m_owner;
+  // True if m_data are external pixels (e.g. a mapped file)
+  bool m_readOnly = false;
+  ColorSpaceRef m_colorSpace;
+  gfx::Rect m_clip;
+  std::vector<gfx::Rect> m_clipStack;
+  int m_lock = 0;
+  uint64_t m_generation;
+};
+
+} // namespace os
+
+#endif
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2018-2024  Igara Studio S.A.
+// Copyright (c) 2018-2025  Igara Studio S.A.
 // Copyright (c) 2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,10 +12,20 @@
 #include "base/memory.h"
 #include "base/string.h"
 #include "gfx/size.h"
+#include "os/common/image_decoder.h"
 #include "os/font.h"
+#include "os/none/none_surface.h"
 #include "os/system.h"
 #include "os/window.h"
 
+#ifdef LAF_FREETYPE
+  #include "ft/lib.h"
+  #include "os/common/freetype_font.h"
+  #include "os/common/freetype_font_manager.h"
+
+  #include <memory>
+#endif
+
 namespace os {
 
 class NoneSystem : public System {
@@ -41,24 +51,74 @@ public:
   Ref<Window> makeWindow(const WindowSpec& spec) override { return nullptr; }
   Ref<Surface> makeSurface(int width, int height, const os::ColorSpaceRef& colorSpace) override
   {
-    return nullptr;
+    return os::make_ref<NoneSurface>(width, height, colorSpace);
   }
 #if CLIP_ENABLE_IMAGE
   Ref<Surface> makeSurface(const clip::image& image) override { return nullptr; }
 #endif
   Ref<Surface> makeRgbaSurface(int width, int height, const os::ColorSpaceRef& colorSpace) override
   {
-    return nullptr;
+    return os::make_ref<NoneSurface>(width, height, colorSpace);
+  }
+  Ref<Surface> loadSurface(const char* filename) override { return loadRgbaSurface(filename); }
+  Ref<Surface> loadRgbaSurface(const char* filename) override
+  {
+    // Only the formats of the built-in decoders are supported
+    ImageInfo info;
+    if (!read_image_info(filename, info))
+      return nullptr;
+
+    auto surface = make_ref<NoneSurface>(info.width, info.height);
+    SurfaceFormatData fd;
+    surface->getFormat(&fd);
+    if (!decode_image(filename, gfx::Rect(), (uint32_t*)surface->getData(0, 0), info.width, fd))
+      return nullptr;
+    return surface;
+  }
+  Ref<Surface> makeRgbaSurfaceFromData(int width,
+                                       int height,
+                                       const SurfaceFormatData& format,
+                                       const void* pixels,
+                                       std::size_t rowBytes,
+                                       std::shared_ptr<const void> owner,
+                                       const os::ColorSpaceRef& colorSpace) override
+  {
+    SurfaceFormatData noneFormat;
+    NoneSurface::getNoneFormat(&noneFormat);
+    if (format != noneFormat || rowBytes % 4 != 0 || rowBytes / 4 < std::size_t(width))
+      return nullptr;
+    return os::make_ref<NoneSurface>(width,
+                                     height,
+                                     (const uint32_t*)pixels,
+                                     int(rowBytes / 4),
+                                     std::move(owner),
+                                     colorSpace);
   }
-  Ref<Surface> loadSurface(const char* filename) override { return nullptr; }
-  Ref<Surface> loadRgbaSurface(const char* filename) override { return nullptr; }
   Ref<Cursor> makeCursor(const Surface* surface, const gfx::Point& focus, const int scale) override
   {
     return nullptr;
   }
-  FontManager* fontManager() override { return nullptr; }
+  FontManager* fontManager() override
+  {
+#ifdef LAF_FREETYPE
+    if (!m_fontManager)
+      m_fontManager = make_ref<FreeTypeFontManager>();
+    return m_fontManager.get();
+#else
+    return nullptr;
+#endif
+  }
   Ref<Font> loadSpriteSheetFont(const char* filename, int scale) override { return nullptr; }
-  Ref<Font> loadTrueTypeFont(const char* filename, int height) override { return nullptr; }
+  Ref<Font> loadTrueTypeFont(const char* filename, int height) override
+  {
+#ifdef LAF_FREETYPE
+    if (!m_ft)
+      m_ft = std::make_unique<ft::Lib>();
+    return Ref<Font>(load_free_type_font(*m_ft, filename, height));
+#else
+    return nullptr;
+#endif
+  }
   bool isKeyPressed(KeyScancode scancode) override { return false; }
   KeyModifiers keyModifiers() override { return kKeyNoneModifier; }
   int getUnicodeFromScancode(KeyScancode scancode) override { return 0; }
@@ -81,6 +141,10 @@ public:
 
 private:
   std::string m_appName;
+#ifdef LAF_FREETYPE
+  std::unique_ptr<ft::Lib> m_ft;
+  Ref<FontManager> m_fontManager;
+#endif
 };
 
 System* make_system_impl()
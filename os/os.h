@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2019-2024  Igara Studio S.A.
+// Copyright (c) 2019-2025  Igara Studio S.A.
 // Copyright (c) 2012-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -25,6 +25,8 @@
 #include "os/font_manager.h"
 #include "os/font_style.h"
 #include "os/font_style_set.h"
+#include "os/image_loader.h"
+#include "os/image_saver.h"
 #include "os/keys.h"
 #include "os/logger.h"
 #include "os/menus.h"
@@ -32,11 +34,13 @@
 #include "os/native_dialogs.h"
 #include "os/paint.h"
 #include "os/pointer_type.h"
+#include "os/raw_surface.h"
 #include "os/ref.h"
 #include "os/screen.h"
 #include "os/shortcut.h"
 #include "os/surface.h"
 #include "os/surface_format.h"
+#include "os/surface_pyramid.h"
 #include "os/system.h"
 #include "os/tablet_options.h"
 #include "os/typeface.h"
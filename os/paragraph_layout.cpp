@@ -0,0 +1,345 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/paragraph_layout.h"
+
+#include "base/debug.h"
+#include "base/line_break.h"
+#include "os/surface.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace os {
+
+ParagraphLayout::ParagraphLayout()
+{
+  splitParagraphs(m_text, 0, m_paragraphs);
+}
+
+ParagraphLayout::ParagraphLayout(const FontRef& font, const std::string& text, const double width)
+  : m_font(font)
+  , m_width(width)
+{
+  setText(text);
+}
+
+void ParagraphLayout::setFont(const FontRef& font)
+{
+  m_font = font;
+  invalidate();
+}
+
+void ParagraphLayout::setText(const std::string& text)
+{
+  m_text = text;
+  m_paragraphs.clear();
+  splitParagraphs(m_text, 0, m_paragraphs);
+  m_dirty = true;
+}
+
+void ParagraphLayout::setWidth(const double width)
+{
+  if (m_width == width)
+    return;
+
+  m_width = width;
+  for (Paragraph& para : m_paragraphs)
+    para.wrapped = false;
+  m_dirty = true;
+}
+
+void ParagraphLayout::replaceText(int pos, int length, const std::string& text)
+{
+  pos = std::clamp(pos, 0, int(m_text.size()));
+  length = std::clamp(length, 0, int(m_text.size()) - pos);
+
+  // Paragraphs that contain the first and the last modified byte (a
+  // paragraph contains its '\n' too)
+  auto paraEnd = [](const Paragraph& para, const int index) {
+    return para.begin + para.length < index;
+  };
+  auto first = std::lower_bound(m_paragraphs.begin(), m_paragraphs.end(), pos, paraEnd);
+  auto last = std::lower_bound(first, m_paragraphs.end(), pos + length, paraEnd);
+  ASSERT(first != m_paragraphs.end());
+  ASSERT(last != m_paragraphs.end());
+
+  const int delta = int(text.size()) - length;
+  const int begin = first->begin;
+  const int end = last->begin + last->length + delta;
+  m_text.replace(pos, length, text);
+
+  // Move the following paragraphs (they don't need a new layout)
+  for (auto it = last + 1; it != m_paragraphs.end(); ++it) {
+    it->begin += delta;
+    for (Line& line : it->lines) {
+      line.begin += delta;
+      line.end += delta;
+    }
+  }
+
+  std::vector<Paragraph> newParagraphs;
+  splitParagraphs(m_text.substr(begin, end - begin), begin, newParagraphs);
+
+  const auto it = m_paragraphs.erase(first, last + 1);
+  m_paragraphs.insert(it,
+                      std::make_move_iterator(newParagraphs.begin()),
+                      std::make_move_iterator(newParagraphs.end()));
+  m_dirty = true;
+}
+
+void ParagraphLayout::invalidate()
+{
+  for (Paragraph& para : m_paragraphs)
+    para.shaped = para.wrapped = false;
+  m_dirty = true;
+}
+
+void ParagraphLayout::layout()
+{
+  if (!m_dirty)
+    return;
+
+  // Shape all the modified paragraphs together (so they can be shaped
+  // in parallel)
+  std::vector<Paragraph*> toShape;
+  std::vector<std::string> strings;
+  for (Paragraph& para : m_paragraphs) {
+    if (!para.shaped) {
+      toShape.push_back(&para);
+      strings.push_back(m_text.substr(para.begin, para.length));
+    }
+  }
+  if (!toShape.empty()) {
+    std::vector<TextLayout> layouts;
+    if (m_font)
+      layouts = layout_texts(m_font.get(), strings, m_pool);
+    else
+      layouts.resize(strings.size());
+
+    for (size_t i = 0; i < toShape.size(); ++i) {
+      toShape[i]->layout = std::move(layouts[i]);
+      toShape[i]->shaped = true;
+      toShape[i]->wrapped = false;
+    }
+  }
+
+  m_firstLine.resize(m_paragraphs.size() + 1);
+  int lines = 0;
+  for (size_t i = 0; i < m_paragraphs.size(); ++i) {
+    Paragraph& para = m_paragraphs[i];
+    if (!para.wrapped)
+      wrapParagraph(para);
+
+    m_firstLine[i] = lines;
+    lines += int(para.lines.size());
+  }
+  m_firstLine.back() = lines;
+  m_dirty = false;
+}
+
+int ParagraphLayout::lineCount()
+{
+  layout();
+  return m_firstLine.back();
+}
+
+const ParagraphLayout::Line& ParagraphLayout::line(const int i)
+{
+  layout();
+  ASSERT(i >= 0 && i < m_firstLine.back());
+
+  const auto it = std::upper_bound(m_firstLine.begin(), m_firstLine.end(), i) - 1;
+  const int para = it - m_firstLine.begin();
+  return m_paragraphs[para].lines[i - *it];
+}
+
+int ParagraphLayout::lineHeight() const
+{
+  return (m_font ? m_font->height() : 0);
+}
+
+gfx::Size ParagraphLayout::size()
+{
+  layout();
+
+  double width = 0.0;
+  for (const Paragraph& para : m_paragraphs)
+    for (const Line& line : para.lines)
+      width = std::max(width, line.width);
+
+  return gfx::Size(int(std::ceil(width)), lineCount() * lineHeight());
+}
+
+int ParagraphLayout::hitTest(const gfx::PointF& pt)
+{
+  layout();
+
+  const int lh = lineHeight();
+  const int i = std::clamp(lh > 0 ? int(std::floor(pt.y / lh)) : 0, 0, lineCount() - 1);
+  const Line& l = line(i);
+
+  for (const TextLayout::Glyph& g : l.layout.glyphs) {
+    if (pt.x < g.endX)
+      return l.begin + g.charIndex;
+  }
+  return l.end;
+}
+
+gfx::RectF ParagraphLayout::clusterBounds(const int index)
+{
+  layout();
+
+  const int i = findLine(index);
+  const Line& l = line(i);
+  const double y = i * lineHeight();
+
+  gfx::RectF bounds(l.layout.advance, y, 0.0, lineHeight());
+  bool found = false;
+  for (const TextLayout::Glyph& g : l.layout.glyphs) {
+    if (l.begin + g.charIndex == index) {
+      const gfx::RectF glyphBounds(g.startX, y, g.endX - g.startX, lineHeight());
+      bounds = (found ? bounds.createUnion(glyphBounds) : glyphBounds);
+      found = true;
+    }
+  }
+  return bounds;
+}
+
+void ParagraphLayout::draw(Surface* surface,
+                           const gfx::Color fg,
+                           const gfx::Color bg,
+                           const int x,
+                           const int y)
+{
+  if (!m_font)
+    return;
+
+  layout();
+
+  const int lh = lineHeight();
+  int firstLine = 0;
+  int lastLine = lineCount() - 1;
+  if (surface && lh > 0) {
+    const gfx::Rect clip = surface->getClipBounds();
+    firstLine = std::max(firstLine, (clip.y - y) / lh);
+    lastLine = std::min(lastLine, (clip.y2() - y) / lh);
+  }
+
+  for (int i = firstLine; i <= lastLine; ++i)
+    draw_text_layout(surface, m_font.get(), line(i).layout, fg, bg, x, y + i * lh);
+}
+
+// static
+void ParagraphLayout::splitParagraphs(const std::string& text,
+                                      const int offset,
+                                      std::vector<Paragraph>& paragraphs)
+{
+  size_t begin = 0;
+  while (true) {
+    const size_t end = text.find('\n', begin);
+
+    Paragraph para;
+    para.begin = offset + int(begin);
+    para.length = int((end == std::string::npos ? text.size() : end) - begin);
+    paragraphs.push_back(std::move(para));
+
+    if (end == std::string::npos)
+      break;
+    begin = end + 1;
+  }
+}
+
+void ParagraphLayout::wrapParagraph(Paragraph& para)
+{
+  const std::string str = m_text.substr(para.begin, para.length);
+  const std::vector<TextLayout::Glyph>& glyphs = para.layout.glyphs;
+
+  // X position where each byte of the paragraph starts (bytes in the
+  // middle of a cluster get the position of the next cluster)
+  std::vector<double> xs(para.length + 1, -1.0);
+  xs[para.length] = para.layout.advance;
+  for (auto it = glyphs.rbegin(); it != glyphs.rend(); ++it) {
+    if (it->charIndex >= 0 && it->charIndex < para.length)
+      xs[it->charIndex] = it->startX;
+  }
+  for (int i = para.length - 1; i >= 0; --i) {
+    if (xs[i] < 0.0)
+      xs[i] = xs[i + 1];
+  }
+
+  // Trailing spaces don't count in the line width
+  auto lineWidth = [&](const int begin, int end) {
+    while (end > begin && str[end - 1] == ' ')
+      --end;
+    return xs[end] - xs[begin];
+  };
+
+  para.lines.clear();
+  size_t glyph = 0;
+  auto addLine = [&](const int begin, const int end) {
+    Line line;
+    line.begin = para.begin + begin;
+    line.end = para.begin + end;
+    line.width = lineWidth(begin, end);
+    line.layout.fontSize = para.layout.fontSize;
+    line.layout.advance = xs[end] - xs[begin];
+
+    // Glyphs are sorted by cluster (left-to-right text)
+    const double x0 = xs[begin];
+    for (; glyph < glyphs.size() && glyphs[glyph].charIndex < end; ++glyph) {
+      TextLayout::Glyph g = glyphs[glyph];
+      g.charIndex -= begin;
+      g.x -= x0;
+      g.startX -= x0;
+      g.endX -= x0;
+      line.layout.glyphs.push_back(g);
+    }
+    para.lines.push_back(std::move(line));
+  };
+
+  std::vector<base::line_break> breaks = base::find_line_breaks(str);
+  breaks.push_back(base::line_break{ para.length, true });
+
+  int begin = 0;
+  int lastFit = 0; // Last break opportunity where the line fits
+  for (const base::line_break& b : breaks) {
+    if (m_width > 0.0 && lastFit > begin && lineWidth(begin, b.pos) > m_width) {
+      addLine(begin, lastFit);
+      begin = lastFit;
+    }
+    if (b.mandatory) {
+      addLine(begin, b.pos);
+      begin = b.pos;
+    }
+    lastFit = b.pos;
+  }
+
+  para.wrapped = true;
+}
+
+int ParagraphLayout::findLine(const int index)
+{
+  auto paraEnd = [](const Paragraph& para, const int index) {
+    return para.begin + para.length < index;
+  };
+  auto it = std::lower_bound(m_paragraphs.begin(), m_paragraphs.end(), index, paraEnd);
+  if (it == m_paragraphs.end())
+    --it;
+
+  const int para = it - m_paragraphs.begin();
+  const std::vector<Line>& lines = it->lines;
+  int i = 0;
+  while (i + 1 < int(lines.size()) && index >= lines[i + 1].begin)
+    ++i;
+  return m_firstLine[para] + i;
+}
+
+} // namespace os
@@ -0,0 +1,121 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_PARAGRAPH_LAYOUT_H_INCLUDED
+#define OS_PARAGRAPH_LAYOUT_H_INCLUDED
+#pragma once
+
+#include "gfx/color.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/font.h"
+#include "os/text_layout.h"
+
+#include <string>
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Surface;
+
+// Multi-line text wrapped to a specific width. The text is divided
+// in paragraphs (by '\n' chars), each paragraph is shaped once and
+// then broken in lines at the line break opportunities given by
+// base::find_line_breaks(). Shaped paragraphs and their lines are
+// cached, so editing the text with replaceText() re-shapes only the
+// modified paragraphs, and changing the width doesn't re-shape
+// anything (only lines are wrapped again).
+//
+// Each paragraph is shaped as a whole, so glyphs don't change when a
+// line is broken (only left-to-right text is supported).
+class ParagraphLayout {
+public:
+  struct Line {
+    int begin, end; // Byte range in the whole text (without the '\n')
+    double width;   // Width without trailing spaces
+    TextLayout layout; // Glyph charIndex is relative to "begin"
+  };
+
+  ParagraphLayout();
+  ParagraphLayout(const FontRef& font, const std::string& text, double width);
+
+  Font* font() const { return m_font.get(); }
+  const std::string& text() const { return m_text; }
+  double width() const { return m_width; }
+
+  void setFont(const FontRef& font);
+  void setText(const std::string& text);
+
+  // Max width of each line (lines are not wrapped if it's <= 0).
+  void setWidth(double width);
+
+  // Uses the threads of the given pool to shape several paragraphs
+  // at the same time (see layout_texts()).
+  void setThreadPool(base::thread_pool* pool) { m_pool = pool; }
+
+  // Replaces "length" bytes from "pos" with the given text, only the
+  // paragraphs affected by the change are laid out again.
+  void replaceText(int pos, int length, const std::string& text);
+
+  // Forces to shape all the text again (e.g. if the font size was
+  // changed).
+  void invalidate();
+
+  // Shapes modified paragraphs and breaks lines, it's called
+  // automatically by all the functions below.
+  void layout();
+
+  int lineCount();
+  const Line& line(int i);
+  int lineHeight() const;
+  gfx::Size size();
+
+  // Returns the byte index (in text()) of the cluster in the given
+  // position (relative to the origin of the paragraph), or the
+  // end of the line if the position is after the last cluster.
+  int hitTest(const gfx::PointF& pt);
+
+  // Returns the bounds of the cluster at the given byte index.
+  gfx::RectF clusterBounds(int index);
+
+  // Draws all the visible lines (inside the surface clip bounds).
+  void draw(Surface* surface, gfx::Color fg, gfx::Color bg, int x, int y);
+
+private:
+  struct Paragraph {
+    int begin = 0;  // Byte index in the whole text
+    int length = 0; // Number of bytes (without the '\n')
+    bool shaped = false;
+    bool wrapped = false;
+    TextLayout layout; // Layout of the whole paragraph
+    std::vector<Line> lines;
+  };
+
+  static void splitParagraphs(const std::string& text,
+                              int offset,
+                              std::vector<Paragraph>& paragraphs);
+  void wrapParagraph(Paragraph& para);
+  int findLine(int index);
+
+  FontRef m_font;
+  std::string m_text;
+  double m_width = 0.0;
+  base::thread_pool* m_pool = nullptr;
+  std::vector<Paragraph> m_paragraphs;
+
+  // Index of the first line of each paragraph + total lines at the end
+  std::vector<int> m_firstLine;
+  bool m_dirty = true;
+};
+
+} // namespace os
+
+#endif
@@ -0,0 +1,190 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#if LAF_FREETYPE
+
+  #include "os/common/sprite_sheet_font.h"
+  #include "os/paragraph_layout.h"
+
+  #include <string>
+  #include <vector>
+
+using namespace os;
+
+namespace {
+
+constexpr int kCharW = 10;
+constexpr int kCharH = 12;
+
+// Monospaced sprite sheet font (without a sheet, only the bounds of
+// the chars are needed to lay out the text).
+FontRef make_font()
+{
+  std::vector<gfx::Rect> chars;
+  for (int chr = ' '; chr <= 128; ++chr)
+    chars.push_back(gfx::Rect((chr - ' ') * kCharW, 0, kCharW, kCharH));
+  return SpriteSheetFont::fromSurface(SurfaceRef(), chars);
+}
+
+void expect_line(ParagraphLayout& para,
+                 const int i,
+                 const int begin,
+                 const int end,
+                 const double width)
+{
+  const ParagraphLayout::Line& l = para.line(i);
+  EXPECT_EQ(begin, l.begin) << "line " << i;
+  EXPECT_EQ(end, l.end) << "line " << i;
+  EXPECT_EQ(width, l.width) << "line " << i;
+  EXPECT_EQ(end - begin, int(l.layout.glyphs.size())) << "line " << i;
+}
+
+// Compares the lines of an edited paragraph with the lines of the
+// same text laid out from scratch.
+void expect_same_lines(ParagraphLayout& edited, const FontRef& font)
+{
+  ParagraphLayout expected(font, edited.text(), edited.width());
+  ASSERT_EQ(expected.lineCount(), edited.lineCount()) << edited.text();
+  for (int i = 0; i < expected.lineCount(); ++i) {
+    const ParagraphLayout::Line& l = expected.line(i);
+    expect_line(edited, i, l.begin, l.end, l.width);
+  }
+}
+
+} // anonymous namespace
+
+TEST(ParagraphLayout, WrapAtSpaces)
+{
+  ParagraphLayout para(make_font(), "hello world foo", 60);
+  EXPECT_EQ(kCharH, para.lineHeight());
+  ASSERT_EQ(3, para.lineCount());
+  expect_line(para, 0, 0, 6, 50); // Trailing space doesn't count
+  expect_line(para, 1, 6, 12, 50);
+  expect_line(para, 2, 12, 15, 30);
+  EXPECT_EQ(gfx::Size(50, 3 * kCharH), para.size());
+
+  // Glyphs are relative to the beginning of the line
+  const ParagraphLayout::Line& l = para.line(1);
+  EXPECT_EQ(0, l.layout.glyphs[0].charIndex);
+  EXPECT_EQ(0.0, l.layout.glyphs[0].startX);
+  EXPECT_EQ(60.0, l.layout.advance);
+}
+
+TEST(ParagraphLayout, SetWidth)
+{
+  ParagraphLayout para(make_font(), "hello world foo", 0);
+  ASSERT_EQ(1, para.lineCount());
+  expect_line(para, 0, 0, 15, 150);
+
+  para.setWidth(60);
+  ASSERT_EQ(3, para.lineCount());
+  expect_line(para, 2, 12, 15, 30);
+
+  // "world foo" fits exactly
+  para.setWidth(90);
+  ASSERT_EQ(2, para.lineCount());
+  expect_line(para, 0, 0, 6, 50);
+  expect_line(para, 1, 6, 15, 90);
+
+  para.setWidth(150);
+  ASSERT_EQ(1, para.lineCount());
+}
+
+TEST(ParagraphLayout, WordWiderThanWidth)
+{
+  // Words are not broken when there is no break opportunity
+  ParagraphLayout para(make_font(), "abcdefghij klm", 30);
+  ASSERT_EQ(2, para.lineCount());
+  expect_line(para, 0, 0, 11, 100);
+  expect_line(para, 1, 11, 14, 30);
+}
+
+TEST(ParagraphLayout, NewLines)
+{
+  ParagraphLayout para(make_font(), "ab\n\ncd ef", 30);
+  ASSERT_EQ(4, para.lineCount());
+  expect_line(para, 0, 0, 2, 20);
+  expect_line(para, 1, 3, 3, 0); // Empty paragraph
+  expect_line(para, 2, 4, 7, 20);
+  expect_line(para, 3, 7, 9, 20);
+}
+
+TEST(ParagraphLayout, ReplaceText)
+{
+  const FontRef font = make_font();
+  ParagraphLayout para(font, "hello world\nfoo bar\nlast line", 60);
+  ASSERT_EQ(6, para.lineCount());
+
+  // Insert in the middle of a paragraph (the following paragraph is
+  // only moved)
+  para.replaceText(6, 0, "big ");
+  EXPECT_EQ("hello big world\nfoo bar\nlast line", para.text());
+  expect_same_lines(para, font);
+  expect_line(para, 3, 16, 20, 30);
+
+  // Split a paragraph
+  para.replaceText(19, 1, "\n");
+  EXPECT_EQ("hello big world\nfoo\nbar\nlast line", para.text());
+  expect_same_lines(para, font);
+
+  // Join two paragraphs
+  para.replaceText(15, 1, " ");
+  EXPECT_EQ("hello big world foo\nbar\nlast line", para.text());
+  expect_same_lines(para, font);
+
+  // Replace text across paragraphs
+  para.replaceText(10, 14, "x\ny");
+  EXPECT_EQ("hello big x\nylast line", para.text());
+  expect_same_lines(para, font);
+
+  // Edits at the beginning and at the end
+  para.replaceText(0, 6, "");
+  para.replaceText(int(para.text().size()), 0, " end");
+  EXPECT_EQ("big x\nylast line end", para.text());
+  expect_same_lines(para, font);
+
+  // Remove everything
+  para.replaceText(0, int(para.text().size()), "");
+  ASSERT_EQ(1, para.lineCount());
+  expect_line(para, 0, 0, 0, 0);
+}
+
+TEST(ParagraphLayout, HitTest)
+{
+  ParagraphLayout para(make_font(), "hello world\nab", 60);
+  ASSERT_EQ(3, para.lineCount());
+
+  EXPECT_EQ(0, para.hitTest(gfx::PointF(0, 0)));
+  EXPECT_EQ(1, para.hitTest(gfx::PointF(15, 5)));
+  EXPECT_EQ(7, para.hitTest(gfx::PointF(15, kCharH + 1)));
+
+  // After the last cluster of each line
+  EXPECT_EQ(6, para.hitTest(gfx::PointF(1000, 0)));
+  EXPECT_EQ(11, para.hitTest(gfx::PointF(1000, kCharH)));
+  EXPECT_EQ(14, para.hitTest(gfx::PointF(1000, 2 * kCharH)));
+
+  // Outside the paragraph (the nearest line is used)
+  EXPECT_EQ(0, para.hitTest(gfx::PointF(-10, -10)));
+  EXPECT_EQ(13, para.hitTest(gfx::PointF(15, 1000)));
+  EXPECT_EQ(14, para.hitTest(gfx::PointF(1000, 1000)));
+
+  EXPECT_EQ(gfx::RectF(10, kCharH, 10, kCharH), para.clusterBounds(7));
+  EXPECT_EQ(gfx::RectF(20, 2 * kCharH, 0, kCharH), para.clusterBounds(14));
+}
+
+#endif // LAF_FREETYPE
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
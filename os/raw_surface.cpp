@@ -0,0 +1,99 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/raw_surface.h"
+
+#include "os/common/pixel_container.h"
+#include "os/common/surface_utils.h"
+#include "os/system.h"
+
+namespace os {
+
+namespace {
+
+uint64_t hash_of(const os::ColorSpace* colorSpace)
+{
+  return color_space_hash(colorSpace ? colorSpace->gfxColorSpace().get() : nullptr);
+}
+
+} // anonymous namespace
+
+bool save_raw_surface(Surface* surface,
+                      const char* filename,
+                      const bool compress,
+                      base::thread_pool* pool)
+{
+  if (!surface)
+    return false;
+
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  if (fd.bitsPerPixel != 32)
+    return false;
+
+  const SurfaceLock lock(surface, SurfaceLock::ReadOnly);
+  const uint32_t* pixels = (const uint32_t*)surface->getData(0, 0);
+  if (!pixels)
+    return false;
+
+  // Distance between rows in pixels
+  const int stride = row_stride(surface);
+
+  return write_pixel_container(filename,
+                               pixels,
+                               surface->width(),
+                               surface->height(),
+                               stride,
+                               fd,
+                               hash_of(surface->colorSpace().get()),
+                               compress,
+                               pool);
+}
+
+SurfaceRef load_raw_surface(const char* filename,
+                            const os::ColorSpaceRef& colorSpace,
+                            base::thread_pool* pool)
+{
+  PixelContainer container;
+  if (!container.open(filename) || container.info().colorSpaceHash != hash_of(colorSpace.get()))
+    return nullptr;
+
+  const PixelContainerInfo& info = container.info();
+  System* system = instance();
+  if (!info.compressed) {
+    SurfaceRef surface = system->makeRgbaSurfaceFromData(info.width,
+                                                         info.height,
+                                                         info.format,
+                                                         container.pixels(),
+                                                         container.rowBytes(),
+                                                         container.file(),
+                                                         colorSpace);
+    if (surface)
+      return surface;
+  }
+
+  SurfaceRef surface = system->makeRgbaSurface(info.width, info.height, colorSpace);
+  if (!surface)
+    return nullptr;
+
+  SurfaceFormatData fd;
+  surface->getFormat(&fd);
+  const SurfaceLock lock(surface.get());
+  uint32_t* pixels = (uint32_t*)surface->getData(0, 0);
+  if (!pixels)
+    return nullptr;
+
+  const int stride = row_stride(surface.get());
+  if (!container.read(pixels, stride, fd, pool))
+    return nullptr;
+  return surface;
+}
+
+} // namespace os
@@ -0,0 +1,42 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_RAW_SURFACE_H_INCLUDED
+#define OS_RAW_SURFACE_H_INCLUDED
+#pragma once
+
+#include "os/color_space.h"
+#include "os/surface.h"
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+// Saves the surface pixels in a raw pixel container file (see
+// os/common/pixel_container.h) to cache them between sessions. If
+// "compress" is true, tiles of pixels are compressed (in parallel
+// with the threads of the "pool" if it's not nullptr).
+bool save_raw_surface(Surface* surface,
+                      const char* filename,
+                      bool compress = false,
+                      base::thread_pool* pool = nullptr);
+
+// Loads a raw pixel container file saved with save_raw_surface().
+// Uncompressed files with the pixel format of the RGBA surfaces of
+// the current System are mapped in memory and used directly as the
+// pixels of a read-only surface (pages are loaded on demand). Other
+// files are decompressed/converted to a new RGBA surface. Returns
+// nullptr if the file is invalid or if its pixels were saved with a
+// different color space than "colorSpace".
+SurfaceRef load_raw_surface(const char* filename,
+                            const os::ColorSpaceRef& colorSpace = nullptr,
+                            base::thread_pool* pool = nullptr);
+
+} // namespace os
+
+#endif
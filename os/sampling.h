@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2022  Igara Studio S.A.
+// Copyright (c) 2022-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -13,9 +13,13 @@
 
 namespace os {
 
-// Same as SkSamplingOptions struct
+// Same as SkSamplingOptions struct (plus some filters that are only
+// available in os::resample())
 struct Sampling {
   enum class Filter { Nearest, Linear };
+  // Filters that Skia doesn't have, when they are used Skia surfaces
+  // draw scaled surfaces with os::resample()
+  enum class Kernel { Default, Box, Lanczos };
   enum class Mipmap { None, Nearest, Linear };
   struct Cubic {
     float B, C;
@@ -27,12 +31,14 @@ struct Sampling {
   Cubic cubic = { 0, 0 };
   Filter filter = Filter::Nearest;
   Mipmap mipmap = Mipmap::None;
+  Kernel kernel = Kernel::Default;
 
   Sampling() = default;
   Sampling(const Sampling&) = default;
   Sampling& operator=(const Sampling&) = default;
   Sampling(Filter f, Mipmap m = Mipmap::None) : filter(f), mipmap(m) {}
   Sampling(Cubic c) : useCubic(true), cubic(c) {}
+  Sampling(Kernel k) : filter(Filter::Linear), kernel(k) {}
 };
 
 } // namespace os
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -61,7 +61,15 @@ inline void to_skia(const Sampling& sampling, SkSamplingOptions& skSampling)
                   (int)SkMipmapMode::kLinear == (int)Sampling::Mipmap::Linear,
                 "Sampling mipmap modes don't match with Skia");
 
-  if (sampling.useCubic) {
+  // Approximations of the filters that Skia doesn't have (used when
+  // the surface cannot be drawn with os::resample())
+  if (sampling.kernel == Sampling::Kernel::Box) {
+    skSampling = SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kLinear);
+  }
+  else if (sampling.kernel == Sampling::Kernel::Lanczos) {
+    skSampling = SkSamplingOptions(SkCubicResampler::CatmullRom());
+  }
+  else if (sampling.useCubic) {
     skSampling = SkSamplingOptions({ sampling.cubic.B, sampling.cubic.C });
   }
   else {
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2018-2024  Igara Studio S.A.
+// Copyright (c) 2018-2025  Igara Studio S.A.
 // Copyright (c) 2016-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,6 +13,9 @@
 
 #include "base/file_handle.h"
 #include "gfx/path.h"
+#include "os/common/image_decoder.h"
+#include "os/common/nine_slice.h"
+#include "os/common/resample.h"
 #include "os/skia/skia_helpers.h"
 #include "os/surface_format.h"
 #include "os/system.h"
@@ -21,12 +24,14 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkColorData.h"
+#include "include/utils/SkNoDrawCanvas.h"
 
 #if SK_SUPPORT_GPU
   #include "include/gpu/GrBackendSurface.h"
@@ -58,6 +63,17 @@ static SkCanvas::SrcRectConstraint to_constraint(const Paint* paint)
   return SkCanvas::kStrict_SrcRectConstraint;
 }
 
+// Rendered nine-slices of immutable surfaces (only the small ones
+// are cached)
+static constexpr std::size_t kNineSliceCacheSize = 8 * 1024 * 1024;
+static constexpr std::size_t kMaxCachedNineSlice = 256 * 1024;
+
+static NineSliceCache<sk_sp<SkImage>>& nine_slice_cache()
+{
+  static NineSliceCache<sk_sp<SkImage>> cache(kNineSliceCacheSize);
+  return cache;
+}
+
 SkiaSurface::SkiaSurface() : m_surface(nullptr), m_colorSpace(nullptr), m_canvas(nullptr), m_lock(0)
 {
 }
@@ -230,6 +246,13 @@ gfx::Matrix SkiaSurface::matrix() const
 }
 
 void SkiaSurface::lock()
+{
+  // Read-only pixels cannot be modified with getData()
+  ASSERT(!m_readOnly);
+  lockReadOnly();
+}
+
+void SkiaSurface::lockReadOnly()
 {
   ASSERT(m_lock >= 0);
   if (m_lock++ == 0) {
@@ -238,6 +261,11 @@ void SkiaSurface::lock()
   }
 }
 
+void SkiaSurface::unlockReadOnly()
+{
+  unlock();
+}
+
 void SkiaSurface::unlock()
 {
   ASSERT(m_lock > 0);
@@ -267,6 +295,7 @@ void SkiaSurface::applyScale(int scaleFactor)
                        &paint,
                        SkCanvas::kStrict_SrcRectConstraint);
 
+  m_readOnly = false;
   swapBitmap(result);
 }
 
@@ -373,7 +402,7 @@ void SkiaSurface::putPixel(gfx::Color color, int x, int y)
     m_paint.setColor(to_skia(color));
     m_canvas->drawPoint(SkIntToScalar(x), SkIntToScalar(y), m_paint);
   }
-  else {
+  else if (!m_readOnly) {
     // TODO Find a better way to put a pixel in the same color space
     //      as the internal SkPixmap (as Skia expects a sRGB color
     //      in SkBitmap::erase())
@@ -472,7 +501,7 @@ void SkiaSurface::scrollTo(const gfx::Rect& rc, int dx, int dy)
   int w = width();
   int h = height();
   gfx::Clip clip(rc.x + dx, rc.y + dy, rc);
-  if (!clip.clip(w, h, w, h))
+  if (m_readOnly || !clip.clip(w, h, w, h))
     return;
 
   if (m_surface) {
@@ -530,6 +559,17 @@ void SkiaSurface::drawSurface(const Surface* src,
   SkPaint skSrcPaint;
   skSrcPaint.setBlendMode(SkBlendMode::kSrc);
 
+  // Skia doesn't have these filters, so we scale the surface with
+  // os::resample() and draw the result without scaling.
+  if (sampling.kernel != Sampling::Kernel::Default &&
+      drawResampledSurface(static_cast<const SkiaSurface*>(src),
+                           srcRect,
+                           dstRect,
+                           sampling,
+                           (paint ? paint->skPaint() : skSrcPaint))) {
+    return;
+  }
+
   SkSamplingOptions skSampling;
   to_skia(sampling, skSampling);
 
@@ -666,19 +706,68 @@ void SkiaSurface::drawSurfaceNine(os::Surface* surface,
   lattice.fBounds = &srcRect;
   lattice.fColors = nullptr;
 
+  const SkiaSurface* source = (SkiaSurface*)surface;
+
 #if SK_SUPPORT_GPU
-  if (auto srcImage = ((SkiaSurface*)surface)->getOrCreateTextureImage()) {
+  if (auto srcImage = source->getOrCreateTextureImage()) {
     m_canvas->drawImageLattice(srcImage, lattice, dstRect, SkFilterMode::kNearest, &skPaint);
     return;
   }
 #endif
 
-  m_canvas->drawImageLattice(
-    SkImage::MakeFromRaster(((SkiaSurface*)surface)->m_bitmap.pixmap(), nullptr, nullptr).get(),
-    lattice,
-    dstRect,
-    SkFilterMode::kNearest,
-    &skPaint);
+  const sk_sp<SkImage> srcImage =
+    SkImage::MakeFromRaster(source->m_bitmap.pixmap(), nullptr, nullptr);
+
+  // Nine-slices of immutable surfaces (e.g. theme sheets) are
+  // rendered once and drawn as a regular image (the tint color filter
+  // is applied when the image is drawn, so the key color is
+  // ColorNone).
+  const std::size_t bytes = 4 * std::size_t(dst.w) * dst.h;
+  if (srcImage && source->m_bitmap.isImmutable() && bytes > 0 && bytes <= kMaxCachedNineSlice) {
+    NineSliceCache<sk_sp<SkImage>>& cache = nine_slice_cache();
+    NineSliceKey key;
+    key.sourceId = source->m_bitmap.getGenerationID();
+    key.src = src;
+    key.center = center;
+    key.size = dst.size();
+    key.drawCenter = drawCenter;
+
+    sk_sp<SkImage> image = cache.find(key);
+    if (!image) {
+      SkBitmap bitmap;
+      if (bitmap.tryAllocPixels(
+            SkImageInfo::MakeN32Premul(dst.w, dst.h, source->m_bitmap.refColorSpace()))) {
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkPaint latticePaint;
+        latticePaint.setBlendMode(SkBlendMode::kSrcOver);
+        SkCanvas canvas(bitmap);
+        canvas.translate(SkIntToScalar(-dst.x), SkIntToScalar(-dst.y));
+        canvas.drawImageLattice(srcImage.get(),
+                                lattice,
+                                dstRect,
+                                SkFilterMode::kNearest,
+                                &latticePaint);
+        bitmap.setImmutable();
+        image = bitmap.asImage();
+        if (image)
+          cache.insert(key, image, bytes);
+      }
+    }
+    if (image) {
+      m_canvas->drawImage(image.get(),
+                          SkIntToScalar(dst.x),
+                          SkIntToScalar(dst.y),
+                          SkSamplingOptions(),
+                          &skPaint);
+      return;
+    }
+  }
+
+  m_canvas->drawImageLattice(srcImage.get(),
+                             lattice,
+                             dstRect,
+                             SkFilterMode::kNearest,
+                             &skPaint);
 }
 
 void SkiaSurface::swapBitmap(SkBitmap& other)
@@ -686,7 +775,10 @@ void SkiaSurface::swapBitmap(SkBitmap& other)
   ASSERT(!m_surface);
   m_bitmap.swap(other);
   delete m_canvas;
-  m_canvas = new SkCanvas(m_bitmap);
+  if (m_readOnly)
+    m_canvas = new SkNoDrawCanvas(m_bitmap.width(), m_bitmap.height());
+  else
+    m_canvas = new SkCanvas(m_bitmap);
 }
 
 // static
@@ -699,7 +791,7 @@ Ref<Surface> SkiaSurface::loadSurface(const char* filename)
   std::unique_ptr<SkCodec> codec(
     SkCodec::MakeFromStream(std::unique_ptr<SkFILEStream>(new SkFILEStream(f))));
   if (!codec)
-    return nullptr;
+    return loadSurfaceWithBuiltinDecoders(filename);
 
   SkImageInfo info =
     codec->getInfo().makeColorType(kN32_SkColorType).makeAlphaType(kPremul_SkAlphaType);
@@ -716,6 +808,64 @@ Ref<Surface> SkiaSurface::loadSurface(const char* filename)
   return sur;
 }
 
+// static
+Ref<Surface> SkiaSurface::loadSurfaceWithBuiltinDecoders(const char* filename)
+{
+  // Formats that Skia cannot decode (e.g. TGA or QOI)
+  ImageInfo info;
+  if (!read_image_info(filename, info))
+    return nullptr;
+
+  auto sur = make_ref<SkiaSurface>();
+  sur->createRgba(info.width, info.height, nullptr);
+
+  SurfaceFormatData fd;
+  sur->getFormat(&fd);
+  if (!decode_image(filename,
+                    gfx::Rect(),
+                    (uint32_t*)sur->m_bitmap.getPixels(),
+                    int(sur->m_bitmap.rowBytes() / 4),
+                    fd)) {
+    return nullptr;
+  }
+  sur->m_bitmap.notifyPixelsChanged();
+  return sur;
+}
+
+// static
+Ref<Surface> SkiaSurface::makeRgbaSurfaceFromData(const int width,
+                                                  const int height,
+                                                  const SurfaceFormatData& format,
+                                                  const void* pixels,
+                                                  const std::size_t rowBytes,
+                                                  std::shared_ptr<const void> owner,
+                                                  const os::ColorSpaceRef& cs)
+{
+  auto sur = make_ref<SkiaSurface>();
+  sur->m_colorSpace = cs;
+
+  // The owner is released by Skia when the pixels aren't used anymore
+  auto* context = new std::shared_ptr<const void>(std::move(owner));
+  SkBitmap bmp;
+  if (!bmp.installPixels(
+        SkImageInfo::MakeN32Premul(width, height, sur->skColorSpace()),
+        const_cast<void*>(pixels),
+        rowBytes,
+        [](void*, void* context) { delete (std::shared_ptr<const void>*)context; },
+        context)) {
+    return nullptr;
+  }
+  bmp.setImmutable();
+  sur->m_readOnly = true;
+  sur->swapBitmap(bmp);
+
+  SurfaceFormatData fd;
+  sur->getFormat(&fd);
+  if (fd != format)
+    return nullptr;
+  return sur;
+}
+
 void SkiaSurface::skDrawSurface(const Surface* src,
                                 const gfx::Clip& clip,
                                 const SkSamplingOptions& sampling,
@@ -768,6 +918,58 @@ void SkiaSurface::skDrawSurface(const SkiaSurface* src,
                           constraint);
 }
 
+bool SkiaSurface::drawResampledSurface(const SkiaSurface* src,
+                                       const gfx::Rect& srcRect,
+                                       const gfx::Rect& dstRect,
+                                       const Sampling& sampling,
+                                       const SkPaint& paint)
+{
+  // Only raster surfaces drawn with a translation (in other cases
+  // the Skia filter that is closer to "sampling" is used).
+  const SkMatrix& matrix = m_canvas->getTotalMatrix();
+  if (!matrix.isTranslate() || src->m_bitmap.isNull() || src->m_bitmap.bytesPerPixel() != 4 ||
+      srcRect.isEmpty() || dstRect.isEmpty() || !src->bounds().contains(srcRect)) {
+    return false;
+  }
+  const int tx = int(matrix.getTranslateX());
+  const int ty = int(matrix.getTranslateY());
+  if (tx != matrix.getTranslateX() || ty != matrix.getTranslateY())
+    return false;
+
+  // Calculate only the visible pixels of dstRect
+  SkIRect clip;
+  if (!m_canvas->getDeviceClipBounds(&clip))
+    return true;
+  gfx::Rect visible = gfx::Rect(dstRect).offset(tx, ty) &
+                      gfx::Rect(clip.x(), clip.y(), clip.width(), clip.height());
+  if (visible.isEmpty())
+    return true;
+  visible.offset(-tx, -ty);
+
+  SkBitmap tmp;
+  if (!tmp.tryAllocPixels(src->m_bitmap.info().makeWH(visible.w, visible.h)))
+    return false;
+
+  SurfaceFormatData fd;
+  src->getFormat(&fd);
+  resample((const uint32_t*)src->m_bitmap.getPixels(),
+           int(src->m_bitmap.rowBytesAsPixels()),
+           srcRect,
+           (uint32_t*)tmp.getPixels(),
+           int(tmp.rowBytesAsPixels()),
+           dstRect.size(),
+           gfx::Rect(visible).offset(-dstRect.origin()),
+           fd,
+           sampling);
+
+  m_canvas->drawImage(SkImage::MakeFromRaster(tmp.pixmap(), nullptr, nullptr),
+                      SkScalar(visible.x),
+                      SkScalar(visible.y),
+                      SkSamplingOptions(),
+                      &paint);
+  return true;
+}
+
 #if SK_SUPPORT_GPU
 
 const SkImage* SkiaSurface::getOrCreateTextureImage() const
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (c) 2018-2024  Igara Studio S.A.
+// Copyright (c) 2018-2025  Igara Studio S.A.
 // Copyright (c) 2012-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -24,6 +24,7 @@
 #include "include/core/SkSurface.h"
 
 #include <atomic>
+#include <memory>
 
 namespace os {
 
@@ -60,6 +61,8 @@ public:
   gfx::Matrix matrix() const override;
   void lock() override;
   void unlock() override;
+  void lockReadOnly() override;
+  void unlockReadOnly() override;
   void applyScale(int scaleFactor) override;
 
   void* nativeHandle() override;
@@ -119,7 +122,17 @@ public:
 
   static SurfaceRef loadSurface(const char* filename);
 
+  // See System::makeRgbaSurfaceFromData()
+  static SurfaceRef makeRgbaSurfaceFromData(int width,
+                                            int height,
+                                            const SurfaceFormatData& format,
+                                            const void* pixels,
+                                            std::size_t rowBytes,
+                                            std::shared_ptr<const void> owner,
+                                            const os::ColorSpaceRef& cs);
+
 private:
+  static SurfaceRef loadSurfaceWithBuiltinDecoders(const char* filename);
   void skDrawSurface(const Surface* src,
                      const gfx::Clip& clip,
                      const SkSamplingOptions& sampling,
@@ -137,6 +150,11 @@ private:
                      const SkSamplingOptions& sampling,
                      const SkPaint& paint,
                      SkCanvas::SrcRectConstraint constraint);
+  bool drawResampledSurface(const SkiaSurface* src,
+                            const gfx::Rect& srcRect,
+                            const gfx::Rect& dstRect,
+                            const Sampling& sampling,
+                            const SkPaint& paint);
 
 #if SK_SUPPORT_GPU
   const SkImage* getOrCreateTextureImage() const;
@@ -161,6 +179,9 @@ private:
   SkCanvas* m_canvas;
   SkPaint m_paint;
   std::atomic<int> m_lock;
+  // True if m_bitmap has external pixels (see
+  // makeRgbaSurfaceFromData()), m_canvas ignores drawing operations.
+  bool m_readOnly = false;
 };
 
 } // namespace os
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2025  Igara Studio S.A.
 // Copyright (C) 2012-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -103,6 +103,23 @@ public:
 
   SurfaceRef loadRgbaSurface(const char* filename) override { return loadSurface(filename); }
 
+  SurfaceRef makeRgbaSurfaceFromData(int width,
+                                     int height,
+                                     const SurfaceFormatData& format,
+                                     const void* pixels,
+                                     std::size_t rowBytes,
+                                     std::shared_ptr<const void> owner,
+                                     const os::ColorSpaceRef& colorSpace) override
+  {
+    return SkiaSurface::makeRgbaSurfaceFromData(width,
+                                                height,
+                                                format,
+                                                pixels,
+                                                rowBytes,
+                                                std::move(owner),
+                                                colorSpace);
+  }
+
   FontManager* fontManager() override
   {
     if (!m_fontManager)
@@ -65,6 +65,11 @@ public:
   virtual void lock() = 0;
   virtual void unlock() = 0;
 
+  // Same as lock()/unlock() when the pixels are only read, so the
+  // surface is not marked as changed when it's unlocked.
+  virtual void lockReadOnly() = 0;
+  virtual void unlockReadOnly() = 0;
+
   virtual void clear() = 0;
 
   virtual uint8_t* getData(int x, int y) const = 0;
@@ -146,11 +151,30 @@ public:
 
 class SurfaceLock {
 public:
-  SurfaceLock(Surface* surface) : m_surface(surface) { m_surface->lock(); }
-  ~SurfaceLock() { m_surface->unlock(); }
+  enum Mode { ReadWrite, ReadOnly };
+
+  SurfaceLock(Surface* surface, const Mode mode = ReadWrite) : m_surface(surface), m_mode(mode)
+  {
+    if (m_mode == ReadOnly)
+      m_surface->lockReadOnly();
+    else
+      m_surface->lock();
+  }
+
+  // Locks a const surface to read its pixels
+  SurfaceLock(const Surface* surface) : SurfaceLock(const_cast<Surface*>(surface), ReadOnly) {}
+
+  ~SurfaceLock()
+  {
+    if (m_mode == ReadOnly)
+      m_surface->unlockReadOnly();
+    else
+      m_surface->unlock();
+  }
 
 private:
   Surface* m_surface;
+  Mode m_mode;
 };
 
 } // namespace os
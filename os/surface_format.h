@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2024  Igara Studio S.A.
+// Copyright (C) 2024-2025  Igara Studio S.A.
 // Copyright (C) 2012-2013  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -37,6 +37,19 @@ struct SurfaceFormatData {
   PixelAlpha pixelAlpha;
 };
 
+inline bool operator==(const SurfaceFormatData& a, const SurfaceFormatData& b)
+{
+  return (a.format == b.format && a.bitsPerPixel == b.bitsPerPixel && a.redShift == b.redShift &&
+          a.greenShift == b.greenShift && a.blueShift == b.blueShift &&
+          a.alphaShift == b.alphaShift && a.redMask == b.redMask && a.greenMask == b.greenMask &&
+          a.blueMask == b.blueMask && a.alphaMask == b.alphaMask && a.pixelAlpha == b.pixelAlpha);
+}
+
+inline bool operator!=(const SurfaceFormatData& a, const SurfaceFormatData& b)
+{
+  return !(a == b);
+}
+
 } // namespace os
 
 #endif
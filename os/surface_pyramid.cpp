@@ -0,0 +1,204 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/surface_pyramid.h"
+
+#include "base/thread_pool.h"
+#include "os/common/downsample.h"
+#include "os/common/surface_utils.h"
+#include "os/system.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace os {
+
+namespace {
+
+// Number of rows of a level calculated by each task sent to the
+// thread pool.
+constexpr int kRowsPerTask = 32;
+
+DownsampleFilter to_downsample_filter(const SurfacePyramid::Filter filter)
+{
+  return (filter == SurfacePyramid::Filter::Lanczos ? DownsampleFilter::Lanczos :
+                                                      DownsampleFilter::Box);
+}
+
+} // anonymous namespace
+
+SurfacePyramid::SurfacePyramid(const SurfaceRef& source,
+                               const Filter filter,
+                               base::thread_pool* pool)
+  : m_source(source)
+  , m_filter(filter)
+  , m_pool(pool)
+{
+  Level level;
+  level.surface = source;
+  level.size = gfx::Size(source->width(), source->height());
+  m_levels.push_back(level);
+
+  while (level.size.w > 1 || level.size.h > 1) {
+    level.surface = nullptr;
+    level.size = gfx::Size(downsample_size(level.size.w), downsample_size(level.size.h));
+    level.dirty = gfx::Rect(level.size);
+    m_levels.push_back(level);
+  }
+}
+
+Surface* SurfacePyramid::level(const int i)
+{
+  ASSERT(i >= 0 && i < levelCount());
+  if (i > 0 && !updateLevel(i))
+    return nullptr;
+  return m_levels[i].surface.get();
+}
+
+int SurfacePyramid::levelForScale(const double scale) const
+{
+  if (scale >= 1.0 || scale <= 0.0)
+    return 0;
+
+  // The level i has a scale of 1/2^i, we use the smallest level with
+  // a scale >= the given one (a small epsilon avoids using the next
+  // level for exact 1/2^i scales with rounding errors).
+  const int i = int(std::floor(std::log2(1.0 / scale) + 1e-9));
+  return std::clamp(i, 0, levelCount() - 1);
+}
+
+void SurfacePyramid::invalidate(const gfx::Rect& rc)
+{
+  // Only the first level is marked as dirty here, the modified area
+  // is propagated to the next levels when they are updated.
+  if (levelCount() > 1) {
+    Level& level = m_levels[1];
+    level.dirty |= (downsample_area(rc & m_source->bounds(), to_downsample_filter(m_filter)) &
+                    gfx::Rect(level.size));
+  }
+}
+
+void SurfacePyramid::drawTo(Surface* dst,
+                            const gfx::Rect& srcRect,
+                            const gfx::Rect& dstRect,
+                            const Sampling& sampling,
+                            const Paint* paint)
+{
+  if (srcRect.isEmpty() || dstRect.isEmpty())
+    return;
+
+  const double sx = double(dstRect.w) / srcRect.w;
+  const double sy = double(dstRect.h) / srcRect.h;
+  const int i = levelForScale(std::max(sx, sy));
+  if (i == 0) {
+    dst->drawSurface(m_source.get(), srcRect, dstRect, sampling, paint);
+    return;
+  }
+
+  Surface* surface = level(i);
+  if (!surface) {
+    dst->drawSurface(m_source.get(), srcRect, dstRect, sampling, paint);
+    return;
+  }
+
+  const gfx::Size size = m_levels[i].size;
+
+  // Source pixels per level pixel (it's not exactly 2^i when the
+  // size of some level was odd)
+  const double fx = double(m_source->width()) / size.w;
+  const double fy = double(m_source->height()) / size.h;
+
+  // Area of the level that contains srcRect
+  const int x1 = std::max(0, int(std::floor(srcRect.x / fx)));
+  const int y1 = std::max(0, int(std::floor(srcRect.y / fy)));
+  const int x2 = std::min(size.w, int(std::ceil(srcRect.x2() / fx)));
+  const int y2 = std::min(size.h, int(std::ceil(srcRect.y2() / fy)));
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  // Destination of that area (it can be a bit bigger than dstRect as
+  // the level area is aligned to level pixels)
+  const int dx1 = int(std::round(dstRect.x + (x1 * fx - srcRect.x) * sx));
+  const int dy1 = int(std::round(dstRect.y + (y1 * fy - srcRect.y) * sy));
+  const int dx2 = int(std::round(dstRect.x + (x2 * fx - srcRect.x) * sx));
+  const int dy2 = int(std::round(dstRect.y + (y2 * fy - srcRect.y) * sy));
+
+  dst->saveClip();
+  if (dst->clipRect(dstRect)) {
+    dst->drawSurface(surface,
+                     gfx::Rect(x1, y1, x2 - x1, y2 - y1),
+                     gfx::Rect(dx1, dy1, dx2 - dx1, dy2 - dy1),
+                     sampling,
+                     paint);
+  }
+  dst->restoreClip();
+}
+
+bool SurfacePyramid::updateLevel(const int i)
+{
+  // The previous level must be updated first (this propagates its
+  // modified area to this level)
+  if (i > 1 && !updateLevel(i - 1))
+    return false;
+
+  Level& level = m_levels[i];
+  if (!level.surface) {
+    level.surface = instance()->makeRgbaSurface(level.size.w,
+                                                level.size.h,
+                                                m_source->colorSpace());
+    if (!level.surface)
+      return false;
+    level.dirty = gfx::Rect(level.size);
+  }
+  if (level.dirty.isEmpty())
+    return true;
+
+  Surface* src = m_levels[i - 1].surface.get();
+  Surface* dst = level.surface.get();
+  SurfaceLock lockSrc(src, SurfaceLock::ReadOnly);
+  SurfaceLock lockDst(dst);
+
+  SurfaceFormatData fd;
+  dst->getFormat(&fd);
+  ASSERT(fd.bitsPerPixel == 32);
+
+  const uint32_t* srcPixels = (const uint32_t*)src->getData(0, 0);
+  uint32_t* dstPixels = (uint32_t*)dst->getData(0, 0);
+  if (!srcPixels || !dstPixels)
+    return false;
+  const int srcStride = row_stride(src);
+  const int dstStride = row_stride(dst);
+
+  // Calculate bands of rows in parallel
+  const gfx::Rect area = level.dirty;
+  const DownsampleFilter filter = to_downsample_filter(m_filter);
+  base::for_each_task(m_pool, area.h, kRowsPerTask, [&](const int y1, const int y2) {
+    downsample_half(srcPixels,
+                    src->width(),
+                    src->height(),
+                    srcStride,
+                    dstPixels,
+                    dstStride,
+                    gfx::Rect(area.x, area.y + y1, area.w, y2 - y1),
+                    fd,
+                    filter);
+  });
+
+  // The area is clean only after it was calculated, and now the next
+  // level must be updated too
+  level.dirty = gfx::Rect();
+  if (i + 1 < levelCount()) {
+    Level& next = m_levels[i + 1];
+    next.dirty |= (downsample_area(area, filter) & gfx::Rect(next.size));
+  }
+  return true;
+}
+
+} // namespace os
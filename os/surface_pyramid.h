@@ -0,0 +1,88 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_SURFACE_PYRAMID_H_INCLUDED
+#define OS_SURFACE_PYRAMID_H_INCLUDED
+#pragma once
+
+#include "gfx/rect.h"
+#include "gfx/size.h"
+#include "os/sampling.h"
+#include "os/surface.h"
+
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+// Image pyramid (mipmaps) of a surface to draw it zoomed out: each
+// level has half the size of the previous one, and the level that
+// is closer to the drawing scale is used, so we don't read a lot of
+// source pixels to show a few of them. Levels are created the first
+// time they are needed, and the modified areas of the source surface
+// (see invalidate()) are updated incrementally.
+class SurfacePyramid {
+public:
+  enum class Filter {
+    Box,     // 2x2 average, fast
+    Lanczos, // Sharper results
+  };
+
+  // If "pool" is not nullptr, the levels are calculated in parallel
+  // with the threads of the pool.
+  SurfacePyramid(const SurfaceRef& source,
+                 Filter filter = Filter::Box,
+                 base::thread_pool* pool = nullptr);
+
+  const SurfaceRef& source() const { return m_source; }
+  Filter filter() const { return m_filter; }
+
+  // Number of levels including the source surface (level 0), the
+  // last level is 1x1.
+  int levelCount() const { return int(m_levels.size()); }
+
+  // Returns the surface of the given level, creating or updating it
+  // (and the previous levels) if it's needed. Returns nullptr if the
+  // level cannot be calculated (e.g. its surface cannot be created).
+  Surface* level(int i);
+
+  // Returns the smallest level that has enough pixels to draw the
+  // source surface with the given scale (e.g. 0.25 for a 1/4 zoom).
+  int levelForScale(double scale) const;
+
+  // Marks an area of the source surface as modified.
+  void invalidate(const gfx::Rect& rc);
+  void invalidate() { invalidate(m_source->bounds()); }
+
+  // Same as dst->drawSurface(source(), srcRect, dstRect, ...) but
+  // using the level of the pyramid for the dstRect/srcRect scale.
+  void drawTo(Surface* dst,
+              const gfx::Rect& srcRect,
+              const gfx::Rect& dstRect,
+              const Sampling& sampling = Sampling(Sampling::Filter::Linear),
+              const Paint* paint = nullptr);
+
+private:
+  struct Level {
+    SurfaceRef surface;
+    gfx::Size size;
+    gfx::Rect dirty; // Area that must be calculated again
+  };
+
+  bool updateLevel(int i);
+
+  SurfaceRef m_source;
+  Filter m_filter;
+  base::thread_pool* m_pool;
+  std::vector<Level> m_levels;
+};
+
+} // namespace os
+
+#endif
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2018-2024  Igara Studio S.A.
+// Copyright (C) 2018-2025  Igara Studio S.A.
 // Copyright (C) 2012-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -16,6 +16,7 @@
 #include "os/keys.h"
 #include "os/ref.h"
 #include "os/screen.h"
+#include "os/surface_format.h"
 #include "os/tablet_options.h"
 #include "os/window.h"
 #include "os/window_spec.h"
@@ -157,6 +158,21 @@ public:
   virtual Ref<Surface> loadSurface(const char* filename) = 0;
   virtual Ref<Surface> loadRgbaSurface(const char* filename) = 0;
 
+  // Creates a read-only RGBA surface that uses the given pixels
+  // without copying them (e.g. the pixels of a mapped file). Returns
+  // nullptr if "format" is not the format of the RGBA surfaces of
+  // this system (see Surface::getFormat()). The "owner" of the
+  // pixels is kept alive until the surface is destroyed. The pixels
+  // are never modified (drawing operations are ignored), and the
+  // surface can be locked only with SurfaceLock::ReadOnly.
+  virtual Ref<Surface> makeRgbaSurfaceFromData(int width,
+                                               int height,
+                                               const SurfaceFormatData& format,
+                                               const void* pixels,
+                                               std::size_t rowBytes,
+                                               std::shared_ptr<const void> owner,
+                                               const os::ColorSpaceRef& colorSpace = nullptr) = 0;
+
   // Creates a new cursor with the given surface.
   //
   // Warning: On Windows there is a limit of 10,000 GDI objects per
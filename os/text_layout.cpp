@@ -0,0 +1,188 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/text_layout.h"
+
+#include "base/thread_pool.h"
+#include "base/utf8_decode.h"
+#include "ft/algorithm.h"
+#include "ft/hb_face.h"
+#include "ft/thread_face.h"
+#include "os/common/freetype_font.h"
+#include "os/common/sprite_sheet_font.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace os {
+
+namespace {
+
+// Number of strings shaped by each task sent to the thread pool.
+constexpr int kStringsPerTask = 64;
+
+// Face used to shape texts in the threads of the pool
+using ShapingFace = ft::HBFace<ft::FaceFT<ft::NoCache>>;
+
+// HarfBuzz buffers used to shape texts in the current thread
+class ThreadBuffers {
+public:
+  ThreadBuffers() : m_buf(hb_buffer_create()), m_chrBuf(hb_buffer_create()) {}
+  ~ThreadBuffers()
+  {
+    hb_buffer_destroy(m_buf);
+    hb_buffer_destroy(m_chrBuf);
+  }
+
+  hb_buffer_t* buf() const { return m_buf; }
+  hb_buffer_t* chrBuf() const { return m_chrBuf; }
+
+private:
+  hb_buffer_t* m_buf;
+  hb_buffer_t* m_chrBuf;
+};
+
+thread_local ThreadBuffers t_buffers;
+
+template<typename HBFace>
+void shape_layout(HBFace& face,
+                  const std::string& str,
+                  const int fontSize,
+                  TextLayout& layout,
+                  hb_buffer_t* buf,
+                  hb_buffer_t* chrBuf)
+{
+  layout.glyphs.clear();
+  layout.fontSize = fontSize;
+  layout.advance = ft::shape_text(
+    face,
+    str,
+    [&layout](const ft::ShapedGlyph& g) {
+      layout.glyphs.push_back(
+        TextLayout::Glyph{ g.glyph_index, g.char_index, g.x, g.y, g.startX, g.endX });
+    },
+    buf,
+    chrBuf);
+}
+
+void layout_sprite_sheet_text(SpriteSheetFont* font, const std::string& str, TextLayout& layout)
+{
+  layout.glyphs.clear();
+  layout.fontSize = font->height();
+
+  base::utf8_decode decode(str);
+  double x = 0.0;
+  while (true) {
+    const int i = decode.pos() - str.begin();
+    const int chr = decode.next();
+    if (!chr)
+      break;
+
+    const double w = font->getCharBounds(chr).w;
+    layout.glyphs.push_back(TextLayout::Glyph{ uint32_t(chr), i, x, 0.0, x, x + w });
+    x += w;
+  }
+  layout.advance = x;
+}
+
+void layout_free_type_texts(FreeTypeFont* font,
+                            const std::vector<std::string>& strings,
+                            std::vector<TextLayout>& layouts,
+                            base::thread_pool* pool)
+{
+  const int size = font->size();
+
+  // Shape everything in this thread with the font face
+  if (!pool || int(strings.size()) <= kStringsPerTask) {
+    hb_buffer_t* buf = hb_buffer_create();
+    hb_buffer_t* chrBuf = hb_buffer_create();
+    for (size_t i = 0; i < strings.size(); ++i)
+      shape_layout(font->face(), strings[i], size, layouts[i], buf, chrBuf);
+    hb_buffer_destroy(buf);
+    hb_buffer_destroy(chrBuf);
+    return;
+  }
+
+  const std::string& filename = font->filename();
+  const int faceIndex = font->faceIndex();
+  const bool antialias = font->face().antialias();
+  const bool subpixelPositioning = font->face().subpixelPositioning();
+  std::atomic<bool> failed(false);
+  const int n = int(strings.size());
+  base::for_each_task(pool, n, kStringsPerTask, [&](const int begin, const int end) {
+    ShapingFace& face = ft::get_thread_face<ShapingFace>(filename,
+                                                         faceIndex,
+                                                         size,
+                                                         antialias,
+                                                         subpixelPositioning);
+    if (!face.isValid()) {
+      failed = true;
+      return;
+    }
+    for (int i = begin; i < end; ++i)
+      shape_layout(face, strings[i], size, layouts[i], t_buffers.buf(), t_buffers.chrBuf());
+  });
+
+  // The font file cannot be opened again (e.g. it was deleted), so
+  // we shape the text using the font face in this thread.
+  if (failed)
+    layout_free_type_texts(font, strings, layouts, nullptr);
+}
+
+} // anonymous namespace
+
+std::vector<TextLayout> layout_texts(Font* font,
+                                     const std::vector<std::string>& strings,
+                                     base::thread_pool* pool)
+{
+  std::vector<TextLayout> layouts(strings.size());
+
+  switch (font->type()) {
+    case FontType::SpriteSheet:
+      for (size_t i = 0; i < strings.size(); ++i)
+        layout_sprite_sheet_text(static_cast<SpriteSheetFont*>(font), strings[i], layouts[i]);
+      break;
+
+    case FontType::FreeType:
+      layout_free_type_texts(static_cast<FreeTypeFont*>(font), strings, layouts, pool);
+      break;
+
+    default:
+      // Do nothing
+      break;
+  }
+
+  return layouts;
+}
+
+void prerasterize_glyphs(Font* font, const std::string& chars, base::thread_pool& pool)
+{
+  if (font->type() == FontType::FreeType)
+    static_cast<FreeTypeFont*>(font)->prerasterizeGlyphs(chars, pool);
+}
+
+GlyphCacheStats glyph_cache_stats(Font* font)
+{
+  GlyphCacheStats result;
+  if (font->type() == FontType::FreeType) {
+    const ft::GlyphCacheStats& stats = static_cast<FreeTypeFont*>(font)->face().cache().stats();
+    result.hits = stats.hits;
+    result.misses = stats.misses;
+  }
+  return result;
+}
+
+void reset_glyph_cache_stats(Font* font)
+{
+  if (font->type() == FontType::FreeType)
+    static_cast<FreeTypeFont*>(font)->face().cache().resetStats();
+}
+
+} // namespace os
@@ -0,0 +1,82 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_TEXT_LAYOUT_H_INCLUDED
+#define OS_TEXT_LAYOUT_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+#include "gfx/color.h"
+#include "gfx/fwd.h"
+
+#include <string>
+#include <vector>
+
+namespace base {
+class thread_pool;
+}
+
+namespace os {
+
+class Font;
+class Surface;
+
+// Positioned glyphs of a string shaped with a specific font and
+// size. It doesn't reference the font, so it can be cached and drawn
+// later with draw_text_layout() using the same font/size.
+struct TextLayout {
+  struct Glyph {
+    uint32_t glyph; // Glyph index (or the codepoint for sprite sheet fonts)
+    int charIndex;  // Byte index in the UTF-8 string
+    double x, y;    // Pen position (without the glyph bearing)
+    double startX, endX;
+  };
+
+  std::vector<Glyph> glyphs;
+  double advance = 0.0;
+  int fontSize = 0;
+};
+
+// Shapes all the given strings with the same font (fallback fonts
+// are not used). If "pool" is not nullptr, strings are shaped in
+// parallel on its threads, each thread with its own copy of the
+// FreeType face and HarfBuzz buffers (they cannot be shared between
+// threads). The result has one TextLayout for each string.
+std::vector<TextLayout> layout_texts(Font* font,
+                                     const std::vector<std::string>& strings,
+                                     base::thread_pool* pool = nullptr);
+
+// Rasterizes the glyphs of the given chars in parallel with the
+// threads of the pool (e.g. before drawing a lot of text with a new
+// font or size). Only FreeType fonts are affected.
+void prerasterize_glyphs(Font* font, const std::string& chars, base::thread_pool& pool);
+
+// Number of glyphs found in the glyph cache of a font (hits) or
+// rasterized (misses) since the font was created or the last
+// reset_glyph_cache_stats() call. Only FreeType fonts have a glyph
+// cache, for other fonts both values are zero.
+struct GlyphCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+GlyphCacheStats glyph_cache_stats(Font* font);
+void reset_glyph_cache_stats(Font* font);
+
+// Draws a text layout previously calculated with layout_texts(),
+// the font must be the same (and with the same size). Returns the
+// bounds of the drawn text (same as draw_text()).
+gfx::Rect draw_text_layout(Surface* surface,
+                           Font* font,
+                           const TextLayout& layout,
+                           gfx::Color fg,
+                           gfx::Color bg,
+                           int x,
+                           int y);
+
+} // namespace os
+
+#endif